@@ -49,6 +49,7 @@
 #include <nuttx/fs/loop.h>
 #include <nuttx/net/loopback.h>
 #include <nuttx/net/tun.h>
+#include <nuttx/net/can.h>
 #include <nuttx/net/telnet.h>
 #include <nuttx/syslog/syslog.h>
 #include <nuttx/syslog/syslog_console.h>
@@ -254,6 +255,12 @@ void up_initialize(void)
   (void)tun_initialize();
 #endif
 
+#ifdef CONFIG_NETDEV_VCAN
+  /* Initialize the virtual CAN device */
+
+  (void)vcan_initialize();
+#endif
+
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
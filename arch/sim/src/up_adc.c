@@ -0,0 +1,428 @@
+/****************************************************************************
+ * arch/sim/src/up_adc.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_ADC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SIM_ADC_NCHANNELS
+#  define CONFIG_SIM_ADC_NCHANNELS 4
+#endif
+
+#ifndef CONFIG_SIM_ADC_RATE
+#  define CONFIG_SIM_ADC_RATE 1000
+#endif
+
+/* The highest supported scan rate */
+
+#define SIM_ADC_MAXRATE   1000000
+
+/* The most scans generated by one timer tick.  After a longer stall, the
+ * missed scans are skipped rather than generated all at once.
+ */
+
+#define SIM_ADC_MAXBURST  65536
+
+/* The simulated converter has 12 bits */
+
+#define SIM_ADC_MAXVALUE  0xfff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A simulated multi-channel ADC.  There is no interrupt on the simulator
+ * that is faster than the system timer, so the scans are generated in
+ * bursts from a watchdog that runs on each tick.  Each scan is timed as if
+ * it were converted exactly at its sampling period.
+ */
+
+struct sim_adc_s
+{
+  struct adc_dev_s dev;                 /* ADC upper half interface */
+  FAR const struct adc_callback_s *cb;  /* Upper half callbacks */
+  WDOG_ID wdog;                         /* Generates the scans */
+  uint32_t rate;                        /* Scans per second */
+  uint64_t start;                       /* Time of the first scan */
+  uint64_t seq;                         /* Number of scans generated */
+#ifdef CONFIG_ADC_BLOCK
+  FAR struct adc_blkhdr_s *blk;         /* Block being filled */
+  uint16_t nscans;                      /* Scans per block (0: sample mode) */
+  uint16_t fill;                        /* Scans in the current block */
+  uint16_t skip;                        /* Scans to discard after an overrun */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  sim_adc_bind(FAR struct adc_dev_s *dev,
+                         FAR const struct adc_callback_s *callback);
+static void sim_adc_reset(FAR struct adc_dev_s *dev);
+static int  sim_adc_setup(FAR struct adc_dev_s *dev);
+static void sim_adc_shutdown(FAR struct adc_dev_s *dev);
+static void sim_adc_rxint(FAR struct adc_dev_s *dev, bool enable);
+static int  sim_adc_ioctl(FAR struct adc_dev_s *dev, int cmd,
+                          unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct adc_ops_s g_sim_adc_ops =
+{
+  sim_adc_bind,       /* ao_bind */
+  sim_adc_reset,      /* ao_reset */
+  sim_adc_setup,      /* ao_setup */
+  sim_adc_shutdown,   /* ao_shutdown */
+  sim_adc_rxint,      /* ao_rxint */
+  sim_adc_ioctl       /* ao_ioctl */
+};
+
+static struct sim_adc_s g_sim_adc;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_adc_timestamp
+ ****************************************************************************/
+
+static uint64_t sim_adc_timestamp(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: sim_adc_sample
+ *
+ * Description:
+ *   Return the value of one channel in one scan.  Channel 0 is a sawtooth
+ *   that steps by one per scan so that a consumer can detect lost scans;
+ *   the other channels are a triangle, a square wave and DC levels.
+ *
+ ****************************************************************************/
+
+static int32_t sim_adc_sample(int ch, uint64_t seq)
+{
+  uint32_t phase;
+
+  switch (ch & 3)
+    {
+      case 0:
+        return (int32_t)(seq & SIM_ADC_MAXVALUE);
+
+      case 1:
+        phase = (uint32_t)(seq & 511);
+        return phase < 256 ? phase << 4 : (511 - phase) << 4;
+
+      case 2:
+        return (seq & 256) != 0 ? SIM_ADC_MAXVALUE : 0;
+
+      default:
+        return (256 * (ch + 1)) & SIM_ADC_MAXVALUE;
+    }
+}
+
+/****************************************************************************
+ * Name: sim_adc_scan
+ *
+ * Description:
+ *   Deliver one scan, either a sample at a time or into the current block.
+ *
+ ****************************************************************************/
+
+static void sim_adc_scan(FAR struct sim_adc_s *priv, uint64_t seq)
+{
+  int ch;
+
+#ifdef CONFIG_ADC_BLOCK
+  if (priv->nscans > 0)
+    {
+      FAR int16_t *data;
+
+      if (priv->skip > 0)
+        {
+          /* Discarding a block of scans after an overrun */
+
+          priv->skip--;
+          return;
+        }
+
+      if (priv->blk == NULL)
+        {
+          priv->blk = priv->cb->au_getblock(&priv->dev);
+          if (priv->blk == NULL)
+            {
+              priv->skip = priv->nscans - 1;
+              return;
+            }
+
+          priv->blk->ab_timestamp = priv->start +
+                                    seq * 1000000 / priv->rate;
+          priv->fill = 0;
+        }
+
+      data = (FAR int16_t *)ADC_BLKDATA(priv->blk) +
+             priv->fill * CONFIG_SIM_ADC_NCHANNELS;
+
+      for (ch = 0; ch < CONFIG_SIM_ADC_NCHANNELS; ch++)
+        {
+          data[ch] = (int16_t)sim_adc_sample(ch, seq);
+        }
+
+      if (++priv->fill >= priv->blk->ab_nscans)
+        {
+          (void)priv->cb->au_putblock(&priv->dev, priv->blk);
+          priv->blk = NULL;
+        }
+
+      return;
+    }
+#endif
+
+  for (ch = 0; ch < CONFIG_SIM_ADC_NCHANNELS; ch++)
+    {
+      (void)priv->cb->au_receive(&priv->dev, ch, sim_adc_sample(ch, seq));
+    }
+}
+
+/****************************************************************************
+ * Name: sim_adc_timeout
+ *
+ * Description:
+ *   Generate all scans that became due since the last tick.
+ *
+ ****************************************************************************/
+
+static void sim_adc_timeout(int argc, wdparm_t arg1, ...)
+{
+  FAR struct sim_adc_s *priv = (FAR struct sim_adc_s *)((uintptr_t)arg1);
+  uint64_t due;
+
+  due = (sim_adc_timestamp() - priv->start) * priv->rate / 1000000;
+  if (due - priv->seq > SIM_ADC_MAXBURST)
+    {
+      priv->seq = due - SIM_ADC_MAXBURST;
+    }
+
+  while (priv->seq < due)
+    {
+      sim_adc_scan(priv, priv->seq);
+      priv->seq++;
+    }
+
+  (void)wd_start(priv->wdog, 1, (wdentry_t)sim_adc_timeout, 1, arg1);
+}
+
+/****************************************************************************
+ * Name: sim_adc_bind
+ ****************************************************************************/
+
+static int sim_adc_bind(FAR struct adc_dev_s *dev,
+                        FAR const struct adc_callback_s *callback)
+{
+  FAR struct sim_adc_s *priv = (FAR struct sim_adc_s *)dev->ad_priv;
+
+  priv->cb = callback;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sim_adc_reset
+ ****************************************************************************/
+
+static void sim_adc_reset(FAR struct adc_dev_s *dev)
+{
+}
+
+/****************************************************************************
+ * Name: sim_adc_setup
+ ****************************************************************************/
+
+static int sim_adc_setup(FAR struct adc_dev_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sim_adc_shutdown
+ *
+ * Description:
+ *   Stop the conversions.  The upper half leaves block mode on close.
+ *
+ ****************************************************************************/
+
+static void sim_adc_shutdown(FAR struct adc_dev_s *dev)
+{
+  FAR struct sim_adc_s *priv = (FAR struct sim_adc_s *)dev->ad_priv;
+
+  sim_adc_rxint(dev, false);
+#ifdef CONFIG_ADC_BLOCK
+  priv->nscans = 0;
+#endif
+  priv->rate = CONFIG_SIM_ADC_RATE;
+}
+
+/****************************************************************************
+ * Name: sim_adc_rxint
+ *
+ * Description:
+ *   Start or stop the conversions.  Scans are numbered from zero each time
+ *   the conversions are started.
+ *
+ ****************************************************************************/
+
+static void sim_adc_rxint(FAR struct adc_dev_s *dev, bool enable)
+{
+  FAR struct sim_adc_s *priv = (FAR struct sim_adc_s *)dev->ad_priv;
+
+  (void)wd_cancel(priv->wdog);
+
+#ifdef CONFIG_ADC_BLOCK
+  /* Forget the current block:  The pool may be freed */
+
+  priv->blk  = NULL;
+  priv->skip = 0;
+#endif
+
+  if (enable)
+    {
+      priv->start = sim_adc_timestamp();
+      priv->seq   = 0;
+
+      (void)wd_start(priv->wdog, 1, (wdentry_t)sim_adc_timeout, 1,
+                     (wdparm_t)((uintptr_t)priv));
+    }
+}
+
+/****************************************************************************
+ * Name: sim_adc_ioctl
+ ****************************************************************************/
+
+static int sim_adc_ioctl(FAR struct adc_dev_s *dev, int cmd,
+                         unsigned long arg)
+{
+#ifdef CONFIG_ADC_BLOCK
+  FAR struct sim_adc_s *priv = (FAR struct sim_adc_s *)dev->ad_priv;
+#endif
+
+  switch (cmd)
+    {
+#ifdef CONFIG_ADC_BLOCK
+      case ANIOC_BLK_CONFIG:
+        {
+          FAR struct adc_blkcfg_s *cfg =
+            (FAR struct adc_blkcfg_s *)((uintptr_t)arg);
+
+          if (cfg->ac_rate > SIM_ADC_MAXRATE)
+            {
+              cfg->ac_rate = SIM_ADC_MAXRATE;
+            }
+
+          if (cfg->ac_rate > 0)
+            {
+              priv->rate = cfg->ac_rate;
+            }
+
+          priv->nscans       = cfg->ac_nscans;
+          cfg->ac_nchannels  = CONFIG_SIM_ADC_NCHANNELS;
+          cfg->ac_samplesize = sizeof(int16_t);
+        }
+        return OK;
+#endif
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_adc_initialize
+ *
+ * Description:
+ *   Register the simulated ADC at /dev/adc0.
+ *
+ ****************************************************************************/
+
+int up_adc_initialize(void)
+{
+  FAR struct sim_adc_s *priv = &g_sim_adc;
+
+  priv->wdog = wd_create();
+  if (priv->wdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->dev.ad_ops  = &g_sim_adc_ops;
+  priv->dev.ad_priv = priv;
+  priv->rate        = CONFIG_SIM_ADC_RATE;
+
+  return adc_register("/dev/adc0", &priv->dev);
+}
+
+#endif /* CONFIG_SIM_ADC */
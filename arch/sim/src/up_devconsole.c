@@ -130,18 +130,13 @@ static ssize_t devconsole_read(struct file *filep, char *buffer, size_t len)
 
 static ssize_t devconsole_write(struct file *filep, const char *buffer, size_t len)
 {
-  int remaining;
-  int ret = OK;
+  /* Pass the whole buffer to the host in spans, not one character at a
+   * time.
+   */
 
-  for (remaining = len; remaining > 0 && ret >= 0; remaining--)
+  if (simuart_write(buffer, len) < 0)
     {
-      unsigned char ch = *buffer++;
-      ret = simuart_putc((int)ch);
-    }
-
-  if (ret < 0)
-    {
-      return -ret;
+      return -EIO;
     }
 
   return len;
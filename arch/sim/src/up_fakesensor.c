@@ -0,0 +1,233 @@
+/****************************************************************************
+ * arch/sim/src/up_fakesensor.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/wdog.h>
+#include <nuttx/sensors/sensor.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_FAKESENSOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SIM_FAKESENSOR_PERIOD
+#  define CONFIG_SIM_FAKESENSOR_PERIOD 1000
+#endif
+
+/* The shortest supported sampling period (10 kHz) */
+
+#define FAKESENSOR_MINPERIOD 100
+
+/* The most samples generated by one timer tick.  After a longer stall, the
+ * missed samples are skipped rather than generated all at once.
+ */
+
+#define FAKESENSOR_MAXBURST  1024
+
+/* The number of samples in one period of the generated waveform */
+
+#define FAKESENSOR_WAVELEN   200
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A simulated accelerometer.  There is no interrupt on the simulator that
+ * is faster than the system timer, so the samples are generated in bursts
+ * from a watchdog that runs on each tick; each sample is timestamped as if
+ * it were taken exactly at its sampling period.
+ */
+
+struct sim_fakesensor_s
+{
+  struct sensor_lowerhalf_s lower; /* Sensor upper half interface */
+  WDOG_ID wdog;                    /* Generates the samples */
+  uint32_t period;                 /* Sampling period in microseconds */
+  uint32_t seq;                    /* Number of samples generated */
+  uint64_t next;                   /* Timestamp of the next sample */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int fakesensor_activate(FAR struct sensor_lowerhalf_s *lower,
+                               bool enable);
+static int fakesensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                   FAR uint32_t *period_us);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_ops_s g_fakesensor_ops =
+{
+  fakesensor_activate,      /* activate */
+  fakesensor_set_interval,  /* set_interval */
+  NULL                      /* control */
+};
+
+static struct sim_fakesensor_s g_fakesensor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fakesensor_timeout
+ *
+ * Description:
+ *   Generate all samples that became due since the last tick.  The X axis
+ *   is a sawtooth that steps by 0.01 m/s^2 per sample so that a consumer
+ *   can detect lost samples; Y is its negation and Z reads 1g.
+ *
+ ****************************************************************************/
+
+static void fakesensor_timeout(int argc, wdparm_t arg1, ...)
+{
+  FAR struct sim_fakesensor_s *priv =
+    (FAR struct sim_fakesensor_s *)((uintptr_t)arg1);
+  struct sensor_accel_s data;
+  uint64_t now;
+  int n;
+
+  now = sensor_timestamp();
+  for (n = 0; priv->next <= now && n < FAKESENSOR_MAXBURST; n++)
+    {
+      data.timestamp = priv->next;
+      data.x = (float)((int)(priv->seq % FAKESENSOR_WAVELEN) -
+                       FAKESENSOR_WAVELEN / 2) * 0.01f;
+      data.y = -data.x;
+      data.z = SENSOR_STANDARD_GRAVITY;
+
+      (void)sensor_push(&priv->lower, &data);
+
+      priv->seq++;
+      priv->next += priv->period;
+    }
+
+  if (priv->next <= now)
+    {
+      priv->next = now + priv->period;
+    }
+
+  (void)wd_start(priv->wdog, 1, (wdentry_t)fakesensor_timeout, 1, arg1);
+}
+
+/****************************************************************************
+ * Name: fakesensor_activate
+ ****************************************************************************/
+
+static int fakesensor_activate(FAR struct sensor_lowerhalf_s *lower,
+                               bool enable)
+{
+  FAR struct sim_fakesensor_s *priv = (FAR struct sim_fakesensor_s *)lower;
+
+  if (!enable)
+    {
+      return wd_cancel(priv->wdog);
+    }
+
+  priv->seq  = 0;
+  priv->next = sensor_timestamp() + priv->period;
+
+  return wd_start(priv->wdog, 1, (wdentry_t)fakesensor_timeout, 1,
+                  (wdparm_t)((uintptr_t)priv));
+}
+
+/****************************************************************************
+ * Name: fakesensor_set_interval
+ ****************************************************************************/
+
+static int fakesensor_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                   FAR uint32_t *period_us)
+{
+  FAR struct sim_fakesensor_s *priv = (FAR struct sim_fakesensor_s *)lower;
+
+  if (*period_us < FAKESENSOR_MINPERIOD)
+    {
+      *period_us = FAKESENSOR_MINPERIOD;
+    }
+
+  priv->period = *period_us;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fakesensor_initialize
+ *
+ * Description:
+ *   Register the simulated accelerometer at /dev/fakesensor0.
+ *
+ ****************************************************************************/
+
+int up_fakesensor_initialize(void)
+{
+  FAR struct sim_fakesensor_s *priv = &g_fakesensor;
+
+  priv->wdog = wd_create();
+  if (priv->wdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->lower.ops   = &g_fakesensor_ops;
+  priv->lower.type  = SENSOR_TYPE_ACCELEROMETER;
+  priv->lower.esize = sizeof(struct sensor_accel_s);
+  priv->period      = CONFIG_SIM_FAKESENSOR_PERIOD;
+
+  return sensor_register("/dev/fakesensor0", &priv->lower);
+}
+
+#endif /* CONFIG_SIM_FAKESENSOR */
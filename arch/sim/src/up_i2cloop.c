@@ -0,0 +1,172 @@
+/****************************************************************************
+ * arch/sim/src/up_i2cloop.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_I2CLOOP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define I2CLOOP_NREGS 256
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A simulated I2C bus on which every address answers as a simple register
+ * file:  The first byte written selects a register; following bytes are
+ * written to consecutive registers.  Reads return consecutive registers
+ * starting at the selected one.  So data read back is the data that was
+ * written.
+ */
+
+struct sim_i2cloop_s
+{
+  struct i2c_master_s dev;     /* Externally visible part of the I2C interface */
+  sem_t exclsem;               /* Supports mutually exclusive access */
+  uint8_t regaddr;             /* The selected register */
+  uint8_t regs[I2CLOOP_NREGS]; /* The register file */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int i2cloop_transfer(FAR struct i2c_master_s *dev,
+                            FAR struct i2c_msg_s *msgs, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct i2c_ops_s g_i2cloop_ops =
+{
+  .transfer = i2cloop_transfer,
+};
+
+static struct sim_i2cloop_s g_i2cloop =
+{
+  .dev      = { &g_i2cloop_ops },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2cloop_transfer
+ ****************************************************************************/
+
+static int i2cloop_transfer(FAR struct i2c_master_s *dev,
+                            FAR struct i2c_msg_s *msgs, int count)
+{
+  FAR struct sim_i2cloop_s *priv = (FAR struct sim_i2cloop_s *)dev;
+  FAR struct i2c_msg_s *msg;
+  ssize_t i;
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&priv->exclsem);
+    }
+  while (ret == -EINTR);
+
+  for (msg = msgs; msg < &msgs[count]; msg++)
+    {
+      if ((msg->flags & I2C_M_READ) != 0)
+        {
+          for (i = 0; i < msg->length; i++)
+            {
+              msg->buffer[i] = priv->regs[priv->regaddr++];
+            }
+        }
+      else if (msg->length > 0)
+        {
+          /* A new message (not a continuation) starts with the register
+           * address.
+           */
+
+          i = 0;
+          if ((msg->flags & I2C_M_NOSTART) == 0)
+            {
+              priv->regaddr = msg->buffer[0];
+              i = 1;
+            }
+
+          for (; i < msg->length; i++)
+            {
+              priv->regs[priv->regaddr++] = msg->buffer[i];
+            }
+        }
+    }
+
+  nxsem_post(&priv->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_i2cloop_initialize
+ *
+ * Description:
+ *   Return the simulated I2C loopback bus.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_master_s *up_i2cloop_initialize(void)
+{
+  nxsem_init(&g_i2cloop.exclsem, 0, 1);
+  return &g_i2cloop.dev;
+}
+
+#endif /* CONFIG_SIM_I2CLOOP */
@@ -49,6 +49,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/net/loopback.h>
 #include <nuttx/net/tun.h>
+#include <nuttx/net/can.h>
 #include <nuttx/net/telnet.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/syslog/syslog.h>
@@ -56,6 +57,8 @@
 #include <nuttx/serial/pty.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/power/pm.h>
+#include <nuttx/spi/spi_transfer.h>
+#include <nuttx/i2c/i2c_master.h>
 
 #include "up_internal.h"
 
@@ -293,6 +296,12 @@ void up_initialize(void)
   (void)tun_initialize();
 #endif
 
+#ifdef CONFIG_NETDEV_VCAN
+  /* Initialize the virtual CAN device */
+
+  (void)vcan_initialize();
+#endif
+
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
@@ -302,4 +311,28 @@ void up_initialize(void)
 #if defined(CONFIG_FS_SMARTFS) && (defined(CONFIG_SIM_SPIFLASH) || defined(CONFIG_SIM_QSPIFLASH))
   up_init_smartfs();
 #endif
+
+#if defined(CONFIG_SIM_SPILOOP) && defined(CONFIG_SPI_DRIVER)
+  /* Register the SPI loopback bus at /dev/spi0 */
+
+  (void)spi_register(up_spiloop_initialize(), 0);
+#endif
+
+#if defined(CONFIG_SIM_I2CLOOP) && defined(CONFIG_I2C_DRIVER)
+  /* Register the I2C loopback bus at /dev/i2c0 */
+
+  (void)i2c_register(up_i2cloop_initialize(), 0);
+#endif
+
+#ifdef CONFIG_SIM_FAKESENSOR
+  /* Register the simulated sensor at /dev/fakesensor0 */
+
+  (void)up_fakesensor_initialize();
+#endif
+
+#ifdef CONFIG_SIM_ADC
+  /* Register the simulated ADC at /dev/adc0 */
+
+  (void)up_adc_initialize();
+#endif
 }
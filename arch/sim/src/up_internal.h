@@ -265,6 +265,7 @@ void up_registerblockdevice(void);
 
 void simuart_start(void);
 int  simuart_putc(int ch);
+int  simuart_write(const char *buffer, size_t len);
 int  simuart_getc(bool block);
 bool simuart_checkc(void);
 void simuart_terminate(void);
@@ -378,5 +379,31 @@ struct qspi_dev_s;
 struct qspi_dev_s *up_qspiflashinitialize(void);
 #endif
 
+/* up_spiloop.c ***********************************************************/
+
+#ifdef CONFIG_SIM_SPILOOP
+struct spi_dev_s;
+FAR struct spi_dev_s *up_spiloop_initialize(void);
+#endif
+
+/* up_i2cloop.c ***********************************************************/
+
+#ifdef CONFIG_SIM_I2CLOOP
+struct i2c_master_s;
+FAR struct i2c_master_s *up_i2cloop_initialize(void);
+#endif
+
+/* up_fakesensor.c ********************************************************/
+
+#ifdef CONFIG_SIM_FAKESENSOR
+int up_fakesensor_initialize(void);
+#endif
+
+/* up_adc.c ***************************************************************/
+
+#ifdef CONFIG_SIM_ADC
+int up_adc_initialize(void);
+#endif
+
 #endif /* __ASSEMBLY__ */
 #endif /* __ARCH_SIM_SRC_UP_INTERNAL_H */
@@ -216,6 +216,34 @@ int simuart_putraw(int ch)
   return ch;
 }
 
+/****************************************************************************
+ * Name: simuart_putspan
+ ****************************************************************************/
+
+static int simuart_putspan(const char *buffer, size_t len)
+{
+  ssize_t nwritten;
+
+  while (len > 0)
+    {
+      nwritten = write(1, buffer, len);
+      if (nwritten < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+
+          return -1;
+        }
+
+      buffer += nwritten;
+      len    -= nwritten;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -265,6 +293,49 @@ int simuart_putc(int ch)
   return ret;
 }
 
+/****************************************************************************
+ * Name: simuart_write
+ *
+ * Description:
+ *   Write a buffer to the console with one host write() per line rather
+ *   than one per character.  As with simuart_putc(), \n is expanded to
+ *   \r\n.
+ *
+ ****************************************************************************/
+
+int simuart_write(const char *buffer, size_t len)
+{
+  const char *nl;
+  size_t span;
+
+  while (len > 0)
+    {
+      nl   = memchr(buffer, '\n', len);
+      span = nl != NULL ? (size_t)(nl - buffer) : len;
+
+      if (span > 0 && simuart_putspan(buffer, span) < 0)
+        {
+          return -1;
+        }
+
+      buffer += span;
+      len    -= span;
+
+      if (nl != NULL)
+        {
+          if (simuart_putspan("\r\n", 2) < 0)
+            {
+              return -1;
+            }
+
+          buffer++;
+          len--;
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: simuart_getc
  ****************************************************************************/
@@ -0,0 +1,252 @@
+/****************************************************************************
+ * arch/sim/src/up_spiloop.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_SIM_SPILOOP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A simulated SPI bus with MOSI connected to MISO */
+
+struct sim_spiloop_s
+{
+  struct spi_dev_s spidev;     /* Externally visible part of the SPI interface */
+  sem_t exclsem;               /* Supports mutually exclusive access */
+  uint8_t nbits;               /* Width of a word in bits */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int      spiloop_lock(FAR struct spi_dev_s *dev, bool lock);
+static void     spiloop_select(FAR struct spi_dev_s *dev, uint32_t devid,
+                  bool selected);
+static uint32_t spiloop_setfrequency(FAR struct spi_dev_s *dev,
+                  uint32_t frequency);
+static void     spiloop_setmode(FAR struct spi_dev_s *dev,
+                  enum spi_mode_e mode);
+static void     spiloop_setbits(FAR struct spi_dev_s *dev, int nbits);
+static uint8_t  spiloop_status(FAR struct spi_dev_s *dev, uint32_t devid);
+static uint16_t spiloop_send(FAR struct spi_dev_s *dev, uint16_t wd);
+static void     spiloop_exchange(FAR struct spi_dev_s *dev,
+                  FAR const void *txbuffer, FAR void *rxbuffer,
+                  size_t nwords);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct spi_ops_s g_spiloop_ops =
+{
+  .lock              = spiloop_lock,
+  .select            = spiloop_select,
+  .setfrequency      = spiloop_setfrequency,
+  .setmode           = spiloop_setmode,
+  .setbits           = spiloop_setbits,
+#ifdef CONFIG_SPI_HWFEATURES
+  .hwfeatures        = 0,                   /* Not supported */
+#endif
+  .status            = spiloop_status,
+#ifdef CONFIG_SPI_CMDDATA
+  .cmddata           = 0,                   /* Not supported */
+#endif
+  .send              = spiloop_send,
+  .exchange          = spiloop_exchange,
+  .registercallback  = 0,                   /* Not supported */
+};
+
+static struct sim_spiloop_s g_spiloop =
+{
+  .spidev            = { &g_spiloop_ops },
+  .nbits             = 8,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiloop_lock
+ ****************************************************************************/
+
+static int spiloop_lock(FAR struct spi_dev_s *dev, bool lock)
+{
+  FAR struct sim_spiloop_s *priv = (FAR struct sim_spiloop_s *)dev;
+  int ret;
+
+  if (lock)
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      do
+        {
+          ret = nxsem_wait(&priv->exclsem);
+        }
+      while (ret == -EINTR);
+    }
+  else
+    {
+      ret = nxsem_post(&priv->exclsem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spiloop_select
+ ****************************************************************************/
+
+static void spiloop_select(FAR struct spi_dev_s *dev, uint32_t devid,
+                           bool selected)
+{
+}
+
+/****************************************************************************
+ * Name: spiloop_setfrequency
+ ****************************************************************************/
+
+static uint32_t spiloop_setfrequency(FAR struct spi_dev_s *dev,
+                                     uint32_t frequency)
+{
+  return frequency;
+}
+
+/****************************************************************************
+ * Name: spiloop_setmode
+ ****************************************************************************/
+
+static void spiloop_setmode(FAR struct spi_dev_s *dev, enum spi_mode_e mode)
+{
+}
+
+/****************************************************************************
+ * Name: spiloop_setbits
+ ****************************************************************************/
+
+static void spiloop_setbits(FAR struct spi_dev_s *dev, int nbits)
+{
+  FAR struct sim_spiloop_s *priv = (FAR struct sim_spiloop_s *)dev;
+
+  if (nbits > 0 && nbits <= 16)
+    {
+      priv->nbits = nbits;
+    }
+}
+
+/****************************************************************************
+ * Name: spiloop_status
+ ****************************************************************************/
+
+static uint8_t spiloop_status(FAR struct spi_dev_s *dev, uint32_t devid)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Name: spiloop_send
+ ****************************************************************************/
+
+static uint16_t spiloop_send(FAR struct spi_dev_s *dev, uint16_t wd)
+{
+  return wd;
+}
+
+/****************************************************************************
+ * Name: spiloop_exchange
+ *
+ * Description:
+ *   Every word received is the word that was sent.  If there is no TX
+ *   buffer, the line idles high and all ones are received.
+ *
+ ****************************************************************************/
+
+static void spiloop_exchange(FAR struct spi_dev_s *dev,
+                             FAR const void *txbuffer, FAR void *rxbuffer,
+                             size_t nwords)
+{
+  FAR struct sim_spiloop_s *priv = (FAR struct sim_spiloop_s *)dev;
+  size_t nbytes = priv->nbits > 8 ? 2 * nwords : nwords;
+
+  if (rxbuffer != NULL)
+    {
+      if (txbuffer != NULL)
+        {
+          memmove(rxbuffer, txbuffer, nbytes);
+        }
+      else
+        {
+          memset(rxbuffer, 0xff, nbytes);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_spiloop_initialize
+ *
+ * Description:
+ *   Return the simulated SPI loopback bus.
+ *
+ ****************************************************************************/
+
+FAR struct spi_dev_s *up_spiloop_initialize(void)
+{
+  nxsem_init(&g_spiloop.exclsem, 0, 1);
+  return &g_spiloop.spidev;
+}
+
+#endif /* CONFIG_SIM_SPILOOP */
@@ -0,0 +1,1687 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * A software mixer that shares one lower level audio device among several
+ * client streams.
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_AUDIO_MIXER_SAMPLERATE
+#  define CONFIG_AUDIO_MIXER_SAMPLERATE 48000
+#endif
+
+/* The sample rate is passed to the output device in a 16-bit field */
+
+#if CONFIG_AUDIO_MIXER_SAMPLERATE > 65535
+#  error CONFIG_AUDIO_MIXER_SAMPLERATE does not fit in ac_controls.hw[0]
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_BUFFER_SIZE
+#  define CONFIG_AUDIO_MIXER_BUFFER_SIZE 2048
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_NUM_BUFFERS
+#  define CONFIG_AUDIO_MIXER_NUM_BUFFERS 3
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PRIORITY
+#  define CONFIG_AUDIO_MIXER_PRIORITY 200
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STACKSIZE
+#  define CONFIG_AUDIO_MIXER_STACKSIZE 1024
+#endif
+
+/* The mixed output is always 16-bit signed stereo */
+
+#define MIXER_NCHANNELS     2
+#define MIXER_FRAMESIZE     (MIXER_NCHANNELS * sizeof(int16_t))
+
+/* The accumulator holds one output buffer of the configured size */
+
+#define MIXER_ACCFRAMES     (CONFIG_AUDIO_MIXER_BUFFER_SIZE / MIXER_FRAMESIZE)
+
+/* Polyphase resampler geometry.  Each of the MIXER_NPHASES sub-filters has
+ * MIXER_NTAPS taps.  The stream position is kept as a Q16 fraction of an
+ * input frame; the upper MIXER_PHASE_SHIFT bits of the fraction select the
+ * sub-filter.
+ */
+
+#define MIXER_NTAPS         16
+#define MIXER_NPHASES       64
+#define MIXER_PHASE_SHIFT   6
+#define MIXER_ONE           (1 << 16)
+
+/* Q15 unity gain */
+
+#define MIXER_UNITY         32767
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes one client stream.  Each stream is registered as
+ * a separate audio device.
+ */
+
+struct mixer_stream_s
+{
+  /* This is is our appearance to the outside world.  This *MUST* be the
+   * first element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer; /* The mixer that contains this stream */
+  struct dq_queue_s pendq;         /* Buffers enqueued by the client */
+
+  volatile bool reserved;          /* The stream has been reserved */
+  volatile bool started;           /* The stream is being mixed */
+  volatile bool paused;            /* The stream is paused */
+  volatile bool stopreq;           /* Stop (or completion) is pending */
+  bool draining;                   /* Waiting for the output to play out */
+  uint32_t drainseq;               /* Output buffers enqueued at the stop */
+
+  /* Input format */
+
+  uint32_t samprate;               /* Input sample rate */
+  uint8_t  nchannels;              /* 1=Mono, 2=Stereo */
+  uint8_t  bpsamp;                 /* 8=unsigned 8-bit, 16=signed 16-bit */
+  uint8_t  framesize;              /* Bytes per input frame */
+  int16_t  gain;                   /* Q15 volume */
+
+  /* Sample rate converter.  Not used if the input rate matches the output
+   * rate.
+   */
+
+  FAR int16_t *bank;               /* MIXER_NPHASES x MIXER_NTAPS, Q15 */
+  uint32_t step;                   /* Input frames per output frame, Q16 */
+  uint32_t frac;                   /* Position in the input, Q16 */
+  uint8_t  hpos;                   /* Index of the newest history frame */
+
+  /* History of converted input frames.  Each frame is stored twice so that
+   * the most recent MIXER_NTAPS frames are always contiguous.
+   */
+
+  int16_t hist[MIXER_NCHANNELS][2 * MIXER_NTAPS];
+};
+
+/* This structure describes the internal state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The contained output device */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;               /* Session of the output device */
+#endif
+  sem_t wakesem;                   /* Wakes up the mixer thread */
+  sem_t exclsem;                   /* Serializes start/stop of the output */
+  struct dq_queue_s freeq;         /* Output buffers waiting to be filled */
+  FAR struct ap_buffer_s *outbuf[CONFIG_AUDIO_MIXER_NUM_BUFFERS];
+  FAR int32_t *acc;                /* Mixing accumulator */
+  uint32_t nenqueued;              /* Output buffers passed to the device */
+  volatile uint32_t ndequeued;     /* Output buffers returned by the device */
+  pthread_t threadid;              /* The mixer thread */
+  uint8_t nactive;                 /* Number of started streams */
+  bool running;                    /* The output device is started */
+  int nstreams;                    /* Number of streams */
+  struct mixer_stream_s stream[1]; /* Actually nstreams */
+};
+
+#define SIZEOF_AUDIO_MIXER_S(n) \
+  (sizeof(struct audio_mixer_s) + ((n) - 1) * sizeof(struct mixer_stream_s))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps);
+#else
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps);
+#endif
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_start(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+#else
+static int mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+#else
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                        FAR void *session);
+#else
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb);
+static int mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb);
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session);
+static int mixer_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session);
+#else
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session);
+#else
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_mixer_ops =
+{
+  mixer_getcaps,       /* getcaps        */
+  mixer_configure,     /* configure      */
+  mixer_shutdown,      /* shutdown       */
+  mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,         /* pause          */
+  mixer_resume,        /* resume         */
+#endif
+  NULL,                /* allocbuffer    */
+  NULL,                /* freebuffer     */
+  mixer_enqueuebuffer, /* enqueue_buffer */
+  mixer_cancelbuffer,  /* cancel_buffer  */
+  mixer_ioctl,         /* ioctl          */
+  NULL,                /* read           */
+  NULL,                /* write          */
+  mixer_reserve,       /* reserve        */
+  mixer_release        /* release        */
+};
+
+/* sin(x) for x = 0 .. pi/2 in 64 steps, Q15.  Used only to design the
+ * resampling filters.
+ */
+
+static const int16_t g_mixer_sintab[65] =
+{
+      0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+   6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_dqentry
+ *
+ * Description:
+ *   Return the queue entry of an audio buffer.  struct ap_buffer_s is
+ *   packed, but dq_entry is its first member and the buffers come from the
+ *   heap, so the entry is always aligned.
+ *
+ ****************************************************************************/
+
+static inline FAR dq_entry_t *mixer_dqentry(FAR void *apb)
+{
+  return (FAR dq_entry_t *)apb;
+}
+
+/****************************************************************************
+ * Name: mixer_sinpi
+ *
+ * Description:
+ *   Return sin(pi * x) in Q15 where x is given in Q16.
+ *
+ ****************************************************************************/
+
+static int32_t mixer_sinpi(int32_t x)
+{
+  int32_t value;
+  bool negate = false;
+  int ndx;
+
+  /* Reduce to 0 <= x < 2 */
+
+  x &= (2 * MIXER_ONE) - 1;
+
+  /* sin(pi * x) = -sin(pi * (x - 1)) for 1 <= x < 2 */
+
+  if (x >= MIXER_ONE)
+    {
+      x     -= MIXER_ONE;
+      negate = true;
+    }
+
+  /* sin(pi * x) = sin(pi * (1 - x)) for 1/2 < x < 1 */
+
+  if (x > MIXER_ONE / 2)
+    {
+      x = MIXER_ONE - x;
+    }
+
+  /* Interpolate in the quarter wave table (512 Q16 steps per entry) */
+
+  ndx   = x >> 9;
+  value = g_mixer_sintab[ndx];
+  if (ndx < 64)
+    {
+      value += ((g_mixer_sintab[ndx + 1] - value) * (x & 511)) >> 9;
+    }
+
+  return negate ? -value : value;
+}
+
+/****************************************************************************
+ * Name: mixer_design
+ *
+ * Description:
+ *   Design the polyphase filter bank of a stream:  A Hann-windowed sinc
+ *   low-pass filter with the cutoff at the lower of the input and output
+ *   Nyquist frequencies.  Each phase is normalized to unity DC gain.
+ *
+ ****************************************************************************/
+
+static void mixer_design(FAR struct mixer_stream_s *stream)
+{
+  int32_t cutoff;
+  int32_t coeff[MIXER_NTAPS];
+  int32_t sum;
+  int phase;
+  int tap;
+
+  /* Cutoff relative to the input Nyquist frequency, Q16 */
+
+  if (stream->samprate > CONFIG_AUDIO_MIXER_SAMPLERATE)
+    {
+      cutoff = (int32_t)(((uint64_t)CONFIG_AUDIO_MIXER_SAMPLERATE << 16) /
+                         stream->samprate);
+    }
+  else
+    {
+      cutoff = MIXER_ONE;
+    }
+
+  for (phase = 0; phase < MIXER_NPHASES; phase++)
+    {
+      sum = 0;
+
+      for (tap = 0; tap < MIXER_NTAPS; tap++)
+        {
+          int32_t t;
+          int32_t a;
+          int32_t sinc;
+          int32_t window;
+
+          /* Distance of this tap from the output instant in input frames,
+           * Q16.  The window covers -MIXER_NTAPS/2 .. MIXER_NTAPS/2.
+           */
+
+          t = ((MIXER_NTAPS / 2 - 1 - tap) << 16) +
+              (phase << (16 - MIXER_PHASE_SHIFT));
+
+          /* sinc(cutoff * t) in Q15 */
+
+          a = (int32_t)(((int64_t)cutoff * t) >> 16);
+          if (a == 0)
+            {
+              sinc = MIXER_UNITY;
+            }
+          else
+            {
+              /* sin(pi * a) / (pi * a); pi in Q16 is 205887 */
+
+              int64_t pia = ((int64_t)a * 205887) >> 16;
+              sinc = (int32_t)(((int64_t)mixer_sinpi(a) << 16) / pia);
+            }
+
+          /* Hann window:  0.5 + 0.5 * cos(pi * t / (MIXER_NTAPS / 2)) */
+
+          window = (MIXER_UNITY +
+                    mixer_sinpi(t / (MIXER_NTAPS / 2) + MIXER_ONE / 2)) >> 1;
+
+          coeff[tap] = (sinc * window) >> 15;
+          sum       += coeff[tap];
+        }
+
+      /* Normalize the phase to unity gain */
+
+      for (tap = 0; tap < MIXER_NTAPS; tap++)
+        {
+          stream->bank[phase * MIXER_NTAPS + tap] =
+            (int16_t)(((int64_t)coeff[tap] * MIXER_UNITY) / sum);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_acc_s16 and friends
+ *
+ * Description:
+ *   Mixing kernels.  Each accumulates nframes frames of one input format
+ *   into the stereo accumulator, applying the Q15 gain.  These are simple
+ *   unit-stride loops that the compiler can vectorize.
+ *
+ ****************************************************************************/
+
+static void mixer_acc_s16(FAR int32_t *acc, FAR const int16_t *src,
+                          int nsamples, int32_t gain)
+{
+  int i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      acc[i] += (src[i] * gain) >> 15;
+    }
+}
+
+static void mixer_acc_s16_mono(FAR int32_t *acc, FAR const int16_t *src,
+                               int nframes, int32_t gain)
+{
+  int32_t value;
+  int i;
+
+  for (i = 0; i < nframes; i++)
+    {
+      value           = (src[i] * gain) >> 15;
+      acc[2 * i]     += value;
+      acc[2 * i + 1] += value;
+    }
+}
+
+static void mixer_acc_u8(FAR int32_t *acc, FAR const uint8_t *src,
+                         int nsamples, int32_t gain)
+{
+  int i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      acc[i] += (((int32_t)src[i] - 128) * 256 * gain) >> 15;
+    }
+}
+
+static void mixer_acc_u8_mono(FAR int32_t *acc, FAR const uint8_t *src,
+                              int nframes, int32_t gain)
+{
+  int32_t value;
+  int i;
+
+  for (i = 0; i < nframes; i++)
+    {
+      value           = (((int32_t)src[i] - 128) * 256 * gain) >> 15;
+      acc[2 * i]     += value;
+      acc[2 * i + 1] += value;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_saturate
+ *
+ * Description:
+ *   Convert the accumulator to 16-bit output samples with saturation.
+ *
+ ****************************************************************************/
+
+static void mixer_saturate(FAR int16_t *dest, FAR const int32_t *acc,
+                           int nsamples)
+{
+  int32_t value;
+  int i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      value   = acc[i];
+      value   = value > INT16_MAX ? INT16_MAX : value;
+      value   = value < INT16_MIN ? INT16_MIN : value;
+      dest[i] = (int16_t)value;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_dot
+ *
+ * Description:
+ *   Apply one phase of the resampling filter to the history of one channel.
+ *
+ ****************************************************************************/
+
+static int32_t mixer_dot(FAR const int16_t *coeff, FAR const int16_t *hist)
+{
+  int32_t sum = 0;
+  int i;
+
+  /* The absolute sum of the coefficients of a phase may slightly exceed 2.0,
+   * so one bit of headroom is taken from each product.
+   */
+
+  for (i = 0; i < MIXER_NTAPS; i++)
+    {
+      sum += (coeff[i] * hist[i]) >> 1;
+    }
+
+  return sum >> 14;
+}
+
+/****************************************************************************
+ * Name: mixer_notify
+ *
+ * Description:
+ *   Report an event on a stream to its upper half.
+ *
+ ****************************************************************************/
+
+static void mixer_notify(FAR struct mixer_stream_s *stream, uint16_t reason,
+                         FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->export.upper(stream->export.priv, reason, apb, OK, stream);
+#else
+  stream->export.upper(stream->export.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: mixer_retire
+ *
+ * Description:
+ *   Return the consumed buffer at the head of the stream's queue to the
+ *   client.  If that was the final buffer of the stream, the stream is
+ *   marked for completion.
+ *
+ ****************************************************************************/
+
+static void mixer_retire(FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pendq);
+  leave_critical_section(flags);
+
+  if (apb != NULL)
+    {
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stream->stopreq = true;
+        }
+
+      mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_head
+ *
+ * Description:
+ *   Get the buffer at the head of the stream's queue that still holds at
+ *   least one complete frame, retiring exhausted buffers on the way.
+ *
+ ****************************************************************************/
+
+static FAR struct ap_buffer_s *mixer_head(FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while (!stream->stopreq)
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (apb->nbytes - apb->curbyte >= stream->framesize)
+        {
+          return apb;
+        }
+
+      mixer_retire(stream);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mixer_pull
+ *
+ * Description:
+ *   Move the next input frame into the resampler history.
+ *
+ * Returned Value:
+ *   True if a frame was available.
+ *
+ ****************************************************************************/
+
+static bool mixer_pull(FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *src;
+  int32_t left;
+  int32_t right;
+  uint8_t hpos;
+
+  apb = mixer_head(stream);
+  if (apb == NULL)
+    {
+      return false;
+    }
+
+  src = &apb->samp[apb->curbyte];
+  if (stream->bpsamp == 8)
+    {
+      left  = ((int32_t)src[0] - 128) << 8;
+      right = stream->nchannels > 1 ? ((int32_t)src[1] - 128) << 8 : left;
+    }
+  else
+    {
+      left  = ((FAR const int16_t *)src)[0];
+      right = stream->nchannels > 1 ? ((FAR const int16_t *)src)[1] : left;
+    }
+
+  apb->curbyte += stream->framesize;
+
+  hpos = stream->hpos + 1;
+  if (hpos >= MIXER_NTAPS)
+    {
+      hpos = 0;
+    }
+
+  stream->hist[0][hpos] = stream->hist[0][hpos + MIXER_NTAPS] = left;
+  stream->hist[1][hpos] = stream->hist[1][hpos + MIXER_NTAPS] = right;
+  stream->hpos          = hpos;
+  return true;
+}
+
+/****************************************************************************
+ * Name: mixer_render
+ *
+ * Description:
+ *   Add up to nframes output frames from one stream to the accumulator.
+ *   A stream that runs out of data simply contributes silence to the rest
+ *   of the buffer.
+ *
+ ****************************************************************************/
+
+static void mixer_render(FAR struct mixer_stream_s *stream,
+                         FAR int32_t *acc, int nframes)
+{
+  FAR struct ap_buffer_s *apb;
+  int32_t gain = stream->gain;
+  int done = 0;
+  int n;
+
+  if (stream->bank == NULL)
+    {
+      /* Same rate:  Mix directly from the client's buffers */
+
+      while (done < nframes && (apb = mixer_head(stream)) != NULL)
+        {
+          FAR const uint8_t *src = &apb->samp[apb->curbyte];
+
+          n = (apb->nbytes - apb->curbyte) / stream->framesize;
+          if (n > nframes - done)
+            {
+              n = nframes - done;
+            }
+
+          if (stream->bpsamp == 8)
+            {
+              if (stream->nchannels > 1)
+                {
+                  mixer_acc_u8(&acc[2 * done], src, 2 * n, gain);
+                }
+              else
+                {
+                  mixer_acc_u8_mono(&acc[2 * done], src, n, gain);
+                }
+            }
+          else
+            {
+              if (stream->nchannels > 1)
+                {
+                  mixer_acc_s16(&acc[2 * done],
+                                (FAR const int16_t *)src, 2 * n, gain);
+                }
+              else
+                {
+                  mixer_acc_s16_mono(&acc[2 * done],
+                                     (FAR const int16_t *)src, n, gain);
+                }
+            }
+
+          apb->curbyte += n * stream->framesize;
+          done         += n;
+        }
+    }
+  else
+    {
+      /* Different rate:  Polyphase resampling */
+
+      for (; done < nframes; done++)
+        {
+          FAR const int16_t *coeff;
+          int first;
+
+          /* Advance the history to the current input position */
+
+          while (stream->frac >= MIXER_ONE)
+            {
+              if (!mixer_pull(stream))
+                {
+                  goto starved;
+                }
+
+              stream->frac -= MIXER_ONE;
+            }
+
+          coeff = &stream->bank[(stream->frac >> (16 - MIXER_PHASE_SHIFT)) *
+                                MIXER_NTAPS];
+          first = stream->hpos + 1;
+
+          acc[2 * done]     += (mixer_dot(coeff, &stream->hist[0][first]) *
+                                gain) >> 15;
+          acc[2 * done + 1] += (mixer_dot(coeff, &stream->hist[1][first]) *
+                                gain) >> 15;
+
+          stream->frac += stream->step;
+        }
+
+starved:
+      ;
+    }
+
+  /* Return the buffer if it was completely consumed */
+
+  (void)mixer_head(stream);
+}
+
+/****************************************************************************
+ * Name: mixer_ready
+ *
+ * Description:
+ *   Return true if any running stream has data to be mixed.
+ *
+ ****************************************************************************/
+
+static bool mixer_ready(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct mixer_stream_s *stream;
+  int i;
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->stream[i];
+      if (stream->started && !stream->paused && !stream->stopreq &&
+          !dq_empty(&stream->pendq))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_mix
+ *
+ * Description:
+ *   Fill one output buffer from all running streams.
+ *
+ ****************************************************************************/
+
+static void mixer_mix(FAR struct audio_mixer_s *mixer,
+                      FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream;
+  int nframes;
+  int i;
+
+  /* The output device may have allocated a larger buffer than requested.
+   * Never mix more frames than the accumulator holds.
+   */
+
+  nframes = apb->nmaxbytes / MIXER_FRAMESIZE;
+  if (nframes > MIXER_ACCFRAMES)
+    {
+      nframes = MIXER_ACCFRAMES;
+    }
+
+  memset(mixer->acc, 0, nframes * MIXER_NCHANNELS * sizeof(int32_t));
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->stream[i];
+      if (stream->started && !stream->paused && !stream->stopreq)
+        {
+          mixer_render(stream, mixer->acc, nframes);
+        }
+    }
+
+  /* Write the mix directly into the output device's buffer */
+
+  mixer_saturate((FAR int16_t *)apb->samp, mixer->acc,
+                 nframes * MIXER_NCHANNELS);
+
+  apb->nbytes      = nframes * MIXER_FRAMESIZE;
+  apb->curbyte     = 0;
+  apb->flags       = 0;
+  apb->i.channels  = MIXER_NCHANNELS;
+  apb->i.format    = AUDIO_FMT_PCM;
+  apb->i.subformat = AUDIO_SUBFMT_PCM_S16_LE;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  apb->session     = mixer->session;
+#endif
+}
+
+/****************************************************************************
+ * Name: mixer_hwstart
+ *
+ * Description:
+ *   Configure and start the output device.  The output buffers are
+ *   allocated on first use.
+ *
+ ****************************************************************************/
+
+static int mixer_hwstart(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_caps_s caps;
+  struct audio_buf_desc_s bufdesc;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPLERATE;
+  caps.ac_controls.b[2]  = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure the output: %d\n", ret);
+      return ret;
+    }
+
+  if (mixer->acc == NULL)
+    {
+      for (i = 0; i < CONFIG_AUDIO_MIXER_NUM_BUFFERS; i++)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session    = mixer->session;
+#endif
+          bufdesc.numbytes   = CONFIG_AUDIO_MIXER_BUFFER_SIZE;
+          bufdesc.u.ppBuffer = &mixer->outbuf[i];
+
+          if (lower->ops->allocbuffer != NULL)
+            {
+              ret = lower->ops->allocbuffer(lower, &bufdesc);
+            }
+          else
+            {
+              ret = apb_alloc(&bufdesc);
+            }
+
+          if (ret < 0 || mixer->outbuf[i] == NULL)
+            {
+              auderr("ERROR: Failed to allocate output buffer\n");
+              return ret < 0 ? ret : -ENOMEM;
+            }
+
+          flags = enter_critical_section();
+          dq_addlast(mixer_dqentry(mixer->outbuf[i]), &mixer->freeq);
+          leave_critical_section(flags);
+        }
+
+      mixer->acc = (FAR int32_t *)
+        kmm_malloc(MIXER_ACCFRAMES * MIXER_NCHANNELS * sizeof(int32_t));
+      if (mixer->acc == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to start the output: %d\n", ret);
+      return ret;
+    }
+
+  mixer->running = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_complete
+ *
+ * Description:
+ *   Complete a stream that was stopped or that played its final buffer:
+ *   Return all of its buffers and stop mixing it.  Completion is reported
+ *   by mixer_drain() once the output buffers that hold the last of its
+ *   data have been returned by the output device.
+ *
+ ****************************************************************************/
+
+static void mixer_complete(FAR struct audio_mixer_s *mixer,
+                           FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pendq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  stream->started  = false;
+  stream->stopreq  = false;
+  stream->draining = true;
+  stream->drainseq = mixer->nenqueued;
+  mixer->nactive--;
+
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: mixer_drain
+ *
+ * Description:
+ *   Report completion for the streams whose last output buffer has been
+ *   returned by the output device.  Stop the output device when no stream
+ *   is running and all output buffers have been returned.
+ *
+ ****************************************************************************/
+
+static void mixer_drain(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct mixer_stream_s *stream;
+  uint32_t ndequeued = mixer->ndequeued;
+  int i;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (mixer->nactive == 0 && mixer->running &&
+      ndequeued == mixer->nenqueued)
+    {
+      mixer->running = false;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+      if (mixer->lower->ops->stop != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          (void)mixer->lower->ops->stop(mixer->lower, mixer->session);
+#else
+          (void)mixer->lower->ops->stop(mixer->lower);
+#endif
+        }
+#endif
+    }
+
+  nxsem_post(&mixer->exclsem);
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->stream[i];
+      if (stream->draining &&
+          (int32_t)(ndequeued - stream->drainseq) >= 0)
+        {
+          stream->draining = false;
+          mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_thread
+ *
+ * Description:
+ *   The mixer thread fills output buffers as they are returned by the
+ *   output device and as client streams provide data.
+ *
+ ****************************************************************************/
+
+static FAR void *mixer_thread(pthread_addr_t arg)
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  FAR struct ap_buffer_s *apb;
+  FAR struct mixer_stream_s *stream;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&mixer->wakesem);
+
+      /* Complete any streams that were stopped or finished */
+
+      for (i = 0; i < mixer->nstreams; i++)
+        {
+          stream = &mixer->stream[i];
+          if (stream->started && stream->stopreq)
+            {
+              mixer_complete(mixer, stream);
+            }
+        }
+
+      /* Fill output buffers for as long as there is data */
+
+      while (mixer->running && mixer_ready(mixer))
+        {
+          flags = enter_critical_section();
+          apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+          leave_critical_section(flags);
+
+          if (apb == NULL)
+            {
+              break;
+            }
+
+          mixer_mix(mixer, apb);
+
+          ret = mixer->lower->ops->enqueuebuffer(mixer->lower, apb);
+          if (ret < 0)
+            {
+              auderr("ERROR: Output enqueue failed: %d\n", ret);
+
+              flags = enter_critical_section();
+              dq_addfirst(mixer_dqentry(apb), &mixer->freeq);
+              leave_critical_section(flags);
+              break;
+            }
+
+          mixer->nenqueued++;
+
+          /* Streams may have finished while mixing */
+
+          for (i = 0; i < mixer->nstreams; i++)
+            {
+              stream = &mixer->stream[i];
+              if (stream->started && stream->stopreq)
+                {
+                  mixer_complete(mixer, stream);
+                }
+            }
+        }
+
+      /* Report the completed streams and stop the idle output device */
+
+      mixer_drain(mixer);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description:
+ *   Get the capabilities of a stream:  8- or 16-bit PCM, mono or stereo,
+ *   at any of the standard sample rates up to 48KHz, with volume control.
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = MIXER_NCHANNELS;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_format.hw     = (1 << (AUDIO_FMT_PCM - 1));
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = MIXER_NCHANNELS;
+
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_SAMP_RATE_8K | AUDIO_SAMP_RATE_11K |
+                                     AUDIO_SAMP_RATE_16K | AUDIO_SAMP_RATE_22K |
+                                     AUDIO_SAMP_RATE_32K | AUDIO_SAMP_RATE_44K |
+                                     AUDIO_SAMP_RATE_48K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        caps->ac_subtype  = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description:
+ *   Configure the input format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps)
+#else
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  uint32_t samprate;
+  uint8_t nchannels;
+  uint8_t bpsamp;
+
+  DEBUGASSERT(stream != NULL && caps != NULL);
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            /* Volume is 0..1000 */
+
+            uint32_t volume = caps->ac_controls.hw[0];
+            if (volume > 1000)
+              {
+                return -EDOM;
+              }
+
+            stream->gain = (int16_t)(volume * MIXER_UNITY / 1000);
+          }
+        break;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        nchannels = caps->ac_channels;
+        samprate  = caps->ac_controls.hw[0];
+        bpsamp    = caps->ac_controls.b[2];
+
+        if (nchannels < 1 || nchannels > 2 ||
+            (bpsamp != 8 && bpsamp != 16) || samprate == 0)
+          {
+            return -EINVAL;
+          }
+
+        /* The format cannot change while the stream is being mixed */
+
+        if (stream->started)
+          {
+            return -EBUSY;
+          }
+
+        stream->nchannels = nchannels;
+        stream->bpsamp    = bpsamp;
+        stream->framesize = nchannels * (bpsamp >> 3);
+        stream->samprate  = samprate;
+
+        if (samprate == CONFIG_AUDIO_MIXER_SAMPLERATE)
+          {
+            if (stream->bank != NULL)
+              {
+                kmm_free(stream->bank);
+                stream->bank = NULL;
+              }
+          }
+        else
+          {
+            if (stream->bank == NULL)
+              {
+                stream->bank = (FAR int16_t *)
+                  kmm_malloc(MIXER_NPHASES * MIXER_NTAPS * sizeof(int16_t));
+                if (stream->bank == NULL)
+                  {
+                    return -ENOMEM;
+                  }
+              }
+
+            stream->step = (uint32_t)(((uint64_t)samprate << 16) /
+                                      CONFIG_AUDIO_MIXER_SAMPLERATE);
+            mixer_design(stream);
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ *
+ * Description:
+ *   Start mixing the stream.  The output device is started with the first
+ *   stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_start(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (!stream->started)
+    {
+      /* A stream restarted before its previous output played out is
+       * completed now.
+       */
+
+      if (stream->draining)
+        {
+          stream->draining = false;
+          mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+        }
+
+      /* Reset the resampler:  The history starts out silent and the first
+       * input frame is pulled before the first output frame.
+       */
+
+      memset(stream->hist, 0, sizeof(stream->hist));
+      stream->frac    = MIXER_ONE;
+      stream->paused  = false;
+      stream->stopreq = false;
+
+      if (!mixer->running)
+        {
+          ret = mixer_hwstart(mixer);
+        }
+
+      if (ret >= 0)
+        {
+          stream->started = true;
+          mixer->nactive++;
+        }
+    }
+
+  nxsem_post(&mixer->exclsem);
+  nxsem_post(&mixer->wakesem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ *
+ * Description:
+ *   Stop the stream.  The buffers are returned and completion is reported
+ *   asynchronously by the mixer thread.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->stopreq = true;
+  nxsem_post(&stream->mixer->wakesem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_pause and mixer_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = false;
+  nxsem_post(&stream->mixer->wakesem);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue a client buffer.  The buffer is mixed in place and returned when
+ *   all of its data has been consumed.
+ *
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  irqstate_t flags;
+
+  DEBUGASSERT(stream != NULL && apb != NULL);
+
+  flags = enter_critical_section();
+  dq_addlast(mixer_dqentry(apb), &stream->pendq);
+  leave_critical_section(flags);
+
+  nxsem_post(&stream->mixer->wakesem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_cancelbuffer
+ ****************************************************************************/
+
+static int mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  FAR struct ap_buffer_info_s *bufinfo;
+
+  if (cmd == AUDIOIOC_GETBUFFERINFO)
+    {
+      /* Client buffers of the same size as the output buffers */
+
+      bufinfo              = (FAR struct ap_buffer_info_s *)arg;
+      bufinfo->buffer_size = CONFIG_AUDIO_MIXER_BUFFER_SIZE;
+      bufinfo->nbuffers    = CONFIG_AUDIO_MIXER_NUM_BUFFERS;
+      return OK;
+    }
+#endif
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve
+ *
+ * Description:
+ *   Reserve the stream.  Each stream supports one client at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session)
+#else
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&stream->mixer->exclsem);
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = stream;
+#endif
+    }
+
+  nxsem_post(&stream->mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_release
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session)
+#else
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_callback
+ *
+ * Description:
+ *   Output device callback.  Returned output buffers are queued for the
+ *   mixer thread.  This may be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session)
+#else
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        DEBUGASSERT(apb != NULL);
+
+        flags = enter_critical_section();
+        dq_addlast(mixer_dqentry(apb), &mixer->freeq);
+        mixer->ndequeued++;
+        leave_critical_section(flags);
+
+        nxsem_post(&mixer->wakesem);
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: Output I/O error: %d\n", status);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Initialize a software mixer.  The mixer takes ownership of the output
+ *   device dev and registers nstreams audio devices named <name>0,
+ *   <name>1, ...  Each accepts one client stream of 8- or 16-bit PCM, mono
+ *   or stereo, at any sample rate.  The streams are converted to 16-bit
+ *   stereo at CONFIG_AUDIO_MIXER_SAMPLERATE and mixed into the output
+ *   device's buffers.
+ *
+ * Input Parameters:
+ *   name     - The base name of the stream devices.
+ *   dev      - The output device.
+ *   nstreams - The number of client streams.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *dev, int nstreams)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct mixer_stream_s *stream;
+  struct sched_param sparam;
+  pthread_attr_t tattr;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && dev != NULL && nstreams > 0);
+
+  mixer = (FAR struct audio_mixer_s *)kmm_zalloc(SIZEOF_AUDIO_MIXER_S(nstreams));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&mixer->wakesem, 0, 0);
+  nxsem_setprotocol(&mixer->wakesem, SEM_PRIO_NONE);
+  nxsem_init(&mixer->exclsem, 0, 1);
+
+  mixer->lower    = dev;
+  mixer->nstreams = nstreams;
+  dev->upper      = mixer_callback;
+  dev->priv       = mixer;
+
+  /* The mixer is the only user of the output device */
+
+  if (dev->ops->reserve != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = dev->ops->reserve(dev, &mixer->session);
+#else
+      ret = dev->ops->reserve(dev);
+#endif
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to reserve the output: %d\n", ret);
+          goto errout_with_mixer;
+        }
+    }
+
+  pthread_attr_init(&tattr);
+  sparam.sched_priority = CONFIG_AUDIO_MIXER_PRIORITY;
+  (void)pthread_attr_setschedparam(&tattr, &sparam);
+  (void)pthread_attr_setstacksize(&tattr, CONFIG_AUDIO_MIXER_STACKSIZE);
+
+  ret = pthread_create(&mixer->threadid, &tattr, mixer_thread,
+                       (pthread_addr_t)mixer);
+  if (ret != OK)
+    {
+      auderr("ERROR: pthread_create failed: %d\n", ret);
+      ret = -ret;
+      goto errout_with_mixer;
+    }
+
+  pthread_setname_np(mixer->threadid, "audio mixer");
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mixer->stream[i];
+      stream->export.ops = &g_mixer_ops;
+      stream->mixer      = mixer;
+      stream->nchannels  = MIXER_NCHANNELS;
+      stream->bpsamp     = 16;
+      stream->framesize  = MIXER_FRAMESIZE;
+      stream->samprate   = CONFIG_AUDIO_MIXER_SAMPLERATE;
+      stream->gain       = MIXER_UNITY;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+
+          /* The mixer thread and the streams registered so far are kept */
+
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout_with_mixer:
+  nxsem_destroy(&mixer->wakesem);
+  nxsem_destroy(&mixer->exclsem);
+  kmm_free(mixer);
+  return ret;
+}
+
+#endif /* CONFIG_AUDIO_MIXER */
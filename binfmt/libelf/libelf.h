@@ -163,8 +163,8 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
  * Input Parameters:
  *   loadinfo - Load state information
  *   sym      - Symbol table entry (value might be undefined)
- *   exports  - The symbol table to use for resolving undefined symbols.
- *   nexports - Number of symbols in the symbol table.
+ *   exports  - The hashed symbol table to use for resolving undefined
+ *              symbols.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -178,8 +178,9 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
  *
  ****************************************************************************/
 
+struct symtab_hash_s;
 int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
-                 FAR const struct symtab_s *exports, int nexports);
+                 FAR const struct symtab_hash_s *exports);
 
 /****************************************************************************
  * Name: elf_freebuffers
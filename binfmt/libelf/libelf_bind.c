@@ -67,6 +67,10 @@
 #  define CONFIG_ELF_BUFFERSIZE 128
 #endif
 
+/* Number of relocation entries read from the file at a time */
+
+#define ELF_RELBATCH 16
+
 #ifdef CONFIG_ELF_DUMPBUFFER
 # define elf_dumpbuffer(m,b,n) binfodumpbuffer(m,b,n)
 #else
@@ -86,34 +90,37 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: elf_readrel
+ * Name: elf_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read up to 'nrels' Elf32_Rel structures, starting at 'index', into
+ *   memory with a single read.
  *
  ****************************************************************************/
 
-static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
+static inline int elf_readrels(FAR struct elf_loadinfo_s *loadinfo,
+                               FAR const Elf32_Shdr *relsec,
+                               int index, FAR Elf32_Rel *rels, int nrels)
 {
   off_t offset;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation indices lie within the relocation section */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || nrels <= 0 ||
+      index + nrels > (relsec->sh_size / sizeof(Elf32_Rel)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return elf_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return elf_read(loadinfo, (FAR uint8_t *)rels, sizeof(Elf32_Rel) * nrels,
+                  offset);
 }
 
 /****************************************************************************
@@ -129,15 +136,16 @@ static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                        FAR const struct symtab_s *exports, int nexports)
+                        FAR const struct symtab_hash_s *exports)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  Elf32_Rel       rels[ELF_RELBATCH];
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  int             nrels;
   int             symidx;
   int             ret;
   int             i;
@@ -147,25 +155,37 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  for (i = 0; i < nrels; i++)
     {
+      FAR Elf32_Rel *rel = &rels[i % ELF_RELBATCH];
+
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next batch of relocation entries into memory */
 
-      ret = elf_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if (i % ELF_RELBATCH == 0)
         {
-          berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          int nbatch = nrels - i;
+          if (nbatch > ELF_RELBATCH)
+            {
+              nbatch = ELF_RELBATCH;
+            }
+
+          ret = elf_readrels(loadinfo, relsec, i, rels, nbatch);
+          if (ret < 0)
+            {
+              berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
       /* Read the symbol table entry into memory */
 
@@ -179,7 +199,7 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       /* Get the value of the symbol (in sym.st_value) */
 
-      ret = elf_symvalue(loadinfo, &sym, exports, nexports);
+      ret = elf_symvalue(loadinfo, &sym, exports);
       if (ret < 0)
         {
           /* The special error -ESRCH is returned only in one condition:  The
@@ -208,18 +228,18 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           berr("Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           berr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
@@ -231,7 +251,7 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 }
 
 static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                           FAR const struct symtab_s *exports, int nexports)
+                           FAR const struct symtab_hash_s *exports)
 {
   berr("Not implemented\n");
   return -ENOSYS;
@@ -257,6 +277,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  struct symtab_hash_s exphash;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -282,6 +303,12 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return -ENOMEM;
     }
 
+  /* Index the exported symbols by name.  If there is not enough memory for
+   * the index, symtab_findbyhash() will simply search the table.
+   */
+
+  (void)symtab_inithash(&exphash, exports, nexports);
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -292,6 +319,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       berr("ERROR: elf_addrenv_select() failed: %d\n", ret);
+      symtab_freehash(&exphash);
       return ret;
     }
 #endif
@@ -321,11 +349,11 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, &exphash);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = elf_relocateadd(loadinfo, i, exports, nexports);
+          ret = elf_relocateadd(loadinfo, i, &exphash);
         }
 
       if (ret < 0)
@@ -334,6 +362,8 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
         }
     }
 
+  symtab_freehash(&exphash);
+
 #if defined(CONFIG_ARCH_ADDRENV)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -91,33 +92,19 @@ static inline void elf_dumpreaddata(FAR char *buffer, int buflen)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: elf_read
+ * Name: elf_fileread
  *
  * Description:
- *   Read 'readsize' bytes from the object file at 'offset'.  The data is
- *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
- *   then the caller is responsibile for assuring that that address
- *   environment is in place before calling this function (i.e., that
- *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
- *
- * Returned Value:
- *   0 (OK) is returned on success and a negated errno is returned on
- *   failure.
+ *   Read 'readsize' bytes from the object file at 'offset' into 'buffer'.
  *
  ****************************************************************************/
 
-int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
-             size_t readsize, off_t offset)
+static int elf_fileread(FAR struct elf_loadinfo_s *loadinfo,
+                        FAR uint8_t *buffer, size_t readsize, off_t offset)
 {
   ssize_t nbytes;      /* Number of bytes read */
   off_t   rpos;        /* Position returned by lseek */
 
-  binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
-
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
@@ -160,6 +147,187 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
         }
     }
 
-  elf_dumpreaddata(buffer, readsize);
   return OK;
 }
+
+/****************************************************************************
+ * Name: elf_cacheread
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset' through the
+ *   block cache.  The least recently used block is replaced on a miss.
+ *
+ ****************************************************************************/
+
+#if CONFIG_ELF_CACHEBLOCKS > 0
+static int elf_cacheread(FAR struct elf_loadinfo_s *loadinfo,
+                         FAR uint8_t *buffer, size_t readsize, off_t offset)
+{
+  FAR uint8_t *block;
+  off_t blkoff;
+  size_t blklen;
+  size_t ncopy;
+  int slot;
+  int ret;
+  int i;
+
+  /* Allocate the cache on first use.  If that fails, just read the file */
+
+  if (loadinfo->cache == NULL)
+    {
+      loadinfo->cache = (FAR uint8_t *)
+        kmm_malloc(CONFIG_ELF_CACHEBLOCKS * CONFIG_ELF_CACHEBLOCKSIZE);
+      if (loadinfo->cache == NULL)
+        {
+          return elf_fileread(loadinfo, buffer, readsize, offset);
+        }
+    }
+
+  while (readsize > 0)
+    {
+      blkoff = offset & ~((off_t)CONFIG_ELF_CACHEBLOCKSIZE - 1);
+
+      /* Look for the block in the cache, remembering the least recently
+       * used slot in case it is not there.
+       */
+
+      slot = 0;
+      for (i = 0; i < CONFIG_ELF_CACHEBLOCKS; i++)
+        {
+          if (loadinfo->cachelen[i] > 0 && loadinfo->cacheoff[i] == blkoff)
+            {
+              break;
+            }
+
+          if (loadinfo->cachelen[i] == 0 ||
+              (loadinfo->cachelen[slot] > 0 &&
+               loadinfo->cacheage[i] < loadinfo->cacheage[slot]))
+            {
+              slot = i;
+            }
+        }
+
+      if (i < CONFIG_ELF_CACHEBLOCKS)
+        {
+          slot = i;
+        }
+      else
+        {
+          /* Cache miss.  Read the block (or what is left of the file) */
+
+          blklen = CONFIG_ELF_CACHEBLOCKSIZE;
+          if (blkoff + (off_t)blklen > loadinfo->filelen)
+            {
+              if (blkoff >= loadinfo->filelen)
+                {
+                  berr("Unexpected end of file\n");
+                  return -ENODATA;
+                }
+
+              blklen = loadinfo->filelen - blkoff;
+            }
+
+          loadinfo->cachelen[slot] = 0;
+          ret = elf_fileread(loadinfo,
+                             loadinfo->cache +
+                             slot * CONFIG_ELF_CACHEBLOCKSIZE,
+                             blklen, blkoff);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          loadinfo->cacheoff[slot] = blkoff;
+          loadinfo->cachelen[slot] = blklen;
+        }
+
+      loadinfo->cacheage[slot] = ++loadinfo->cacheclock;
+
+      /* Copy the part of the block that was requested */
+
+      if (offset - blkoff >= loadinfo->cachelen[slot])
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      block = loadinfo->cache + slot * CONFIG_ELF_CACHEBLOCKSIZE;
+      ncopy = loadinfo->cachelen[slot] - (offset - blkoff);
+      if (ncopy > readsize)
+        {
+          ncopy = readsize;
+        }
+
+      memcpy(buffer, block + (offset - blkoff), ncopy);
+      readsize -= ncopy;
+      buffer   += ncopy;
+      offset   += ncopy;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_read
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset'.  The data is
+ *   read into 'buffer.' If 'buffer' is part of the ELF address environment,
+ *   then the caller is responsibile for assuring that that address
+ *   environment is in place before calling this function (i.e., that
+ *   elf_addrenv_select() has been called if CONFIG_ARCH_ADDRENV=y).
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
+             size_t readsize, off_t offset)
+{
+  int ret;
+
+  binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
+
+  if (loadinfo->xipbase != NULL)
+    {
+      /* The file is mapped into memory; just copy the data */
+
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      ret = OK;
+    }
+#if CONFIG_ELF_CACHEBLOCKS > 0
+  else if (readsize < CONFIG_ELF_CACHEBLOCKSIZE)
+    {
+      /* Small reads of symbols, relocations, and names go through the
+       * cache.
+       */
+
+      ret = elf_cacheread(loadinfo, buffer, readsize, offset);
+    }
+#endif
+  else
+    {
+      ret = elf_fileread(loadinfo, buffer, readsize, offset);
+    }
+
+  if (ret == OK)
+    {
+      elf_dumpreaddata(buffer, readsize);
+    }
+
+  return ret;
+}
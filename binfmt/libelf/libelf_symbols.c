@@ -252,6 +252,8 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
  * Input Parameters:
  *   loadinfo - Load state information
  *   sym      - Symbol table entry (value might be undefined)
+ *   exports  - The hashed symbol table to use for resolving undefined
+ *              symbols.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -266,7 +268,7 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
  ****************************************************************************/
 
 int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
-                 FAR const struct symtab_s *exports, int nexports)
+                 FAR const struct symtab_hash_s *exports)
 {
   FAR const struct symtab_s *symbol;
   uintptr_t secbase;
@@ -309,11 +311,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
 
         /* Check if the base code exports a symbol of this name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-        symbol = symtab_findorderedbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
-#else
-        symbol = symtab_findbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
-#endif
+        symbol = symtab_findbyhash(exports, (FAR char *)loadinfo->iobuffer);
         if (!symbol)
           {
             berr("SHN_UNDEF: Exported symbol \"%s\" not found\n", loadinfo->iobuffer);
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <string.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -122,5 +123,14 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#if CONFIG_ELF_CACHEBLOCKS > 0
+  if (loadinfo->cache)
+    {
+      kmm_free((FAR void *)loadinfo->cache);
+      loadinfo->cache     = NULL;
+      memset(loadinfo->cachelen, 0, sizeof(loadinfo->cachelen));
+    }
+#endif
+
   return OK;
 }
@@ -57,13 +57,27 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 
 #include <nuttx/irq.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+/* Return the header of block 'n' of the block pool */
+
+#  define ADC_BLOCK(dev,n) \
+     ((FAR struct adc_blkhdr_s *)&(dev)->ad_blkpool[(n) * (dev)->ad_blksize])
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -76,6 +90,18 @@ static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
 static void    adc_notify(FAR struct adc_dev_s *dev);
+#ifdef CONFIG_ADC_BLOCK
+static FAR struct adc_blkhdr_s *adc_getblock(FAR struct adc_dev_s *dev);
+static int     adc_putblock(FAR struct adc_dev_s *dev,
+                            FAR struct adc_blkhdr_s *blk);
+static int     adc_blktake(FAR struct file *filep, FAR struct adc_dev_s *dev);
+static void    adc_blkrelease(FAR struct adc_dev_s *dev, int ndx);
+static ssize_t adc_blkread(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     adc_blkconfig(FAR struct adc_dev_s *dev,
+                             FAR struct adc_blkcfg_s *cfg);
+static void    adc_blkfree(FAR struct adc_dev_s *dev);
+#endif
 #ifndef CONFIG_DISABLE_POLL
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
 #endif
@@ -103,6 +129,10 @@ static const struct file_operations g_adc_fops =
 static const struct adc_callback_s g_adc_callback =
 {
   adc_receive   /* au_receive */
+#ifdef CONFIG_ADC_BLOCK
+  , adc_getblock  /* au_getblock */
+  , adc_putblock  /* au_putblock */
+#endif
 };
 
 /****************************************************************************
@@ -216,6 +246,12 @@ static int adc_close(FAR struct file *filep)
           dev->ad_ops->ao_shutdown(dev);       /* Disable the ADC */
           leave_critical_section(flags);
 
+#ifdef CONFIG_ADC_BLOCK
+          /* Return to sample mode for the next open */
+
+          adc_blkfree(dev);
+#endif
+
           nxsem_post(&dev->ad_closesem);
         }
     }
@@ -238,6 +274,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCK
+  /* In block mode, whole blocks are returned */
+
+  if (dev->ad_blkpool != NULL)
+    {
+      return adc_blkread(filep, buffer, buflen);
+    }
+#endif
+
   /* Determine size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -412,7 +457,107 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct adc_dev_s *dev = inode->i_private;
   int ret;
 
-  ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+  switch (cmd)
+    {
+#ifdef CONFIG_ADC_BLOCK
+      /* Select block mode and its geometry.  Argument: A reference to
+       * struct adc_blkcfg_s.
+       */
+
+      case ANIOC_BLK_CONFIG:
+        {
+          FAR struct adc_blkcfg_s *cfg =
+            (FAR struct adc_blkcfg_s *)((uintptr_t)arg);
+
+          if (cfg == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = adc_blkconfig(dev, cfg);
+            }
+        }
+        break;
+
+      /* Take the oldest filled block for use in place.  Argument: A
+       * reference to an int that receives the index of the block.
+       */
+
+      case ANIOC_BLK_GET:
+        {
+          FAR int *ndx = (FAR int *)((uintptr_t)arg);
+          irqstate_t flags;
+
+          if (ndx == NULL || dev->ad_blkpool == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          flags = enter_critical_section();
+          ret   = adc_blktake(filep, dev);
+          if (ret >= 0)
+            {
+              *ndx = ret;
+              ret  = OK;
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* Return a block taken with ANIOC_BLK_GET.  Argument: The index of
+       * the block.
+       */
+
+      case ANIOC_BLK_RELEASE:
+        {
+          irqstate_t flags = enter_critical_section();
+
+          if (dev->ad_blkpool == NULL || arg >= CONFIG_ADC_BLOCK_NBUFFERS ||
+              (dev->ad_blkuser & (1 << arg)) == 0)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              adc_blkrelease(dev, (int)arg);
+              ret = OK;
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* Return the address of the block pool.  Argument: A reference to a
+       * pointer that receives the address.
+       */
+
+      case FIOC_MMAP:
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          if (addr == NULL || dev->ad_blkpool == NULL)
+            {
+              ret = -ENODEV;
+            }
+          else
+            {
+              *addr = dev->ad_blkpool;
+              ret   = OK;
+            }
+        }
+        break;
+#endif
+
+      /* Everything else is forwarded to the lower half */
+
+      default:
+        ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+        break;
+    }
+
   return ret;
 }
 
@@ -504,6 +649,379 @@ static void adc_notify(FAR struct adc_dev_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: adc_getblock
+ *
+ * Description:
+ *   Block mode:  Give the lower half an empty block to fill.  If no block
+ *   is free, the oldest filled block that no reader has taken is reused and
+ *   counted as lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static FAR struct adc_blkhdr_s *adc_getblock(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_blkhdr_s *blk = NULL;
+  irqstate_t flags;
+  int ndx;
+
+  flags = enter_critical_section();
+  if (dev->ad_blkpool != NULL)
+    {
+      if (dev->ad_blkfree != 0)
+        {
+          /* Take the lowest numbered free block */
+
+          for (ndx = 0; (dev->ad_blkfree & (1 << ndx)) == 0; ndx++);
+          dev->ad_blkfree &= ~(1 << ndx);
+        }
+      else if (dev->ad_blkcount > 0)
+        {
+          /* Overrun:  Sacrifice the oldest block that is still queued */
+
+          ndx = dev->ad_blkq[dev->ad_blkhead];
+          if (++dev->ad_blkhead >= CONFIG_ADC_BLOCK_NBUFFERS)
+            {
+              dev->ad_blkhead = 0;
+            }
+
+          dev->ad_blkcount--;
+          dev->ad_blklost++;
+        }
+      else
+        {
+          /* Every block is held by the lower half or by readers.  The lower
+           * half will discard the next block of scans.
+           */
+
+          dev->ad_blklost++;
+          goto errout;
+        }
+
+      blk = ADC_BLOCK(dev, ndx);
+      blk->ab_nscans = dev->ad_blknscans;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return blk;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_putblock
+ *
+ * Description:
+ *   Block mode:  Queue a block filled by the lower half and wake up the
+ *   readers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_putblock(FAR struct adc_dev_s *dev,
+                        FAR struct adc_blkhdr_s *blk)
+{
+  irqstate_t flags;
+  int tail;
+
+  DEBUGASSERT(blk != NULL && blk->ab_index < CONFIG_ADC_BLOCK_NBUFFERS);
+
+  flags = enter_critical_section();
+  if (dev->ad_blkpool == NULL)
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  blk->ab_seq      = dev->ad_blkseq++;
+  blk->ab_overrun  = dev->ad_blklost;
+  dev->ad_blklost  = 0;
+
+  /* There can be no more queued blocks than there are blocks */
+
+  tail = dev->ad_blkhead + dev->ad_blkcount;
+  if (tail >= CONFIG_ADC_BLOCK_NBUFFERS)
+    {
+      tail -= CONFIG_ADC_BLOCK_NBUFFERS;
+    }
+
+  dev->ad_blkq[tail] = blk->ab_index;
+  dev->ad_blkcount++;
+
+  adc_notify(dev);
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_blktake
+ *
+ * Description:
+ *   Block mode:  Wait for a filled block and hand it to the reader.
+ *
+ * Returned Value:
+ *   The index of the block on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_blktake(FAR struct file *filep, FAR struct adc_dev_s *dev)
+{
+  int ndx;
+  int ret;
+
+  while (dev->ad_blkcount == 0)
+    {
+      /* No block is ready -- was non-blocking mode selected? */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Wait for a block to be queued */
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Block mode may have been left while we waited */
+
+      if (dev->ad_blkpool == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+
+  ndx = dev->ad_blkq[dev->ad_blkhead];
+  if (++dev->ad_blkhead >= CONFIG_ADC_BLOCK_NBUFFERS)
+    {
+      dev->ad_blkhead = 0;
+    }
+
+  dev->ad_blkcount--;
+  dev->ad_blkuser |= (1 << ndx);
+  return ndx;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_blkrelease
+ *
+ * Description:
+ *   Block mode:  Return a block taken by a reader to the free set.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static void adc_blkrelease(FAR struct adc_dev_s *dev, int ndx)
+{
+  dev->ad_blkuser &= ~(1 << ndx);
+  dev->ad_blkfree |= (1 << ndx);
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_blkread
+ *
+ * Description:
+ *   Block mode:  Copy as many whole blocks as fit into the user buffer.
+ *   Each block occupies ad_blksize bytes of the buffer, as in the pool.
+ *   Interrupts are enabled while a block is copied; the block is held as
+ *   taken by a reader meanwhile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static ssize_t adc_blkread(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+  irqstate_t            flags;
+  size_t                nread = 0;
+  int                   ndx;
+
+  if (buflen < dev->ad_blksize)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  ndx = adc_blktake(filep, dev);
+  if (ndx < 0)
+    {
+      leave_critical_section(flags);
+      return ndx;
+    }
+
+  for (; ; )
+    {
+      leave_critical_section(flags);
+      memcpy(&buffer[nread], ADC_BLOCK(dev, ndx), dev->ad_blksize);
+      nread += dev->ad_blksize;
+      flags = enter_critical_section();
+
+      adc_blkrelease(dev, ndx);
+
+      /* Is there another queued block that will fit? */
+
+      if (dev->ad_blkcount == 0 || nread + dev->ad_blksize > buflen)
+        {
+          break;
+        }
+
+      ndx = adc_blktake(filep, dev);
+    }
+
+  leave_critical_section(flags);
+  return nread;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_blkfree
+ *
+ * Description:
+ *   Leave block mode and free the block pool.
+ *
+ * Assumptions:
+ *   The lower half is no longer filling blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static void adc_blkfree(FAR struct adc_dev_s *dev)
+{
+  FAR uint8_t *pool;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  pool             = dev->ad_blkpool;
+  dev->ad_blkpool  = NULL;
+  dev->ad_blkfree  = 0;
+  dev->ad_blkuser  = 0;
+  dev->ad_blkhead  = 0;
+  dev->ad_blkcount = 0;
+  leave_critical_section(flags);
+
+  if (pool != NULL)
+    {
+      kumm_free(pool);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_blkconfig
+ *
+ * Description:
+ *   Handle ANIOC_BLK_CONFIG:  Let the lower half accept the geometry, then
+ *   (re)allocate the block pool.  Conversions are stopped meanwhile.  The
+ *   pool is allocated from the user heap so that it may be used directly by
+ *   the application after FIOC_MMAP.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_BLOCK
+static int adc_blkconfig(FAR struct adc_dev_s *dev,
+                         FAR struct adc_blkcfg_s *cfg)
+{
+  FAR struct adc_blkhdr_s *blk;
+  FAR uint8_t *pool;
+  irqstate_t flags;
+  size_t blksize;
+  int ret;
+  int i;
+
+  /* Blocks that are in use by readers would be lost */
+
+  if (dev->ad_blkuser != 0)
+    {
+      return -EBUSY;
+    }
+
+  /* Stop conversions and drop the old pool */
+
+  flags = enter_critical_section();
+  dev->ad_ops->ao_rxint(dev, false);
+  leave_critical_section(flags);
+
+  adc_blkfree(dev);
+
+  /* The lower half accepts the geometry and reports the scan layout */
+
+  ret = dev->ad_ops->ao_ioctl(dev, ANIOC_BLK_CONFIG, (unsigned long)cfg);
+  if (ret < 0 || cfg->ac_nscans == 0)
+    {
+      goto errout_with_restart;
+    }
+
+  if (cfg->ac_nchannels == 0 ||
+      (cfg->ac_samplesize != 2 && cfg->ac_samplesize != 4))
+    {
+      aerr("ERROR: Bad scan layout: %u x %u\n",
+           cfg->ac_nchannels, cfg->ac_samplesize);
+      ret = -EINVAL;
+      goto errout_with_restart;
+    }
+
+  /* Keep the headers of all blocks 64-bit aligned */
+
+  blksize = sizeof(struct adc_blkhdr_s) +
+            (size_t)cfg->ac_nscans * cfg->ac_nchannels * cfg->ac_samplesize;
+  blksize = (blksize + 7) & ~7;
+
+  pool = (FAR uint8_t *)kumm_zalloc(CONFIG_ADC_BLOCK_NBUFFERS * blksize);
+  if (pool == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_restart;
+    }
+
+  for (i = 0; i < CONFIG_ADC_BLOCK_NBUFFERS; i++)
+    {
+      blk                = (FAR struct adc_blkhdr_s *)&pool[i * blksize];
+      blk->ab_nchannels  = cfg->ac_nchannels;
+      blk->ab_nscans     = cfg->ac_nscans;
+      blk->ab_samplesize = cfg->ac_samplesize;
+      blk->ab_index      = i;
+    }
+
+  cfg->ac_nblocks = CONFIG_ADC_BLOCK_NBUFFERS;
+  cfg->ac_blksize = blksize;
+
+  flags = enter_critical_section();
+  dev->ad_blksize   = blksize;
+  dev->ad_blknscans = cfg->ac_nscans;
+  dev->ad_blkseq    = 0;
+  dev->ad_blklost   = 0;
+  dev->ad_blkfree   = (1 << CONFIG_ADC_BLOCK_NBUFFERS) - 1;
+  dev->ad_blkpool   = pool;
+  dev->ad_ops->ao_rxint(dev, true);
+  leave_critical_section(flags);
+  return OK;
+
+errout_with_restart:
+  flags = enter_critical_section();
+  dev->ad_ops->ao_rxint(dev, true);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /************************************************************************************
  * Name: adc_poll
  ************************************************************************************/
@@ -564,6 +1082,12 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           adc_pollnotify(dev, POLLIN);
         }
+#ifdef CONFIG_ADC_BLOCK
+      else if (dev->ad_blkcount > 0)
+        {
+          adc_pollnotify(dev, POLLIN);
+        }
+#endif
     }
   else if (fds->priv)
     {
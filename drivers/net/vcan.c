@@ -0,0 +1,408 @@
+/****************************************************************************
+ * drivers/net/vcan.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/can.h>
+
+#ifdef CONFIG_NETDEV_VCAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* We need to have the work queue to handle TX polling */
+
+#if !defined(CONFIG_SCHED_WORKQUEUE)
+#  error Worker thread support is required (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+/* TX poll delay = 1 seconds. CLK_TCK is the number of clock ticks per second */
+
+#define VCAN_WDDELAY   (1*CLK_TCK)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The vcan_driver_s encapsulates all state information for the virtual CAN
+ * interface
+ */
+
+struct vcan_driver_s
+{
+  bool vc_bifup;               /* true:ifup false:ifdown */
+  WDOG_ID vc_polldog;          /* TX poll timer */
+  struct work_s vc_work;       /* For deferring poll work to the work queue */
+
+  /* This holds the information visible to the NuttX network */
+
+  struct net_driver_s vc_dev;  /* Interface understood by the network */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct vcan_driver_s g_vcan;
+
+/* The network may poll other protocols on this device, so the buffer is
+ * sized like that of any other device rather than for one CAN frame.
+ */
+
+static uint8_t g_iobuffer[MAX_NETDEV_PKTSIZE + CONFIG_NET_GUARDSIZE];
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Polling logic */
+
+static int  vcan_txpoll(FAR struct net_driver_s *dev);
+static void vcan_poll_work(FAR void *arg);
+static void vcan_poll_expiry(int argc, wdparm_t arg, ...);
+
+/* NuttX callback functions */
+
+static int  vcan_ifup(FAR struct net_driver_s *dev);
+static int  vcan_ifdown(FAR struct net_driver_s *dev);
+static void vcan_txavail_work(FAR void *arg);
+static int  vcan_txavail(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vcan_txpoll
+ *
+ * Description:
+ *   Check if the network has any outgoing frames ready to send.  This is
+ *   a callback from devif_poll() or devif_timer().
+ *
+ *   The PF_CAN layer has already delivered the frame to the local sockets
+ *   that want to see it, so "sending" on the virtual bus only means
+ *   counting the frame and discarding it.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int vcan_txpoll(FAR struct net_driver_s *dev)
+{
+  if (dev->d_len > 0)
+    {
+      NETDEV_TXPACKETS(dev);
+      NETDEV_TXDONE(dev);
+      dev->d_len = 0;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: vcan_poll_work
+ *
+ * Description:
+ *   Perform periodic polling from the worker thread
+ *
+ * Input Parameters:
+ *   arg - The argument passed when work_queue() as called.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called on the lower priority worker thread.
+ *
+ ****************************************************************************/
+
+static void vcan_poll_work(FAR void *arg)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)arg;
+
+  /* Perform the poll */
+
+  net_lock();
+  (void)devif_timer(&priv->vc_dev, vcan_txpoll);
+
+  /* Setup the watchdog poll timer again */
+
+  (void)wd_start(priv->vc_polldog, VCAN_WDDELAY,
+                 (wdentry_t)vcan_poll_expiry, 1, (wdparm_t)priv);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: vcan_poll_expiry
+ *
+ * Description:
+ *   Periodic timer handler.  Called from the timer interrupt handler.
+ *
+ * Input Parameters:
+ *   argc - The number of available arguments
+ *   arg  - The first argument
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void vcan_poll_expiry(int argc, wdparm_t arg, ...)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)arg;
+
+  /* Schedule to perform the poll on the worker thread. */
+
+  work_queue(LPWORK, &priv->vc_work, vcan_poll_work, priv, 0);
+}
+
+/****************************************************************************
+ * Name: vcan_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the virtual CAN interface
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static int vcan_ifup(FAR struct net_driver_s *dev)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)dev->d_private;
+
+  ninfo("Bringing up: %s\n", dev->d_ifname);
+
+  /* Set and activate a timer process */
+
+  (void)wd_start(priv->vc_polldog, VCAN_WDDELAY,
+                 (wdentry_t)vcan_poll_expiry, 1, (wdparm_t)priv);
+
+  priv->vc_bifup = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vcan_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static int vcan_ifdown(FAR struct net_driver_s *dev)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)dev->d_private;
+
+  /* Cancel the TX poll timer */
+
+  wd_cancel(priv->vc_polldog);
+
+  /* Mark the device "down" */
+
+  priv->vc_bifup = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vcan_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called on the lower priority worker thread.
+ *
+ ****************************************************************************/
+
+static void vcan_txavail_work(FAR void *arg)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)arg;
+
+  /* Ignore the notification if the interface is not yet up */
+
+  net_lock();
+  if (priv->vc_bifup)
+    {
+      /* Poll the network for new XMIT data */
+
+      (void)devif_poll(&priv->vc_dev, vcan_txpoll);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: vcan_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called in normal user mode
+ *
+ ****************************************************************************/
+
+static int vcan_txavail(FAR struct net_driver_s *dev)
+{
+  FAR struct vcan_driver_s *priv = (FAR struct vcan_driver_s *)dev->d_private;
+
+  /* Is our single work structure available?  It may not be if there are
+   * pending poll actions and we will have to ignore the Tx availability
+   * action.
+   */
+
+  if (work_available(&priv->vc_work))
+    {
+      /* Schedule to serialize the poll on the worker thread. */
+
+      work_queue(LPWORK, &priv->vc_work, vcan_txavail_work, priv, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vcan_initialize
+ *
+ * Description:
+ *   Register the virtual CAN device, vcan0.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int vcan_initialize(void)
+{
+  FAR struct vcan_driver_s *priv;
+  int ret;
+
+  /* Get the interface structure associated with this interface number. */
+
+  priv = &g_vcan;
+
+  /* Initialize the driver structure */
+
+  memset(priv, 0, sizeof(struct vcan_driver_s));
+  priv->vc_dev.d_ifup    = vcan_ifup;     /* I/F up callback */
+  priv->vc_dev.d_ifdown  = vcan_ifdown;   /* I/F down callback */
+  priv->vc_dev.d_txavail = vcan_txavail;  /* New TX data callback */
+  priv->vc_dev.d_buf     = g_iobuffer;    /* Attach the IO buffer */
+  priv->vc_dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
+
+  /* Use the vcan name rather than the can name of real CAN devices */
+
+  strncpy(priv->vc_dev.d_ifname, "vcan%d", IFNAMSIZ);
+
+  /* Create a watchdog for timing polling */
+
+  priv->vc_polldog       = wd_create();   /* Create periodic poll timer */
+
+  /* Register the device with the OS so that socket IOCTLs can be
+   * performed.
+   */
+
+  ret = netdev_register(&priv->vc_dev, NET_LL_CAN);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_register failed: %d\n", ret);
+      return ret;
+    }
+
+  /* There is no bus to configure:  Put the device in the UP state */
+
+  priv->vc_dev.d_flags = IFF_UP;
+  return vcan_ifup(&priv->vc_dev);
+}
+
+#endif /* CONFIG_NETDEV_VCAN */
@@ -235,14 +235,22 @@ int pipecommon_open(FAR struct file *filep)
    * is first opened.
    */
 
-  if (dev->d_refs == 0 && dev->d_buffer == NULL)
+  if (dev->d_refs == 0 && dev->d_ring.rb_buffer == NULL)
     {
-      dev->d_buffer = (FAR uint8_t *)kmm_malloc(dev->d_bufsize);
-      if (!dev->d_buffer)
+      FAR uint8_t *buffer = (FAR uint8_t *)kmm_malloc(dev->d_bufsize);
+      if (!buffer)
         {
           (void)nxsem_post(&dev->d_bfsem);
           return -ENOMEM;
         }
+
+      ret = ringbuf_init(&dev->d_ring, buffer, dev->d_bufsize);
+      if (ret < 0)
+        {
+          kmm_free(buffer);
+          (void)nxsem_post(&dev->d_bfsem);
+          return ret;
+        }
     }
 
   /* Increment the reference count on the pipe instance */
@@ -285,7 +293,7 @@ int pipecommon_open(FAR struct file *filep)
 
   if ((filep->f_oflags & O_RDWR) == O_RDONLY &&  /* Read-only */
       dev->d_nwriters < 1 &&                     /* No writers on the pipe */
-      dev->d_wrndx == dev->d_rdndx)              /* Buffer is empty */
+      ringbuf_is_empty(&dev->d_ring))            /* Buffer is empty */
     {
       /* NOTE: d_rdsem is normally used when the read logic waits for more
        * data to be written.  But until the first writer has opened the
@@ -389,17 +397,16 @@ int pipecommon_close(FAR struct file *filep)
    * obtained when the pipe is re-opened.
    */
 
-  else if (PIPE_IS_POLICY_0(dev->d_flags) || dev->d_wrndx == dev->d_rdndx)
+  else if (PIPE_IS_POLICY_0(dev->d_flags) || ringbuf_is_empty(&dev->d_ring))
     {
       /* Policy 0 or the buffer is empty ... deallocate the buffer now. */
 
-      kmm_free(dev->d_buffer);
-      dev->d_buffer = NULL;
+      kmm_free(dev->d_ring.rb_buffer);
+      dev->d_ring.rb_buffer = NULL;
 
       /* And reset all counts and indices */
 
-      dev->d_wrndx    = 0;
-      dev->d_rdndx    = 0;
+      ringbuf_reset(&dev->d_ring);
       dev->d_refs     = 0;
       dev->d_nwriters = 0;
       dev->d_nreaders = 0;
@@ -453,7 +460,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  while (ringbuf_is_empty(&dev->d_ring))
     {
       /* If O_NONBLOCK was set, then return EGAIN */
 
@@ -486,17 +493,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* Then return whatever is available in the pipe (which is at least one byte) */
 
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
-
-      nread++;
-    }
+  nread = ringbuf_get(&dev->d_ring, buffer, len);
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
 
@@ -525,7 +522,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
   int                    sval;
   int                    ret;
 
@@ -578,86 +574,72 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Copy as many bytes as will fit into the circular buffer */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
+      nwritten += ringbuf_put(&dev->d_ring, buffer + nwritten,
+                              len - nwritten);
 
-      /* Would the next write overflow the circular buffer? */
+      /* Is the write complete? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if ((size_t)nwritten >= len)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          /* Yes.. Notify all of the waiting readers that more data is available */
 
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+              nxsem_post(&dev->d_rdsem);
+            }
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Notify all poll/select waiters that they can read from the FIFO */
 
-              pipecommon_pollnotify(dev, POLLIN);
+          pipecommon_pollnotify(dev, POLLIN);
 
-              /* Return the number of bytes written */
+          /* Return the number of bytes written */
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
+          nxsem_post(&dev->d_bfsem);
+          return len;
         }
-      else
+
+      /* There is not enough room for the remaining bytes.  Was anything
+       * written in this pass?
+       */
+
+      if (last < nwritten)
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+          /* Yes.. Notify all of the waiting readers that more data is available */
 
-          if (last < nwritten)
+          while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+              nxsem_post(&dev->d_rdsem);
+            }
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Notify all poll/select waiters that they can read from the FIFO */
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+          pipecommon_pollnotify(dev, POLLIN);
+        }
 
-          last = nwritten;
+      last = nwritten;
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-          if (filep->f_oflags & O_NONBLOCK)
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
             {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
-
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
+              nwritten = -EAGAIN;
             }
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
-
-          sched_lock();
           nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+          return nwritten;
         }
+
+      /* There is more to be written.. wait for data to be removed from the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
     }
 }
 
@@ -712,21 +694,14 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = ringbuf_used(&dev->d_ring);
 
       /* Notify the POLLOUT event if the pipe is not full, but only if
        * there is readers.
        */
 
       eventset = 0;
-      if ((filep->f_oflags & O_WROK) && (nbytes < (dev->d_bufsize - 1)))
+      if ((filep->f_oflags & O_WROK) && ringbuf_space(&dev->d_ring) > 0)
         {
           eventset |= POLLOUT;
         }
@@ -831,19 +806,9 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           /* Determine the number of bytes written to the buffer.  This is,
            * of course, also the number of bytes that may be read from the
            * buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
            */
 
-          if (dev->d_wrndx < dev->d_rdndx)
-            {
-              count = (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
-            }
-          else
-            {
-              count = dev->d_wrndx - dev->d_rdndx;
-            }
+          count = ringbuf_used(&dev->d_ring);
 
           *(FAR int *)((uintptr_t)arg) = count;
           ret = 0;
@@ -856,20 +821,9 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         {
           int count;
 
-          /* Determine the number of bytes free in the buffer.
-           *
-           *   d_rdndx - index to remove next byte from the buffer
-           *   d_wrndx - Index to next location to add a byte to the buffer.
-           */
+          /* Determine the number of bytes free in the buffer */
 
-          if (dev->d_wrndx < dev->d_rdndx)
-            {
-              count = (dev->d_rdndx - dev->d_wrndx) - 1;
-            }
-          else
-            {
-              count = ((dev->d_bufsize - dev->d_wrndx) + dev->d_rdndx) - 1;
-            }
+          count = ringbuf_space(&dev->d_ring);
 
           *(FAR int *)((uintptr_t)arg) = count;
           ret = 0;
@@ -906,9 +860,9 @@ int pipecommon_unlink(FAR struct inode *inode)
     {
       /* No.. free the buffer (if there is one) */
 
-      if (dev->d_buffer)
+      if (dev->d_ring.rb_buffer)
         {
-          kmm_free(dev->d_buffer);
+          kmm_free(dev->d_ring.rb_buffer);
         }
 
       /* And free the device structure. */
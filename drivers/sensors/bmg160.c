@@ -44,44 +44,59 @@
 #include <errno.h>
 #include <debug.h>
 #include <string.h>
-#include <semaphore.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 
-#include <nuttx/fs/fs.h>
 #include <nuttx/sensors/bmg160.h>
+#include <nuttx/sensors/sensor.h>
 #include <nuttx/random.h>
 
 #if defined(CONFIG_SPI) && defined(CONFIG_SENSORS_BMG160)
 
 /****************************************************************************
- * Private
+ * Pre-processor Definitions
  ****************************************************************************/
 
-struct bmg160_sensor_data_s
-{
-  int16_t x_gyr;              /* Measurement result for x axis */
-  int16_t y_gyr;              /* Measurement result for y axis */
-  int16_t z_gyr;              /* Measurement result for z axis */
-};
+/* Angular rate per LSB at the +/- 250 deg/s full scale range, in rad/s */
+
+#define BMG160_RADPS_PER_LSB  ((1.0f / 131.2f) * SENSOR_DEG2RAD)
+
+/* Size of the sample ring of the upper half */
+
+#define BMG160_NSAMPLES       128
+
+/****************************************************************************
+ * Private
+ ****************************************************************************/
 
 struct bmg160_dev_s
 {
+  struct sensor_lowerhalf_s lower;    /* Sensor upper half interface (must
+                                       * be first) */
   FAR struct bmg160_dev_s *flink;     /* Supports a singly linked list of
                                        * drivers */
   FAR struct spi_dev_s *spi;          /* Pointer to the SPI instance */
   FAR struct bmg160_config_s *config; /* Pointer to the configuration of the
                                        * BMG160 sensor */
-  sem_t datasem;                      /* Manages exclusive access to this
-                                       * structure */
-  struct bmg160_sensor_data_s data;   /* The data as measured by the sensor */
+  uint64_t timestamp;                 /* Time of the last data ready
+                                       * interrupt */
   struct work_s work;                 /* The work queue is responsible for
                                        * retrieving the data from the sensor
                                        * after the arrival of new data was
                                        * signalled in an interrupt */
 };
 
+/* Supported output data rates: sampling period and BW_REG value, from the
+ * slowest to the fastest.
+ */
+
+struct bmg160_odr_s
+{
+  uint32_t period;                    /* Sampling period in microseconds */
+  uint8_t bw;                         /* BMG160_BW_REG value */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -92,40 +107,42 @@ static void bmg160_write_register(FAR struct bmg160_dev_s *dev,
                                   uint8_t const reg_addr,
                                   uint8_t const reg_data);
 static void bmg160_reset(FAR struct bmg160_dev_s *dev);
-static void bmg160_read_measurement_data(FAR struct bmg160_dev_s *dev);
+static void bmg160_read_measurement_data(FAR struct bmg160_dev_s *dev,
+                                         uint64_t timestamp);
 static void bmg160_read_gyroscope_data(FAR struct bmg160_dev_s *dev,
                                        uint16_t * x_gyr, uint16_t * y_gyr,
                                        uint16_t * z_gyr);
 static int bmg160_interrupt_handler(int irq, FAR void *context);
 static void bmg160_worker(FAR void *arg);
 
-static int bmg160_open(FAR struct file *filep);
-static int bmg160_close(FAR struct file *filep);
-static ssize_t bmg160_read(FAR struct file *, FAR char *, size_t);
-static ssize_t bmg160_write(FAR struct file *filep, FAR const char *buffer,
-                            size_t buflen);
-static int bmg160_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int bmg160_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable);
+static int bmg160_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                               FAR uint32_t *period_us);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static const struct file_operations g_bmg160_fops =
+static const struct sensor_ops_s g_bmg160_ops =
 {
-  bmg160_open,
-  bmg160_close,
-  bmg160_read,
-  bmg160_write,
-  NULL,
-  bmg160_ioctl
-#ifndef CONFIG_DISABLE_POLL
-  , NULL
-#endif
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL
-#endif
+  bmg160_activate,      /* activate */
+  bmg160_set_interval,  /* set_interval */
+  NULL                  /* control */
 };
 
+static const struct bmg160_odr_s g_bmg160_odr[] =
+{
+  { 10000, BMG160_BW_REG_ODR_2_bm | BMG160_BW_REG_ODR_1_bm |
+           BMG160_BW_REG_ODR_0_bm },                      /* 100 Hz */
+  { 5000,  BMG160_BW_REG_ODR_2_bm | BMG160_BW_REG_ODR_1_bm }, /* 200 Hz */
+  { 2500,  BMG160_BW_REG_ODR_1_bm | BMG160_BW_REG_ODR_0_bm }, /* 400 Hz */
+  { 1000,  BMG160_BW_REG_ODR_1_bm },                      /* 1000 Hz */
+  { 500,   BMG160_BW_REG_ODR_0_bm }                       /* 2000 Hz */
+};
+
+#define BMG160_NODR (sizeof(g_bmg160_odr) / sizeof(struct bmg160_odr_s))
+
 /* Single linked list to store instances of drivers */
 
 static struct bmg160_dev_s *g_bmg160_list = NULL;
@@ -216,9 +233,10 @@ static void bmg160_reset(FAR struct bmg160_dev_s *dev)
  * Name: bmg160_read_measurement_data
  ****************************************************************************/
 
-static void bmg160_read_measurement_data(FAR struct bmg160_dev_s *dev)
+static void bmg160_read_measurement_data(FAR struct bmg160_dev_s *dev,
+                                         uint64_t timestamp)
 {
-  int ret;
+  struct sensor_gyro_s data;
 
   /* Read Gyroscope */
 
@@ -226,25 +244,14 @@ static void bmg160_read_measurement_data(FAR struct bmg160_dev_s *dev)
 
   bmg160_read_gyroscope_data(dev, &x_gyr, &y_gyr, &z_gyr);
 
-  /* Aquire the semaphore before the data is copied */
-
-  ret = nxsem_wait(&dev->datasem);
-  if (ret < 0)
-    {
-      snerr("ERROR: Could not aquire dev->datasem: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return;
-    }
+  /* Convert the data and pass it to the sensor upper half */
 
-  /* Copy retrieve data to internal data structure */
+  data.timestamp = timestamp;
+  data.x         = (float)(int16_t)x_gyr * BMG160_RADPS_PER_LSB;
+  data.y         = (float)(int16_t)y_gyr * BMG160_RADPS_PER_LSB;
+  data.z         = (float)(int16_t)z_gyr * BMG160_RADPS_PER_LSB;
 
-  dev->data.x_gyr = (int16_t) (x_gyr);
-  dev->data.y_gyr = (int16_t) (y_gyr);
-  dev->data.z_gyr = (int16_t) (z_gyr);
-
-  /* Give back the semaphore */
-
-  nxsem_post(&dev->datasem);
+  (void)sensor_push(&dev->lower, &data);
 
   /* Feed sensor data to entropy pool */
 
@@ -314,15 +321,20 @@ static int bmg160_interrupt_handler(int irq, FAR void *context)
 
   /* Task the worker with retrieving the latest sensor data. We should not do
    * this in a interrupt since it might take too long. Also we cannot lock the
-   * SPI bus from within an interrupt.
+   * SPI bus from within an interrupt.  The sample is timestamped here, when
+   * it became ready.  If the previous sample has not been read yet, this
+   * one is lost.
    */
 
-  DEBUGASSERT(priv->work.worker == NULL);
-  ret = work_queue(HPWORK, &priv->work, bmg160_worker, priv, 0);
-  if (ret < 0)
+  if (work_available(&priv->work))
     {
-      snerr("ERROR: Failed to queue work: %d\n", ret);
-      return ret;
+      priv->timestamp = sensor_timestamp();
+      ret = work_queue(HPWORK, &priv->work, bmg160_worker, priv, 0);
+      if (ret < 0)
+        {
+          snerr("ERROR: Failed to queue work: %d\n", ret);
+          return ret;
+        }
     }
 
   return OK;
@@ -339,17 +351,25 @@ static void bmg160_worker(FAR void *arg)
 
   /* Read out the latest sensor data */
 
-  bmg160_read_measurement_data(priv);
+  bmg160_read_measurement_data(priv, priv->timestamp);
 }
 
 /****************************************************************************
- * Name: bmg160_open
+ * Name: bmg160_activate
+ *
+ * Description:
+ *   Start or stop sampling.  Called by the sensor upper half on the first
+ *   open and the last close of the device.
+ *
  ****************************************************************************/
 
-static int bmg160_open(FAR struct file *filep)
+static int bmg160_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct bmg160_dev_s *priv = inode->i_private;
+  FAR struct bmg160_dev_s *priv = (FAR struct bmg160_dev_s *)lower;
+  uint16_t x_gyr;
+  uint16_t y_gyr;
+  uint16_t z_gyr;
 #ifdef CONFIG_DEBUG_SENSORS_INFO
   uint8_t reg_content;
 #endif
@@ -360,6 +380,12 @@ static int bmg160_open(FAR struct file *filep)
 
   bmg160_reset(priv);
 
+  if (!enable)
+    {
+      (void)work_cancel(HPWORK, &priv->work);
+      return OK;
+    }
+
   /* Configure the sensor for our needs */
 
   /* Enable - the full scale range FS = +/- 250 °/s */
@@ -391,7 +417,7 @@ static int bmg160_open(FAR struct file *filep)
 
   /* Read measurement data to ensure DRDY is low */
 
-  bmg160_read_measurement_data(priv);
+  bmg160_read_gyroscope_data(priv, &x_gyr, &y_gyr, &z_gyr);
 
 #ifdef CONFIG_DEBUG_SENSORS_INFO
   /* Read back the content of all control registers for debug purposes */
@@ -417,100 +443,31 @@ static int bmg160_open(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: bmg160_close
- ****************************************************************************/
-
-static int bmg160_close(FAR struct file *filep)
-{
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct bmg160_dev_s *priv = inode->i_private;
-
-  DEBUGASSERT(priv != NULL);
-
-  /* Perform a reset */
-
-  bmg160_reset(priv);
-
-  return OK;
-}
-
-/****************************************************************************
- * Name: bmg160_read
- ****************************************************************************/
-
-static ssize_t bmg160_read(FAR struct file *filep, FAR char *buffer,
-                           size_t buflen)
-{
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct bmg160_dev_s *priv = inode->i_private;
-  FAR struct bmg160_sensor_data_s *data;
-  int ret;
-
-  DEBUGASSERT(priv != NULL);
-
-  /* Check if enough memory was provided for the read call */
-
-  if (buflen < sizeof(FAR struct bmg160_sensor_data_s))
-    {
-      snerr("ERROR: Not enough memory for reading out a sensor data sample\n");
-      return -ENOSYS;
-    }
-
-  /* Aquire the semaphore before the data is copied */
-
-  ret = nxsem_wait(&priv->datasem);
-  if (ret < 0)
-    {
-      snerr("ERROR: Could not aquire priv->datasem: %d\n", ret);
-      DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
-      return ret;
-    }
-
-  /* Copy the sensor data into the buffer */
-
-  data = (FAR struct bmg160_sensor_data_s *)buffer;
-  memset(data, 0, sizeof(FAR struct bmg160_sensor_data_s));
-
-  data->x_gyr = priv->data.x_gyr;
-  data->y_gyr = priv->data.y_gyr;
-  data->z_gyr = priv->data.z_gyr;
-
-  /* Give back the semaphore */
-
-  nxsem_post(&priv->datasem);
-
-  return sizeof(FAR struct bmg160_sensor_data_s);
-}
-
-/****************************************************************************
- * Name: bmg160_write
- ****************************************************************************/
-
-static ssize_t bmg160_write(FAR struct file *filep, FAR const char *buffer,
-                            size_t buflen)
-{
-  return -ENOSYS;
-}
-
-/****************************************************************************
- * Name: bmg160_ioctl
+ * Name: bmg160_set_interval
+ *
+ * Description:
+ *   Select the slowest output data rate whose sampling period does not
+ *   exceed the requested one (or the fastest rate if none does).
+ *
  ****************************************************************************/
 
-static int bmg160_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+static int bmg160_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                               FAR uint32_t *period_us)
 {
-  int ret = OK;
+  FAR struct bmg160_dev_s *priv = (FAR struct bmg160_dev_s *)lower;
+  int i;
 
-  switch (cmd)
+  for (i = 0; i < BMG160_NODR - 1; i++)
     {
-      /* Command was not recognized */
-
-    default:
-      snerr("ERROR: Unrecognized cmd: %d\n", cmd);
-      ret = -ENOTTY;
-      break;
+      if (g_bmg160_odr[i].period <= *period_us)
+        {
+          break;
+        }
     }
 
-  return ret;
+  bmg160_write_register(priv, BMG160_BW_REG, g_bmg160_odr[i].bw);
+  *period_us = g_bmg160_odr[i].period;
+  return OK;
 }
 
 /****************************************************************************
@@ -548,21 +505,21 @@ int bmg160_register(FAR const char *devpath, FAR struct spi_dev_s *spi,
 
   /* Initialize the BMG160 device structure */
 
-  priv = (FAR struct bmg160_dev_s *)kmm_malloc(sizeof(struct bmg160_dev_s));
+  priv = (FAR struct bmg160_dev_s *)kmm_zalloc(sizeof(struct bmg160_dev_s));
   if (priv == NULL)
     {
       snerr("ERROR: Failed to allocate instance\n");
       return -ENOMEM;
     }
 
+  priv->lower.ops   = &g_bmg160_ops;
+  priv->lower.type  = SENSOR_TYPE_GYROSCOPE;
+  priv->lower.esize = sizeof(struct sensor_gyro_s);
+  priv->lower.nelem = BMG160_NSAMPLES;
   priv->spi         = spi;
   priv->config      = config;
   priv->work.worker = NULL;
 
-  /* Initialize sensor data access semaphore */
-
-  nxsem_init(&priv->datasem, 0, 1);
-
   /* Setup SPI frequency and mode */
 
   SPI_SETFREQUENCY(spi, BMG160_SPI_FREQUENCY);
@@ -574,17 +531,17 @@ int bmg160_register(FAR const char *devpath, FAR struct spi_dev_s *spi,
   if (ret < 0)
     {
       snerr("ERROR: Failed to attach interrupt\n");
+      kmm_free(priv);
       return ret;
     }
 
-  /* Register the character driver */
+  /* Register the character driver with the sensor upper half */
 
-  ret = register_driver(devpath, &g_bmg160_fops, 0666, priv);
+  ret = sensor_register(devpath, &priv->lower);
   if (ret < 0)
     {
       snerr("ERROR: Failed to register driver: %d\n", ret);
       kmm_free(priv);
-      nxsem_destroy(&priv->datasem);
       return ret;
     }
 
@@ -42,15 +42,14 @@
 #include <errno.h>
 #include <debug.h>
 #include <string.h>
-#include <semaphore.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/random.h>
 
-#include <nuttx/fs/fs.h>
 #include <nuttx/sensors/lis3dh.h>
 #include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor.h>
 
 #if defined(CONFIG_SPI) && defined(CONFIG_LIS3DH)
 
@@ -58,27 +57,26 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LIS3DH_QUEUE_MAX 32
 #define LIS3DH_FIFOBUF_SIZE ((32 * 6) + 1)
 
+/* Size of the sample ring of the upper half */
+
+#define LIS3DH_NSAMPLES     128
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct lis3dh_dev_s
 {
+  struct sensor_lowerhalf_s lower;      /* Sensor upper half interface (must
+                                         * be first) */
   FAR struct lis3dh_config_s *config;   /* Driver configuration */
   FAR struct spi_dev_s *spi;            /* Pointer to the SPI instance */
   struct work_s work;                   /* Work Queue */
   uint8_t power_mode;                   /* The power mode used to determine mg/digit */
   uint8_t odr;                          /* The current output data rate */
-  sem_t readsem;                        /* Read notification semaphore */
   uint8_t fifobuf[LIS3DH_FIFOBUF_SIZE]; /* Raw FIFO buffer */
-  struct lis3dh_sensor_data_s queue[LIS3DH_QUEUE_MAX];
-  sem_t queuesem;                       /* Queue exclusive lock */
-  uint8_t queue_rpos;                   /* Queue read position */
-  uint8_t queue_wpos;                   /* Queue write position */
-  uint8_t queue_count;                  /* Number of elements in the queue */
 };
 
 struct lis3dh_sample_s
@@ -105,32 +103,41 @@ static void lis3dh_worker(FAR void *arg);
 static int lis3dh_irq_enable(FAR struct lis3dh_dev_s *dev, bool enable);
 static int lis3dh_fifo_enable(FAR struct lis3dh_dev_s *dev);
 
-static int lis3dh_open(FAR struct file *filep);
-static int lis3dh_close(FAR struct file *filep);
-static ssize_t lis3dh_read(FAR struct file *, FAR char *buffer,
-                           size_t buflen);
-static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
-                            size_t buflen);
-static int lis3dh_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int lis3dh_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable);
+static int lis3dh_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                               FAR uint32_t *period_us);
+static int lis3dh_control(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static const struct file_operations g_lis3dh_fops =
+static const struct sensor_ops_s g_lis3dh_ops =
 {
-  lis3dh_open,
-  lis3dh_close,
-  lis3dh_read,
-  lis3dh_write,
-  NULL,
-  lis3dh_ioctl
-#ifndef CONFIG_DISABLE_POLL
-  , NULL
-#endif
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , NULL
-#endif
+  lis3dh_activate,      /* activate */
+  lis3dh_set_interval,  /* set_interval */
+  lis3dh_control        /* control */
+};
+
+/* Sampling period in microseconds for each LIS3DH_ODR_* value in the
+ * normal and high resolution modes.  The low power mode differs only for
+ * the two fastest settings (see lis3dh_period()).
+ */
+
+static const uint32_t g_lis3dh_period[] =
+{
+  0,        /* LIS3DH_ODR_POWER_DOWN */
+  1000000,  /* LIS3DH_ODR_1HZ */
+  100000,   /* LIS3DH_ODR_10HZ */
+  40000,    /* LIS3DH_ODR_25HZ */
+  20000,    /* LIS3DH_ODR_50HZ */
+  10000,    /* LIS3DH_ODR_100HZ */
+  5000,     /* LIS3DH_ODR_200HZ */
+  2500,     /* LIS3DH_ODR_400HZ */
+  0,        /* LIS3DH_ODR_LP_1600HZ (low power mode only) */
+  744       /* LIS3DH_ODR_1344HZ */
 };
 
 /****************************************************************************
@@ -263,114 +270,46 @@ static int lis3dh_ident(FAR struct lis3dh_dev_s *dev)
 }
 
 /****************************************************************************
- * Name: lis3dh_queue_lock
- *
- * Description:
- *   Locks exclusive access to the ring buffer queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static void lis3dh_queue_lock(FAR struct lis3dh_dev_s *dev)
-{
-  int ret;
-
-  ret = nxsem_wait(&dev->queuesem);
-  if (ret < 0)
-    {
-      snerr("ERROR: queuesem wait error: %d\n", ret);
-      return;
-    }
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_unlock
+ * Name: lis3dh_period
  *
  * Description:
- *   Unlocks exclusive acccess to the ring buffer queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static void lis3dh_queue_unlock(FAR struct lis3dh_dev_s *dev)
-{
-  nxsem_post(&dev->queuesem);
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_push
- *
- * Description:
- *   Push a sensor measurement into the queue
- *
- * Input Parameters:
- *   dev - Pointer to device driver instance
- *
- ****************************************************************************/
-
-static int lis3dh_queue_push(FAR struct lis3dh_dev_s *dev,
-                             struct lis3dh_sensor_data_s *data)
-{
-  lis3dh_queue_lock(dev);
-  if (dev->queue_count >= LIS3DH_QUEUE_MAX)
-    {
-      lis3dh_queue_unlock(dev);
-      return -ENOMEM;
-    }
-
-  dev->queue_wpos++;
-  dev->queue[dev->queue_wpos % LIS3DH_QUEUE_MAX] = *data;
-
-  dev->queue_count++;
-  lis3dh_queue_unlock(dev);
-
-  return OK;
-}
-
-/****************************************************************************
- * Name: lis3dh_queue_pop
- *
- * Description:
- *   Pops a sensor measurement from the queue
+ *   Return the sampling period for an output data rate in the current
+ *   power mode.
  *
  * Input Parameters:
  *   dev - Pointer to device driver instance
+ *   odr - LIS3DH_ODR_*
  *
  * Returned Value:
- *   OK if a measurement was successfully dequeued
- *   -EAGAIN if the queue is empty
+ *   The period in microseconds or zero if the ODR is not available.
  *
  ****************************************************************************/
 
-static int lis3dh_queue_pop(FAR struct lis3dh_dev_s *dev,
-                            struct lis3dh_sensor_data_s *data)
+static uint32_t lis3dh_period(FAR struct lis3dh_dev_s *dev, uint8_t odr)
 {
-  lis3dh_queue_lock(dev);
-  if (dev->queue_count == 0)
+  if (dev->power_mode == LIS3DH_POWER_LOW)
     {
-      lis3dh_queue_unlock(dev);
-      return -EAGAIN;
+      if (odr == LIS3DH_ODR_LP_1600HZ)
+        {
+          return 625;
+        }
+      else if (odr == LIS3DH_ODR_LP_5376HZ)
+        {
+          return 186;
+        }
     }
 
-  dev->queue_rpos++;
-  *data = dev->queue[dev->queue_rpos % LIS3DH_QUEUE_MAX];
-
-  dev->queue_count--;
-
-  lis3dh_queue_unlock(dev);
-
-  return OK;
+  return odr < sizeof(g_lis3dh_period) / sizeof(uint32_t) ?
+         g_lis3dh_period[odr] : 0;
 }
 
 /****************************************************************************
  * Name: lis3dh_read_fifo
  *
  * Description:
- *   Reads the FIFO from the LIS3DH sensor, and pushes to the internal queue.
+ *   Reads the FIFO from the LIS3DH sensor, and pushes the samples to the
+ *   sensor upper half.  The newest sample is taken to be as old as the
+ *   FIFO status; the older ones are spaced by the sampling period.
  *
  * Input Parameters:
  *   dev - Pointer to device driver instance
@@ -381,16 +320,23 @@ static int lis3dh_queue_pop(FAR struct lis3dh_dev_s *dev,
 
 static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
 {
+  struct sensor_accel_s data;
+  uint64_t timestamp;
+  uint32_t period;
   uint8_t fifosrc;
   uint8_t count;
   int i;
 
+  period = lis3dh_period(dev, dev->odr);
+
   /* Lock the SPI bus */
 
   SPI_LOCK(dev->spi, true);
 
   /* Read the FIFO source register */
 
+  timestamp = sensor_timestamp();
+
   dev->fifobuf[0] = LIS3DH_FIFO_SRC_REG | 0x80;
   dev->fifobuf[1] = 0;
 
@@ -420,7 +366,6 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
 
   for (i = 0; i < count; i++)
     {
-      struct lis3dh_sensor_data_s data;
       uint16_t x_raw;
       uint16_t y_raw;
       uint16_t z_raw;
@@ -449,9 +394,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 8;
             z_acc = (int16_t)z_raw >> 8;
 
-            data.x_acc = (float)x_acc * 0.016;
-            data.y_acc = (float)y_acc * 0.016;
-            data.z_acc = (float)z_acc * 0.016;
+            data.x = (float)x_acc * 0.016 * SENSOR_STANDARD_GRAVITY;
+            data.y = (float)y_acc * 0.016 * SENSOR_STANDARD_GRAVITY;
+            data.z = (float)z_acc * 0.016 * SENSOR_STANDARD_GRAVITY;
             break;
 
           case LIS3DH_POWER_NORMAL:  /* 10 bit measurements */
@@ -459,9 +404,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 6;
             z_acc = (int16_t)z_raw >> 6;
 
-            data.x_acc = (float)x_acc * 0.004;
-            data.y_acc = (float)y_acc * 0.004;
-            data.z_acc = (float)z_acc * 0.004;
+            data.x = (float)x_acc * 0.004 * SENSOR_STANDARD_GRAVITY;
+            data.y = (float)y_acc * 0.004 * SENSOR_STANDARD_GRAVITY;
+            data.z = (float)z_acc * 0.004 * SENSOR_STANDARD_GRAVITY;
             break;
 
           case LIS3DH_POWER_HIGH:    /* 12 bit measurements */
@@ -469,9 +414,9 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             y_acc = (int16_t)y_raw >> 4;
             z_acc = (int16_t)z_raw >> 4;
 
-            data.x_acc = (float)x_acc * 0.001;
-            data.y_acc = (float)y_acc * 0.001;
-            data.z_acc = (float)z_acc * 0.001;
+            data.x = (float)x_acc * 0.001 * SENSOR_STANDARD_GRAVITY;
+            data.y = (float)y_acc * 0.001 * SENSOR_STANDARD_GRAVITY;
+            data.z = (float)z_acc * 0.001 * SENSOR_STANDARD_GRAVITY;
             break;
 
           default:
@@ -479,10 +424,8 @@ static int lis3dh_read_fifo(FAR struct lis3dh_dev_s *dev)
             return -EINVAL;
         }
 
-      if (lis3dh_queue_push(dev, &data) == OK)
-        {
-          nxsem_post(&dev->readsem);
-        }
+      data.timestamp = timestamp - (uint64_t)(count - 1 - i) * period;
+      (void)sensor_push(&dev->lower, &data);
     }
 
   return OK;
@@ -532,7 +475,7 @@ static int lis3dh_interrupt_handler(int irq, FAR void *context, FAR void *arg)
  * Description:
  *   Worker callback executed from high priority work queue.
  *   Performs reading the FIFO from the sensor and pushing samples to
- *   the internal device driver queue.
+ *   the sensor upper half.
  *
  * Input Parameters:
  *   arg - Pointer to device driver instance
@@ -545,7 +488,7 @@ static void lis3dh_worker(FAR void *arg)
 
   DEBUGASSERT(priv != NULL);
 
-  /* Read the FIFO and fill the queue */
+  /* Read the FIFO and fill the sample ring */
 
   lis3dh_read_fifo(priv);
 }
@@ -638,12 +581,13 @@ static int lis3dh_set_odr(FAR struct lis3dh_dev_s *dev, uint8_t odr)
 {
   uint8_t ctrl1;
 
-  if (odr > LIS3DH_CTRL_REG1_ODR_LP_5376HZ)
+  if (odr > LIS3DH_ODR_LP_5376HZ)
     {
       return -EINVAL;
     }
 
   lis3dh_read_register(dev, LIS3DH_CTRL_REG1, &ctrl1);
+  ctrl1 &= ~LIS3DH_CTRL_REG1_ODR_MASK;
   ctrl1 |= LIS3DH_CTRL_REG1_ODR(odr) & LIS3DH_CTRL_REG1_ODR_MASK;
   lis3dh_write_register(dev, LIS3DH_CTRL_REG1, ctrl1);
 
@@ -754,30 +698,42 @@ static int lis3dh_enable(FAR struct lis3dh_dev_s *priv)
 }
 
 /****************************************************************************
- * Name: lis3dh_open
+ * Name: lis3dh_activate
  *
  * Description:
- *   Character device open call.
+ *   Start or stop sampling.  Called by the sensor upper half on the first
+ *   open and the last close of the device.
  *
  * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower  - Pointer to the lower half (the device driver instance)
+ *   enable - True to start sampling
  *
  * Returned Value:
  *   -ENODEV - Device was not identified on the SPI bus.
- *   OK      - Sensor device was opened successfully.
+ *   OK      - Sampling was started or stopped successfully.
  *
  ****************************************************************************/
 
-static int lis3dh_open(FAR struct file *filep)
+static int lis3dh_activate(FAR struct sensor_lowerhalf_s *lower,
+                           bool enable)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
 
   DEBUGASSERT(priv != NULL);
 
   /* Perform a reset */
 
   lis3dh_reset(priv);
+
+  if (!enable)
+    {
+      /* Detach the interrupt line and forget any pending FIFO read */
+
+      (priv->config->irq_detach)(priv->config);
+      (void)work_cancel(HPWORK, &priv->work);
+      return OK;
+    }
+
   if (lis3dh_ident(priv) < 0)
     {
       snerr("ERROR: Failed to identify LIS3DH on SPI bus\n");
@@ -804,126 +760,63 @@ static int lis3dh_open(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: lis3dh_close
+ * Name: lis3dh_set_interval
  *
  * Description:
- *   Character device close call.
+ *   Select the slowest output data rate whose sampling period does not
+ *   exceed the requested one (or the fastest rate if none does).
  *
  * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower     - Pointer to the lower half (the device driver instance)
+ *   period_us - The requested period in microseconds; the period actually
+ *               selected is returned here.
  *
  * Returned Value:
- *   OK - Sensor device was closed successfully.
- *
- ****************************************************************************/
-
-static int lis3dh_close(FAR struct file *filep)
-{
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
-
-  DEBUGASSERT(priv != NULL);
-
-  /* Perform a reset */
-
-  lis3dh_reset(priv);
-
-  /* Detach the interrupt line */
-
-  (priv->config->irq_detach)(priv->config);
-
-  return OK;
-}
-
-/****************************************************************************
- * Name: lis3dh_read
- *
- * Description:
- *   Character device read call. Blocks until requested buffer size is full.
- *
- * Input Parameters:
- *   filep - Pointer to struct file
- *   buffer - Pointer to user buffer
- *   buflen - Size of user buffer in bytes
- *
- * Returned Value:
- *   Returns the number of bytes written to the buffer.
- *   -EINVAL - Supplied buffer length invalid
+ *   OK on success or a negative errno value on failure.
  *
  ****************************************************************************/
 
-static ssize_t lis3dh_read(FAR struct file *filep, FAR char *buffer,
-                            size_t buflen)
+static int lis3dh_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                               FAR uint32_t *period_us)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
-  FAR struct lis3dh_sensor_data_s *data;
-  int count;
-  int remain;
-
-  DEBUGASSERT(priv != NULL);
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
+  uint32_t period;
+  uint8_t best = LIS3DH_ODR_1HZ;
+  uint8_t odr;
+  int ret;
 
-  if ((buflen % sizeof(FAR struct lis3dh_sensor_data_s)) != 0)
+  for (odr = LIS3DH_ODR_1HZ; odr <= LIS3DH_ODR_1344HZ; odr++)
     {
-      snerr("ERROR: Provided buffer must be multiple of sensor data size\n");
-      return -EINVAL;
-    }
-
-  /* Get the number of samples the user has requested */
-
-  count = buflen / sizeof(struct lis3dh_sensor_data_s);
-
-  /* Cast a pointer into the user buffer */
+      period = lis3dh_period(priv, odr);
+      if (period == 0)
+        {
+          continue;
+        }
 
-  data = (FAR struct lis3dh_sensor_data_s *)buffer;
+      best = odr;
+      if (period <= *period_us)
+        {
+          break;
+        }
+    }
 
-  for (remain=count;remain > 0;remain--)
+  ret = lis3dh_set_odr(priv, best);
+  if (ret >= 0)
     {
-
-      /* Wait for data to be available in the queue */
-
-      nxsem_wait(&priv->readsem);
-
-      /* Pop a sample off of the queue */
-
-      lis3dh_queue_pop(priv, data);
-
-      data++;
+      *period_us = lis3dh_period(priv, best);
     }
 
-  return count * sizeof(struct lis3dh_sensor_data_s);
-}
-
-/****************************************************************************
- * Name: lis3dh_write
- *
- * Description:
- *   Character device write call. Not supported.
- *
- * Input Parameters:
- *   filep  - Pointer to struct file
- *   buffer - Pointer to user buffer
- *   buflen - Size of user buffer in bytes
- *
- * Returned Value:
- *   -ENOSYS
- *
- ****************************************************************************/
-
-static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
-                             size_t buflen)
-{
-  return -ENOSYS;
+  return ret;
 }
 
 /****************************************************************************
- * Name: lis3dh_ioctl
+ * Name: lis3dh_control
  *
  * Description:
- *   Character device ioctl call. Sets device parameters.
+ *   Handle the LIS3DH specific ioctl commands.
  *
  * Input Parameters:
- *   filep - Pointer to struct file
+ *   lower - Pointer to the lower half (the device driver instance)
  *   cmd   - SNIOC_*
  *   arg   - ioctl specific argument
  *
@@ -933,10 +826,10 @@ static ssize_t lis3dh_write(FAR struct file *filep, FAR const char *buffer,
  *
  ****************************************************************************/
 
-static int lis3dh_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+static int lis3dh_control(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                          unsigned long arg)
 {
-  FAR struct inode *inode = filep->f_inode;
-  FAR struct lis3dh_dev_s *priv = inode->i_private;
+  FAR struct lis3dh_dev_s *priv = (FAR struct lis3dh_dev_s *)lower;
   int ret = OK;
 
   switch (cmd)
@@ -988,41 +881,33 @@ int lis3dh_register(FAR const char *devpath, FAR struct spi_dev_s *spi,
 
   /* Initialize the LIS3DH device structure */
 
-  priv = (FAR struct lis3dh_dev_s *)kmm_malloc(sizeof(struct lis3dh_dev_s));
+  priv = (FAR struct lis3dh_dev_s *)kmm_zalloc(sizeof(struct lis3dh_dev_s));
   if (priv == NULL)
     {
       snerr("ERROR: Failed to allocate instance\n");
       return -ENOMEM;
     }
 
-  priv->config = config;
-  priv->spi = spi;
+  priv->lower.ops   = &g_lis3dh_ops;
+  priv->lower.type  = SENSOR_TYPE_ACCELEROMETER;
+  priv->lower.esize = sizeof(struct sensor_accel_s);
+  priv->lower.nelem = LIS3DH_NSAMPLES;
+  priv->config      = config;
+  priv->spi         = spi;
   priv->work.worker = NULL;
-  priv->queue_count = 0;
-
-  /* Initialize queue semaphore */
-
-  nxsem_init(&priv->queuesem, 0, 1);
-
-  /* Initialize read notification semaphore */
-
-  nxsem_init(&priv->readsem, 0, 0);
-  nxsem_setprotocol(&priv->readsem, SEM_PRIO_NONE);
 
   /* Setup SPI frequency and mode */
 
   SPI_SETFREQUENCY(spi, LIS3DH_SPI_FREQUENCY);
   SPI_SETMODE(spi, LIS3DH_SPI_MODE);
 
-  /* Register the character driver */
+  /* Register the character driver with the sensor upper half */
 
-  ret = register_driver(devpath, &g_lis3dh_fops, 0666, priv);
+  ret = sensor_register(devpath, &priv->lower);
   if (ret < 0)
     {
       snerr("ERROR: Failed to register driver: %d\n", ret);
       kmm_free(priv);
-      nxsem_destroy(&priv->queuesem);
-      nxsem_destroy(&priv->readsem);
       return ret;
     }
 
@@ -0,0 +1,726 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/ringbuf.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SENSORS_NSAMPLES
+#  define CONFIG_SENSORS_NSAMPLES 64
+#endif
+
+#ifndef CONFIG_SENSORS_NPOLLWAITERS
+#  define CONFIG_SENSORS_NPOLLWAITERS 2
+#endif
+
+/* The size of a ring holding 'n' samples of 'e' bytes each */
+
+#define SIZEOF_SENSOR_RING_S(n,e) \
+  (offsetof(struct sensor_ring_s, sr_data) + (size_t)(n) * (e))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of the upper half driver */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* Lower half driver state */
+  FAR struct sensor_ring_s *ring;       /* The sample ring */
+  uint32_t head;                        /* Kernel copy of ring->sr_head */
+  uint32_t nelem;                       /* Capacity of the ring in samples */
+  uint32_t mask;                        /* nelem - 1 */
+  uint16_t esize;                       /* Size of one sample in bytes */
+  uint32_t watermark;                   /* Samples that make it readable */
+  uint32_t rdthresh;                    /* Samples a blocked reader needs */
+  uint8_t crefs;                        /* Number of open references */
+  uint8_t nwaiters;                     /* Number of blocked readers */
+  sem_t exclsem;                        /* Supports mutual exclusion */
+  sem_t readsem;                        /* Wakes up blocked readers */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,     /* open */
+  sensor_close,    /* close */
+  sensor_read,     /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  sensor_ioctl     /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , sensor_poll    /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_takesem
+ ****************************************************************************/
+
+static int sensor_takesem(FAR sem_t *sem)
+{
+  int ret;
+
+  ret = nxsem_wait(sem);
+  DEBUGASSERT(ret == OK || ret == -EINTR || ret == -ECANCELED);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_tail
+ *
+ * Description:
+ *   Return the consumer position of the ring.  The ring is writable by the
+ *   application after FIOC_MMAP, so sr_tail is clamped to at most nelem
+ *   samples behind the head; everything else is taken from the kernel
+ *   copies in the upper half.
+ *
+ ****************************************************************************/
+
+static uint32_t sensor_tail(FAR struct sensor_upperhalf_s *upper)
+{
+  uint32_t tail = upper->ring->sr_tail;
+
+  if (upper->head - tail > upper->nelem)
+    {
+      tail = upper->head - upper->nelem;
+    }
+
+  return tail;
+}
+
+/****************************************************************************
+ * Name: sensor_pollnotify
+ *
+ * Description:
+ *   Report 'eventset' to all threads waiting in poll().  Called with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void sensor_pollnotify(FAR struct sensor_upperhalf_s *upper,
+                              pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sensor_open
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_ring_s *ring = upper->ring;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->crefs >= UINT8_MAX)
+    {
+      ret = -EMFILE;
+      goto errout_with_sem;
+    }
+
+  /* Start sampling into an empty ring on the first open */
+
+  if (upper->crefs == 0)
+    {
+      upper->head    = 0;
+      ring->sr_head  = 0;
+      ring->sr_tail  = 0;
+      ring->sr_drops = 0;
+
+      ret = lower->ops->activate(lower, true);
+      if (ret < 0)
+        {
+          snerr("ERROR: Failed to activate the sensor: %d\n", ret);
+          goto errout_with_sem;
+        }
+    }
+
+  upper->crefs++;
+  ret = OK;
+
+errout_with_sem:
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(upper->crefs > 0);
+  if (--upper->crefs == 0)
+    {
+      ret = lower->ops->activate(lower, false);
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Copy as many whole samples as fit in the user buffer.  Unless the
+ *   device was opened non-blocking, wait until that many samples -OR- the
+ *   watermark number of samples are buffered.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_ring_s *ring = upper->ring;
+  irqstate_t flags;
+  uint32_t nsamples;
+  uint32_t threshold;
+  uint32_t navail;
+  uint32_t offset;
+  uint32_t ncopy;
+  uint32_t tail;
+  int ret;
+
+  nsamples = buflen / upper->esize;
+  if (nsamples == 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_NONBLOCK) != 0)
+    {
+      threshold = 1;
+    }
+  else
+    {
+      threshold = nsamples < upper->watermark ? nsamples : upper->watermark;
+    }
+
+  /* Interrupts are disabled so that the producer cannot add samples
+   * between the test and the wait.
+   */
+
+  flags = enter_critical_section();
+  while (upper->head - sensor_tail(upper) < threshold)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          nxsem_post(&upper->exclsem);
+          return -EAGAIN;
+        }
+
+      /* Wait without holding exclsem so that ioctl() and poll() are not
+       * held off while no samples arrive.
+       */
+
+      upper->rdthresh = threshold;
+      upper->nwaiters++;
+      nxsem_post(&upper->exclsem);
+
+      ret = nxsem_wait(&upper->readsem);
+      if (ret < 0)
+        {
+          if (upper->nwaiters > 0)
+            {
+              upper->nwaiters--;
+            }
+
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      ret = sensor_takesem(&upper->exclsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Copy the samples, in at most two pieces: up to the end of the ring and
+   * then from its start.
+   */
+
+  tail   = sensor_tail(upper);
+  navail = upper->head - tail;
+  RINGBUF_MB();
+
+  if (nsamples > navail)
+    {
+      nsamples = navail;
+    }
+
+  offset = tail & upper->mask;
+  ncopy  = upper->nelem - offset;
+  if (ncopy > nsamples)
+    {
+      ncopy = nsamples;
+    }
+
+  memcpy(buffer, &ring->sr_data[offset * upper->esize],
+         ncopy * upper->esize);
+  if (ncopy < nsamples)
+    {
+      memcpy(buffer + ncopy * upper->esize, ring->sr_data,
+             (nsamples - ncopy) * upper->esize);
+    }
+
+  RINGBUF_MB();
+  ring->sr_tail = tail + nsamples;
+
+  nxsem_post(&upper->exclsem);
+  return nsamples * upper->esize;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_ring_s *ring = upper->ring;
+  irqstate_t flags;
+  int ret;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case SNIOC_SET_PERIOD:  /* Set the sampling period */
+        {
+          FAR uint32_t *period = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (period == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else if (lower->ops->set_interval == NULL)
+            {
+              ret = -ENOTSUP;
+            }
+          else
+            {
+              ret = lower->ops->set_interval(lower, period);
+            }
+        }
+        break;
+
+      case SNIOC_SET_WATERMARK:  /* Set the read/poll() threshold */
+        if (arg < 1 || arg > upper->nelem)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            upper->watermark = (uint32_t)arg;
+          }
+        break;
+
+      case SNIOC_FLUSH:  /* Discard all buffered samples */
+        flags = enter_critical_section();
+        ring->sr_tail = upper->head;
+        leave_critical_section(flags);
+        break;
+
+      case FIOC_MMAP:  /* Get the address of the sample ring */
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          *ppv = ring;
+        }
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = sensor_takesem(&upper->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The poll slots are also examined by sensor_push() */
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else if (upper->head - sensor_tail(upper) >= upper->watermark)
+        {
+          sensor_pollnotify(upper, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  nxsem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Allocate the sample ring for a lower half sensor driver and register
+ *   the character device at 'path'.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *path,
+                    FAR struct sensor_lowerhalf_s *lower)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  FAR struct sensor_ring_s *ring;
+  uint32_t nelem;
+  int ret;
+
+  DEBUGASSERT(path != NULL && lower != NULL && lower->ops != NULL &&
+              lower->ops->activate != NULL && lower->esize > 0);
+
+  /* The ring capacity is rounded up to a power of two */
+
+  for (nelem = 1;
+       nelem < (lower->nelem > 0 ? lower->nelem : CONFIG_SENSORS_NSAMPLES);
+       nelem <<= 1);
+
+  upper = (FAR struct sensor_upperhalf_s *)
+    kmm_zalloc(sizeof(struct sensor_upperhalf_s));
+  if (upper == NULL)
+    {
+      snerr("ERROR: Failed to allocate the upper half\n");
+      return -ENOMEM;
+    }
+
+  /* The ring is allocated from the user heap so that it may be accessed
+   * directly by the application after FIOC_MMAP.
+   */
+
+  ring = (FAR struct sensor_ring_s *)
+    kumm_zalloc(SIZEOF_SENSOR_RING_S(nelem, lower->esize));
+  if (ring == NULL)
+    {
+      snerr("ERROR: Failed to allocate a ring of %lu samples\n",
+            (unsigned long)nelem);
+      ret = -ENOMEM;
+      goto errout_with_upper;
+    }
+
+  ring->sr_nelem   = nelem;
+  ring->sr_esize   = lower->esize;
+  ring->sr_type    = lower->type;
+
+  upper->lower     = lower;
+  upper->ring      = ring;
+  upper->nelem     = nelem;
+  upper->mask      = nelem - 1;
+  upper->esize     = lower->esize;
+  upper->watermark = 1;
+  lower->upper     = upper;
+
+  nxsem_init(&upper->exclsem, 0, 1);
+  nxsem_init(&upper->readsem, 0, 0);
+
+  /* The read semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_setprotocol(&upper->readsem, SEM_PRIO_NONE);
+
+  ret = register_driver(path, &g_sensor_fops, 0666, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to register %s: %d\n", path, ret);
+      goto errout_with_sem;
+    }
+
+  return OK;
+
+errout_with_sem:
+  nxsem_destroy(&upper->readsem);
+  nxsem_destroy(&upper->exclsem);
+  lower->upper = NULL;
+  kumm_free(ring);
+
+errout_with_upper:
+  kmm_free(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Append one sample to the ring of a sensor and wake up any reader that
+ *   waits for it.
+ *
+ ****************************************************************************/
+
+int sensor_push(FAR struct sensor_lowerhalf_s *lower, FAR const void *sample)
+{
+  FAR struct sensor_upperhalf_s *upper = lower->upper;
+  FAR struct sensor_ring_s *ring = upper->ring;
+  irqstate_t flags;
+  uint32_t navail;
+  uint32_t head;
+
+  /* Only this function advances the head, so the ring can be filled
+   * without a lock; the reader only ever frees more space.
+   */
+
+  head = upper->head;
+  if (head - sensor_tail(upper) >= upper->nelem)
+    {
+      ring->sr_drops++;
+      return -ENOSPC;
+    }
+
+  memcpy(&ring->sr_data[(head & upper->mask) * upper->esize], sample,
+         upper->esize);
+  RINGBUF_WMB();
+  upper->head   = ++head;
+  ring->sr_head = head;
+
+  /* Wake up the blocked readers and pollers once enough samples are
+   * buffered.
+   */
+
+  flags  = enter_critical_section();
+  navail = head - sensor_tail(upper);
+
+  if (upper->nwaiters > 0 && navail >= upper->rdthresh)
+    {
+      do
+        {
+          upper->nwaiters--;
+          nxsem_post(&upper->readsem);
+        }
+      while (upper->nwaiters > 0);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  if (navail >= upper->watermark)
+    {
+      sensor_pollnotify(upper, POLLIN);
+    }
+#endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in the time base of the sample timestamps.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif /* CONFIG_SENSORS_UPPER */
@@ -55,6 +55,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/ringbuf.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/serial/serial.h>
 #include <nuttx/fs/ioctl.h>
@@ -100,6 +101,10 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static int     uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen, bool oktoblock, FAR size_t *nput);
+static size_t  uart_rawspan(FAR uart_dev_t *dev, FAR const char *buffer,
+                            size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
@@ -226,11 +231,7 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
    * head pointer to determine when the circular buffer would overrun
    */
 
-  nexthead = dev->xmit.head + 1;
-  if (nexthead >= dev->xmit.size)
-    {
-      nexthead = 0;
-    }
+  nexthead = RINGBUF_NEXT(dev->xmit.head, dev->xmit.size);
 
   /* Loop until we are able to add the character to the TX buffer. */
 
@@ -243,6 +244,12 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
           /* No.. not full.  Add the character to the TX buffer and return. */
 
           dev->xmit.buffer[dev->xmit.head] = ch;
+
+          /* The TX interrupt may run on another CPU:  The character must
+           * be visible before the new head index.
+           */
+
+          RINGBUF_WMB();
           dev->xmit.head = nexthead;
           return OK;
         }
@@ -350,6 +357,106 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
   return OK;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy a span of characters that needs no output processing into the TX buffer,
+ *   as much at a time as there is space for.  Only when the buffer is full does
+ *   this fall back to uart_putxmitchar() to wait for space (or fail).  The number
+ *   of characters added to the buffer is returned in 'nput', even on failure.
+ *
+ ************************************************************************************/
+
+static int uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen, bool oktoblock, FAR size_t *nput)
+{
+  size_t ncopied = 0;
+  int ret = OK;
+
+  while (ncopied < buflen)
+    {
+      int16_t head = dev->xmit.head;
+      int16_t tail = dev->xmit.tail;
+      size_t nspace = RINGBUF_SPACE(head, tail, dev->xmit.size);
+
+      if (nspace == 0)
+        {
+          /* The TX buffer is full.  Let uart_putxmitchar() do the waiting */
+
+          ret = uart_putxmitchar(dev, buffer[ncopied], oktoblock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ncopied++;
+          continue;
+        }
+
+      if (nspace > buflen - ncopied)
+        {
+          nspace = buflen - ncopied;
+        }
+
+      head = ringbuf_copyin((FAR uint8_t *)dev->xmit.buffer, dev->xmit.size,
+                            head, &buffer[ncopied], nspace);
+
+      /* The TX interrupt may run on another CPU:  The characters must be
+       * visible before the new head index.
+       */
+
+      RINGBUF_WMB();
+      dev->xmit.head = head;
+      ncopied       += nspace;
+    }
+
+  *nput = ncopied;
+  return ret;
+}
+
+/************************************************************************************
+ * Name: uart_rawspan
+ *
+ * Description:
+ *   Return the number of characters at the beginning of 'buffer' that can be
+ *   written without any output post-processing.
+ *
+ ************************************************************************************/
+
+static size_t uart_rawspan(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen)
+{
+  bool nlproc = false;
+  bool crproc = false;
+  size_t i;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if ((dev->tc_oflag & OPOST) != 0)
+    {
+      nlproc = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+      crproc = (dev->tc_oflag & OCRNL) != 0;
+    }
+#else
+  nlproc = dev->isconsole;
+#endif
+
+  if (!nlproc && !crproc)
+    {
+      return buflen;
+    }
+
+  for (i = 0; i < buflen; i++)
+    {
+      if ((nlproc && buffer[i] == '\n') || (crproc && buffer[i] == '\r'))
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -727,8 +834,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  int16_t head;
   int16_t tail;
+#ifdef CONFIG_SERIAL_TERMIOS
   char ch;
+#endif
   int ret;
 
   /* Only one user can access rxbuf->tail at a time */
@@ -778,47 +888,48 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        * 8-bit accesses to obtain the 16-bit head index.
        */
 
+      head = rxbuf->head;
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+
+#ifdef CONFIG_SERIAL_TERMIOS
+      /* Do input processing if any is enabled.  This requires that the
+       * characters be taken one at a time.
+       */
+
+      if (head != tail && (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) != 0)
         {
-          /* Take the next character from the tail of the buffer */
+          /* Take the next character from the tail of the buffer.  The
+           * barriers order the read of the character after the read of
+           * the head index and before the release of the slot.
+           */
 
+          RINGBUF_MB();
           ch = rxbuf->buffer[tail];
+          RINGBUF_MB();
 
           /* Increment the tail index.  Most operations are done using the
            * local variable 'tail' so that the final rxbuf->tail update
            * is atomic.
            */
 
-          if (++tail >= rxbuf->size)
-            {
-              tail = 0;
-            }
-
-          rxbuf->tail = tail;
+          rxbuf->tail = RINGBUF_NEXT(tail, rxbuf->size);
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+          /* \n -> \r or \r -> \n translation? */
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+          if ((ch == '\n') && (dev->tc_iflag & INLCR))
             {
-              /* \n -> \r or \r -> \n translation? */
-
-              if ((ch == '\n') && (dev->tc_iflag & INLCR))
-                {
-                  ch = '\r';
-                }
-              else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
-                {
-                  ch = '\n';
-                }
+              ch = '\r';
+            }
+          else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
+            {
+              ch = '\n';
+            }
 
-              /* Discarding \r ? */
+          /* Discarding \r ? */
 
-              if ((ch == '\r') & (dev->tc_iflag & IGNCR))
-                {
-                  continue;
-                }
+          if ((ch == '\r') & (dev->tc_iflag & IGNCR))
+            {
+              continue;
             }
 
           /* Specifically not handled:
@@ -829,13 +940,38 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
            * IUCLC - Not Posix
            * IXON/OXOFF - no xon/xoff flow control.
            */
-#endif
 
           /* Store the received character */
 
           *buffer++ = ch;
           recvd++;
         }
+      else
+#endif
+      if (head != tail)
+        {
+          size_t nread = RINGBUF_USED(head, tail, rxbuf->size);
+
+          /* No input processing:  Take everything that is buffered (up to
+           * the size of the user buffer) as a block.  The barriers order the
+           * read of the data after the read of the head index and before the
+           * release of the space.
+           */
+
+          if (nread > buflen - (size_t)recvd)
+            {
+              nread = buflen - (size_t)recvd;
+            }
+
+          RINGBUF_MB();
+          tail = ringbuf_copyout((FAR const uint8_t *)rxbuf->buffer,
+                                 rxbuf->size, tail, buffer, nread);
+          RINGBUF_MB();
+
+          rxbuf->tail = tail;
+          buffer     += nread;
+          recvd      += nread;
+        }
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
       /* No... then we would have to wait to get receive more data.
@@ -1018,15 +1154,10 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
   /* How many bytes are now buffered */
 
-  rxbuf = &dev->recv;
-  if (rxbuf->head >= rxbuf->tail)
-    {
-      nbuffered = rxbuf->head - rxbuf->tail;
-    }
-  else
-    {
-      nbuffered = rxbuf->size - rxbuf->tail + rxbuf->head;
-    }
+  rxbuf     = &dev->recv;
+  head      = rxbuf->head;
+  tail      = rxbuf->tail;
+  nbuffered = RINGBUF_USED(head, tail, rxbuf->size);
 
   /* Is the level now below the watermark level that we need to report? */
 
@@ -1065,6 +1196,8 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nspan;
+  size_t            nput;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -1135,53 +1268,73 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  while (buflen > 0)
     {
-      ch  = *buffer++;
-      ret = OK;
-
-#ifdef CONFIG_SERIAL_TERMIOS
-      /* Do output post-processing */
+      /* Characters that need no output post-processing are copied into the
+       * TX buffer as a block.
+       */
 
-      if ((dev->tc_oflag & OPOST) != 0)
+      nspan = uart_rawspan(dev, buffer, buflen);
+      if (nspan > 0)
         {
-          /* Mapping CR to NL? */
+          ret     = uart_putxmitbuf(dev, buffer, nspan, oktoblock, &nput);
+          buffer += nput;
+          buflen -= nput;
+        }
+      else
+        {
+          ch  = *buffer;
+          ret = OK;
 
-          if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+#ifdef CONFIG_SERIAL_TERMIOS
+          /* Do output post-processing */
+
+          if ((dev->tc_oflag & OPOST) != 0)
             {
-              ch = '\n';
-            }
+              /* Mapping CR to NL? */
 
-          /* Are we interested in newline processing? */
+              if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+                {
+                  ch = '\n';
+                }
 
-          if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
-            {
-              ret = uart_putxmitchar(dev, '\r', oktoblock);
-            }
+              /* Are we interested in newline processing? */
 
-          /* Specifically not handled:
-           *
-           * OXTABS - primarily a full-screen terminal optimization
-           * ONOEOT - Unix interoperability hack
-           * OLCUC  - Not specified by POSIX
-           * ONOCR  - low-speed interactive optimization
-           */
-        }
+              if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+                {
+                  ret = uart_putxmitchar(dev, '\r', oktoblock);
+                }
+
+              /* Specifically not handled:
+               *
+               * OXTABS - primarily a full-screen terminal optimization
+               * ONOEOT - Unix interoperability hack
+               * OLCUC  - Not specified by POSIX
+               * ONOCR  - low-speed interactive optimization
+               */
+            }
 
 #else /* !CONFIG_SERIAL_TERMIOS */
-      /* If this is the console, convert \n -> \r\n */
+          /* If this is the console, convert \n -> \r\n */
 
-      if (dev->isconsole && ch == '\n')
-        {
-          ret = uart_putxmitchar(dev, '\r', oktoblock);
-        }
+          if (dev->isconsole && ch == '\n')
+            {
+              ret = uart_putxmitchar(dev, '\r', oktoblock);
+            }
 #endif
 
-      /* Put the character into the transmit buffer */
+          /* Put the character into the transmit buffer */
 
-      if (ret >= 0)
-        {
-          ret = uart_putxmitchar(dev, ch, oktoblock);
+          if (ret >= 0)
+            {
+              ret = uart_putxmitchar(dev, ch, oktoblock);
+            }
+
+          if (ret >= 0)
+            {
+              buffer++;
+              buflen--;
+            }
         }
 
       /* uart_putxmitchar() might return an error under one of two
@@ -1267,14 +1420,8 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
               /* Determine the number of bytes available in the RX buffer */
 
-              if (dev->recv.tail <= dev->recv.head)
-                {
-                  count = dev->recv.head - dev->recv.tail;
-                }
-              else
-                {
-                  count = dev->recv.size - (dev->recv.tail - dev->recv.head);
-                }
+              count = RINGBUF_USED(dev->recv.head, dev->recv.tail,
+                                   dev->recv.size);
 
               leave_critical_section(flags);
 
@@ -1292,14 +1439,8 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
               /* Determine the number of bytes waiting in the TX buffer */
 
-              if (dev->xmit.tail <= dev->xmit.head)
-                {
-                  count = dev->xmit.head - dev->xmit.tail;
-                }
-              else
-                {
-                  count = dev->xmit.size - (dev->xmit.tail - dev->xmit.head);
-                }
+              count = RINGBUF_USED(dev->xmit.head, dev->xmit.tail,
+                                   dev->xmit.size);
 
               leave_critical_section(flags);
 
@@ -1317,14 +1458,8 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
               /* Determine the number of bytes free in the TX buffer */
 
-              if (dev->xmit.head < dev->xmit.tail)
-                {
-                  count = dev->xmit.tail - dev->xmit.head - 1;
-                }
-              else
-                {
-                  count = dev->xmit.size - (dev->xmit.head - dev->xmit.tail) - 1;
-                }
+              count = RINGBUF_SPACE(dev->xmit.head, dev->xmit.tail,
+                                    dev->xmit.size);
 
               leave_critical_section(flags);
 
@@ -1528,11 +1663,7 @@ static int uart_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
       eventset = 0;
       (void)uart_takesem(&dev->xmit.sem, false);
 
-      ndx = dev->xmit.head + 1;
-      if (ndx >= dev->xmit.size)
-        {
-          ndx = 0;
-        }
+      ndx = RINGBUF_NEXT(dev->xmit.head, dev->xmit.size);
 
       if (ndx != dev->xmit.tail)
        {
@@ -44,8 +44,77 @@
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/ringbuf.h>
 #include <nuttx/serial/serial.h>
 
+/************************************************************************************
+ * Private Functions
+ ************************************************************************************/
+
+/************************************************************************************
+ * Name: uart_recvblock
+ *
+ * Description:
+ *   Fill the receive buffer from the lower half recvbuf() method, one contiguous
+ *   span at a time, until the hardware is drained or the buffer reaches 'limit'
+ *   buffered bytes.  Returns the number of bytes added to the buffer.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_FIFOBUF
+static uint16_t uart_recvblock(FAR uart_dev_t *dev, unsigned int limit)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t head = rxbuf->head;
+  uint16_t nbytes = 0;
+
+  if (limit > (unsigned int)rxbuf->size - 1)
+    {
+      limit = rxbuf->size - 1;
+    }
+
+  for (; ; )
+    {
+      unsigned int nbuffered = RINGBUF_USED(head, rxbuf->tail, rxbuf->size);
+      size_t len;
+      size_t nrecvd;
+
+      if (nbuffered >= limit)
+        {
+          break;
+        }
+
+      /* Receive directly into the contiguous free space after the head */
+
+      len = limit - nbuffered;
+      if (len > (size_t)(rxbuf->size - head))
+        {
+          len = rxbuf->size - head;
+        }
+
+      nrecvd = uart_recvbuf(dev, &rxbuf->buffer[head], len);
+      if (nrecvd == 0)
+        {
+          break;
+        }
+
+      /* The data must be visible before the new head index */
+
+      RINGBUF_WMB();
+      head        = RINGBUF_ADVANCE(head, nrecvd, rxbuf->size);
+      rxbuf->head = head;
+      nbytes     += nrecvd;
+
+      if (nrecvd < len)
+        {
+          break;
+        }
+    }
+
+  return nbytes;
+}
+#endif
+
 /************************************************************************************
  * Public Functions
  ************************************************************************************/
@@ -64,24 +133,63 @@
 void uart_xmitchars(FAR uart_dev_t *dev)
 {
   uint16_t nbytes = 0;
+  int16_t tail = dev->xmit.tail;
 
-  /* Send while we still have data in the TX buffer & room in the fifo */
-
-  while (dev->xmit.head != dev->xmit.tail && uart_txready(dev))
+#ifdef CONFIG_SERIAL_FIFOBUF
+  if (uart_hassendbuf(dev))
     {
-      /* Send the next byte */
+      /* Hand contiguous spans of the TX buffer to the lower half until the
+       * buffer is empty or the fifo will take no more.
+       */
+
+      while (dev->xmit.head != tail)
+        {
+          int16_t head = dev->xmit.head;
+          size_t len;
+          size_t nsent;
 
-      uart_send(dev, dev->xmit.buffer[dev->xmit.tail]);
-      nbytes++;
+          len = (head > tail ? head : dev->xmit.size) - tail;
 
-      /* Increment the tail index */
+          RINGBUF_MB();
+          nsent   = uart_sendbuf(dev, &dev->xmit.buffer[tail], len);
+          nbytes += nsent;
+          tail    = RINGBUF_ADVANCE(tail, nsent, dev->xmit.size);
 
-      if (++(dev->xmit.tail) >= dev->xmit.size)
+          if (nsent < len)
+            {
+              break;
+            }
+        }
+    }
+  else
+#endif
+    {
+      /* Send while we still have data in the TX buffer & room in the fifo */
+
+      while (dev->xmit.head != tail && uart_txready(dev))
         {
-          dev->xmit.tail = 0;
+          /* Send the next byte.  It must be read after the head index that
+           * covers it.
+           */
+
+          RINGBUF_MB();
+          uart_send(dev, dev->xmit.buffer[tail]);
+          nbytes++;
+
+          /* Increment the tail index */
+
+          tail = RINGBUF_NEXT(tail, dev->xmit.size);
         }
     }
 
+  /* Release the space only after the bytes have been read */
+
+  if (nbytes)
+    {
+      RINGBUF_MB();
+      dev->xmit.tail = tail;
+    }
+
   /* When all of the characters have been sent from the buffer disable the TX
    * interrupt.
    *
@@ -97,10 +205,15 @@ void uart_xmitchars(FAR uart_dev_t *dev)
     }
 
   /* If any bytes were removed from the buffer, inform any waiters there there is
-   * space available.
+   * space available.  A writer blocked on a full buffer is not woken for every
+   * few bytes that leave it, only once the buffer is half empty (or empty) so
+   * that it can refill the buffer with one large copy.  The TX interrupt stays
+   * enabled until the buffer is empty, so the wakeup will come.
    */
 
-  if (nbytes)
+  if (nbytes &&
+      (dev->xmit.head == tail ||
+       RINGBUF_SPACE(dev->xmit.head, tail, dev->xmit.size) >= dev->xmit.size / 2))
     {
       uart_datasent(dev);
     }
@@ -124,23 +237,40 @@ void uart_recvchars(FAR uart_dev_t *dev)
   unsigned int watermark;
 #endif
   unsigned int status;
-  int nexthead = rxbuf->head + 1;
+  int nexthead = RINGBUF_NEXT(rxbuf->head, rxbuf->size);
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
   int signo = 0;
 #endif
   uint16_t nbytes = 0;
 
-  if (nexthead >= rxbuf->size)
-    {
-      nexthead = 0;
-    }
-
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
   /* Pre-calculate the watermark level that we will need to test against. */
 
   watermark = (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * rxbuf->size) / 100;
 #endif
 
+#ifdef CONFIG_SERIAL_FIFOBUF
+  /* If the lower half can read its fifo as a block, take everything that fits
+   * that way first.  This is not possible if each character must be checked
+   * for the special signal characters.  Anything left (a full buffer, flow
+   * control) is handled one character at a time below.
+   */
+
+  if (uart_hasrecvbuf(dev)
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+      && dev->pid < 0
+#endif
+     )
+    {
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+      nbytes   = uart_recvblock(dev, watermark);
+#else
+      nbytes   = uart_recvblock(dev, rxbuf->size - 1);
+#endif
+      nexthead = RINGBUF_NEXT(rxbuf->head, rxbuf->size);
+    }
+#endif
+
   /* Loop putting characters into the receive buffer until there are no further
    * characters to available.
    */
@@ -153,17 +283,11 @@ void uart_recvchars(FAR uart_dev_t *dev)
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
       unsigned int nbuffered;
+      int16_t tail = rxbuf->tail;
 
       /* How many bytes are buffered */
 
-      if (rxbuf->head >= rxbuf->tail)
-        {
-          nbuffered = rxbuf->head - rxbuf->tail;
-        }
-      else
-        {
-          nbuffered = rxbuf->size - rxbuf->tail + rxbuf->head;
-        }
+      nbuffered = RINGBUF_USED(rxbuf->head, tail, rxbuf->size);
 
       /* Is the level now above the watermark level that we need to report? */
 
@@ -250,13 +374,13 @@ void uart_recvchars(FAR uart_dev_t *dev)
           rxbuf->buffer[rxbuf->head] = ch;
           nbytes++;
 
-          /* Increment the head index */
+          /* Increment the head index.  The reader may run on another CPU:
+           * The character must be visible before the new head index.
+           */
 
+          RINGBUF_WMB();
           rxbuf->head = nexthead;
-          if (++nexthead >= rxbuf->size)
-            {
-               nexthead = 0;
-            }
+          nexthead    = RINGBUF_NEXT(nexthead, rxbuf->size);
         }
     }
 
@@ -63,6 +63,17 @@
  * Pre-processor definitions
  ****************************************************************************/
 
+/* Number of bytes that may be written to THR once THRE is set.  That is the
+ * FIFO depth if u16550_setup() enabled the FIFOs;  otherwise, we know only
+ * that the holding register is empty.
+ */
+
+#ifndef CONFIG_16550_SUPRESS_CONFIG
+#  define UART_TXFIFO_DEPTH 16
+#else
+#  define UART_TXFIFO_DEPTH 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -113,6 +124,12 @@ static void u16550_send(FAR struct uart_dev_s *dev, int ch);
 static void u16550_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool u16550_txready(FAR struct uart_dev_s *dev);
 static bool u16550_txempty(FAR struct uart_dev_s *dev);
+#ifdef CONFIG_SERIAL_FIFOBUF
+static size_t u16550_sendbuf(FAR struct uart_dev_s *dev,
+                             FAR const char *buffer, size_t len);
+static size_t u16550_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                             size_t len);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -141,6 +158,10 @@ static const struct uart_ops_s g_uart_ops =
   .txint          = u16550_txint,
   .txready        = u16550_txready,
   .txempty        = u16550_txempty,
+#ifdef CONFIG_SERIAL_FIFOBUF
+  .sendbuf        = u16550_sendbuf,
+  .recvbuf        = u16550_recvbuf,
+#endif
 };
 
 /* I/O buffers */
@@ -1258,6 +1279,69 @@ static bool u16550_txempty(struct uart_dev_s *dev)
   return ((u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_TEMT) != 0);
 }
 
+/****************************************************************************
+ * Name: u16550_sendbuf
+ *
+ * Description:
+ *   Fill the transmit FIFO from 'buffer'.  Returns the number of bytes
+ *   written, zero if the FIFO is not yet empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_FIFOBUF
+static size_t u16550_sendbuf(FAR struct uart_dev_s *dev,
+                             FAR const char *buffer, size_t len)
+{
+  FAR struct u16550_s *priv = (FAR struct u16550_s *)dev->priv;
+  size_t nsent;
+
+  if ((u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_THRE) == 0)
+    {
+      return 0;
+    }
+
+  if (len > UART_TXFIFO_DEPTH)
+    {
+      len = UART_TXFIFO_DEPTH;
+    }
+
+  for (nsent = 0; nsent < len; nsent++)
+    {
+      u16550_serialout(priv, UART_THR_OFFSET, (uart_datawidth_t)buffer[nsent]);
+    }
+
+  return nsent;
+}
+
+/****************************************************************************
+ * Name: u16550_recvbuf
+ *
+ * Description:
+ *   Drain the receive FIFO into 'buffer'.  Returns the number of bytes
+ *   read.
+ *
+ ****************************************************************************/
+
+static size_t u16550_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                             size_t len)
+{
+  FAR struct u16550_s *priv = (FAR struct u16550_s *)dev->priv;
+  size_t nrecvd;
+
+  for (nrecvd = 0; nrecvd < len; nrecvd++)
+    {
+      if ((u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_DR) == 0)
+        {
+          break;
+        }
+
+      buffer[nrecvd] = (char)u16550_serialin(priv, UART_RBR_OFFSET);
+    }
+
+  return nrecvd;
+}
+#endif
+
 /****************************************************************************
  * Name: u16550_putc
  *
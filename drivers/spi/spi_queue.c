@@ -0,0 +1,315 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+#include <nuttx/spi/spi_queue.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one SPI bus queue */
+
+struct spi_queue_s
+{
+  FAR struct spi_dev_s *spi;         /* The lower half SPI driver */
+  sq_queue_t pending;                /* Requests waiting to be performed */
+  sq_queue_t done;                   /* Requests completed by the lower half */
+  sem_t waitsem;                     /* Wakes up the bus thread */
+  pid_t pid;                         /* The bus thread */
+#ifdef CONFIG_SMP
+  spinlock_t lock;                   /* Protects the request lists */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_remfirst
+ *
+ * Description:
+ *   Remove the request at the head of a list.  The lists may be modified by
+ *   spi_queue_complete() from interrupt handlers.  They are private to the
+ *   queue, so only the queue's own spinlock is needed, not the global
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_request_s *
+spi_queue_remfirst(FAR struct spi_queue_s *queue, FAR sq_queue_t *list)
+{
+  FAR struct spi_request_s *req;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_local(&queue->lock);
+  req   = (FAR struct spi_request_s *)sq_remfirst(list);
+  spin_unlock_irqrestore_local(&queue->lock, flags);
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: spi_queue_thread
+ *
+ * Description:
+ *   The bus thread.  Calls the callbacks of requests completed by the lower
+ *   half and performs pending requests with spi_transfer().
+ *
+ ****************************************************************************/
+
+static int spi_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_queue_s *queue;
+  FAR struct spi_request_s *req;
+
+  DEBUGASSERT(argc > 1 && argv[1] != NULL);
+  queue = (FAR struct spi_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      /* Wait for something to do */
+
+      (void)nxsem_wait(&queue->waitsem);
+
+      /* Report requests completed by the lower half */
+
+      while ((req = spi_queue_remfirst(queue, &queue->done)) != NULL)
+        {
+          req->callback(req);
+        }
+
+      /* Perform requests waiting for the bus */
+
+      while ((req = spi_queue_remfirst(queue, &queue->pending)) != NULL)
+        {
+          req->result = spi_transfer(queue->spi, req->seq);
+          req->callback(req);
+        }
+    }
+
+  return EXIT_SUCCESS; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create the transaction queue for an SPI bus and start the thread that
+ *   serves it.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi,
+                                             int bus)
+{
+  FAR struct spi_queue_s *queue;
+  FAR char *argv[2];
+  char name[8];
+  char arg1[2 * sizeof(uintptr_t) + 1];
+
+  DEBUGASSERT(spi != NULL);
+
+  queue = (FAR struct spi_queue_s *)kmm_zalloc(sizeof(struct spi_queue_s));
+  if (queue == NULL)
+    {
+      spierr("ERROR: Failed to allocate the SPI%d queue\n", bus);
+      return NULL;
+    }
+
+  queue->spi = spi;
+  sq_init(&queue->pending);
+  sq_init(&queue->done);
+#ifdef CONFIG_SMP
+  spin_initialize(&queue->lock, SP_UNLOCKED);
+#endif
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&queue->waitsem, 0, 0);
+  nxsem_setprotocol(&queue->waitsem, SEM_PRIO_NONE);
+
+  /* Start the bus thread, passing it the address of the queue */
+
+  snprintf(name, sizeof(name), "spiq%d", bus);
+  snprintf(arg1, sizeof(arg1), "%lx", (unsigned long)((uintptr_t)queue));
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  queue->pid = kthread_create(name, CONFIG_SPI_QUEUE_PRIORITY,
+                              CONFIG_SPI_QUEUE_STACKSIZE,
+                              (main_t)spi_queue_thread,
+                              (FAR char * const *)argv);
+  if (queue->pid < 0)
+    {
+      spierr("ERROR: Failed to start the SPI%d thread: %d\n",
+             bus, queue->pid);
+      nxsem_destroy(&queue->waitsem);
+      kmm_free(queue);
+      return NULL;
+    }
+
+  return queue;
+}
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Add a request to the tail of the queue of the SPI bus.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR struct spi_dev_s *spi;
+  irqstate_t flags;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  if (req->seq == NULL || req->callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  req->queue  = queue;
+  req->result = -EBUSY;
+
+  /* If the lower half can run requests by itself, give it the request */
+
+  spi = queue->spi;
+  if (spi->ops->submit != NULL)
+    {
+      return SPI_SUBMIT(spi, req);
+    }
+
+  /* Otherwise, queue the request for the bus thread */
+
+  flags = spin_lock_irqsave_local(&queue->lock);
+  sq_addlast((FAR sq_entry_t *)req, &queue->pending);
+  spin_unlock_irqrestore_local(&queue->lock, flags);
+
+  return nxsem_post(&queue->waitsem);
+}
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req)
+{
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  DEBUGASSERT(queue != NULL && req != NULL);
+
+  flags = spin_lock_irqsave_local(&queue->lock);
+  for (curr = sq_peek(&queue->pending); curr != NULL; curr = sq_next(curr))
+    {
+      if (curr == (FAR sq_entry_t *)req)
+        {
+          sq_rem(curr, &queue->pending);
+          ret = OK;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore_local(&queue->lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_queue_complete
+ *
+ * Description:
+ *   Called by a lower half that implements the submit() method when a
+ *   request has completed.
+ *
+ ****************************************************************************/
+
+void spi_queue_complete(FAR struct spi_request_s *req, int result)
+{
+  FAR struct spi_queue_s *queue;
+  irqstate_t flags;
+
+  DEBUGASSERT(req != NULL && req->queue != NULL);
+
+  queue       = req->queue;
+  req->result = result;
+
+  flags = spin_lock_irqsave_local(&queue->lock);
+  sq_addlast((FAR sq_entry_t *)req, &queue->done);
+  spin_unlock_irqrestore_local(&queue->lock, flags);
+
+  (void)nxsem_post(&queue->waitsem);
+}
+
+#endif /* CONFIG_SPI_QUEUE */
@@ -99,6 +99,9 @@ struct ramlog_dev_s
 
 #ifdef CONFIG_RAMLOG_SYSLOG
 static int ramlog_flush(void);
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen);
+#endif
 #endif
 
 /* Helper functions */
@@ -107,7 +110,12 @@ static int ramlog_flush(void);
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+static int     ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#endif
+static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                             FAR const char *buffer, size_t len);
+static void ramlog_readnotify(FAR struct ramlog_dev_s *priv);
 
 /* Character driver methods */
 
@@ -129,7 +137,10 @@ static const struct syslog_channel_s g_ramlog_syslog_channel =
 {
   ramlog_putc,
   ramlog_putc,
-  ramlog_flush
+  ramlog_flush,
+#ifdef CONFIG_SYSLOG_WRITE
+  ramlog_syslog_write
+#endif
 };
 #endif
 
@@ -196,6 +207,28 @@ static int ramlog_flush(void)
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_SYSLOG) && defined(CONFIG_SYSLOG_WRITE)
+static ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct ramlog_dev_s *priv = &g_sysdev;
+
+  /* Add the whole block under a single critical section.  Data that does
+   * not fit is dropped.
+   */
+
+  if (ramlog_addbuf(priv, buffer, buflen) > 0)
+    {
+      ramlog_readnotify(priv);
+    }
+
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: ramlog_pollnotify
  ****************************************************************************/
@@ -233,6 +266,7 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
  * Name: ramlog_addchar
  ****************************************************************************/
 
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
 static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
 {
   irqstate_t flags;
@@ -267,6 +301,132 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
   leave_critical_section(flags);
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: ramlog_addbuf
+ *
+ * Description:
+ *   Add a block of characters to the circular buffer.  Unlike
+ *   ramlog_addchar(), the critical section is entered only once for the
+ *   whole block.
+ *
+ * Returned Value:
+ *   The number of bytes from the caller's buffer that were consumed.  This
+ *   is less than len if the circular buffer became full.
+ *
+ ****************************************************************************/
+
+static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                             FAR const char *buffer, size_t len)
+{
+  irqstate_t flags;
+  size_t nwritten;
+  size_t head;
+  size_t nexthead;
+  char ch;
+
+  /* This function may be called from an interrupt handler!  Semaphores
+   * cannot be used!
+   */
+
+  flags = enter_critical_section();
+  head  = priv->rl_head;
+
+  for (nwritten = 0; nwritten < len; nwritten++)
+    {
+      /* Get the next character to output */
+
+      ch = buffer[nwritten];
+
+#ifdef CONFIG_RAMLOG_CRLF
+      /* Ignore carriage returns */
+
+      if (ch == '\r')
+        {
+          continue;
+        }
+
+      /* Pre-pend a carriage before a linefeed */
+
+      if (ch == '\n')
+        {
+          nexthead = head + 1;
+          if (nexthead >= priv->rl_bufsize)
+            {
+              nexthead = 0;
+            }
+
+          if (nexthead == priv->rl_tail)
+            {
+              /* The buffer is full.  The remaining data is dropped on the
+               * floor.
+               */
+
+              break;
+            }
+
+          priv->rl_buffer[head] = '\r';
+          head = nexthead;
+        }
+#endif
+
+      /* Then output the character */
+
+      nexthead = head + 1;
+      if (nexthead >= priv->rl_bufsize)
+        {
+          nexthead = 0;
+        }
+
+      if (nexthead == priv->rl_tail)
+        {
+          break;
+        }
+
+      priv->rl_buffer[head] = ch;
+      head = nexthead;
+    }
+
+  priv->rl_head = head;
+  leave_critical_section(flags);
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: ramlog_readnotify
+ *
+ * Description:
+ *   Wake up any threads waiting for read data or polling for POLLIN.
+ *
+ ****************************************************************************/
+
+static void ramlog_readnotify(FAR struct ramlog_dev_s *priv)
+{
+#if !defined(CONFIG_RAMLOG_NONBLOCKING) || !defined(CONFIG_DISABLE_POLL)
+  irqstate_t flags;
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  int i;
+#endif
+
+  /* Are there threads waiting for read data? */
+
+  flags = enter_critical_section();
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  for (i = 0; i < priv->rl_nwaiters; i++)
+    {
+      /* Yes.. Notify all of the waiting readers that more data is available */
+
+      nxsem_post(&priv->rl_waitsem);
+    }
+#endif
+
+  /* Notify all poll/select waiters that they can write to the FIFO */
+
+  ramlog_pollnotify(priv, POLLIN);
+  leave_critical_section(flags);
+#endif
+}
 
 /****************************************************************************
  * Name: ramlog_read
@@ -446,97 +606,30 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
-  ssize_t nwritten;
-  char ch;
-  int ret;
 
   /* Some sanity checking */
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct ramlog_dev_s *)inode->i_private;
 
-  /* Loop until all of the bytes have been written.  This function may be
+  /* Add all of the bytes to the circular buffer.  This function may be
    * called from an interrupt handler!  Semaphores cannot be used!
    *
    * The write logic only needs to modify the rl_head index.  Therefore,
    * there is a difference in the way that rl_head and rl_tail are protected:
    * rl_tail is protected with a semaphore; rl_tail is protected by disabling
    * interrupts.
+   *
+   * If the buffer becomes full, the data that was not saved is dropped on
+   * the floor.
    */
 
-  for (nwritten = 0; (size_t)nwritten < len; nwritten++)
-    {
-      /* Get the next character to output */
-
-      ch = buffer[nwritten];
-
-      /* Ignore carriage returns */
-
-#ifdef CONFIG_RAMLOG_CRLF
-      if (ch == '\r')
-        {
-          continue;
-        }
-
-      /* Pre-pend a carriage before a linefeed */
-
-      if (ch == '\n')
-        {
-          ret = ramlog_addchar(priv, '\r');
-          if (ret < 0)
-            {
-              /* The buffer is full and nothing was saved. Break out of the
-               * loop to return the number of bytes written up to this point.
-               * The data to be written is dropped on the floor.
-               */
-
-              break;
-            }
-        }
-#endif
-
-      /* Then output the character */
-
-      ret = ramlog_addchar(priv, ch);
-      if (ret < 0)
-        {
-          /* The buffer is full and nothing was saved. Break out of the
-           * loop to return the number of bytes written up to this point.
-           * The data to be written is dropped on the floor.
-           */
-
-          break;
-        }
-    }
-
-  /* Was anything written? */
-
-#if !defined(CONFIG_RAMLOG_NONBLOCKING) || !defined(CONFIG_DISABLE_POLL)
-  if (nwritten > 0)
+  if (ramlog_addbuf(priv, buffer, len) > 0)
     {
-      irqstate_t flags;
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      int i;
-#endif
-
-      /* Are there threads waiting for read data? */
+      /* Something was written.  Notify any waiting readers. */
 
-      flags = enter_critical_section();
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      for (i = 0; i < priv->rl_nwaiters; i++)
-        {
-          /* Yes.. Notify all of the waiting readers that more data is available */
-
-          nxsem_post(&priv->rl_waitsem);
-        }
-#endif
-
-      /* Notify all poll/select waiters that they can write to the FIFO */
-
-      ramlog_pollnotify(priv, POLLIN);
-      leave_critical_section(flags);
+      ramlog_readnotify(priv);
     }
-#endif
 
   /* We always have to return the number of bytes requested and NOT the
    * number of bytes that were actually written.  Otherwise, callers
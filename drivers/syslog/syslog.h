@@ -254,6 +254,74 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_async_ready
+ *
+ * Description:
+ *   Return true if formatted SYSLOG records may be passed to
+ *   syslog_async_write().  The first call from a task context after the OS
+ *   is ready will start the drain thread.  Until then, SYSLOG output must
+ *   use the direct path.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   True if the asynchronous SYSLOG drain is running.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+bool syslog_async_ready(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add one complete, formatted SYSLOG record to the ring of the current
+ *   CPU.  The record is written to the SYSLOG channel later by the drain
+ *   thread.  If the record does not fit, it is discarded and counted.
+ *
+ * Input Parameters:
+ *   buffer - The formatted record
+ *   buflen - The size of the record in bytes
+ *
+ * Returned Value:
+ *   The number of bytes accepted (buflen) on success; -ENOSPC if the
+ *   record was dropped.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+ssize_t syslog_async_write(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Write any records remaining in the per-CPU rings to the SYSLOG channel
+ *   using its force() method.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from crash-handling logic; interrupts may be disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_ASYNC
+void syslog_async_flush(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
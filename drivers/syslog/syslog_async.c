@@ -0,0 +1,477 @@
+/****************************************************************************
+ * drivers/syslog/syslog_async.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+#include <nuttx/sched.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/syslog/syslog.h>
+
+#ifdef CONFIG_SMP
+#  include <nuttx/spinlock.h>
+#endif
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SYSLOG_ASYNC_BUFSIZE
+#  define CONFIG_SYSLOG_ASYNC_BUFSIZE 1024
+#endif
+
+#if CONFIG_SYSLOG_ASYNC_BUFSIZE > 65535
+#  undef  CONFIG_SYSLOG_ASYNC_BUFSIZE
+#  define CONFIG_SYSLOG_ASYNC_BUFSIZE 65535
+#endif
+
+#ifndef CONFIG_SYSLOG_ASYNC_PRIORITY
+#  define CONFIG_SYSLOG_ASYNC_PRIORITY 50
+#endif
+
+#ifndef CONFIG_SYSLOG_ASYNC_STACKSIZE
+#  define CONFIG_SYSLOG_ASYNC_STACKSIZE 1024
+#endif
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NRINGS     CONFIG_SMP_NCPUS
+#  define syslog_cpu()      up_cpu_index()
+#  define SYSLOG_DMB()      SP_DMB()
+#else
+#  define SYSLOG_NRINGS     1
+#  define syslog_cpu()      (0)
+#  define SYSLOG_DMB()
+#endif
+
+/* Message emitted by the drain thread when records have been lost */
+
+#define SYSLOG_DROPPED_FORMAT "[syslog: %lu records dropped]\n"
+#define SYSLOG_DROPPED_SIZE   48
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One ring of formatted SYSLOG records.  There is one ring per CPU.  Only
+ * the owning CPU adds records, and it does so with local interrupts
+ * disabled so that each record is copied into the ring atomically with
+ * respect to other producers on that CPU.  Only the drain thread removes
+ * data.  Neither side takes a lock shared with the other to access the
+ * ring.
+ */
+
+struct syslog_ring_s
+{
+  volatile uint16_t sr_head;     /* Index of the next free byte */
+  volatile uint16_t sr_tail;     /* Index of the oldest unwritten byte */
+  volatile uint32_t sr_dropped;  /* Records lost to overflow (producer) */
+  uint32_t sr_reported;          /* Dropped records reported (consumer) */
+  char sr_buffer[CONFIG_SYSLOG_ASYNC_BUFSIZE];
+};
+
+/* State of the asynchronous SYSLOG drain */
+
+struct syslog_async_s
+{
+  volatile bool sa_ready;        /* True: The drain thread is running */
+  bool sa_starting;              /* True: The drain thread is being started */
+  sem_t sa_sem;                  /* Wakes up the drain thread */
+  struct syslog_ring_s sa_ring[SYSLOG_NRINGS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_async_s g_syslog_async;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_ring_drain
+ *
+ * Description:
+ *   Write all complete records in one ring to the SYSLOG channel.  At most
+ *   two writes are needed:  One up to the end of the ring buffer and one
+ *   for the part that wrapped to the beginning.
+ *
+ * Input Parameters:
+ *   ring  - The ring to be drained.
+ *   force - Use the force() method of the channel vs. the write() method.
+ *
+ * Returned Value:
+ *   The number of bytes removed from the ring.
+ *
+ ****************************************************************************/
+
+static size_t syslog_ring_drain(FAR struct syslog_ring_s *ring, bool force)
+{
+  FAR const char *data;
+  uint32_t dropped;
+  size_t total = 0;
+  size_t nbytes;
+  size_t head;
+  size_t tail;
+  char msg[SYSLOG_DROPPED_SIZE];
+
+  head = ring->sr_head;
+  tail = ring->sr_tail;
+  SYSLOG_DMB();
+
+  while (tail != head)
+    {
+      /* Get the contiguous span starting at the tail */
+
+      data   = &ring->sr_buffer[tail];
+      nbytes = (head > tail) ? head - tail :
+               CONFIG_SYSLOG_ASYNC_BUFSIZE - tail;
+
+      if (force)
+        {
+          size_t i;
+
+          for (i = 0; i < nbytes; i++)
+            {
+              g_syslog_channel->sc_force(data[i]);
+            }
+        }
+      else
+        {
+          (void)syslog_write(data, nbytes);
+        }
+
+      total += nbytes;
+      tail  += nbytes;
+      if (tail >= CONFIG_SYSLOG_ASYNC_BUFSIZE)
+        {
+          tail = 0;
+        }
+
+      /* Release the space to the producer only after the data has been
+       * consumed.
+       */
+
+      SYSLOG_DMB();
+      ring->sr_tail = (uint16_t)tail;
+    }
+
+  /* Report any records that were lost since the last time we looked */
+
+  dropped = ring->sr_dropped - ring->sr_reported;
+  if (dropped > 0)
+    {
+      int len = snprintf(msg, SYSLOG_DROPPED_SIZE, SYSLOG_DROPPED_FORMAT,
+                         (unsigned long)dropped);
+      int i;
+
+      ring->sr_reported += dropped;
+
+      if (force)
+        {
+          for (i = 0; i < len; i++)
+            {
+              g_syslog_channel->sc_force(msg[i]);
+            }
+        }
+      else
+        {
+          (void)syslog_write(msg, len);
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: syslog_async_thread
+ *
+ * Description:
+ *   The drain thread.  It waits until records are posted to any of the
+ *   per-CPU rings and then writes them to the SYSLOG channel in bulk.
+ *
+ ****************************************************************************/
+
+static int syslog_async_thread(int argc, FAR char *argv[])
+{
+  size_t nbytes;
+  int i;
+
+  g_syslog_async.sa_ready = true;
+
+  for (; ; )
+    {
+      /* Drain every ring until they are all observed empty */
+
+      do
+        {
+          nbytes = 0;
+          for (i = 0; i < SYSLOG_NRINGS; i++)
+            {
+              nbytes += syslog_ring_drain(&g_syslog_async.sa_ring[i], false);
+            }
+        }
+      while (nbytes > 0);
+
+      /* Then wait for more.  A producer posts the semaphore whenever it
+       * adds a record to an empty ring.
+       */
+
+      (void)nxsem_wait(&g_syslog_async.sa_sem);
+    }
+
+  return OK; /* Not reachable */
+}
+
+/****************************************************************************
+ * Name: syslog_async_start
+ *
+ * Description:
+ *   Start the drain thread.  This is deferred until the first SYSLOG
+ *   output after the OS is ready that is made from a task context.
+ *
+ ****************************************************************************/
+
+static void syslog_async_start(void)
+{
+  int pid;
+
+  sched_lock();
+  if (!g_syslog_async.sa_starting)
+    {
+      /* Mark the start as in progress first:  Any SYSLOG output generated
+       * while the thread is being created will use the direct path.
+       */
+
+      g_syslog_async.sa_starting = true;
+
+      nxsem_init(&g_syslog_async.sa_sem, 0, 0);
+      nxsem_setprotocol(&g_syslog_async.sa_sem, SEM_PRIO_NONE);
+
+      pid = kthread_create("syslog", CONFIG_SYSLOG_ASYNC_PRIORITY,
+                           CONFIG_SYSLOG_ASYNC_STACKSIZE,
+                           (main_t)syslog_async_thread,
+                           (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          /* Stay with the direct path and try again on a later call */
+
+          nxsem_destroy(&g_syslog_async.sa_sem);
+          g_syslog_async.sa_starting = false;
+        }
+    }
+
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_async_ready
+ *
+ * Description:
+ *   Return true if formatted SYSLOG records may be passed to
+ *   syslog_async_write().  The first call from a task context after the OS
+ *   is ready will start the drain thread.  Until then, SYSLOG output must
+ *   use the direct path.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   True if the asynchronous SYSLOG drain is running.
+ *
+ ****************************************************************************/
+
+bool syslog_async_ready(void)
+{
+  if (!g_syslog_async.sa_ready && !g_syslog_async.sa_starting &&
+      OSINIT_OS_READY() && !up_interrupt_context() && !sched_idletask())
+    {
+      syslog_async_start();
+    }
+
+  return g_syslog_async.sa_ready;
+}
+
+/****************************************************************************
+ * Name: syslog_async_write
+ *
+ * Description:
+ *   Add one complete, formatted SYSLOG record to the ring of the current
+ *   CPU.  This never blocks.  Only local interrupts are disabled while the
+ *   record is copied.  The global critical section is entered only by
+ *   nxsem_post() when the record is added to an empty ring and the drain
+ *   thread must be woken up.  If the record does not fit, it is discarded
+ *   and counted.  The drain thread will report the number of discarded
+ *   records.
+ *
+ *   This function may be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   buffer - The formatted record
+ *   buflen - The size of the record in bytes
+ *
+ * Returned Value:
+ *   The number of bytes accepted (buflen) on success; -ENOSPC if the
+ *   record was dropped.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_async_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_ring_s *ring;
+  irqstate_t flags;
+  size_t space;
+  size_t nbytes;
+  size_t head;
+  size_t tail;
+  bool wasempty;
+
+  if (buflen == 0)
+    {
+      return 0;
+    }
+
+  flags = up_irq_save();
+  ring  = &g_syslog_async.sa_ring[syslog_cpu()];
+  head  = ring->sr_head;
+  tail  = ring->sr_tail;
+
+  /* One byte is always left unused to distinguish full from empty */
+
+  space = (tail > head) ? tail - head - 1 :
+          CONFIG_SYSLOG_ASYNC_BUFSIZE - (head - tail) - 1;
+
+  if (buflen > space)
+    {
+      ring->sr_dropped++;
+      up_irq_restore(flags);
+      return -ENOSPC;
+    }
+
+  wasempty = (head == tail);
+
+  /* Copy the record, wrapping to the beginning of the ring if necessary */
+
+  nbytes = CONFIG_SYSLOG_ASYNC_BUFSIZE - head;
+  if (nbytes > buflen)
+    {
+      nbytes = buflen;
+    }
+
+  memcpy(&ring->sr_buffer[head], buffer, nbytes);
+  if (nbytes < buflen)
+    {
+      memcpy(ring->sr_buffer, &buffer[nbytes], buflen - nbytes);
+    }
+
+  head += buflen;
+  if (head >= CONFIG_SYSLOG_ASYNC_BUFSIZE)
+    {
+      head -= CONFIG_SYSLOG_ASYNC_BUFSIZE;
+    }
+
+  /* Publish the record only after its data is in place */
+
+  SYSLOG_DMB();
+  ring->sr_head = (uint16_t)head;
+  up_irq_restore(flags);
+
+  /* Wake up the drain thread if the ring was empty.  Otherwise, the thread
+   * has not yet observed this ring as empty and will get to it anyway.
+   */
+
+  if (wasempty)
+    {
+      (void)nxsem_post(&g_syslog_async.sa_sem);
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_async_flush
+ *
+ * Description:
+ *   Write any records remaining in the per-CPU rings to the SYSLOG channel
+ *   using its force() method.  This is called from syslog_flush() by
+ *   crash-handling logic when the drain thread may no longer run.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syslog_async_flush(void)
+{
+  int i;
+
+  if (g_syslog_async.sa_ready)
+    {
+      for (i = 0; i < SYSLOG_NRINGS; i++)
+        {
+          (void)syslog_ring_drain(&g_syslog_async.sa_ring[i], true);
+        }
+    }
+}
+
+#endif /* CONFIG_SYSLOG_ASYNC */
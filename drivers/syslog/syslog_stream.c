@@ -41,6 +41,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -188,6 +189,87 @@ static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
     }
 }
 
+/****************************************************************************
+ * Name: syslogstream_puts
+ ****************************************************************************/
+
+static void syslogstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const void *buf, int len)
+{
+  FAR const char *ptr = (FAR const char *)buf;
+
+#ifdef CONFIG_SYSLOG_BUFFER
+  FAR struct lib_syslogstream_s *stream =
+    (FAR struct lib_syslogstream_s *)this;
+
+  DEBUGASSERT(stream != NULL);
+
+  /* Do we have an IO buffer? */
+
+  if (stream->iob != NULL)
+    {
+      FAR struct iob_s *iob = stream->iob;
+      int nbytes;
+      int space;
+
+      while (len > 0)
+        {
+          /* Make sure that there is space in the buffer.  If the flush
+           * fails, the remainder of the block is lost.
+           */
+
+          if (iob->io_len >= CONFIG_IOB_BUFSIZE &&
+              syslogstream_flush(stream) < 0)
+            {
+              return;
+            }
+
+          /* Find the run of characters that can be copied directly into
+           * the buffer.  Carriage returns and linefeeds need translation
+           * and are handled by syslogstream_putc().
+           */
+
+          space = CONFIG_IOB_BUFSIZE - iob->io_len;
+          for (nbytes = 0;
+               nbytes < len && nbytes < space &&
+               ptr[nbytes] != '\n' && ptr[nbytes] != '\r';
+               nbytes++);
+
+          if (nbytes > 0)
+            {
+              memcpy(&iob->io_data[iob->io_len], ptr, nbytes);
+              iob->io_len         += nbytes;
+              stream->public.nput += nbytes;
+
+              if (iob->io_len >= CONFIG_IOB_BUFSIZE)
+                {
+                  syslogstream_flush(stream);
+                }
+            }
+          else
+            {
+              syslogstream_putc(this, *ptr);
+              nbytes = 1;
+            }
+
+          ptr += nbytes;
+          len -= nbytes;
+        }
+    }
+  else
+#endif
+    {
+      /* No buffering.. each character must go to the SYSLOG device
+       * individually.
+       */
+
+      while (len-- > 0)
+        {
+          syslogstream_putc(this, *ptr++);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -219,6 +301,7 @@ void syslogstream_create(FAR struct lib_syslogstream_s *stream)
   /* Initialize the common fields */
 
   stream->public.put   = syslogstream_putc;
+  stream->public.puts  = syslogstream_puts;
   stream->public.flush = lib_noflush;
   stream->public.nput  = 0;
 
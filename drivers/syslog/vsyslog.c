@@ -49,6 +49,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -69,6 +71,12 @@
 int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 {
   struct lib_syslogstream_s stream;
+  FAR struct lib_outstream_s *outstream = &stream.public;
+#ifdef CONFIG_SYSLOG_ASYNC
+  struct lib_memoutstream_s memstream;
+  char record[CONFIG_SYSLOG_ASYNC_RECSIZE];
+  bool async = false;
+#endif
   int ret;
 
 #ifdef CONFIG_SYSLOG_TIMESTAMP
@@ -121,6 +129,18 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
       emergstream(&stream.public);
     }
+#ifdef CONFIG_SYSLOG_ASYNC
+  else if (syslog_async_ready())
+    {
+      /* Format the whole record in memory.  It will be passed to the
+       * per-CPU ring as a unit when it is complete.
+       */
+
+      lib_memoutstream(&memstream, record, CONFIG_SYSLOG_ASYNC_RECSIZE);
+      outstream = &memstream.public;
+      async     = true;
+    }
+#endif
   else
     {
       /* Use the normal SYSLOG stream */
@@ -131,7 +151,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #if defined(CONFIG_SYSLOG_TIMESTAMP)
   /* Pre-pend the message with the current time, if available */
 
-  ret = lib_sprintf(&stream.public, "[%5d.%06d] ",
+  ret = lib_sprintf(outstream, "[%5d.%06d] ",
                     ts.tv_sec, ts.tv_nsec/1000);
 #else
   ret = 0;
@@ -140,12 +160,22 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #if defined(CONFIG_SYSLOG_PREFIX)
   /* Pre-pend the prefix, if available */
 
-  ret += lib_sprintf(&stream.public, "%s", CONFIG_SYSLOG_PREFIX_STRING);
+  ret += lib_sprintf(outstream, "%s", CONFIG_SYSLOG_PREFIX_STRING);
 #endif
 
   /* Generate the output */
 
-  ret += lib_vsprintf(&stream.public, fmt, *ap);
+  ret += lib_vsprintf(outstream, fmt, *ap);
+
+#ifdef CONFIG_SYSLOG_ASYNC
+  if (async)
+    {
+      /* Hand the complete record to the drain thread */
+
+      (void)syslog_async_write(record, memstream.public.nput);
+      return ret;
+    }
+#endif
 
 #ifdef CONFIG_SYSLOG_BUFFER
   /* Flush and destroy the syslog stream buffer */
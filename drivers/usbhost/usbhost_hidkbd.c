@@ -978,6 +978,7 @@ static inline void usbhost_encodescancode(FAR struct usbhost_state_s *priv,
           /* And it does correspond to a special function key */
 
           usbstream.stream.put  = usbhost_putstream;
+          usbstream.stream.puts = lib_noputs;
           usbstream.stream.nput = 0;
           usbstream.priv        = priv;
 
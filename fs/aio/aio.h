@@ -46,6 +46,7 @@
 #include <string.h>
 #include <aio.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
@@ -78,6 +79,51 @@
 #  error AIO needs file and/or socket descriptors
 #endif
 
+/* Dedicated AIO worker threads */
+
+#ifdef CONFIG_FS_AIO_WORKERS
+#  ifndef CONFIG_FS_AIO_NWORKERS
+#    define CONFIG_FS_AIO_NWORKERS 2
+#  endif
+
+#  ifndef CONFIG_FS_AIO_WORKER_PRIORITY
+#    define CONFIG_FS_AIO_WORKER_PRIORITY 100
+#  endif
+
+#  ifndef CONFIG_FS_AIO_WORKER_STACKSIZE
+#    define CONFIG_FS_AIO_WORKER_STACKSIZE 2048
+#  endif
+
+#  ifndef CONFIG_FS_AIO_COALESCE
+#    define CONFIG_FS_AIO_COALESCE 4096
+#  endif
+
+/* The maximum number of requests that may be merged into one transfer */
+
+#  define AIO_MAXCOALESCE 8
+
+/* Only requests on files are merged */
+
+#  undef AIO_HAVE_COALESCE
+#  if CONFIG_FS_AIO_COALESCE > 0 && defined(AIO_HAVE_FILEP)
+#    define AIO_HAVE_COALESCE
+#  endif
+#endif
+
+/* When I/O is performed on the low priority work queue, the priority of
+ * the work queue is boosted when the I/O is queued and must be restored
+ * by the worker.  The dedicated AIO worker threads manage their own
+ * priority.
+ */
+
+#if !defined(CONFIG_PRIORITY_INHERITANCE)
+#  define aio_restorepriority(prio)
+#elif defined(CONFIG_FS_AIO_WORKERS)
+#  define aio_restorepriority(prio) UNUSED(prio)
+#else
+#  define aio_restorepriority(prio) lpwork_restorepriority(prio)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -87,6 +133,7 @@
  */
 
 struct file;
+struct aio_ring_s;
 struct aio_container_s
 {
   dq_entry_t aioc_link;            /* Supports a doubly linked list */
@@ -101,13 +148,40 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#ifdef CONFIG_FS_AIO_WORKERS
+  worker_t aioc_worker;            /* I/O worker; non-NULL while queued */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *aioc_ring; /* Completion ring (see io_submit()) */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
 };
 
+#ifdef CONFIG_FS_AIO_RING
+/* This structure describes one io_setup() context:  A ring of completed
+ * AIO control blocks that have not yet been reaped by io_getevents().
+ */
+
+struct aio_ring_s
+{
+  sem_t ar_sem;                    /* Counts completed, unreaped requests */
+  uint16_t ar_nevents;             /* Size of the completion ring */
+  uint16_t ar_inflight;            /* Submitted but not yet reaped */
+  uint16_t ar_head;                /* Index of the next completion to reap */
+  uint16_t ar_tail;                /* Index of the next free ring entry */
+  FAR struct aiocb *ar_events[1];  /* Completion ring (actual size is
+                                    * ar_nevents) */
+};
+
+#define SIZEOF_AIO_RING_S(n) \
+  (sizeof(struct aio_ring_s) + ((n) - 1) * sizeof(FAR struct aiocb *))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -258,6 +332,46 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Attempt to remove queued asynchronous I/O before it has been started.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+/****************************************************************************
+ * Name: aio_read_worker, aio_write_worker, aio_fsync_worker
+ *
+ * Description:
+ *   These functions perform the I/O for one queued AIO container.  They
+ *   are passed to aio_queue() and run on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Worker argument.  In this case, a pointer to an instance of
+ *     struct aio_container_s cast to void *.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_read_worker(FAR void *arg);
+void aio_write_worker(FAR void *arg);
+void aio_fsync_worker(FAR void *arg);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -277,6 +391,28 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
 int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
 
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Add a completed AIO control block to the completion ring of the
+ *   io_setup() context that it was submitted with.
+ *
+ * Input Parameters:
+ *   ring   - The completion ring.  May be NULL if the I/O was not
+ *            submitted with io_submit().
+ *   aiocbp - Pointer to the completed asynchronous I/O control block
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_RING
+void aio_ring_complete(FAR struct aio_ring_s *ring,
+                       FAR struct aiocb *aiocbp);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
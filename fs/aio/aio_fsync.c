@@ -53,7 +53,7 @@
 #ifdef CONFIG_FS_AIO
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -72,7 +72,7 @@
  *
  ****************************************************************************/
 
-static void aio_fsync_worker(FAR void *arg)
+void aio_fsync_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
@@ -80,6 +80,14 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *ring;
+#endif
+  union
+  {
+    FAR struct file *aioc_filep;
+    FAR void *ptr;
+  } u;
   int ret;
 
   /* Get the information from the container, decant the AIO control block,
@@ -92,11 +100,15 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  ring   = aioc->aioc_ring;
+#endif
+  u.ptr  = aioc->u.ptr;
   aiocbp = aioc_decant(aioc);
 
   /* Perform the fsync using u.aioc_filep */
 
-  ret = file_fsync(aioc->u.aioc_filep);
+  ret = file_fsync(u.aioc_filep);
   if (ret < 0)
     {
       ferr("ERROR: file_fsync failed: %d\n", ret);
@@ -110,18 +122,15 @@ static void aio_fsync_worker(FAR void *arg)
   /* Signal the client */
 
   (void)aio_signal(pid, aiocbp);
+#ifdef CONFIG_FS_AIO_RING
+  aio_ring_complete(ring, aiocbp);
+#endif
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
-  lpwork_restorepriority(prio);
-#endif
+  aio_restorepriority(prio);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: aio_fsync
  *
@@ -48,10 +48,10 @@
 
 #include "aio/aio.h"
 
-#ifdef CONFIG_FS_AIO
+#if defined(CONFIG_FS_AIO) && !defined(CONFIG_FS_AIO_WORKERS)
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -107,4 +107,29 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
-#endif /* CONFIG_FS_AIO */
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Attempt to remove queued asynchronous I/O before it has been started.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  /* work_cancel() will return -ENOENT if the work is no longer queued */
+
+  return work_cancel(LPWORK, &aioc->aioc_work);
+}
+
+#endif /* CONFIG_FS_AIO && !CONFIG_FS_AIO_WORKERS */
@@ -53,7 +53,7 @@
 #ifdef CONFIG_FS_AIO
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -72,7 +72,7 @@
  *
  ****************************************************************************/
 
-static void aio_read_worker(FAR void *arg)
+void aio_read_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
@@ -80,6 +80,19 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *ring;
+#endif
+  union
+  {
+#ifdef AIO_HAVE_FILEP
+    FAR struct file *aioc_filep;
+#endif
+#ifdef AIO_HAVE_PSOCK
+    FAR struct socket *aioc_psock;
+#endif
+    FAR void *ptr;
+  } u;
   ssize_t nread = 0;
 
   /* Get the information from the container, decant the AIO control block,
@@ -92,6 +105,10 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  ring   = aioc->aioc_ring;
+#endif
+  u.ptr  = aioc->u.ptr;
   aiocbp = aioc_decant(aioc);
 
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
@@ -107,7 +124,7 @@ static void aio_read_worker(FAR void *arg)
        *   aio_offset   - File offset
        */
 
-     nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf,
+     nread = file_pread(u.aioc_filep, (FAR void *)aiocbp->aio_buf,
                         aiocbp->aio_nbytes, aiocbp->aio_offset);
     }
 #endif
@@ -123,7 +140,7 @@ static void aio_read_worker(FAR void *arg)
        *   aio_nbytes   - Length of transfer
        */
 
-      nread = psock_recv(aioc->u.aioc_psock, (FAR void *)aiocbp->aio_buf,
+      nread = psock_recv(u.aioc_psock, (FAR void *)aiocbp->aio_buf,
                          aiocbp->aio_nbytes, 0);
     }
 #endif
@@ -142,18 +159,15 @@ static void aio_read_worker(FAR void *arg)
   /* Signal the client */
 
   (void)aio_signal(pid, aiocbp);
+#ifdef CONFIG_FS_AIO_RING
+  aio_ring_complete(ring, aiocbp);
+#endif
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
-  lpwork_restorepriority(prio);
-#endif
+  aio_restorepriority(prio);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: aio_read
  *
@@ -0,0 +1,389 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/aio_ring.h>
+#include <sched.h>
+#include <time.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_RING)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Queue one request on an I/O context.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int aio_ring_submit(FAR struct aio_ring_s *ring,
+                           FAR struct aiocb *aiocbp)
+{
+  FAR struct aio_container_s *aioc;
+  worker_t worker;
+  int ret;
+
+  switch (aiocbp->aio_lio_opcode)
+    {
+      case LIO_READ:
+        worker = aio_read_worker;
+        break;
+
+      case LIO_WRITE:
+        worker = aio_write_worker;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  /* Never allow more requests in flight than the ring can hold.  The slot
+   * is reserved under the AIO lock because completions release slots
+   * concurrently.
+   */
+
+  aio_lock();
+  if (ring->ar_inflight >= ring->ar_nevents)
+    {
+      aio_unlock();
+      return -EAGAIN;
+    }
+
+  ring->ar_inflight++;
+  aio_unlock();
+
+  /* The result -EINPROGRESS means that the transfer has not yet completed */
+
+  aiocbp->aio_result = -EINPROGRESS;
+  aiocbp->aio_priv   = NULL;
+
+  /* Create a container for the AIO control block.  This may cause us to
+   * block if there are insufficient resources to satisfy the request.
+   */
+
+  aioc = aio_contain(aiocbp);
+  if (aioc == NULL)
+    {
+      ret = -get_errno();
+      aiocbp->aio_result = ret;
+      goto errout_with_slot;
+    }
+
+  aioc->aioc_ring = ring;
+
+  /* Defer the work to the worker thread */
+
+  ret = aio_queue(aioc, worker);
+  if (ret < 0)
+    {
+      ret = aiocbp->aio_result;
+      goto errout_with_slot;
+    }
+
+  return OK;
+
+errout_with_slot:
+  aio_lock();
+  ring->ar_inflight--;
+  aio_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Add a completed AIO control block to the completion ring of the
+ *   io_setup() context that it was submitted with.
+ *
+ * Input Parameters:
+ *   ring   - The completion ring.  May be NULL if the I/O was not
+ *            submitted with io_submit().
+ *   aiocbp - Pointer to the completed asynchronous I/O control block
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_ring_complete(FAR struct aio_ring_s *ring,
+                       FAR struct aiocb *aiocbp)
+{
+  if (ring != NULL)
+    {
+      /* There is always space in the ring because no more than ar_nevents
+       * requests may be in flight.
+       */
+
+      aio_lock();
+      ring->ar_events[ring->ar_tail] = aiocbp;
+      if (++ring->ar_tail >= ring->ar_nevents)
+        {
+          ring->ar_tail = 0;
+        }
+
+      aio_unlock();
+      nxsem_post(&ring->ar_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: io_setup
+ *
+ * Description:
+ *   Create an asynchronous I/O context.  See include/sys/aio_ring.h.
+ *
+ ****************************************************************************/
+
+int io_setup(unsigned int nevents, FAR io_context_t *ctxp)
+{
+  FAR struct aio_ring_s *ring;
+
+  if (nevents == 0 || nevents > UINT16_MAX || ctxp == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  ring = (FAR struct aio_ring_s *)kmm_zalloc(SIZEOF_AIO_RING_S(nevents));
+  if (ring == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&ring->ar_sem, 0, 0);
+  nxsem_setprotocol(&ring->ar_sem, SEM_PRIO_NONE);
+
+  ring->ar_nevents = nevents;
+  *ctxp = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: io_destroy
+ *
+ * Description:
+ *   Destroy an I/O context.  See include/sys/aio_ring.h.
+ *
+ ****************************************************************************/
+
+int io_destroy(io_context_t ctx)
+{
+  int errcode;
+
+  if (ctx == NULL)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  aio_lock();
+  if (ctx->ar_inflight > 0)
+    {
+      aio_unlock();
+      errcode = EBUSY;
+      goto errout;
+    }
+
+  aio_unlock();
+
+  nxsem_destroy(&ctx->ar_sem);
+  kmm_free(ctx);
+  return OK;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: io_submit
+ *
+ * Description:
+ *   Queue a batch of asynchronous I/O requests.  See include/sys/aio_ring.h.
+ *
+ ****************************************************************************/
+
+int io_submit(io_context_t ctx, int nr, FAR struct aiocb * const list[])
+{
+  int nsubmitted;
+  int ret = OK;
+
+  if (ctx == NULL || nr < 0 || (nr > 0 && list == NULL))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Keep the worker threads from starting until the whole batch has been
+   * queued so that adjacent requests can be merged.
+   */
+
+  sched_lock();
+
+  for (nsubmitted = 0; nsubmitted < nr; nsubmitted++)
+    {
+      DEBUGASSERT(list[nsubmitted] != NULL);
+
+      ret = aio_ring_submit(ctx, list[nsubmitted]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  sched_unlock();
+
+  if (nsubmitted == 0 && ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return nsubmitted;
+}
+
+/****************************************************************************
+ * Name: io_getevents
+ *
+ * Description:
+ *   Collect completed requests from an I/O context.  See
+ *   include/sys/aio_ring.h.
+ *
+ ****************************************************************************/
+
+int io_getevents(io_context_t ctx, int min_nr, int nr,
+                 FAR struct aiocb *events[],
+                 FAR const struct timespec *timeout)
+{
+  struct timespec abstime;
+  int nreaped;
+  int ret = OK;
+
+  if (ctx == NULL || events == NULL || min_nr < 0 || nr < min_nr)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  if (timeout != NULL)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &abstime);
+      clock_timespec_add(&abstime, timeout, &abstime);
+    }
+
+  for (nreaped = 0; nreaped < nr; nreaped++)
+    {
+      /* Wait for the first 'min_nr' completions; just take any others that
+       * are already available.
+       */
+
+      if (nreaped >= min_nr)
+        {
+          ret = nxsem_trywait(&ctx->ar_sem);
+        }
+      else if (timeout != NULL)
+        {
+          ret = nxsem_timedwait(&ctx->ar_sem, &abstime);
+        }
+      else
+        {
+          ret = nxsem_wait(&ctx->ar_sem);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Remove the next completed request from the ring */
+
+      aio_lock();
+      events[nreaped] = ctx->ar_events[ctx->ar_head];
+      if (++ctx->ar_head >= ctx->ar_nevents)
+        {
+          ctx->ar_head = 0;
+        }
+
+      ctx->ar_inflight--;
+      aio_unlock();
+    }
+
+  /* Only an interruption before anything was reaped is an error.  An
+   * expired timeout or no more completed requests is not.
+   */
+
+  if (nreaped == 0 && ret == -EINTR)
+    {
+      set_errno(EINTR);
+      return ERROR;
+    }
+
+  return nreaped;
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_AIO_RING */
@@ -0,0 +1,633 @@
+/****************************************************************************
+ * fs/aio/aio_worker.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_WORKERS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of one AIO worker thread */
+
+struct aio_worker_s
+{
+  pid_t aw_pid;          /* Task ID of the worker thread */
+  FAR void *aw_busy;     /* File or socket with I/O in progress (or NULL) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The state of each worker thread */
+
+static struct aio_worker_s g_aio_worker[CONFIG_FS_AIO_NWORKERS];
+
+/* Worker threads wait on this semaphore when there is no work available */
+
+static sem_t g_aio_worksem;
+
+/* True when the worker threads have been started */
+
+static bool g_aio_started;
+
+/* The number of worker threads that were actually created */
+
+static int g_aio_nworkers;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_isbusy
+ *
+ * Description:
+ *   Return true if any worker thread is currently performing I/O on the
+ *   file or socket.  Requests on the same file or socket are performed
+ *   in the order that they were queued, one at a time.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static bool aio_isbusy(FAR void *ptr)
+{
+  int i;
+
+  for (i = 0; i < g_aio_nworkers; i++)
+    {
+      if (g_aio_worker[i].aw_busy == ptr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_canmerge
+ *
+ * Description:
+ *   Return true if the queued request 'next' may be merged into the same
+ *   transfer as 'prev':  Both must be reads or both must be (non-appending)
+ *   writes on the same file and 'next' must begin at the file offset
+ *   where 'prev' ends.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_COALESCE
+static bool aio_canmerge(FAR struct aio_container_s *prev,
+                         FAR struct aio_container_s *next, worker_t worker,
+                         size_t total)
+{
+  FAR struct aiocb *prevcb = prev->aioc_aiocbp;
+  FAR struct aiocb *nextcb = next->aioc_aiocbp;
+
+  return next->aioc_worker == worker &&
+         next->u.ptr == prev->u.ptr &&
+         nextcb->aio_offset == prevcb->aio_offset +
+                               (off_t)prevcb->aio_nbytes &&
+         total + nextcb->aio_nbytes <= CONFIG_FS_AIO_COALESCE;
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_select
+ *
+ * Description:
+ *   Select the oldest queued request on a file or socket that is not
+ *   already being serviced by another worker thread.  Subsequent queued
+ *   requests that may be merged with the selected request are also
+ *   returned.  All selected requests are removed from the queue.
+ *
+ * Input Parameters:
+ *   wndx  - The index of the calling worker thread
+ *   group - Receives the selected AIO containers in file offset order
+ *
+ * Returned Value:
+ *   The number of selected containers (zero if there is no work).
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static int aio_select(int wndx, FAR struct aio_container_s **group)
+{
+  FAR struct aio_container_s *aioc;
+  worker_t worker;
+  int ngroup;
+
+  /* Find the first queued request on an idle file or socket */
+
+  for (aioc = (FAR struct aio_container_s *)g_aio_pending.head;
+       aioc != NULL && (aioc->aioc_worker == NULL || aio_isbusy(aioc->u.ptr));
+       aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink);
+
+  if (aioc == NULL)
+    {
+      return 0;
+    }
+
+  /* Claim the file or socket for this worker thread */
+
+  g_aio_worker[wndx].aw_busy = aioc->u.ptr;
+  worker                     = aioc->aioc_worker;
+  group[0]                   = aioc;
+  ngroup                     = 1;
+
+#ifdef AIO_HAVE_COALESCE
+  /* Merge queued requests for contiguous regions of the same file */
+
+#ifdef AIO_HAVE_PSOCK
+  if (aioc->aioc_aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS &&
+#else
+  if (
+#endif
+      (worker == aio_read_worker ||
+       (worker == aio_write_worker &&
+        (aioc->u.aioc_filep->f_oflags & O_APPEND) == 0)))
+    {
+      FAR struct aio_container_s *next;
+      size_t total = aioc->aioc_aiocbp->aio_nbytes;
+
+      for (next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+           next != NULL && ngroup < AIO_MAXCOALESCE;
+           next = (FAR struct aio_container_s *)next->aioc_link.flink)
+        {
+          if (next->aioc_worker == NULL || next->u.ptr != aioc->u.ptr)
+            {
+              /* Not queued or a different file */
+
+              continue;
+            }
+
+          /* Stop at the first request on this file that cannot be merged.
+           * Requests on the same file must not be reordered.
+           */
+
+          if (!aio_canmerge(group[ngroup - 1], next, worker, total))
+            {
+              break;
+            }
+
+          total          += next->aioc_aiocbp->aio_nbytes;
+          group[ngroup++] = next;
+        }
+    }
+#endif
+
+  return ngroup;
+}
+
+/****************************************************************************
+ * Name: aio_setpriority
+ *
+ * Description:
+ *   Change the priority of the calling worker thread.  The worker runs at
+ *   least at the priority of the task that is waiting for the I/O and then
+ *   returns to its default priority.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static void aio_setpriority(int priority)
+{
+  struct sched_param param;
+
+  param.sched_priority = priority;
+  (void)nxsched_setparam(0, &param);
+}
+
+#  define aio_boostpriority(p) \
+     do \
+       { \
+         if ((p) > CONFIG_FS_AIO_WORKER_PRIORITY) \
+           { \
+             aio_setpriority(p); \
+           } \
+       } \
+     while (0)
+#  define aio_workerpriority() aio_setpriority(CONFIG_FS_AIO_WORKER_PRIORITY)
+#else
+#  define aio_boostpriority(p)
+#  define aio_workerpriority()
+#endif
+
+/****************************************************************************
+ * Name: aio_merged
+ *
+ * Description:
+ *   Perform several queued reads or writes of contiguous regions of the
+ *   same file as one larger transfer through a kernel bounce buffer.
+ *
+ * Input Parameters:
+ *   group  - The AIO containers, in file offset order
+ *   ngroup - The number of AIO containers (at least two)
+ *   worker - The worker that would perform each individual request
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_COALESCE
+static void aio_merged(FAR struct aio_container_s **group, int ngroup,
+                       worker_t worker)
+{
+  FAR struct aiocb *aiocbp[AIO_MAXCOALESCE];
+  pid_t pid[AIO_MAXCOALESCE];
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *ring[AIO_MAXCOALESCE];
+#endif
+  FAR struct file *filep;
+  FAR uint8_t *buffer;
+  bool isread = (worker == aio_read_worker);
+  ssize_t nxfer;
+  off_t offset;
+  size_t total;
+  size_t pos;
+  int i;
+
+  for (total = 0, i = 0; i < ngroup; i++)
+    {
+      total += group[i]->aioc_aiocbp->aio_nbytes;
+    }
+
+  /* Allocate the bounce buffer.  If that fails, just perform each
+   * request individually.
+   */
+
+  buffer = (FAR uint8_t *)kmm_malloc(total);
+  if (buffer == NULL)
+    {
+      for (i = 0; i < ngroup; i++)
+        {
+          worker(group[i]);
+        }
+
+      return;
+    }
+
+  /* Get the information from the containers, then decant the AIO control
+   * blocks and free the containers before starting the I/O.
+   */
+
+  filep  = group[0]->u.aioc_filep;
+  offset = group[0]->aioc_aiocbp->aio_offset;
+
+  for (i = 0; i < ngroup; i++)
+    {
+      pid[i]    = group[i]->aioc_pid;
+#ifdef CONFIG_FS_AIO_RING
+      ring[i]   = group[i]->aioc_ring;
+#endif
+      aiocbp[i] = aioc_decant(group[i]);
+    }
+
+  /* Perform the transfer */
+
+  if (isread)
+    {
+      nxfer = file_pread(filep, buffer, total, offset);
+    }
+  else
+    {
+      for (pos = 0, i = 0; i < ngroup; i++)
+        {
+          memcpy(&buffer[pos], (FAR const void *)aiocbp[i]->aio_buf,
+                 aiocbp[i]->aio_nbytes);
+          pos += aiocbp[i]->aio_nbytes;
+        }
+
+      nxfer = file_pwrite(filep, buffer, total, offset);
+    }
+
+  if (nxfer < 0)
+    {
+      ferr("ERROR: merged %s failed: %d\n",
+           isread ? "pread" : "pwrite", (int)nxfer);
+    }
+
+  /* Distribute the results and signal the clients */
+
+  for (pos = 0, i = 0; i < ngroup; i++)
+    {
+      ssize_t result = nxfer;
+
+      if (nxfer >= 0)
+        {
+          /* Each request gets its share of a short transfer */
+
+          result = (size_t)nxfer > pos ? (ssize_t)(nxfer - pos) : 0;
+          if ((size_t)result > aiocbp[i]->aio_nbytes)
+            {
+              result = aiocbp[i]->aio_nbytes;
+            }
+
+          if (isread && result > 0)
+            {
+              memcpy((FAR void *)aiocbp[i]->aio_buf, &buffer[pos], result);
+            }
+        }
+
+      pos += aiocbp[i]->aio_nbytes;
+      aiocbp[i]->aio_result = result;
+
+      (void)aio_signal(pid[i], aiocbp[i]);
+#ifdef CONFIG_FS_AIO_RING
+      aio_ring_complete(ring[i], aiocbp[i]);
+#endif
+    }
+
+  kmm_free(buffer);
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_thread
+ *
+ * Description:
+ *   The main loop of each AIO worker thread.
+ *
+ ****************************************************************************/
+
+static int aio_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *group[AIO_MAXCOALESCE];
+  worker_t worker;
+  pid_t me = getpid();
+  int wndx;
+  int ngroup;
+  int i;
+
+  /* Find our index in g_aio_worker.  The loop waits until aio_start() has
+   * recorded our task ID.
+   */
+
+  aio_lock();
+  for (wndx = 0; g_aio_worker[wndx].aw_pid != me; wndx++)
+    {
+      DEBUGASSERT(wndx < g_aio_nworkers - 1);
+    }
+
+  for (; ; )
+    {
+      /* Get the next work (we still hold the AIO lock) */
+
+      ngroup = aio_select(wndx, group);
+      if (ngroup == 0)
+        {
+          /* Nothing to do.  Wait for more work */
+
+          aio_unlock();
+          (void)nxsem_wait_uninterruptible(&g_aio_worksem);
+          aio_lock();
+          continue;
+        }
+
+      /* Mark the selected requests as started so that they can no longer
+       * be canceled.
+       */
+
+      worker = group[0]->aioc_worker;
+      for (i = 0; i < ngroup; i++)
+        {
+          group[i]->aioc_worker = NULL;
+        }
+
+      /* Perform the I/O with the AIO lock released */
+
+      aio_boostpriority(group[0]->aioc_prio);
+      aio_unlock();
+
+#ifdef AIO_HAVE_COALESCE
+      if (ngroup > 1)
+        {
+          aio_merged(group, ngroup, worker);
+        }
+      else
+#endif
+        {
+          worker(group[0]);
+        }
+
+      aio_workerpriority();
+
+      /* Release the file or socket.  There may be queued requests for the
+       * same file that another worker could not start.  We will re-check
+       * for such work before waiting again.
+       */
+
+      aio_lock();
+      g_aio_worker[wndx].aw_busy = NULL;
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO worker threads.  This is deferred until the first I/O is
+ *   queued because aio_initialize() runs before kernel threads can be
+ *   created.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static int aio_start(void)
+{
+  pid_t pid;
+  int wndx;
+
+  (void)nxsem_init(&g_aio_worksem, 0, 0);
+  nxsem_setprotocol(&g_aio_worksem, SEM_PRIO_NONE);
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NWORKERS; wndx++)
+    {
+      pid = kthread_create("aio", CONFIG_FS_AIO_WORKER_PRIORITY,
+                           CONFIG_FS_AIO_WORKER_STACKSIZE,
+                           (main_t)aio_thread, (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          ferr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+          if (wndx == 0)
+            {
+              return (int)pid;
+            }
+
+          /* Continue with the workers that could be created */
+
+          break;
+        }
+
+      g_aio_worker[wndx].aw_pid = pid;
+    }
+
+  g_aio_nworkers = wndx;
+  g_aio_started  = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_queue
+ *
+ * Description:
+ *   Schedule the asynchronous I/O on the AIO worker threads
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container holding the I/O request
+ *   worker - The function that will perform the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  int semcount;
+  int ret = OK;
+
+  aio_lock();
+
+  /* Start the worker threads on first use */
+
+  if (!g_aio_started)
+    {
+      ret = aio_start();
+    }
+
+  if (ret < 0)
+    {
+      FAR struct aiocb *aiocbp = aioc_decant(aioc);
+      DEBUGASSERT(aiocbp);
+
+      aio_unlock();
+      aiocbp->aio_result = ret;
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  /* Mark the container as queued.  The container is already in the list
+   * of pending I/O where the worker threads will find it.
+   */
+
+  aioc->aioc_worker = worker;
+
+  /* Wake up a worker thread if one is waiting.  If all workers are busy,
+   * the request will be picked up as soon as one of them finishes.
+   */
+
+  (void)nxsem_getvalue(&g_aio_worksem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&g_aio_worksem);
+    }
+
+  aio_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Attempt to remove queued asynchronous I/O before it has been started.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  if (aioc->aioc_worker == NULL)
+    {
+      return -ENOENT;
+    }
+
+  aioc->aioc_worker = NULL;
+  return OK;
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_AIO_WORKERS */
@@ -73,6 +73,10 @@ static inline int file_fcntl(FAR struct file *filep, int cmd, ...)
 }
 #endif
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_write_worker
  *
@@ -89,7 +93,7 @@ static inline int file_fcntl(FAR struct file *filep, int cmd, ...)
  *
  ****************************************************************************/
 
-static void aio_write_worker(FAR void *arg)
+void aio_write_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
@@ -97,6 +101,19 @@ static void aio_write_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *ring;
+#endif
+  union
+  {
+#ifdef AIO_HAVE_FILEP
+    FAR struct file *aioc_filep;
+#endif
+#ifdef AIO_HAVE_PSOCK
+    FAR struct socket *aioc_psock;
+#endif
+    FAR void *ptr;
+  } u;
   ssize_t nwritten = 0;
 #ifdef AIO_HAVE_FILEP
   int oflags;
@@ -112,6 +129,10 @@ static void aio_write_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  ring   = aioc->aioc_ring;
+#endif
+  u.ptr  = aioc->u.ptr;
   aiocbp = aioc_decant(aioc);
 
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
@@ -121,7 +142,7 @@ static void aio_write_worker(FAR void *arg)
     {
       /* Call fcntl(F_GETFL) to get the file open mode. */
 
-      oflags = file_fcntl(aioc->u.aioc_filep, F_GETFL);
+      oflags = file_fcntl(u.aioc_filep, F_GETFL);
       if (oflags < 0)
         {
           ferr("ERROR: file_fcntl failed: %d\n", oflags);
@@ -143,13 +164,13 @@ static void aio_write_worker(FAR void *arg)
         {
           /* Append to the current file position */
 
-          nwritten = file_write(aioc->u.aioc_filep,
+          nwritten = file_write(u.aioc_filep,
                                 (FAR const void *)aiocbp->aio_buf,
                                 aiocbp->aio_nbytes);
         }
       else
         {
-          nwritten = file_pwrite(aioc->u.aioc_filep,
+          nwritten = file_pwrite(u.aioc_filep,
                                  (FAR const void *)aiocbp->aio_buf,
                                  aiocbp->aio_nbytes,
                                  aiocbp->aio_offset);
@@ -168,7 +189,7 @@ static void aio_write_worker(FAR void *arg)
        *   aio_nbytes   - Length of transfer
        */
 
-      nwritten = psock_send(aioc->u.aioc_psock,
+      nwritten = psock_send(u.aioc_psock,
                             (FAR const void *)aiocbp->aio_buf,
                             aiocbp->aio_nbytes, 0);
     }
@@ -190,18 +211,15 @@ errout:
   /* Signal the client */
 
   (void)aio_signal(pid, aiocbp);
+#ifdef CONFIG_FS_AIO_RING
+  aio_ring_complete(ring, aiocbp);
+#endif
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
-  lpwork_restorepriority(prio);
-#endif
+  aio_restorepriority(prio);
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: aio_write
  *
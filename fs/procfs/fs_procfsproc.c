@@ -169,9 +169,9 @@ struct proc_envinfo_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -639,6 +639,41 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
       return totalsize;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Show the deadline statistics */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                            "DlMissed:", (unsigned long)tcb->deadline.nmisses);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                                 &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+
+      linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                            "DlOverrun:", (unsigned long)tcb->deadline.noverruns);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                                 &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+#endif
+
   /* Show the signal mask */
 
 #ifndef CONFIG_DISABLE_SIGNALS
@@ -48,9 +48,129 @@
 #include <assert.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
-#if CONFIG_NFILE_DESCRIPTORS > 0 && CONFIG_NET_SENDFILE
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_splice
+ *
+ * Description:
+ *   Copy data between two files entirely within the OS.  The output may be
+ *   a regular file, a character driver or a pipe.  Compared to the generic
+ *   lib_sendfile(), this avoids a system call and two file descriptor
+ *   lookups for each buffer transferred and does not allocate from the
+ *   user heap.
+ *
+ * Input Parameters:
+ *   outfile - The file structure of the output file
+ *   infile  - The file structure of the input file
+ *   offset  - See sendfile()
+ *   count   - The number of bytes to copy
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value if nothing
+ *   could be transferred.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_splice(FAR struct file *outfile,
+                               FAR struct file *infile, FAR off_t *offset,
+                               size_t count)
+{
+  FAR uint8_t *iobuffer;
+  off_t startpos = 0;
+  size_t ntransferred = 0;
+  ssize_t ret = OK;
+
+  /* If an offset was provided, remember the current file position so that
+   * it can be restored when we are finished.
+   */
+
+  if (offset != NULL)
+    {
+      startpos = file_seek(infile, 0, SEEK_CUR);
+      if (startpos < 0)
+        {
+          return (ssize_t)startpos;
+        }
+
+      ret = file_seek(infile, *offset, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Allocate an I/O buffer */
+
+  iobuffer = (FAR uint8_t *)kmm_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
+  if (iobuffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_offset;
+    }
+
+  /* Now transfer 'count' bytes from the infile to the outfile */
+
+  while (ntransferred < count)
+    {
+      size_t nwritten;
+      ssize_t nread;
+
+      nread = count - ntransferred;
+      if (nread > CONFIG_LIB_SENDFILE_BUFSIZE)
+        {
+          nread = CONFIG_LIB_SENDFILE_BUFSIZE;
+        }
+
+      nread = file_read(infile, iobuffer, nread);
+      if (nread <= 0)
+        {
+          /* End of file or read error */
+
+          ret = nread;
+          break;
+        }
+
+      /* Pipes and character drivers may accept less than requested.  Loop
+       * until all of the data that was read has been written.
+       */
+
+      for (nwritten = 0; nwritten < nread; )
+        {
+          ret = file_write(outfile, &iobuffer[nwritten], nread - nwritten);
+          if (ret <= 0)
+            {
+              ntransferred += nwritten;
+              ret = ret < 0 ? ret : -EIO;
+              goto errout_with_iobuffer;
+            }
+
+          nwritten += ret;
+        }
+
+      ntransferred += nread;
+    }
+
+errout_with_iobuffer:
+  kmm_free(iobuffer);
+
+errout_with_offset:
+  if (offset != NULL)
+    {
+      *offset += ntransferred;
+      (void)file_seek(infile, startpos, SEEK_SET);
+    }
+
+  return ntransferred > 0 ? (ssize_t)ntransferred : ret;
+}
 
 /****************************************************************************
  * Public Functions
@@ -67,6 +187,12 @@
  *   If the destination descriptor is a socket, it gives a better
  *   performance than simple reds() and writes(). The data is read directly
  *   into the net buffer and the whole tcp window is filled if possible.
+ *   With TCP write buffering, the data is read only once into I/O buffers
+ *   that are then retained for retransmission.
+ *
+ *   If both descriptors are file descriptors (regular files, character
+ *   drivers or pipes), the copy is performed within the OS without a
+ *   system call per buffer.
  *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
@@ -141,11 +267,41 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
-   * lib_sendfile() can handle that case.
+  /* Is this a file-to-file (or file-to-pipe) transfer? */
+
+  if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS &&
+      (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct file *outfile;
+      FAR struct file *infile;
+      ssize_t ret;
+
+      ret = fs_getfilep(outfd, &outfile);
+      if (ret >= 0)
+        {
+          ret = fs_getfilep(infd, &infile);
+        }
+
+      if (ret >= 0)
+        {
+          DEBUGASSERT(outfile != NULL && infile != NULL);
+          ret = sendfile_splice(outfile, infile, offset, count);
+        }
+
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      return ret;
+    }
+
+  /* No... then this is something else (probably socket-to-file).  The
+   * generic lib_sendfile() can handle that case.
    */
 
   return lib_sendfile(outfd, infd, offset, count);
 }
 
-#endif /* CONFIG_NFILE_DESCRIPTORS > 0 && CONFIG_NET_SENDFILE */
+#endif /* CONFIG_NFILE_DESCRIPTORS > 0 */
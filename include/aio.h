@@ -58,8 +58,9 @@
 #  undef CONFIG_FS_AIO
 #endif
 
-/* Work queue support is required.  The low-priority work queue is required
- * so that the asynchronous I/O does not interfere with high priority driver
+/* Work queue support is required.  Unless dedicated AIO worker threads are
+ * selected, the low-priority work queue is required so that the
+ * asynchronous I/O does not interfere with high priority driver
  * operations.  If this pre-requisite is met, then asynchronous I/O support
  * can be enabled with CONFIG_FS_AIO
  */
@@ -70,8 +71,8 @@
 #  error Asynchronous I/O requires CONFIG_SCHED_WORKQUEUE
 #endif
 
-#ifndef CONFIG_SCHED_LPWORK
-#  error Asynchronous I/O requires CONFIG_SCHED_LPWORK
+#if !defined(CONFIG_SCHED_LPWORK) && !defined(CONFIG_FS_AIO_WORKERS)
+#  error Asynchronous I/O requires CONFIG_SCHED_LPWORK or CONFIG_FS_AIO_WORKERS
 #endif
 
 /* Standard Definitions *****************************************************/
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * include/netpacket/can.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NETPACKET_CAN_H
+#define __INCLUDE_NETPACKET_CAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Special address description flags for the CAN_ID */
+
+#define CAN_EFF_FLAG   0x80000000  /* EFF/SFF is set in the MSB */
+#define CAN_RTR_FLAG   0x40000000  /* Remote transmission request */
+#define CAN_ERR_FLAG   0x20000000  /* Error message frame */
+
+/* Valid bits in the CAN ID for frame formats */
+
+#define CAN_SFF_MASK   0x000007ff  /* Standard frame format (SFF) */
+#define CAN_EFF_MASK   0x1fffffff  /* Extended frame format (EFF) */
+#define CAN_ERR_MASK   0x1fffffff  /* Omit EFF, RTR, ERR flags */
+
+/* Set in the can_id of a struct can_filter to invert the sense of the
+ * filter.
+ */
+
+#define CAN_INV_FILTER 0x20000000
+
+/* Maximum payload of a classic CAN frame and the size of struct can_frame */
+
+#define CAN_MAX_DLC    8
+#define CAN_MAX_DLEN   8
+#define CAN_MTU        (sizeof(struct can_frame))
+
+/* PF_CAN protocols (the protocol argument of socket()) */
+
+#define CAN_RAW        1           /* RAW sockets */
+
+/* CAN_RAW socket options (level SOL_CAN_RAW) */
+
+#define CAN_RAW_FILTER        (__SO_PROTOCOL + 0)
+                                   /* Set 0 .. n struct can_filter entries.
+                                    * An empty set disables reception.
+                                    * Default: one filter that accepts
+                                    * all frames.
+                                    */
+#define CAN_RAW_ERR_FILTER    (__SO_PROTOCOL + 1)
+                                   /* Set a can_err_mask_t selecting the
+                                    * error frames to be received.
+                                    * Default: zero (no error frames).
+                                    */
+#define CAN_RAW_LOOPBACK      (__SO_PROTOCOL + 2)
+                                   /* Deliver frames sent on this socket
+                                    * to other sockets on the same device
+                                    * (int, boolean).  Default: enabled.
+                                    */
+#define CAN_RAW_RECV_OWN_MSGS (__SO_PROTOCOL + 3)
+                                   /* Also deliver frames sent on this
+                                    * socket to itself (int, boolean).
+                                    * Default: disabled.
+                                    */
+
+/* The maximum number of filters that may be set with CAN_RAW_FILTER on one
+ * socket.
+ */
+
+#ifdef CONFIG_NET_CAN_NFILTERS
+#  define CAN_RAW_FILTER_MAX   CONFIG_NET_CAN_NFILTERS
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Controller Area Network Identifier structure
+ *
+ *   bit 0-28  : CAN identifier (11/29 bit)
+ *   bit 29    : Error message frame flag (0 = data frame, 1 = error
+ *               message)
+ *   bit 30    : Remote transmission request flag (1 = RTR frame)
+ *   bit 31    : Frame format flag (0 = standard 11 bit, 1 = extended 29
+ *               bit)
+ */
+
+typedef uint32_t canid_t;
+
+/* Error mask selecting error frame classes (see CAN_RAW_ERR_FILTER) */
+
+typedef uint32_t can_err_mask_t;
+
+/* The classic CAN frame as it is read from and written to a CAN_RAW
+ * socket.  Exactly CAN_MTU bytes must be written with each send() and each
+ * recv() returns exactly one frame.
+ */
+
+struct can_frame
+{
+  canid_t can_id;                  /* 32 bit CAN_ID + EFF/RTR/ERR flags */
+  uint8_t can_dlc;                 /* Frame payload length in bytes (0 .. 8) */
+  uint8_t __pad;                   /* Padding */
+  uint8_t __res0;                  /* Reserved / padding */
+  uint8_t __res1;                  /* Reserved / padding */
+  uint8_t data[CAN_MAX_DLEN];      /* Frame payload */
+};
+
+/* The CAN socket address.  A can_ifindex of zero binds the socket to all
+ * CAN devices.
+ */
+
+struct sockaddr_can
+{
+  sa_family_t can_family;          /* AF_CAN */
+  int         can_ifindex;         /* Interface index (see if_nametoindex) */
+};
+
+/* A receive filter.  A frame matches the filter when:
+ *
+ *   (received_can_id & can_mask) == (can_id & can_mask)
+ *
+ * The sense of the match is inverted if CAN_INV_FILTER is set in can_id.
+ */
+
+struct can_filter
+{
+  canid_t can_id;                  /* Relevant bits of the CAN ID */
+  canid_t can_mask;                /* Mask selecting the relevant bits */
+};
+
+#endif /* __INCLUDE_NETPACKET_CAN_H */
@@ -78,6 +78,26 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+/* The number of blocks in the block mode pool is limited to 8 to fit the
+ * set of free blocks into a uint8_t.
+ */
+
+#ifdef CONFIG_ADC_BLOCK
+#  if !defined(CONFIG_ADC_BLOCK_NBUFFERS)
+#    define CONFIG_ADC_BLOCK_NBUFFERS 3
+#  elif CONFIG_ADC_BLOCK_NBUFFERS < 2
+#    undef  CONFIG_ADC_BLOCK_NBUFFERS
+#    define CONFIG_ADC_BLOCK_NBUFFERS 2
+#  elif CONFIG_ADC_BLOCK_NBUFFERS > 8
+#    undef  CONFIG_ADC_BLOCK_NBUFFERS
+#    define CONFIG_ADC_BLOCK_NBUFFERS 8
+#  endif
+#endif
+
+/* Return a pointer to the first sample that follows a block header */
+
+#define ADC_BLKDATA(hdr)       ((FAR void *)((FAR struct adc_blkhdr_s *)(hdr) + 1))
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -105,6 +125,34 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_BLOCK
+  /* Block mode only.  This method is called from the lower half to obtain
+   * an empty block that it will fill with whole scans, e.g. by DMA.  The
+   * header fields are already set except for ab_timestamp, which the lower
+   * half sets to the time of the first scan.  If the readers have fallen
+   * behind, the oldest filled block that has not yet been taken by a reader
+   * is reused and its loss is reported in ab_overrun of the next block.
+   *
+   * Returned Value:
+   *   The empty block, or NULL if every block is held by the lower half or
+   *   by readers.  In that case the lower half must discard one block of
+   *   scans before it asks again; the loss is counted.
+   */
+
+  CODE FAR struct adc_blkhdr_s *(*au_getblock)(FAR struct adc_dev_s *dev);
+
+  /* Block mode only.  Hand a block obtained with au_getblock() back to the
+   * upper half when it has been filled.  ab_nscans may be reduced if the
+   * block is only partially filled.
+   *
+   * Returned Value:
+   *   Zero on success; a negated errno value on failure.
+   */
+
+  CODE int (*au_putblock)(FAR struct adc_dev_s *dev,
+                          FAR struct adc_blkhdr_s *blk);
+#endif
 };
 
 /* This describes on ADC message */
@@ -126,6 +174,43 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+/* In block mode the lower half delivers whole scan buffers rather than one
+ * sample at a time.  Each block in the pool starts with this header and is
+ * followed by ab_nscans scans of ab_nchannels samples each, in scan order.
+ * A sample is a native endian int16_t or int32_t as given by
+ * ab_samplesize.  read() returns whole blocks; with FIOC_MMAP the pool is
+ * used in place and blocks are taken and returned with ANIOC_BLK_GET and
+ * ANIOC_BLK_RELEASE.
+ */
+
+struct adc_blkhdr_s
+{
+  uint64_t     ab_timestamp;             /* Time of the first scan (microseconds) */
+  uint32_t     ab_seq;                   /* Sequence number of the block */
+  uint32_t     ab_overrun;               /* Blocks lost just before this block */
+  uint16_t     ab_nchannels;             /* Number of samples in one scan */
+  uint16_t     ab_nscans;                /* Number of scans in the block */
+  uint8_t      ab_samplesize;            /* Size of one sample (2 or 4 bytes) */
+  uint8_t      ab_index;                 /* Index of the block in the pool */
+  uint16_t     ab_reserved;
+};
+
+/* Argument of ANIOC_BLK_CONFIG.  The lower half sets ac_nchannels and
+ * ac_samplesize; the upper half allocates the pool and sets the remaining
+ * OUT fields.
+ */
+
+struct adc_blkcfg_s
+{
+  uint32_t     ac_rate;                  /* IN:  Scans per second (0: unchanged) */
+  uint16_t     ac_nscans;                /* IN:  Scans per block (0: leave block mode) */
+  uint16_t     ac_nchannels;             /* OUT: Number of samples in one scan */
+  uint8_t      ac_samplesize;            /* OUT: Size of one sample (2 or 4 bytes) */
+  uint8_t      ac_nblocks;               /* OUT: Number of blocks in the pool */
+  uint16_t     ac_reserved;
+  uint32_t     ac_blksize;               /* OUT: Distance between blocks in bytes */
+};
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of can_register().
@@ -161,7 +246,10 @@ struct adc_ops_s
 
   CODE void (*ao_shutdown)(FAR struct adc_dev_s *dev);
 
-  /* Call to enable or disable RX interrupts */
+  /* Call to enable or disable RX interrupts.  In block mode, disabling
+   * must also stop filling and forget any block obtained with au_getblock():
+   * the upper half may free the pool afterward.
+   */
 
   CODE void (*ao_rxint)(FAR struct adc_dev_s *dev, bool enable);
 
@@ -190,6 +278,24 @@ struct adc_dev_s
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
 
+#ifdef CONFIG_ADC_BLOCK
+  /* Block mode state.  Every block is in exactly one of these states:  free
+   * (ad_blkfree), being filled by the lower half, filled and queued
+   * (ad_blkq), or taken by a reader (ad_blkuser).
+   */
+
+  FAR uint8_t                *ad_blkpool;    /* Block pool (NULL: sample mode) */
+  uint32_t                    ad_blksize;    /* Distance between blocks in bytes */
+  uint32_t                    ad_blkseq;     /* Sequence number of the next block */
+  uint32_t                    ad_blklost;    /* Blocks lost since the last one queued */
+  uint16_t                    ad_blknscans;  /* Scans in a full block */
+  uint8_t                     ad_blkfree;    /* Set of free blocks */
+  uint8_t                     ad_blkuser;    /* Set of blocks taken by readers */
+  uint8_t                     ad_blkhead;    /* Oldest entry in ad_blkq */
+  uint8_t                     ad_blkcount;   /* Number of entries in ad_blkq */
+  uint8_t                     ad_blkq[CONFIG_ADC_BLOCK_NBUFFERS]; /* Filled blocks */
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
    * retained in the f_priv field of the 'struct file'.
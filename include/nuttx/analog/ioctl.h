@@ -65,8 +65,21 @@
                                            * IN: Threshold value
                                            * OUT: None */
 
+/* ADC block mode (CONFIG_ADC_BLOCK, see include/nuttx/analog/adc.h) */
+
+#define ANIOC_BLK_CONFIG  _ANIOC(0x0004)  /* Select block mode and its geometry
+                                           * IN: struct adc_blkcfg_s pointer
+                                           * OUT: Fields marked OUT are set */
+#define ANIOC_BLK_GET     _ANIOC(0x0005)  /* Take the oldest filled block
+                                           * IN: Pointer to int
+                                           * OUT: Index of the block */
+#define ANIOC_BLK_RELEASE _ANIOC(0x0006)  /* Return a block taken with
+                                           * ANIOC_BLK_GET
+                                           * IN: Index of the block
+                                           * OUT: None */
+
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          3               /* Number of common commands */
+#define AN_NCMDS          6               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half QE driver to the lower-half QE driver via the ioctl()
@@ -72,6 +72,14 @@
 #  define CONFIG_ELF_BUFFERINCR 32
 #endif
 
+#ifndef CONFIG_ELF_CACHEBLOCKS
+#  define CONFIG_ELF_CACHEBLOCKS 0
+#endif
+
+#if CONFIG_ELF_CACHEBLOCKS > 0 && !defined(CONFIG_ELF_CACHEBLOCKSIZE)
+#  define CONFIG_ELF_CACHEBLOCKSIZE 512
+#endif
+
 /* Allocation array size and indices */
 
 #define LIBELF_ELF_ALLOC     0
@@ -142,6 +150,20 @@ struct elf_loadinfo_s
   uint16_t           strtabidx;  /* String table section index */
   uint16_t           buflen;     /* size of iobuffer[] */
   int                filfd;      /* Descriptor for the file being loaded */
+
+  /* If the file system can map the file into memory (FIOC_MMAP, e.g.,
+   * ROMFS on XIP media), the file is accessed directly at xipbase.
+   * Otherwise, small reads are served from a cache of file blocks.
+   */
+
+  FAR const uint8_t *xipbase;    /* Memory mapped file or NULL */
+#if CONFIG_ELF_CACHEBLOCKS > 0
+  FAR uint8_t       *cache;      /* Read cache blocks */
+  off_t              cacheoff[CONFIG_ELF_CACHEBLOCKS];  /* File offset of each block */
+  uint16_t           cachelen[CONFIG_ELF_CACHEBLOCKS];  /* Valid bytes (0: empty) */
+  uint32_t           cacheage[CONFIG_ELF_CACHEBLOCKS];  /* Time of last use */
+  uint32_t           cacheclock; /* Incremented on each use of the cache */
+#endif
 };
 
 /****************************************************************************
@@ -239,6 +239,24 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The time page is a copy of the kernel time base that resides in user
+ * memory so that user space can read CLOCK_REALTIME and CLOCK_MONOTONIC
+ * without a system call.  The kernel increments seq before and after each
+ * update so that it is odd while the update is in progress; a reader
+ * retries if seq was odd or changed while it was copying the values.  A
+ * seq value of zero means that the kernel has not initialized the page.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t seq;       /* Update sequence count */
+  volatile clock_t  systimer;  /* System timer (ticks since power up) */
+  volatile time_t   basesec;   /* CLOCK_REALTIME when systimer was zero */
+  volatile long     basensec;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -266,6 +284,14 @@ EXTERN volatile clock_t g_system_timer;
 #endif
 #endif
 
+/* The user-space instance of the time page.  The kernel finds it through
+ * the struct userspace_s header of the user blob.
+ */
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+EXTERN struct clock_timepage_s g_clock_timepage;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
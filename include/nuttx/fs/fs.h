@@ -996,7 +996,7 @@ int lib_flushall(FAR struct streamlist *list);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#if CONFIG_NFILE_DESCRIPTORS > 0
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count);
 #endif
 
@@ -93,6 +93,7 @@
 #define _MAC802154BASE  (0x2600) /* 802.15.4 MAC ioctl commands */
 #define _PWRBASE        (0x2700) /* Power-related ioctl commands */
 #define _FBIOCBASE      (0x2800) /* Frame buffer character driver ioctl commands */
+#define _PCAPIOCBASE    (0x2900) /* Network packet capture ioctl commands */
 
 /* boardctl() commands share the same number space */
 
@@ -470,6 +471,11 @@
 #define _FBIOCVALID(c)   (_IOC_TYPE(c)==_FBIOCBASE)
 #define _FBIOC(nr)       _IOC(_FBIOCBASE,nr)
 
+/* Network packet capture driver ********************************************/
+
+#define _PCAPIOCVALID(c) (_IOC_TYPE(c)==_PCAPIOCBASE)
+#define _PCAPIOC(nr)     _IOC(_PCAPIOCBASE,nr)
+
 /* boardctl() command definitions *******************************************/
 
 #define _BOARDIOCVALID(c) (_IOC_TYPE(c)==_BOARDBASE)
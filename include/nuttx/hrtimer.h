@@ -0,0 +1,256 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error High resolution timers require 64-bit integer support
+#endif
+
+/* Flags that may be passed to hrtimer_start().  HRTIMER_ABSTIME has the
+ * same meaning as TIMER_ABSTIME for timer_settime():  The expiration time
+ * is an absolute value of hrtimer_gettime() rather than a delay.
+ */
+
+#define HRTIMER_ABSTIME 0x01
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the form of the function that is called when a high resolution
+ * timer expires.  It runs in the context of the timer interrupt handler
+ * (inside of a critical section) and may re-start the same timer.
+ */
+
+struct hrtimer_s;
+typedef CODE void (*hrtimer_callback_t)(FAR struct hrtimer_s *timer);
+
+/* This structure describes one high resolution timer.  It is allocated by
+ * the caller (typically embedded in a driver or on the stack of a waiting
+ * thread) and must remain valid until the timer expires or is cancelled.
+ */
+
+struct hrtimer_s
+{
+  uint64_t           expired;  /* Expiration time in nanoseconds */
+  hrtimer_callback_t func;     /* Function to call on expiration */
+  FAR void          *arg;      /* Argument available to the callback */
+  uint16_t           index;    /* Position in the timer heap (0: inactive) */
+};
+
+#ifdef CONFIG_HRTIMER_LATENCY
+/* Expiration latency statistics.  The latency of one expiration is the
+ * time from the requested expiration time until the callback is entered.
+ * Bucket 0 of the histogram counts latencies below one microsecond; bucket
+ * n counts latencies from 2^(n-1) up to 2^n microseconds; the final bucket
+ * also counts everything longer.
+ */
+
+#define HRTIMER_NHISTOGRAM 16
+
+struct hrtimer_latency_s
+{
+  uint32_t count;                      /* Number of expirations */
+  uint32_t max;                        /* Worst latency (nanoseconds) */
+  uint64_t total;                      /* Sum of latencies (nanoseconds) */
+  uint32_t hist[HRTIMER_NHISTOGRAM];   /* Latency histogram */
+};
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.  This must be called once before
+ *   the timer is started and must not be called while the timer is active.
+ *   A zeroed timer structure is also a valid, inactive timer.
+ *
+ * Input Parameters:
+ *   timer - The timer to be initialized
+ *   func  - The function to call when the timer expires
+ *   arg   - An argument that will be available to func as timer->arg
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t func,
+                  FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current value of the high resolution time base.  This is
+ *   the time since power up in nanoseconds as reported by the platform
+ *   up_timer_gettime() interface.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The current time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or re-start) a high resolution timer.  If the timer is already
+ *   active, it is first cancelled.  A time that has already passed will
+ *   expire at the next opportunity.
+ *
+ * Input Parameters:
+ *   timer - The timer to be started
+ *   ns    - The delay in nanoseconds or, if HRTIMER_ABSTIME is set in flags,
+ *           the absolute expiration time
+ *   flags - Zero or HRTIMER_ABSTIME
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure:
+ *
+ *   -EINVAL - The timer or its callback is NULL.
+ *   -ENOMEM - CONFIG_HRTIMER_NTIMERS timers are already active.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t ns, int flags);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.  It is not an error to cancel a timer
+ *   that is not active.
+ *
+ * Input Parameters:
+ *   timer - The timer to be cancelled
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if timer is NULL.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the time remaining before a high resolution timer expires.
+ *
+ * Input Parameters:
+ *   timer - The timer to be queried
+ *
+ * Returned Value:
+ *   The remaining time in nanoseconds.  Zero means that the timer is not
+ *   active or that it has already expired.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer);
+
+/****************************************************************************
+ * Name: hrtimer_isactive
+ *
+ * Description:
+ *   Return true if the high resolution timer is pending expiration.
+ *
+ ****************************************************************************/
+
+#define hrtimer_isactive(t) ((t)->index != 0)
+
+/****************************************************************************
+ * Name: hrtimer_latency
+ *
+ * Description:
+ *   Return the expiration latency statistics collected since power up or
+ *   since the last reset.
+ *
+ * Input Parameters:
+ *   latency - Location to return the statistics
+ *   reset   - True: Clear the statistics after they have been returned
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_LATENCY
+void hrtimer_latency(FAR struct hrtimer_latency_s *latency, bool reset);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
@@ -184,6 +184,31 @@
 #  define I2C_RESET(d) ((d)->ops->reset(d))
 #endif
 
+/****************************************************************************
+ * Name: I2C_SUBMIT
+ *
+ * Description:
+ *   Start an asynchronous request from the I2C transaction queue (see
+ *   include/nuttx/i2c/i2c_queue.h).  The lower half must call
+ *   i2c_queue_complete() when the request has completed.  Optional; if
+ *   the method is not provided, the queue performs requests on its own
+ *   thread using I2C_TRANSFER().
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to start
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was accepted; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_QUEUE
+#  define I2C_SUBMIT(d,r) \
+  (((d)->ops->submit) ? ((d)->ops->submit(d,r)) : -ENOSYS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -192,6 +217,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_request_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -199,6 +225,10 @@ struct i2c_ops_s
 #ifdef CONFIG_I2C_RESET
   CODE int (*reset)(FAR struct i2c_master_s *dev);
 #endif
+#ifdef CONFIG_I2C_QUEUE
+  CODE int (*submit)(FAR struct i2c_master_s *dev,
+                     FAR struct i2c_request_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * include/nuttx/i2c/i2c_queue.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_I2C_I2C_QUEUE_H
+#define __INCLUDE_NUTTX_I2C_I2C_QUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The asynchronous I2C transaction queue.
+ *
+ * This works like the I2C transaction queue (include/nuttx/i2c/i2c_queue.h):
+ * A request holds the same array of messages that would be passed to
+ * I2C_TRANSFER() and is submitted to the queue of the bus with
+ * i2c_queue_submit(), which returns immediately.  When the transfer has
+ * completed, the request's callback is called on the bus thread.
+ *
+ * By default, the bus thread performs each request with I2C_TRANSFER().  A
+ * lower half that can run transfers by itself may instead provide the
+ * submit() method and call i2c_queue_complete() as each request finishes.
+ */
+
+struct i2c_queue_s;
+struct i2c_request_s;
+
+typedef CODE void (*i2c_reqcallback_t)(FAR struct i2c_request_s *req);
+
+struct i2c_request_s
+{
+  FAR struct i2c_request_s *flink;   /* Supports a singly linked list */
+  FAR struct i2c_msg_s *msgs;        /* The messages to transfer */
+  int count;                         /* The number of messages */
+  i2c_reqcallback_t callback;        /* Called when the request completes */
+  FAR void *arg;                     /* Available for use by the callback */
+  int result;                        /* OK or a negated errno on completion */
+
+  /* The following is for internal use by the I2C queue */
+
+  FAR struct i2c_queue_s *queue;     /* The queue the request was sent to */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Create the transaction queue for an I2C bus and start the thread that
+ *   serves it.  This is normally called once for each bus by board
+ *   initialization logic; the queue is then passed to each driver on the
+ *   bus.
+ *
+ * Input Parameters:
+ *   i2c - An instance of the lower half I2C driver
+ *   bus - The I2C bus number.  This is used only to name the bus thread.
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *i2c,
+                                             int bus);
+
+/****************************************************************************
+ * Name: i2c_queue_submit
+ *
+ * Description:
+ *   Add a request to the tail of the queue of the I2C bus.  This function
+ *   does not wait for the transfers to be performed.
+ *
+ * Input Parameters:
+ *   queue - The I2C bus queue
+ *   req   - The request to perform.  The msgs, count and callback fields
+ *           must be initialized.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *   In the case of failure, the callback will not be called.
+ *
+ ****************************************************************************/
+
+int i2c_queue_submit(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  The
+ *   callback of a cancelled request is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if the request has already
+ *   been started (its callback will still be called).
+ *
+ ****************************************************************************/
+
+int i2c_queue_cancel(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_queue_complete
+ *
+ * Description:
+ *   Called by a lower half that implements the submit() method when a
+ *   request has completed.  This may be called from an interrupt handler;
+ *   the callback of the request will be called later on the bus thread.
+ *
+ * Input Parameters:
+ *   req    - The completed request
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void i2c_queue_complete(FAR struct i2c_request_s *req, int result);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_I2C_QUEUE */
+#endif /* __INCLUDE_NUTTX_I2C_I2C_QUEUE_H */
@@ -49,6 +49,10 @@
 # include <arch/irq.h>
 #endif
 
+#if defined(CONFIG_SMP) && !defined(__ASSEMBLY__)
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -297,6 +301,63 @@ void spin_unlock_irqrestore(irqstate_t flags);
 #  define spin_unlock_irqrestore(f) leave_critical_section(f)
 #endif
 
+/****************************************************************************
+ * Name: spin_lock_irqsave_local
+ *
+ * Description:
+ *   Disable local interrupts and take a spinlock that protects data private
+ *   to one driver or subsystem.  Unlike spin_lock_irqsave(), this does not
+ *   serialize against every other user of the global lock; only users of
+ *   the same 'lock' wait for each other.
+ *
+ *   The protected region must be short and must not call any function
+ *   that may enter the critical section or suspend the caller (nxsem_post()
+ *   included).  Nested calls on the same lock will deadlock.
+ *
+ *   On non-SMP builds, this simply disables interrupts.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+irqstate_t spin_lock_irqsave_local(FAR volatile spinlock_t *lock);
+#else
+/* Without SMP, there is no other CPU to exclude.  The lock argument is not
+ * evaluated, so the lock object itself need only exist in SMP builds.
+ */
+
+#  define spin_lock_irqsave_local(l) up_irq_save()
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore_local
+ *
+ * Description:
+ *   Release a spinlock taken with spin_lock_irqsave_local() and restore the
+ *   local interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_irqsave_local().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void spin_unlock_irqrestore_local(FAR volatile spinlock_t *lock,
+                                  irqstate_t flags);
+#else
+#  define spin_unlock_irqrestore_local(l,f) up_irq_restore(f)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -69,6 +69,14 @@
 #  define CONFIG_MODLIB_BUFFERINCR 32
 #endif
 
+#ifndef CONFIG_MODLIB_CACHEBLOCKS
+#  define CONFIG_MODLIB_CACHEBLOCKS 0
+#endif
+
+#if CONFIG_MODLIB_CACHEBLOCKS > 0 && !defined(CONFIG_MODLIB_CACHEBLOCKSIZE)
+#  define CONFIG_MODLIB_CACHEBLOCKSIZE 512
+#endif
+
 /* CONFIG_DEBUG_INFO, and CONFIG_DEBUG_BINFMT have to be defined or
  * CONFIG_MODLIB_DUMPBUFFER does nothing.
  */
@@ -215,6 +223,20 @@ struct mod_loadinfo_s
   uint16_t          strtabidx;   /* String table section index */
   uint16_t          buflen;      /* size of iobuffer[] */
   int               filfd;       /* Descriptor for the file being loaded */
+
+  /* If the file system can map the file into memory (FIOC_MMAP, e.g.,
+   * ROMFS on XIP media), the file is accessed directly at xipbase.
+   * Otherwise, small reads are served from a cache of file blocks.
+   */
+
+  FAR const uint8_t *xipbase;    /* Memory mapped file or NULL */
+#if CONFIG_MODLIB_CACHEBLOCKS > 0
+  FAR uint8_t      *cache;       /* Read cache blocks */
+  off_t             cacheoff[CONFIG_MODLIB_CACHEBLOCKS];  /* File offset of each block */
+  uint16_t          cachelen[CONFIG_MODLIB_CACHEBLOCKS];  /* Valid bytes (0: empty) */
+  uint32_t          cacheage[CONFIG_MODLIB_CACHEBLOCKS];  /* Time of last use */
+  uint32_t          cacheclock;  /* Incremented on each use of the cache */
+#endif
 };
 
 /****************************************************************************
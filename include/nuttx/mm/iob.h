@@ -69,6 +69,10 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+#if !defined(CONFIG_IOB_PERCPU_CACHE)
+#  define CONFIG_IOB_PERCPU_CACHE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -152,6 +156,21 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+#ifdef CONFIG_IOB_STATISTICS
+/* I/O buffer usage statistics as returned by iob_getstats() */
+
+struct iob_stats_s
+{
+  uint32_t nallocs;     /* Number of I/O buffers allocated */
+  uint32_t nfrees;      /* Number of I/O buffers freed */
+  uint32_t nwaits;      /* Number of allocations that had to wait */
+  uint32_t nthrottled;  /* Number of throttled allocations that had to wait */
+  uint32_t nfailed;     /* Number of failed non-blocking allocations */
+  uint16_t maxused;     /* Most I/O buffers ever taken from the free list */
+  uint16_t ncached;     /* Number of free I/O buffers in per-CPU caches */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -187,6 +206,32 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_chain
+ *
+ * Description:
+ *   Allocate a chain of 'nbufs' empty I/O buffers linked via io_flink.  If
+ *   that many buffers are free, they are all taken from the free list at
+ *   once, adjusting the counting semaphores only once for the whole batch.
+ *   Otherwise, the buffers are allocated one at a time, waiting as
+ *   necessary.  NULL is returned on any failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_chain(unsigned int nbufs, bool throttled);
+
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'nbufs' empty I/O buffers from the free list
+ *   in one batch without waiting.  NULL is returned if not that many
+ *   buffers are available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int nbufs, bool throttled);
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -207,6 +252,18 @@ int iob_navail(bool throttled);
 
 int iob_qentry_navail(void);
 
+/****************************************************************************
+ * Name: iob_getstats
+ *
+ * Description:
+ *   Return a snapshot of the I/O buffer usage statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_STATISTICS
+void iob_getstats(FAR struct iob_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -301,7 +358,8 @@ void iob_notifier_signal(void);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  If no task is waiting for an I/O buffer, the whole chain
+ *   is returned to the free list at once.
  *
  ****************************************************************************/
 
@@ -367,6 +425,19 @@ FAR struct iob_s *iob_remove_queue(FAR struct iob_queue_s *iobq);
 FAR struct iob_s *iob_peek_queue(FAR struct iob_queue_s *iobq);
 #endif
 
+/****************************************************************************
+ * Name: iob_get_queue_size
+ *
+ * Description:
+ *   Return the total number of data bytes held by all of the I/O buffer
+ *   chains in a queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+unsigned int iob_get_queue_size(FAR struct iob_queue_s *queue);
+#endif
+
 /****************************************************************************
  * Name: iob_free_queue
  *
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * include/nuttx/net/pcap.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_PCAP_H
+#define __INCLUDE_NUTTX_NET_PCAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The packet capture device.  Frames passing through the network device
+ * interface layer are copied into a ring buffer that is shared with the
+ * reader.  The reader obtains the address of the ring with the FIOC_MMAP
+ * ioctl, starts capture with PCAPIOC_START, and then consumes records
+ * directly from the shared memory, using poll() to wait for new records.
+ * No system call is needed per captured frame.
+ *
+ * PCAPIOC_START
+ *   Description: Start capturing frames.  The ring is emptied first.
+ *   Argument:    None
+ *   Return:      OK on success, a negated errno value on failure.
+ *
+ * PCAPIOC_STOP
+ *   Description: Stop capturing frames.  Records already in the ring may
+ *                still be consumed.
+ *   Argument:    None
+ *   Return:      OK on success, a negated errno value on failure.
+ *
+ * PCAPIOC_SETFILTER
+ *   Description: Select the frames to be captured.
+ *   Argument:    A read-only reference to struct pcap_filter_s
+ *   Return:      OK on success, a negated errno value on failure.
+ */
+
+#define PCAP_DEVPATH        "/dev/pcap"
+
+#define PCAPIOC_START       _PCAPIOC(0x0001)
+#define PCAPIOC_STOP        _PCAPIOC(0x0002)
+#define PCAPIOC_SETFILTER   _PCAPIOC(0x0003)
+
+/* Values of pc_dir */
+
+#define PCAP_DIR_IN         0  /* Frame received by the device */
+#define PCAP_DIR_OUT        1  /* Frame sent by the device */
+
+/* Records in the ring are aligned to this boundary */
+
+#define PCAP_ALIGN          4
+#define PCAP_ALIGNUP(n)     (((n) + PCAP_ALIGN - 1) & ~(PCAP_ALIGN - 1))
+
+/* Size of one record holding 'caplen' bytes of frame data */
+
+#define PCAP_RECLEN(caplen) \
+  PCAP_ALIGNUP(sizeof(struct pcap_rec_s) + (caplen))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The capture filter.  A zero field matches any value. */
+
+struct pcap_filter_s
+{
+  uint8_t  pf_ifindex;    /* Capture only this device (see if_nametoindex) */
+  uint16_t pf_ethertype;  /* Capture only this ethertype (host order) */
+  uint16_t pf_snaplen;    /* Capture at most this many bytes of each frame */
+};
+
+/* The header that precedes each captured frame in the ring.  A record with
+ * pc_reclen == 0 marks the end of the used part of the ring; the next
+ * record is then at offset zero of pr_data[].
+ */
+
+struct pcap_rec_s
+{
+  uint16_t pc_reclen;     /* Size of the record, including this header */
+  uint16_t pc_caplen;     /* Number of frame bytes captured */
+  uint16_t pc_len;        /* Original length of the frame */
+  uint8_t  pc_ifindex;    /* Index of the network device */
+  uint8_t  pc_lltype;     /* Link layer type of the device (NET_LL_*) */
+  uint8_t  pc_dir;        /* PCAP_DIR_IN or PCAP_DIR_OUT */
+  uint8_t  pc_pad[3];     /* Pads the header to a multiple of PCAP_ALIGN */
+  uint32_t pc_sec;        /* Capture time, seconds (CLOCK_REALTIME) */
+  uint32_t pc_usec;       /* Capture time, microseconds */
+};
+
+/* The shared ring.  pr_head and pr_tail are free-running byte counts; the
+ * offset of a record in pr_data[] is the count modulo pr_size (a power of
+ * two).  Only the kernel advances pr_head and only the reader advances
+ * pr_tail.  The reader must finish with a record before advancing pr_tail
+ * past it.
+ */
+
+struct pcap_ring_s
+{
+  volatile uint32_t pr_head;  /* Producer position (written by the kernel) */
+  volatile uint32_t pr_tail;  /* Consumer position (written by the reader) */
+  uint32_t pr_size;           /* Size of pr_data[] in bytes */
+  volatile uint32_t pr_drops; /* Frames dropped because the ring was full */
+  uint8_t pr_data[1];         /* Start of the record area */
+};
+
+#endif /* __INCLUDE_NUTTX_NET_PCAP_H */
@@ -0,0 +1,336 @@
+/****************************************************************************
+ * include/nuttx/ringbuf.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RINGBUF_H
+#define __INCLUDE_NUTTX_RINGBUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SMP
+#  include <nuttx/spinlock.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_LIBC_RINGBUF_CACHELINE
+#  define CONFIG_LIBC_RINGBUF_CACHELINE 0
+#endif
+
+/* Index arithmetic *********************************************************/
+/* A ring of 'size' bytes has a head index (the next byte to be written)
+ * and a tail index (the next byte to be read), both in the range
+ * 0..size-1.  head == tail means that the ring is empty, so a ring holds at
+ * most size - 1 bytes.  The size need not be a power of two.
+ *
+ * This is the same convention used by the serial, pipe and ramlog
+ * buffers, so these macros may be used on those index fields directly.
+ * The arguments are evaluated more than once:  volatile indices should
+ * first be copied into local variables.
+ */
+
+#define RINGBUF_USED(h,t,s)      ((h) >= (t) ? (h) - (t) : (s) - ((t) - (h)))
+#define RINGBUF_SPACE(h,t,s)     ((s) - 1 - RINGBUF_USED(h,t,s))
+#define RINGBUF_ADVANCE(i,n,s)   ((i) + (n) >= (s) ? (i) + (n) - (s) : (i) + (n))
+#define RINGBUF_NEXT(i,s)        RINGBUF_ADVANCE(i,1,s)
+
+/* Memory ordering **********************************************************/
+/* A single producer and a single consumer may run concurrently, without
+ * any lock, provided that each index is written only by its owner and
+ * that:
+ *
+ *   RINGBUF_WMB() - Separates the producer's data writes from the update
+ *     of the head index.
+ *   RINGBUF_MB() - Separates the consumer's data reads from the reads of
+ *     the head index before them and from the update of the tail index
+ *     after them.
+ *
+ * On a single CPU, only the compiler must be prevented from re-ordering the
+ * accesses.
+ */
+
+#ifdef __GNUC__
+#  define __RINGBUF_COMPILER_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+#else
+#  define __RINGBUF_COMPILER_BARRIER()
+#endif
+
+#ifdef CONFIG_SMP
+#  define RINGBUF_WMB() \
+     do { __RINGBUF_COMPILER_BARRIER(); SP_DMB(); } while (0)
+#  define RINGBUF_MB() \
+     do { __RINGBUF_COMPILER_BARRIER(); SP_DSB(); } while (0)
+#else
+#  define RINGBUF_WMB() __RINGBUF_COMPILER_BARRIER()
+#  define RINGBUF_MB()  __RINGBUF_COMPILER_BARRIER()
+#endif
+
+/* Cache line padding *******************************************************/
+/* The head and tail indices are written by different CPUs.  When
+ * CONFIG_LIBC_RINGBUF_CACHELINE is set, each index is given a cache line
+ * of its own so that the producer and the consumer do not contend for the
+ * same line.
+ */
+
+#if CONFIG_LIBC_RINGBUF_CACHELINE > 4
+#  define __RINGBUF_PAD(n) uint8_t n[CONFIG_LIBC_RINGBUF_CACHELINE - 4];
+#else
+#  define __RINGBUF_PAD(n)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A byte ring buffer.  One producer and one consumer may use the ring at
+ * the same time without locking (including from an interrupt handler).
+ * Several producers must either be serialized by the caller or use
+ * ringbuf_mpput().
+ */
+
+struct ringbuf_s
+{
+  volatile uint32_t rb_head;    /* Next byte to write.  Owned by producer */
+  __RINGBUF_PAD(rb_pad1)
+  volatile uint32_t rb_tail;    /* Next byte to read.  Owned by consumer */
+  __RINGBUF_PAD(rb_pad2)
+  uint32_t rb_size;             /* Size of rb_buffer in bytes */
+  FAR uint8_t *rb_buffer;       /* The ring storage */
+#ifdef CONFIG_SMP
+  volatile spinlock_t rb_lock;  /* Serializes ringbuf_mpput() */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ringbuf_copyin
+ *
+ * Description:
+ *   Copy data into a ring at index 'head', wrapping at the end of the
+ *   buffer as necessary.  The caller must have verified that there is
+ *   space for 'len' bytes (see RINGBUF_SPACE).  The head index is not
+ *   updated.
+ *
+ * Input Parameters:
+ *   buffer - The ring storage
+ *   size   - The size of the ring storage in bytes
+ *   head   - The index at which to begin writing
+ *   data   - The data to copy
+ *   len    - The number of bytes to copy
+ *
+ * Returned Value:
+ *   The new head index.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_copyin(FAR uint8_t *buffer, size_t size, size_t head,
+                      FAR const void *data, size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_copyout
+ *
+ * Description:
+ *   Copy data out of a ring from index 'tail', wrapping at the end of the
+ *   buffer as necessary.  The caller must have verified that 'len' bytes
+ *   are available (see RINGBUF_USED).  The tail index is not updated.
+ *
+ * Input Parameters:
+ *   buffer - The ring storage
+ *   size   - The size of the ring storage in bytes
+ *   tail   - The index at which to begin reading
+ *   data   - The location to copy the data to
+ *   len    - The number of bytes to copy
+ *
+ * Returned Value:
+ *   The new tail index.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_copyout(FAR const uint8_t *buffer, size_t size, size_t tail,
+                       FAR void *data, size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize a ring buffer to use the caller provided storage.
+ *
+ * Input Parameters:
+ *   rb     - The ring buffer to initialize
+ *   buffer - The ring storage
+ *   size   - The size of the storage in bytes.  The ring holds at most
+ *            size - 1 bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the size is too small.
+ *
+ ****************************************************************************/
+
+int ringbuf_init(FAR struct ringbuf_s *rb, FAR void *buffer, size_t size);
+
+/****************************************************************************
+ * Name: ringbuf_reset
+ *
+ * Description:
+ *   Discard all data in the ring.  Neither the producer nor the consumer
+ *   may be using the ring.
+ *
+ ****************************************************************************/
+
+void ringbuf_reset(FAR struct ringbuf_s *rb);
+
+/****************************************************************************
+ * Name: ringbuf_used and ringbuf_space
+ *
+ * Description:
+ *   Return the number of bytes that may be read from or written to the
+ *   ring.  When called by the other side of the ring, the result is only a
+ *   snapshot:  The consumer may only see more data than reported, the
+ *   producer only more space.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_used(FAR const struct ringbuf_s *rb);
+size_t ringbuf_space(FAR const struct ringbuf_s *rb);
+
+#define ringbuf_is_empty(rb) ((rb)->rb_head == (rb)->rb_tail)
+
+/****************************************************************************
+ * Name: ringbuf_put
+ *
+ * Description:
+ *   Copy as much of the data as fits into the ring.  Called only by the
+ *   producer.
+ *
+ * Returned Value:
+ *   The number of bytes written (zero if the ring is full).
+ *
+ ****************************************************************************/
+
+size_t ringbuf_put(FAR struct ringbuf_s *rb, FAR const void *data,
+                   size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_get
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the ring.  Called only by the consumer.
+ *
+ * Returned Value:
+ *   The number of bytes read (zero if the ring is empty).
+ *
+ ****************************************************************************/
+
+size_t ringbuf_get(FAR struct ringbuf_s *rb, FAR void *data, size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_peek and ringbuf_consume
+ *
+ * Description:
+ *   Zero-copy read.  ringbuf_peek() returns the address and length of the
+ *   contiguous data at the tail of the ring (which may be less than all of
+ *   the data if the data wraps).  After using up to that many bytes in
+ *   place, the consumer releases them with ringbuf_consume().
+ *
+ ****************************************************************************/
+
+size_t ringbuf_peek(FAR struct ringbuf_s *rb, FAR void **data);
+void ringbuf_consume(FAR struct ringbuf_s *rb, size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_prepare and ringbuf_commit
+ *
+ * Description:
+ *   Zero-copy write.  ringbuf_prepare() returns the address and length of
+ *   the contiguous free space at the head of the ring.  After filling up
+ *   to that many bytes in place (for example by DMA), the producer
+ *   publishes them with ringbuf_commit().
+ *
+ ****************************************************************************/
+
+size_t ringbuf_prepare(FAR struct ringbuf_s *rb, FAR void **data);
+void ringbuf_commit(FAR struct ringbuf_s *rb, size_t len);
+
+/****************************************************************************
+ * Name: ringbuf_mpput
+ *
+ * Description:
+ *   Write a complete message into a ring that has several producers, any
+ *   of which may run in an interrupt handler or on another CPU.  The
+ *   message is written entirely or not at all.  The consumer uses the
+ *   normal, lock-free consumer interfaces.
+ *
+ *   Producers are serialized by disabling local interrupts and, in the SMP
+ *   case, by a spinlock in the ring.  Available only to the kernel.
+ *
+ * Returned Value:
+ *   'len' on success; zero if there is not enough space.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL) || \
+    defined(__KERNEL__)
+size_t ringbuf_mpput(FAR struct ringbuf_s *rb, FAR const void *data,
+                     size_t len);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RINGBUF_H */
@@ -54,6 +54,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mm/shm.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
@@ -143,15 +144,16 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2) /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3) /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4) /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT) /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT) /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT) /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 8) /* Bit 8: Exitting */
-                                            /* Bits 9-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT) /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8) /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 9) /* Bit 9: Exitting */
+                                            /* Bits 10-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -348,6 +350,30 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s *************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure holds the state of the constant bandwidth server (CBS) of a
+ * SCHED_DEADLINE thread.  All times are in units of system clock ticks.  It
+ * is small enough to be kept in the TCB itself.
+ */
+
+struct deadline_s
+{
+  uint32_t  runtime;                /* Execution budget per period              */
+  uint32_t  deadline;               /* Relative deadline                        */
+  uint32_t  period;                 /* Server period                            */
+  uint32_t  budget;                 /* Budget remaining in this period          */
+  clock_t   abstime;                /* Current absolute (scheduling) deadline   */
+  uint32_t  nmisses;                /* Number of deadlines missed               */
+  uint32_t  noverruns;              /* Number of budget exhaustions             */
+  bool      missed;                 /* Current deadline already counted missed  */
+  bool      blocked;                /* Blocked since the last wake-up           */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s *********************************************************/
 /* This structure is used to maintain information about child tasks.  pthreads
  * work differently, they have join information.  This is only for child tasks.
@@ -666,8 +692,14 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct deadline_s deadline;            /* Deadline scheduling parameters      */
+#endif
 
   FAR struct wdog_s *waitdog;            /* All timed waits use this timer      */
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s waithrtimer;          /* Sub-tick timed signal waits         */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
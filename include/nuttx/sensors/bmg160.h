@@ -416,7 +416,9 @@ extern "C"
  * Name: bmg160_register
  *
  * Description:
- *   Register the BMG160 character device as 'devpath'
+ *   Register the BMG160 character device as 'devpath'.  The device is a
+ *   sensor upper half device (see include/nuttx/sensors/sensor.h); read()
+ *   returns struct sensor_gyro_s samples.
  *
  * Input Parameters:
  *   devpath - The full path to the driver to register. E.g., "/dev/gyr0"
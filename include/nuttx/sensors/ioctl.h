@@ -210,4 +210,10 @@
 #define SNIOC_SET_CLEAN_INTERVAL   _SNIOC(0x005d) /* Arg: uint32_t value (seconds) */
 #define SNIOC_START_FAN_CLEANING   _SNIOC(0x005e) /* Arg: None */
 
+/* IOCTL commands common to the sensor upper half (see sensor.h) */
+
+#define SNIOC_SET_PERIOD           _SNIOC(0x005f) /* Arg: uint32_t* (microseconds) */
+#define SNIOC_SET_WATERMARK        _SNIOC(0x0060) /* Arg: uint32_t value (samples) */
+#define SNIOC_FLUSH                _SNIOC(0x0061) /* Arg: None */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
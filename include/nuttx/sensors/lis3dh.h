@@ -239,13 +239,6 @@
  * Public Types
  ****************************************************************************/
 
-struct lis3dh_sensor_data_s
-{
-  float x_acc;                       /* X axis acceleration */
-  float y_acc;                       /* Y axis acceleration */
-  float z_acc;                       /* Z axis acceleration */
-};
-
 /* Configuration structure used to register the driver */
 
 struct lis3dh_config_s
@@ -280,7 +273,10 @@ extern "C"
  * Name: lis3dh_register
  *
  * Description:
- *   Register the LIS3DH character device at the specified device path
+ *   Register the LIS3DH character device at the specified device path.
+ *   The device is a sensor upper half device (see
+ *   include/nuttx/sensors/sensor.h); read() returns struct sensor_accel_s
+ *   samples.
  *
  * Input Parameters:
  *   devpath - Full path of device node to register ie "/dev/accel0"
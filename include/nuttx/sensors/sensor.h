@@ -0,0 +1,269 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/sensors/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************
+ * CONFIG_SENSORS_UPPER - Enables the common sensor upper half
+ * CONFIG_SENSORS_NSAMPLES - Default ring capacity, in samples
+ * CONFIG_SENSORS_NPOLLWAITERS - Number of threads that may poll() one
+ *   sensor at the same time
+ */
+
+/* Sensor types.  The type selects the layout of the samples in the ring. */
+
+#define SENSOR_TYPE_CUSTOM          0  /* Layout defined by the driver */
+#define SENSOR_TYPE_ACCELEROMETER   1  /* struct sensor_accel_s */
+#define SENSOR_TYPE_GYROSCOPE       2  /* struct sensor_gyro_s */
+#define SENSOR_TYPE_MAGNETIC_FIELD  3  /* struct sensor_mag_s */
+#define SENSOR_TYPE_BAROMETER       4  /* struct sensor_baro_s */
+
+/* Unit conversions for the common sample types */
+
+#define SENSOR_STANDARD_GRAVITY     9.80665f      /* m/s^2 per g */
+#define SENSOR_DEG2RAD              0.017453293f  /* rad per degree */
+
+/* Return the address of sample 'n' (a free-running sample count) in the
+ * ring 'r'.
+ */
+
+#define SENSOR_RING_SAMPLE(r,n) \
+  (&(r)->sr_data[((n) & ((r)->sr_nelem - 1)) * (r)->sr_esize])
+
+/* The ioctl commands common to all sensors using the upper half are
+ * defined in include/nuttx/sensors/ioctl.h:
+ *
+ *   SNIOC_SET_PERIOD    - Set the sampling period in microseconds.  The
+ *                         argument is a pointer to a uint32_t that returns
+ *                         the period actually selected by the hardware.
+ *   SNIOC_SET_WATERMARK - Set the number of buffered samples that makes
+ *                         the device readable for poll() and that a
+ *                         blocking read() waits for (1..sr_nelem).
+ *   SNIOC_FLUSH         - Discard all buffered samples.
+ *   FIOC_MMAP           - Return the address of the struct sensor_ring_s
+ *                         for zero-copy access.
+ *
+ * All other commands are passed to the lower half control() method.
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Every sample starts with the time at which it was taken, in microseconds
+ * since the system was started (the same time base as CLOCK_MONOTONIC).
+ */
+
+struct sensor_accel_s             /* SENSOR_TYPE_ACCELEROMETER */
+{
+  uint64_t timestamp;             /* Microseconds */
+  float x;                        /* X axis acceleration, m/s^2 */
+  float y;                        /* Y axis acceleration, m/s^2 */
+  float z;                        /* Z axis acceleration, m/s^2 */
+};
+
+struct sensor_gyro_s              /* SENSOR_TYPE_GYROSCOPE */
+{
+  uint64_t timestamp;             /* Microseconds */
+  float x;                        /* X axis angular rate, rad/s */
+  float y;                        /* Y axis angular rate, rad/s */
+  float z;                        /* Z axis angular rate, rad/s */
+};
+
+struct sensor_mag_s               /* SENSOR_TYPE_MAGNETIC_FIELD */
+{
+  uint64_t timestamp;             /* Microseconds */
+  float x;                        /* X axis field strength, uT */
+  float y;                        /* Y axis field strength, uT */
+  float z;                        /* Z axis field strength, uT */
+};
+
+struct sensor_baro_s              /* SENSOR_TYPE_BAROMETER */
+{
+  uint64_t timestamp;             /* Microseconds */
+  float pressure;                 /* Pressure, hPa */
+  float temperature;              /* Temperature, degrees Celsius */
+};
+
+/* The sample ring.  sr_head and sr_tail are free-running sample counts;
+ * the slot of a sample is the count modulo sr_nelem (a power of two).
+ * Only the driver advances sr_head and only the reader advances sr_tail:
+ * either read() or, after FIOC_MMAP, the application itself.  When the
+ * ring is full, new samples are discarded and counted in sr_drops.
+ */
+
+struct sensor_ring_s
+{
+  volatile uint32_t sr_head;      /* Producer position (written by driver) */
+  volatile uint32_t sr_tail;      /* Consumer position (written by reader) */
+  uint32_t sr_nelem;              /* Capacity of the ring in samples */
+  uint16_t sr_esize;              /* Size of one sample in bytes */
+  uint8_t  sr_type;               /* SENSOR_TYPE_* */
+  uint8_t  sr_reserved;
+  volatile uint32_t sr_drops;     /* Samples dropped because ring was full */
+  uint32_t sr_pad;                /* Aligns sr_data[] to 64 bits */
+  uint8_t  sr_data[1];            /* Start of the samples */
+};
+
+/* This is the vtable that is used by the upper half to call back into the
+ * lower half sensor driver.
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Start (enable == true) or stop sampling.  Sampling is started on the
+   * first open() of the device and stopped on the last close().
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Select the sampling period closest to *period_us and return the
+   * period actually used in *period_us.  Optional.
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR uint32_t *period_us);
+
+  /* Driver specific ioctl commands.  Optional. */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+
+/* The lower half sensor driver provides this structure (normally as the
+ * first member of its private state) to sensor_register().
+ */
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops;
+  uint8_t  type;                  /* SENSOR_TYPE_* */
+  uint16_t esize;                 /* Size of one sample in bytes */
+  uint32_t nelem;                 /* Ring capacity in samples (zero for
+                                   * CONFIG_SENSORS_NSAMPLES) */
+  FAR void *upper;                /* Private to the upper half */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SENSORS_UPPER
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Allocate the sample ring for a lower half sensor driver and register
+ *   the character device at 'path'.
+ *
+ * Input Parameters:
+ *   path  - The full path to the driver to register. E.g., "/dev/accel0"
+ *   lower - The lower half driver state.  The type, esize, and nelem
+ *           fields must be set.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *path,
+                    FAR struct sensor_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Append one sample to the ring of a sensor and wake up any reader that
+ *   waits for it.  The sample must start with its timestamp.  Samples of
+ *   one sensor must be pushed from a single context at a time; that may be
+ *   an interrupt handler.
+ *
+ * Input Parameters:
+ *   lower  - The lower half driver state passed to sensor_register()
+ *   sample - The sample, lower->esize bytes
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the ring was full and the sample was
+ *   dropped.
+ *
+ ****************************************************************************/
+
+int sensor_push(FAR struct sensor_lowerhalf_s *lower, FAR const void *sample);
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in the time base of the sample timestamps.
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void);
+
+#endif /* CONFIG_SENSORS_UPPER */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
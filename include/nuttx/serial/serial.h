@@ -120,6 +120,13 @@
 
 #endif
 
+#ifdef CONFIG_SERIAL_FIFOBUF
+#  define uart_hassendbuf(dev)    ((dev)->ops->sendbuf != NULL)
+#  define uart_hasrecvbuf(dev)    ((dev)->ops->recvbuf != NULL)
+#  define uart_sendbuf(dev,b,n)   (dev)->ops->sendbuf(dev,b,n)
+#  define uart_recvbuf(dev,b,n)   (dev)->ops->recvbuf(dev,b,n)
+#endif
+
 #ifdef CONFIG_SERIAL_IFLOWCONTROL
 #  define uart_rxflowcontrol(dev,n,u) \
     (dev->ops->rxflowcontrol && dev->ops->rxflowcontrol(dev,n,u))
@@ -265,6 +272,25 @@ struct uart_ops_s
    */
 
   CODE bool (*txempty)(FAR struct uart_dev_s *dev);
+
+#ifdef CONFIG_SERIAL_FIFOBUF
+  /* Optional block transfer methods.  These are kept at the end of the
+   * structure so that existing lower halves that do not provide them are
+   * initialized with NULL.
+   *
+   * sendbuf() writes up to 'len' bytes to the transmit FIFO without
+   * waiting and returns the number of bytes accepted.  recvbuf() reads up
+   * to 'len' bytes from the receive FIFO without waiting and returns the
+   * number of bytes read.  The upper half calls these from the interrupt
+   * handler paths of uart_xmitchars() and uart_recvchars() in place of one
+   * send()/receive() call per character.
+   */
+
+  CODE size_t (*sendbuf)(FAR struct uart_dev_s *dev, FAR const char *buffer,
+                         size_t len);
+  CODE size_t (*recvbuf)(FAR struct uart_dev_s *dev, FAR char *buffer,
+                         size_t len);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
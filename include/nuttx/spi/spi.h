@@ -447,6 +447,30 @@
 #  define SPI_TRIGGER(d) \
   (((d)->ops->trigger) ? ((d)->ops->trigger(d)) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_SUBMIT
+ *
+ * Description:
+ *   Start an asynchronous request from the SPI transaction queue (see
+ *   include/nuttx/spi/spi_queue.h).  The lower half must call
+ *   spi_queue_complete() when the request has completed.  Optional; if
+ *   the method is not provided, the queue performs requests on its own
+ *   thread using the other SPI methods.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to start
+ *
+ * Returned Value:
+ *   0 if the request was accepted; negated errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_QUEUE
+#  define SPI_SUBMIT(d,r) \
+  (((d)->ops->submit) ? ((d)->ops->submit(d,r)) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -547,6 +571,7 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+struct spi_request_s;
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -584,6 +609,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_QUEUE
+  CODE int      (*submit)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_request_s *req);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
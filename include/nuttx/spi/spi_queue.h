@@ -0,0 +1,188 @@
+/****************************************************************************
+ * include/nuttx/spi/spi_queue.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SPI_SPI_QUEUE_H
+#define __INCLUDE_NUTTX_SPI_SPI_QUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The asynchronous SPI transaction queue.
+ *
+ * A driver that must talk to a device periodically (a sensor, for example)
+ * does not need a thread of its own blocked on every SPI transfer.  Instead,
+ * it builds a struct spi_request_s that describes the complete sequence of
+ * transfers (chip select, mode, frequency, and the list of TX/RX buffers)
+ * and submits it to the queue of the bus with spi_queue_submit().  That
+ * call returns immediately.  When the transfers have completed, the
+ * request's callback is called on the bus thread.
+ *
+ * Requests are performed in the order that they were submitted.  The
+ * request and everything that it references belong to the SPI queue from
+ * spi_queue_submit() until the callback is called; the callback may
+ * re-submit the same request.
+ *
+ * By default, the bus thread performs each request with spi_transfer()
+ * using the normal SPI methods.  A lower half that can run transfers
+ * without CPU involvement (for example, with chained DMA) may instead
+ * provide the submit() method:  Requests are then passed directly to the
+ * lower half, which must call spi_queue_complete() (possibly from an
+ * interrupt handler) as each request finishes.
+ */
+
+struct spi_queue_s;
+struct spi_request_s;
+
+typedef CODE void (*spi_reqcallback_t)(FAR struct spi_request_s *req);
+
+struct spi_request_s
+{
+  FAR struct spi_request_s *flink;   /* Supports a singly linked list */
+  FAR struct spi_sequence_s *seq;    /* The sequence of transfers */
+  spi_reqcallback_t callback;        /* Called when the request completes */
+  FAR void *arg;                     /* Available for use by the callback */
+  int result;                        /* OK or a negated errno on completion */
+
+  /* The following is for internal use by the SPI queue */
+
+  FAR struct spi_queue_s *queue;     /* The queue the request was sent to */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create the transaction queue for an SPI bus and start the thread that
+ *   serves it.  This is normally called once for each bus by board
+ *   initialization logic; the queue is then passed to each driver on the
+ *   bus.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *   bus - The SPI bus number.  This is used only to name the bus thread.
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi,
+                                             int bus);
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Add a request to the tail of the queue of the SPI bus.  This function
+ *   does not wait for the transfers to be performed.
+ *
+ * Input Parameters:
+ *   queue - The SPI bus queue
+ *   req   - The request to perform.  The seq and callback fields must be
+ *           initialized.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *   In the case of failure, the callback will not be called.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not yet been started from the queue.  The
+ *   callback of a cancelled request is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if the request has already
+ *   been started (its callback will still be called).
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_request_s *req);
+
+/****************************************************************************
+ * Name: spi_queue_complete
+ *
+ * Description:
+ *   Called by a lower half that implements the submit() method when a
+ *   request has completed.  This may be called from an interrupt handler;
+ *   the callback of the request will be called later on the bus thread.
+ *
+ * Input Parameters:
+ *   req    - The completed request
+ *   result - OK or a negated errno value
+ *
+ ****************************************************************************/
+
+void spi_queue_complete(FAR struct spi_request_s *req, int result);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SPI_QUEUE */
+#endif /* __INCLUDE_NUTTX_SPI_SPI_QUEUE_H */
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -96,6 +97,43 @@
 #  define SP_SECTION
 #endif
 
+/* With CONFIG_SPINLOCK_FAIR, the ticket and MCS locks need atomic
+ * read-modify-write operations beyond up_testset().  These may be provided
+ * in arch/spinlock.h; otherwise the GCC built-ins are used.
+ *
+ *   SP_FETCHADD(p,v)   - Add 'v' to '*p', returning the previous value.
+ *   SP_XCHG(p,v)       - Store 'v' in '*p', returning the previous value.
+ *   SP_CMPXCHG(p,o,n)  - Store 'n' in '*p' if '*p' equals 'o'.  Returns
+ *                        true if the store was performed.
+ *
+ * Without CONFIG_SPINLOCK_FAIR, both lock types are simple test-and-set
+ * spinlocks built on up_testset() and the same interfaces may be used.
+ */
+
+#ifdef CONFIG_SPINLOCK_FAIR
+#  if !defined(SP_FETCHADD)
+#    define SP_FETCHADD(p,v)  __sync_fetch_and_add((p), (v))
+#  endif
+
+#  if !defined(SP_XCHG)
+#    define SP_XCHG(p,v)      __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#  endif
+
+#  if !defined(SP_CMPXCHG)
+#    define SP_CMPXCHG(p,o,n) __sync_bool_compare_and_swap((p), (o), (n))
+#  endif
+#endif
+
+/* Static initializers for the ticket and MCS locks */
+
+#ifdef CONFIG_SPINLOCK_FAIR
+#  define SP_TICKET_INITIALIZER { 0, 0 }
+#  define SP_MCS_INITIALIZER    { NULL }
+#else
+#  define SP_TICKET_INITIALIZER { SP_UNLOCKED }
+#  define SP_MCS_INITIALIZER    { SP_UNLOCKED }
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -112,6 +150,43 @@ struct spinlock_s
 #endif
 };
 
+/* A ticket spinlock.  Each CPU that wants the lock takes the next ticket
+ * and waits until that ticket is being served, so the lock is granted in
+ * FIFO order and no CPU can be starved.  The waiters still all spin on the
+ * same 'owner' word.
+ */
+
+struct spinlock_ticket_s
+{
+#ifdef CONFIG_SPINLOCK_FAIR
+  volatile uint32_t next;       /* The next ticket to be handed out */
+  volatile uint32_t owner;      /* The ticket that now holds the lock */
+#else
+  volatile spinlock_t lock;     /* Test-and-set fallback */
+#endif
+};
+
+/* An MCS queued spinlock.  Each waiter brings its own queue node (usually
+ * on its stack) and spins only on that node, so a hand-off touches just
+ * the cache lines of the old and new owners.  The lock is also granted in
+ * FIFO order.
+ */
+
+struct mcs_node_s
+{
+  FAR struct mcs_node_s *volatile next;  /* The next waiter in the queue */
+  volatile bool locked;                  /* True while this waiter waits */
+};
+
+struct spinlock_mcs_s
+{
+#ifdef CONFIG_SPINLOCK_FAIR
+  FAR struct mcs_node_s *volatile tail;  /* The last waiter (or holder) */
+#else
+  volatile spinlock_t lock;              /* Test-and-set fallback */
+#endif
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -409,5 +484,158 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
+/****************************************************************************
+ * Name: spin_initialize_ticket
+ *
+ * Description:
+ *   Initialize a ticket spinlock object to its initial, unlocked state.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to be initialized.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+/* void spin_initialize_ticket(FAR struct spinlock_ticket_s *lock); */
+#ifdef CONFIG_SPINLOCK_FAIR
+#  define spin_initialize_ticket(l) \
+     do { (l)->next = 0; (l)->owner = 0; } while (0)
+#else
+#  define spin_initialize_ticket(l) do { (l)->lock = SP_UNLOCKED; } while (0)
+#endif
+
+/****************************************************************************
+ * Name: spin_lock_ticket
+ *
+ * Description:
+ *   Take a ticket and loop until that ticket is served.  Like spin_lock(),
+ *   this is non-reentrant.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_FAIR
+void spin_lock_ticket(FAR struct spinlock_ticket_s *lock);
+#else
+#  define spin_lock_ticket(l) spin_lock(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: spin_trylock_ticket
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   SP_LOCKED   - Failure, the spinlock was already locked
+ *   SP_UNLOCKED - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_FAIR
+spinlock_t spin_trylock_ticket(FAR struct spinlock_ticket_s *lock);
+#else
+#  define spin_trylock_ticket(l) spin_trylock(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_ticket
+ *
+ * Description:
+ *   Release a ticket spinlock, handing it to the next waiter (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_FAIR
+void spin_unlock_ticket(FAR struct spinlock_ticket_s *lock);
+#else
+#  define spin_unlock_ticket(l) spin_unlock(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: spin_islocked_ticket
+ *
+ * Description:
+ *   Test if a ticket spinlock is held.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to test.
+ *
+ * Returned Value:
+ *   A boolean value: true the spinlock is locked; false if it is unlocked.
+ *
+ ****************************************************************************/
+
+/* bool spin_islocked_ticket(FAR struct spinlock_ticket_s *lock); */
+#ifdef CONFIG_SPINLOCK_FAIR
+#  define spin_islocked_ticket(l) ((l)->next != (l)->owner)
+#else
+#  define spin_islocked_ticket(l) spin_islocked(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: spin_lock_mcs
+ *
+ * Description:
+ *   Queue the caller's node on an MCS spinlock and loop on that node until
+ *   the previous holder passes the lock on.  The node must remain valid
+ *   and must be passed to spin_unlock_mcs() when the lock is released.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock object to lock.
+ *   node - The queue node to use for this acquisition.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_FAIR
+void spin_lock_mcs(FAR struct spinlock_mcs_s *lock,
+                   FAR struct mcs_node_s *node);
+#else
+#  define spin_lock_mcs(l,n) spin_lock(&(l)->lock)
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_mcs
+ *
+ * Description:
+ *   Release an MCS spinlock, handing it to the next queued waiter (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock object to unlock.
+ *   node - The queue node that was passed to spin_lock_mcs().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_FAIR
+void spin_unlock_mcs(FAR struct spinlock_mcs_s *lock,
+                     FAR struct mcs_node_s *node);
+#else
+#  define spin_unlock_mcs(l,n) spin_unlock(&(l)->lock)
+#endif
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
@@ -58,6 +58,8 @@ typedef int  (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef void (*lib_puts_t)(FAR struct lib_outstream_s *this,
+                           FAR const void *buf, int len);
 typedef int  (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s
@@ -72,7 +74,8 @@ struct lib_outstream_s
   lib_putc_t             put;     /* Put one character to the outstream */
   lib_flush_t            flush;   /* Flush any buffered characters in the outstream */
   int                    nput;    /* Total number of characters put.  Written
-                                   * by put method, readable by user */
+                                   * by put/puts methods, readable by user */
+  lib_puts_t             puts;    /* Put a block of characters to the outstream */
 };
 
 /* Seek-able streams */
@@ -430,6 +433,22 @@ void emergstream(FAR struct lib_outstream_s *stream);
 
 int lib_noflush(FAR struct lib_outstream_s *stream);
 
+/****************************************************************************
+ * Name: lib_noputs
+ *
+ * Description:
+ *  lib_noputs() provides a common puts method for output streams that have
+ *  no native block output.  The block is passed to the stream's put method
+ *  one character at a time.
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+void lib_noputs(FAR struct lib_outstream_s *this, FAR const void *buf,
+                int len);
+
 /****************************************************************************
  * Name: lib_snoflush
  *
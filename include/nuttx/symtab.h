@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -70,6 +72,21 @@ struct symtab_s
   FAR const void *sym_value;         /* The value associated witht the string */
 };
 
+/* struct symtab_hash_s is a hash index over a symbol table.  It is built
+ * by symtab_inithash() so that many names can be looked up in a large table
+ * in constant time.  If the index could not be allocated, sh_buckets is
+ * NULL and symtab_findbyhash() falls back to searching the table.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *sh_symtab; /* The indexed symbol table */
+  FAR uint16_t *sh_buckets;          /* First symbol in each bucket (index+1) */
+  FAR uint16_t *sh_chain;            /* Next symbol in the bucket (index+1) */
+  uint16_t sh_nbuckets;              /* Number of buckets (a power of two) */
+  int sh_nsyms;                      /* Number of symbols in sh_symtab */
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -155,6 +172,51 @@ FAR const struct symtab_s *
 symtab_findorderedbyvalue(FAR const struct symtab_s *symtab,
                           FAR void *value, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_inithash
+ *
+ * Description:
+ *   Build a hash index over a symbol table.  The symbol table is not
+ *   modified and must remain valid until symtab_freehash() is called.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  On failure, a negated errno value is returned;
+ *   the index may still be used with symtab_findbyhash(), which will then
+ *   search the table directly.
+ *
+ ****************************************************************************/
+
+int symtab_inithash(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name using a hash index.  If several
+ *   symbols have the name, the first in the table is returned, as with
+ *   symtab_findbyname().
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_freehash
+ *
+ * Description:
+ *   Free the memory allocated by symtab_inithash().
+ *
+ ****************************************************************************/
+
+void symtab_freehash(FAR struct symtab_hash_s *hash);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
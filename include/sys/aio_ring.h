@@ -0,0 +1,187 @@
+/****************************************************************************
+ * include/sys/aio_ring.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __INCLUDE_SYS_AIO_RING_H
+#define __INCLUDE_SYS_AIO_RING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <aio.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* An opaque reference to an I/O context created by io_setup() */
+
+struct aio_ring_s;
+typedef FAR struct aio_ring_s *io_context_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: io_setup
+ *
+ * Description:
+ *   Create an asynchronous I/O context that can hold up to 'nevents'
+ *   requests in flight.  Requests are submitted to the context with
+ *   io_submit() and their completions are collected with io_getevents().
+ *
+ *   NOTE: These interfaces are similar to the Linux interfaces of the same
+ *   names, but the requests are described with standard POSIX AIO control
+ *   blocks.  The result of each completed request is obtained with
+ *   aio_return().
+ *
+ * Input Parameters:
+ *   nevents - The maximum number of requests in flight
+ *   ctxp    - The location to return the new I/O context
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately:
+ *
+ *   EINVAL - 'nevents' is zero or too large, or 'ctxp' is NULL
+ *   ENOMEM - Insufficient memory to create the context
+ *
+ ****************************************************************************/
+
+int io_setup(unsigned int nevents, FAR io_context_t *ctxp);
+
+/****************************************************************************
+ * Name: io_destroy
+ *
+ * Description:
+ *   Destroy an I/O context created by io_setup().  All submitted requests
+ *   must have been collected with io_getevents().
+ *
+ * Input Parameters:
+ *   ctx - The I/O context to destroy
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately:
+ *
+ *   EINVAL - 'ctx' is not valid
+ *   EBUSY  - There are requests still in flight or not yet collected
+ *
+ ****************************************************************************/
+
+int io_destroy(io_context_t ctx);
+
+/****************************************************************************
+ * Name: io_submit
+ *
+ * Description:
+ *   Queue a batch of asynchronous I/O requests.  The operation for each
+ *   request is selected by its aio_lio_opcode field (LIO_READ or
+ *   LIO_WRITE).  The requests are queued with the scheduler locked so
+ *   that adjacent requests on the same file may be merged by the AIO
+ *   worker threads.  The client is also notified of each completion as
+ *   specified by aio_sigevent.
+ *
+ * Input Parameters:
+ *   ctx   - The I/O context
+ *   nr    - The number of requests in 'list'
+ *   list  - The requests to submit
+ *
+ * Returned Value:
+ *   The number of requests that were queued which may be fewer than 'nr'
+ *   if the context is full.  Otherwise, -1 is returned and the errno is
+ *   set appropriately:
+ *
+ *   EAGAIN - No request could be queued because the context is full
+ *   EINVAL - Bad input parameters or an invalid aio_lio_opcode
+ *   EBADF  - The file descriptor of the first request is not valid
+ *
+ ****************************************************************************/
+
+int io_submit(io_context_t ctx, int nr, FAR struct aiocb * const list[]);
+
+/****************************************************************************
+ * Name: io_getevents
+ *
+ * Description:
+ *   Collect completed requests from an I/O context.  Wait until at least
+ *   'min_nr' requests have completed or until the timeout expires, then
+ *   return up to 'nr' completed requests.
+ *
+ * Input Parameters:
+ *   ctx     - The I/O context
+ *   min_nr  - The minimum number of completed requests to wait for
+ *   nr      - The maximum number of completed requests to return
+ *   events  - The location to return the completed requests
+ *   timeout - The maximum time to wait (relative), or NULL to wait
+ *             indefinitely
+ *
+ * Returned Value:
+ *   The number of completed requests returned in 'events' (which may be
+ *   less than 'min_nr' if the timeout expired or a signal was received).
+ *   Otherwise, -1 is returned and the errno is set appropriately:
+ *
+ *   EINVAL - Bad input parameters
+ *   EINTR  - Interrupted by a signal before any request completed
+ *
+ ****************************************************************************/
+
+int io_getevents(io_context_t ctx, int min_nr, int nr,
+                 FAR struct aiocb *events[],
+                 FAR const struct timespec *timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_SYS_AIO_RING_H */
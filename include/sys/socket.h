@@ -61,6 +61,7 @@
 #define PF_INET6      10 /* IPv6 Internet protocols */
 #define PF_NETLINK    16 /* Netlink IPC socket */
 #define PF_PACKET     17 /* Low level packet interface */
+#define PF_CAN        29 /* Controller Area Network */
 #define PF_BLUETOOTH  31 /* Bluetooth sockets */
 #define PF_IEEE802154 36 /* Low level IEEE 802.15.4 radio frame interface */
 #define PF_PKTRADIO   64 /* Low level packet radio interface */
@@ -76,6 +77,7 @@
 #define AF_INET6       PF_INET6
 #define AF_NETLINK     PF_NETLINK
 #define AF_PACKET      PF_PACKET
+#define AF_CAN         PF_CAN
 #define AF_BLUETOOTH   PF_BLUETOOTH
 #define AF_IEEE802154  PF_IEEE802154
 #define AF_PKTRADIO    PF_PKTRADIO
@@ -124,6 +126,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): block until 1+ packets avail */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -208,6 +211,7 @@
 #define SOL_L2CAP       6 /* See options in include/netpacket/bluetooth.h */
 #define SOL_SCO         7 /* See options in include/netpacket/bluetooth.h */
 #define SOL_RFCOMM      8 /* See options in include/netpacket/bluetooth.h */
+#define SOL_CAN_RAW     9 /* See options in include/netpacket/can.h */
 
 /* Protocol-level socket options may begin with this value */
 
@@ -248,6 +252,11 @@
 #define CMSG_FIRSTHDR(msg) \
   __CMSG_FIRSTHDR((msg)->msg_control, (msg)->msg_controllen)
 
+/* Socket-level control message types (cmsg_level SOL_SOCKET) */
+
+#define SCM_RIGHTS      0x01 /* Array of file descriptors passed */
+#define SCM_TIMESTAMP   0x02 /* Reception time as a struct timeval */
+
 /****************************************************************************
  * Type Definitions
  ****************************************************************************/
@@ -303,6 +312,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* Used with sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -378,6 +395,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
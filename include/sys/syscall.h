@@ -291,7 +291,15 @@
 #    define SYS_aio_write              (__SYS_descriptors + 7)
 #    define SYS_aio_fsync              (__SYS_descriptors + 8)
 #    define SYS_aio_cancel             (__SYS_descriptors + 9)
-#    define __SYS_poll                 (__SYS_descriptors + 10)
+#    ifdef CONFIG_FS_AIO_RING
+#      define SYS_io_setup             (__SYS_descriptors + 10)
+#      define SYS_io_destroy           (__SYS_descriptors + 11)
+#      define SYS_io_submit            (__SYS_descriptors + 12)
+#      define SYS_io_getevents         (__SYS_descriptors + 13)
+#      define __SYS_poll               (__SYS_descriptors + 14)
+#    else
+#      define __SYS_poll               (__SYS_descriptors + 10)
+#    endif
 #  else
 #    define __SYS_poll                 (__SYS_descriptors + 6)
 #  endif
@@ -384,12 +392,8 @@
 #    define __SYS_sendfile             (__SYS_fs_fdopen + 0)
 #  endif
 
-#  if defined(CONFIG_NET_SENDFILE)
-#    define SYS_sendfile,              __SYS_sendfile
-#    define __SYS_mountpoint           (__SYS_sendfile + 1)
-#  else
-#    define __SYS_mountpoint           __SYS_sendfile
-#  endif
+#  define SYS_sendfile                 __SYS_sendfile
+#  define __SYS_mountpoint             (__SYS_sendfile + 1)
 
 #  if !defined(CONFIG_DISABLE_MOUNTPOINT)
 #  if defined(CONFIG_FS_READABLE)
@@ -537,10 +541,14 @@
 #  define SYS_listen                   (__SYS_network + 6)
 #  define SYS_recv                     (__SYS_network + 7)
 #  define SYS_recvfrom                 (__SYS_network + 8)
-#  define SYS_send                     (__SYS_network + 9)
-#  define SYS_sendto                   (__SYS_network + 10)
-#  define SYS_setsockopt               (__SYS_network + 11)
-#  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_recvmmsg                 (__SYS_network + 9)
+#  define SYS_recvmsg                  (__SYS_network + 10)
+#  define SYS_send                     (__SYS_network + 11)
+#  define SYS_sendmmsg                 (__SYS_network + 12)
+#  define SYS_sendmsg                  (__SYS_network + 13)
+#  define SYS_sendto                   (__SYS_network + 14)
+#  define SYS_setsockopt               (__SYS_network + 15)
+#  define SYS_socket                   (__SYS_network + 16)
 #else
 #  define SYS_socket                    __SYS_network
 #endif
@@ -112,6 +112,8 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
  *   modp     - Module state information
  *   loadinfo - Load state information
  *   sym      - Symbol table entry (value might be undefined)
+ *   exports  - The hashed base code symbol table to use for resolving
+ *              undefined symbols not exported by other modules.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -125,8 +127,10 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
  *
  ****************************************************************************/
 
+struct symtab_hash_s;
 int modlib_symvalue(FAR struct module_s *modp,
-                    FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym);
+                    FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
+                    FAR const struct symtab_hash_s *exports);
 
 /****************************************************************************
  * Name: modlib_loadshdrs
@@ -52,39 +52,50 @@
 
 #include "modlib/modlib.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of relocation entries read from the file at a time */
+
+#define MODLIB_RELBATCH 16
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: modlib_readrel
+ * Name: modlib_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read up to 'nrels' Elf32_Rel structures, starting at 'index', into
+ *   memory with a single read.
  *
  ****************************************************************************/
 
-static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
-                                 FAR const Elf32_Shdr *relsec,
-                                 int index, FAR Elf32_Rel *rel)
+static inline int modlib_readrels(FAR struct mod_loadinfo_s *loadinfo,
+                                  FAR const Elf32_Shdr *relsec,
+                                  int index, FAR Elf32_Rel *rels, int nrels)
 {
   off_t offset;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation indices lie within the relocation section */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || nrels <= 0 ||
+      index + nrels > (relsec->sh_size / sizeof(Elf32_Rel)))
     {
       berr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return modlib_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return modlib_read(loadinfo, (FAR uint8_t *)rels,
+                     sizeof(Elf32_Rel) * nrels, offset);
 }
 
 /****************************************************************************
@@ -100,15 +111,17 @@ static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int modlib_relocate(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                           FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR const struct symtab_hash_s *exports)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  Elf32_Rel       rels[MODLIB_RELBATCH];
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  int             nrels;
   int             symidx;
   int             ret;
   int             i;
@@ -118,25 +131,37 @@ static int modlib_relocate(FAR struct module_s *modp,
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  for (i = 0; i < nrels; i++)
     {
+      FAR Elf32_Rel *rel = &rels[i % MODLIB_RELBATCH];
+
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next batch of relocation entries into memory */
 
-      ret = modlib_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if (i % MODLIB_RELBATCH == 0)
         {
-          berr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          int nbatch = nrels - i;
+          if (nbatch > MODLIB_RELBATCH)
+            {
+              nbatch = MODLIB_RELBATCH;
+            }
+
+          ret = modlib_readrels(loadinfo, relsec, i, rels, nbatch);
+          if (ret < 0)
+            {
+              berr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
       /* Read the symbol table entry into memory */
 
@@ -150,7 +175,7 @@ static int modlib_relocate(FAR struct module_s *modp,
 
       /* Get the value of the symbol (in sym.st_value) */
 
-      ret = modlib_symvalue(modp, loadinfo, &sym);
+      ret = modlib_symvalue(modp, loadinfo, &sym, exports);
       if (ret < 0)
         {
           /* The special error -ESRCH is returned only in one condition:  The
@@ -179,18 +204,18 @@ static int modlib_relocate(FAR struct module_s *modp,
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           berr("ERROR: Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           berr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
@@ -202,7 +227,8 @@ static int modlib_relocate(FAR struct module_s *modp,
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                              FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                              FAR const struct symtab_hash_s *exports)
 {
   berr("ERROR: Not implemented\n");
   return -ENOSYS;
@@ -231,6 +257,9 @@ static int modlib_relocateadd(FAR struct module_s *modp,
 
 int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 {
+  FAR const struct symtab_s *symtab;
+  struct symtab_hash_s exphash;
+  int nsymbols;
   int ret;
   int i;
 
@@ -253,6 +282,14 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
       return -ENOMEM;
     }
 
+  /* Index the symbols exported by the base code by name.  If there is not
+   * enough memory for the index, symtab_findbyhash() will simply search
+   * the table.
+   */
+
+  modlib_getsymtab(&symtab, &nsymbols);
+  (void)symtab_inithash(&exphash, symtab, nsymbols);
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -278,11 +315,11 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = modlib_relocate(modp, loadinfo, i);
+          ret = modlib_relocate(modp, loadinfo, i, &exphash);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
-          ret = modlib_relocateadd(modp, loadinfo, i);
+          ret = modlib_relocateadd(modp, loadinfo, i, &exphash);
         }
 
       if (ret < 0)
@@ -291,6 +328,8 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
         }
     }
 
+  symtab_freehash(&exphash);
+
 #if defined(CONFIG_ARCH_HAVE_COHERENT_DCACHE)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <string.h>
@@ -50,6 +51,7 @@
 
 #include <nuttx/module.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/modlib.h>
 
 #include "modlib/modlib.h"
@@ -169,6 +171,16 @@ int modlib_initialize(FAR const char *filename,
       return -errval;
     }
 
+  /* If the file system can map the file into memory, then the file data
+   * can be accessed directly without reading it.
+   */
+
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = NULL;
+    }
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = modlib_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
@@ -51,6 +51,8 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/lib/modlib.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -87,6 +89,187 @@ static inline void modlib_dumpreaddata(FAR char *buffer, int buflen)
 #  define modlib_dumpreaddata(b,n)
 #endif
 
+/****************************************************************************
+ * Name: modlib_fileread
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset' into 'buffer'.
+ *
+ ****************************************************************************/
+
+static int modlib_fileread(FAR struct mod_loadinfo_s *loadinfo,
+                           FAR uint8_t *buffer, size_t readsize,
+                           off_t offset)
+{
+  ssize_t nbytes;      /* Number of bytes read */
+  off_t   rpos;        /* Position returned by lseek */
+
+  /* Loop until all of the requested data has been read. */
+
+  while (readsize > 0)
+    {
+      /* Seek to the next read position */
+
+      rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
+      if (rpos != offset)
+        {
+          int errval = get_errno();
+          berr("ERROR: Failed to seek to position %lu: %d\n",
+               (unsigned long)offset, errval);
+          return -errval;
+        }
+
+      /* Read the file data at offset into the user buffer */
+
+      nbytes = _NX_READ(loadinfo->filfd, buffer, readsize);
+      if (nbytes < 0)
+        {
+          int errval = _NX_GETERRNO(nbytes);
+
+          /* EINTR just means that we received a signal */
+
+          if (errval != EINTR)
+            {
+              berr("ERROR: Read from offset %lu failed: %d\n",
+                   (unsigned long)offset, errval);
+              return -errval;
+            }
+        }
+      else if (nbytes == 0)
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+      else
+        {
+          readsize -= nbytes;
+          buffer   += nbytes;
+          offset   += nbytes;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: modlib_cacheread
+ *
+ * Description:
+ *   Read 'readsize' bytes from the object file at 'offset' through the
+ *   block cache.  The least recently used block is replaced on a miss.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MODLIB_CACHEBLOCKS > 0
+static int modlib_cacheread(FAR struct mod_loadinfo_s *loadinfo,
+                            FAR uint8_t *buffer, size_t readsize,
+                            off_t offset)
+{
+  FAR uint8_t *block;
+  off_t blkoff;
+  size_t blklen;
+  size_t ncopy;
+  int slot;
+  int ret;
+  int i;
+
+  /* Allocate the cache on first use.  If that fails, just read the file */
+
+  if (loadinfo->cache == NULL)
+    {
+      loadinfo->cache = (FAR uint8_t *)
+        lib_malloc(CONFIG_MODLIB_CACHEBLOCKS * CONFIG_MODLIB_CACHEBLOCKSIZE);
+      if (loadinfo->cache == NULL)
+        {
+          return modlib_fileread(loadinfo, buffer, readsize, offset);
+        }
+    }
+
+  while (readsize > 0)
+    {
+      blkoff = offset & ~((off_t)CONFIG_MODLIB_CACHEBLOCKSIZE - 1);
+
+      /* Look for the block in the cache, remembering the least recently
+       * used slot in case it is not there.
+       */
+
+      slot = 0;
+      for (i = 0; i < CONFIG_MODLIB_CACHEBLOCKS; i++)
+        {
+          if (loadinfo->cachelen[i] > 0 && loadinfo->cacheoff[i] == blkoff)
+            {
+              break;
+            }
+
+          if (loadinfo->cachelen[i] == 0 ||
+              (loadinfo->cachelen[slot] > 0 &&
+               loadinfo->cacheage[i] < loadinfo->cacheage[slot]))
+            {
+              slot = i;
+            }
+        }
+
+      if (i < CONFIG_MODLIB_CACHEBLOCKS)
+        {
+          slot = i;
+        }
+      else
+        {
+          /* Cache miss.  Read the block (or what is left of the file) */
+
+          blklen = CONFIG_MODLIB_CACHEBLOCKSIZE;
+          if (blkoff + (off_t)blklen > loadinfo->filelen)
+            {
+              if (blkoff >= loadinfo->filelen)
+                {
+                  berr("ERROR: Unexpected end of file\n");
+                  return -ENODATA;
+                }
+
+              blklen = loadinfo->filelen - blkoff;
+            }
+
+          loadinfo->cachelen[slot] = 0;
+          ret = modlib_fileread(loadinfo,
+                                loadinfo->cache +
+                                slot * CONFIG_MODLIB_CACHEBLOCKSIZE,
+                                blklen, blkoff);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          loadinfo->cacheoff[slot] = blkoff;
+          loadinfo->cachelen[slot] = blklen;
+        }
+
+      loadinfo->cacheage[slot] = ++loadinfo->cacheclock;
+
+      /* Copy the part of the block that was requested */
+
+      if (offset - blkoff >= loadinfo->cachelen[slot])
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      block = loadinfo->cache + slot * CONFIG_MODLIB_CACHEBLOCKSIZE;
+      ncopy = loadinfo->cachelen[slot] - (offset - blkoff);
+      if (ncopy > readsize)
+        {
+          ncopy = readsize;
+        }
+
+      memcpy(buffer, block + (offset - blkoff), ncopy);
+      readsize -= ncopy;
+      buffer   += ncopy;
+      offset   += ncopy;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -107,55 +290,43 @@ static inline void modlib_dumpreaddata(FAR char *buffer, int buflen)
 int modlib_read(FAR struct mod_loadinfo_s *loadinfo, FAR uint8_t *buffer,
                 size_t readsize, off_t offset)
 {
-  ssize_t nbytes;      /* Number of bytes read */
-  off_t   rpos;        /* Position returned by lseek */
+  int ret;
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
-  /* Loop until all of the requested data has been read. */
-
-  while (readsize > 0)
+  if (loadinfo->xipbase != NULL)
     {
-      /* Seek to the next read position */
+      /* The file is mapped into memory; just copy the data */
 
-      rpos = lseek(loadinfo->filfd, offset, SEEK_SET);
-      if (rpos != offset)
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
         {
-          int errval = get_errno();
-          berr("ERROR: Failed to seek to position %lu: %d\n",
-               (unsigned long)offset, errval);
-          return -errval;
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
         }
 
-      /* Read the file data at offset into the user buffer */
+      memcpy(buffer, loadinfo->xipbase + offset, readsize);
+      ret = OK;
+    }
+#if CONFIG_MODLIB_CACHEBLOCKS > 0
+  else if (readsize < CONFIG_MODLIB_CACHEBLOCKSIZE)
+    {
+      /* Small reads of symbols, relocations, and names go through the
+       * cache.
+       */
 
-       nbytes = _NX_READ(loadinfo->filfd, buffer, readsize);
-       if (nbytes < 0)
-         {
-           int errval = _NX_GETERRNO(nbytes);
-
-           /* EINTR just means that we received a signal */
-
-           if (errval != EINTR)
-             {
-               berr("ERROR: Read from offset %lu failed: %d\n",
-                    (unsigned long)offset, errval);
-               return -errval;
-             }
-         }
-       else if (nbytes == 0)
-         {
-           berr("ERROR: Unexpected end of file\n");
-           return -ENODATA;
-         }
-       else
-         {
-           readsize -= nbytes;
-           buffer   += nbytes;
-           offset   += nbytes;
-         }
+      ret = modlib_cacheread(loadinfo, buffer, readsize, offset);
+    }
+#endif
+  else
+    {
+      ret = modlib_fileread(loadinfo, buffer, readsize, offset);
     }
 
-  modlib_dumpreaddata(buffer, readsize);
-  return OK;
+  if (ret == OK)
+    {
+      modlib_dumpreaddata(buffer, readsize);
+    }
+
+  return ret;
 }
@@ -318,6 +318,8 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
  *   modp     - Module state information
  *   loadinfo - Load state information
  *   sym      - Symbol table entry (value might be undefined)
+ *   exports  - The hashed base code symbol table to use for resolving
+ *              undefined symbols not exported by other modules.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -332,12 +334,12 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
  ****************************************************************************/
 
 int modlib_symvalue(FAR struct module_s *modp,
-                    FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym)
+                    FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
+                    FAR const struct symtab_hash_s *exports)
 {
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
   uintptr_t secbase;
-  int nsymbols;
   int ret;
 
   switch (sym->st_shndx)
@@ -400,14 +402,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            modlib_getsymtab(&symbol, &nsymbols);
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-            symbol = symtab_findorderedbyname(symbol, exportinfo.name,
-                                              nsymbols);
-#else
-            symbol = symtab_findbyname(symbol, exportinfo.name,
-                                       nsymbols);
-#endif
+            symbol = symtab_findbyhash(exports, exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
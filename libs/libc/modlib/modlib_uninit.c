@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <string.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -112,5 +113,14 @@ int modlib_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#if CONFIG_MODLIB_CACHEBLOCKS > 0
+  if (loadinfo->cache != NULL)
+    {
+      lib_free((FAR void *)loadinfo->cache);
+      loadinfo->cache     = NULL;
+      memset(loadinfo->cachelen, 0, sizeof(loadinfo->cachelen));
+    }
+#endif
+
   return OK;
 }
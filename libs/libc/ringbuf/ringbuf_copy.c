@@ -0,0 +1,100 @@
+/****************************************************************************
+ * libs/libc/ringbuf/ringbuf_copy.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/ringbuf.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_copyin
+ *
+ * Description:
+ *   Copy data into a ring at index 'head', wrapping at the end of the
+ *   buffer as necessary.  At most two memcpy() calls are needed.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_copyin(FAR uint8_t *buffer, size_t size, size_t head,
+                      FAR const void *data, size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t first = size - head;
+
+  if (len < first)
+    {
+      memcpy(&buffer[head], src, len);
+      return head + len;
+    }
+
+  memcpy(&buffer[head], src, first);
+  memcpy(buffer, src + first, len - first);
+  return len - first;
+}
+
+/****************************************************************************
+ * Name: ringbuf_copyout
+ *
+ * Description:
+ *   Copy data out of a ring from index 'tail', wrapping at the end of the
+ *   buffer as necessary.  At most two memcpy() calls are needed.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_copyout(FAR const uint8_t *buffer, size_t size, size_t tail,
+                       FAR void *data, size_t len)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)data;
+  size_t first = size - tail;
+
+  if (len < first)
+    {
+      memcpy(dest, &buffer[tail], len);
+      return tail + len;
+    }
+
+  memcpy(dest, &buffer[tail], first);
+  memcpy(dest + first, buffer, len - first);
+  return len - first;
+}
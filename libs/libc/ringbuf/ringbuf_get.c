@@ -0,0 +1,122 @@
+/****************************************************************************
+ * libs/libc/ringbuf/ringbuf_get.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/ringbuf.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_get
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the ring.  Called only by the consumer.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_get(FAR struct ringbuf_s *rb, FAR void *data, size_t len)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+  size_t used;
+
+  used = RINGBUF_USED(head, tail, rb->rb_size);
+  if (len > used)
+    {
+      len = used;
+    }
+
+  if (len > 0)
+    {
+      /* Read the data only after the head index that covers it */
+
+      RINGBUF_MB();
+      tail = ringbuf_copyout(rb->rb_buffer, rb->rb_size, tail, data, len);
+
+      /* And release the space only after the data has been read */
+
+      RINGBUF_MB();
+      rb->rb_tail = tail;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ringbuf_peek
+ *
+ * Description:
+ *   Return the address and length of the contiguous data at the tail of
+ *   the ring.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_peek(FAR struct ringbuf_s *rb, FAR void **data)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+  size_t used;
+
+  used = RINGBUF_USED(head, tail, rb->rb_size);
+  if (used > rb->rb_size - tail)
+    {
+      used = rb->rb_size - tail;
+    }
+
+  RINGBUF_MB();
+  *data = &rb->rb_buffer[tail];
+  return used;
+}
+
+/****************************************************************************
+ * Name: ringbuf_consume
+ *
+ * Description:
+ *   Release 'len' bytes used in place after ringbuf_peek().
+ *
+ ****************************************************************************/
+
+void ringbuf_consume(FAR struct ringbuf_s *rb, size_t len)
+{
+  RINGBUF_MB();
+  rb->rb_tail = RINGBUF_ADVANCE(rb->rb_tail, len, rb->rb_size);
+}
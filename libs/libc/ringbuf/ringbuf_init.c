@@ -0,0 +1,119 @@
+/****************************************************************************
+ * libs/libc/ringbuf/ringbuf_init.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/ringbuf.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize a ring buffer to use the caller provided storage.
+ *
+ ****************************************************************************/
+
+int ringbuf_init(FAR struct ringbuf_s *rb, FAR void *buffer, size_t size)
+{
+  if (size < 2 || size > UINT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  rb->rb_head   = 0;
+  rb->rb_tail   = 0;
+  rb->rb_size   = size;
+  rb->rb_buffer = (FAR uint8_t *)buffer;
+#ifdef CONFIG_SMP
+  rb->rb_lock   = SP_UNLOCKED;
+#endif
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ringbuf_reset
+ *
+ * Description:
+ *   Discard all data in the ring.
+ *
+ ****************************************************************************/
+
+void ringbuf_reset(FAR struct ringbuf_s *rb)
+{
+  rb->rb_head = 0;
+  rb->rb_tail = 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_used
+ *
+ * Description:
+ *   Return the number of bytes that may be read from the ring.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_used(FAR const struct ringbuf_s *rb)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+
+  return RINGBUF_USED(head, tail, rb->rb_size);
+}
+
+/****************************************************************************
+ * Name: ringbuf_space
+ *
+ * Description:
+ *   Return the number of bytes that may be written to the ring.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_space(FAR const struct ringbuf_s *rb)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+
+  return RINGBUF_SPACE(head, tail, rb->rb_size);
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * libs/libc/ringbuf/ringbuf_mpput.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/ringbuf.h>
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL) || \
+    defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_mpput
+ *
+ * Description:
+ *   Write a complete message into a ring that has several producers.
+ *
+ *   Only the producers are serialized, and only for the time needed to
+ *   copy the message.  Local interrupts are disabled so that a producer in
+ *   an interrupt handler cannot spin on a lock held by the code that it
+ *   interrupted.  The consumer never takes the lock.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_mpput(FAR struct ringbuf_s *rb, FAR const void *data,
+                     size_t len)
+{
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+
+  flags = up_irq_save();
+#ifdef CONFIG_SMP
+  while (up_testset(&rb->rb_lock) == SP_LOCKED)
+    {
+    }
+#endif
+
+  head = rb->rb_head;
+  tail = rb->rb_tail;
+
+  if (len > RINGBUF_SPACE(head, tail, rb->rb_size))
+    {
+      len = 0;
+    }
+  else if (len > 0)
+    {
+      head = ringbuf_copyin(rb->rb_buffer, rb->rb_size, head, data, len);
+
+      RINGBUF_WMB();
+      rb->rb_head = head;
+    }
+
+#ifdef CONFIG_SMP
+  RINGBUF_MB();
+  rb->rb_lock = SP_UNLOCKED;
+#endif
+  up_irq_restore(flags);
+  return len;
+}
+
+#endif /* !CONFIG_BUILD_PROTECTED && !CONFIG_BUILD_KERNEL || __KERNEL__ */
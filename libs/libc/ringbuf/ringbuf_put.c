@@ -0,0 +1,120 @@
+/****************************************************************************
+ * libs/libc/ringbuf/ringbuf_put.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/ringbuf.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_put
+ *
+ * Description:
+ *   Copy as much of the data as fits into the ring.  Called only by the
+ *   producer.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_put(FAR struct ringbuf_s *rb, FAR const void *data,
+                   size_t len)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+  size_t space;
+
+  space = RINGBUF_SPACE(head, tail, rb->rb_size);
+  if (len > space)
+    {
+      len = space;
+    }
+
+  if (len > 0)
+    {
+      head = ringbuf_copyin(rb->rb_buffer, rb->rb_size, head, data, len);
+
+      /* The data must be visible before the new head index */
+
+      RINGBUF_WMB();
+      rb->rb_head = head;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ringbuf_prepare
+ *
+ * Description:
+ *   Return the address and length of the contiguous free space at the head
+ *   of the ring.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_prepare(FAR struct ringbuf_s *rb, FAR void **data)
+{
+  uint32_t head = rb->rb_head;
+  uint32_t tail = rb->rb_tail;
+  size_t space;
+
+  space = RINGBUF_SPACE(head, tail, rb->rb_size);
+  if (space > rb->rb_size - head)
+    {
+      space = rb->rb_size - head;
+    }
+
+  *data = &rb->rb_buffer[head];
+  return space;
+}
+
+/****************************************************************************
+ * Name: ringbuf_commit
+ *
+ * Description:
+ *   Publish 'len' bytes written in place after ringbuf_prepare().
+ *
+ ****************************************************************************/
+
+void ringbuf_commit(FAR struct ringbuf_s *rb, size_t len)
+{
+  RINGBUF_WMB();
+  rb->rb_head = RINGBUF_ADVANCE(rb->rb_head, len, rb->rb_size);
+}
@@ -134,6 +134,11 @@ enum
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Block output */
+
+static void putblock(FAR struct lib_outstream_s *obj, FAR const char *buf,
+                     int len);
+
 /* Pointer to ASCII conversion */
 
 #ifdef CONFIG_PTR_IS_NOT_INT
@@ -201,6 +206,28 @@ static const char g_nullstring[] = "(null)";
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: putblock
+ *
+ * Description:
+ *   Output a block of characters with the puts method of the stream.
+ *   Streams set up without a puts method get one put() per character.
+ *
+ ****************************************************************************/
+
+static void putblock(FAR struct lib_outstream_s *obj, FAR const char *buf,
+                     int len)
+{
+  if (obj->puts != NULL)
+    {
+      obj->puts(obj, buf, len);
+    }
+  else
+    {
+      lib_noputs(obj, buf, len);
+    }
+}
+
 /* Include floating point functions */
 
 #ifdef CONFIG_LIBC_FLOATINGPOINT
@@ -271,19 +298,20 @@ static int getpsize(uint8_t flags, FAR void *p)
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 {
   char buf[16];
-  int i = 0;
+  int i = sizeof(buf);
+
+  /* Generate the digits from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
   do
     {
-      buf[i++] = n % 10 + '0';
+      buf[--i] = n % 10 + '0';
       n /= 10;
     }
   while (n > 0);
 
-  while (i > 0)
-    {
-      obj->put(obj, buf[--i]);
-    }
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -293,31 +321,31 @@ static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 static void utohex(FAR struct lib_outstream_s *obj, unsigned int n,
                    uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buf[(CHAR_BIT * sizeof(unsigned int) + 3) / 4];
+  int i = sizeof(buf);
+
+  /* Generate the nibbles from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
-  for (bits = CHAR_BIT * sizeof(unsigned int); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
+      uint8_t nibble = (uint8_t)(n & 0xf);
 
-          if (nibble < 10)
-            {
-              obj->put(obj, nibble + '0');
-            }
-          else
-            {
-              obj->put(obj, nibble + a - 10);
-            }
+      if (nibble < 10)
+        {
+          buf[--i] = nibble + '0';
+        }
+      else
+        {
+          buf[--i] = nibble + a - 10;
         }
-    }
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
+      n >>= 4;
     }
+  while (n > 0);
+
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -520,19 +548,20 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
   char buf[32];
-  int i = 0;
+  int i = sizeof(buf);
+
+  /* Generate the digits from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
   do
     {
-      buf[i++] = n % 10 + '0';
+      buf[--i] = n % 10 + '0';
       n /= 10;
     }
   while (n > 0);
 
-  while (i > 0)
-    {
-      obj->put(obj, buf[--i]);
-    }
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -542,31 +571,31 @@ static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 static void lutohex(FAR struct lib_outstream_s *obj, unsigned long n,
                     uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buf[(CHAR_BIT * sizeof(unsigned long) + 3) / 4];
+  int i = sizeof(buf);
+
+  /* Generate the nibbles from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
-  for (bits = CHAR_BIT * sizeof(unsigned long); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
+      uint8_t nibble = (uint8_t)(n & 0xf);
 
-          if (nibble < 10)
-            {
-              obj->put(obj, nibble + '0');
-            }
-          else
-            {
-              obj->put(obj, nibble + a - 10);
-            }
+      if (nibble < 10)
+        {
+          buf[--i] = nibble + '0';
+        }
+      else
+        {
+          buf[--i] = nibble + a - 10;
         }
-    }
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
+      n >>= 4;
     }
+  while (n > 0);
+
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -750,19 +779,20 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
   char buf[32];
-  int i = 0;
+  int i = sizeof(buf);
+
+  /* Generate the digits from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
   do
     {
-      buf[i++] = n % 10 + '0';
+      buf[--i] = n % 10 + '0';
       n /= 10;
     }
   while (n > 0);
 
-  while (i > 0)
-    {
-      obj->put(obj, buf[--i]);
-    }
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -772,31 +802,31 @@ static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 static void llutohex(FAR struct lib_outstream_s *obj, unsigned long long n,
                      uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buf[(CHAR_BIT * sizeof(unsigned long long) + 3) / 4];
+  int i = sizeof(buf);
+
+  /* Generate the nibbles from the end of the buffer so that the number can
+   * be output as a single block.
+   */
 
-  for (bits = CHAR_BIT*sizeof(unsigned long long); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
+      uint8_t nibble = (uint8_t)(n & 0xf);
 
-          if (nibble < 10)
-            {
-              obj->put(obj, (nibble + '0'));
-            }
-          else
-            {
-              obj->put(obj, (nibble + a - 10));
-            }
+      if (nibble < 10)
+        {
+          buf[--i] = nibble + '0';
+        }
+      else
+        {
+          buf[--i] = nibble + a - 10;
         }
-    }
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
+      n >>= 4;
     }
+  while (n > 0);
+
+  putblock(obj, &buf[i], sizeof(buf) - i);
 }
 
 /****************************************************************************
@@ -1199,9 +1229,27 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
-           /* Output the character */
+#if defined(CONFIG_ARCH_ROMGETC) || defined(CONFIG_AVR_HAS_MEMX_PTR)
+           /* The format string is not directly addressable.  Output the
+            * character.
+            */
 
            obj->put(obj, FMT_CHAR);
+#else
+           FAR const char *start = src;
+
+           /* Output the run of regular characters up to the next format
+            * specifier, the end of the format, or a newline as one block.
+            * src is left at the last character of the run.
+            */
+
+           while (*src != '\n' && src[1] != '%' && src[1] != '\0')
+             {
+               src++;
+             }
+
+           putblock(obj, start, src - start + 1);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1347,7 +1395,6 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
       if (FMT_CHAR == 's')
         {
           int swidth;
-          int left;
 
           /* Get the string to output */
 
@@ -1364,20 +1411,10 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           swidth = (IS_HASDOT(flags) && trunc >= 0)
                       ? strnlen(ptmp, trunc) : strlen(ptmp);
           prejustify(obj, FMT_CHAR, justify, 0, width, swidth, 0);
-          left = swidth;
 
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-              if (left-- <= 0)
-                {
-                  break;
-                }
-
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          putblock(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
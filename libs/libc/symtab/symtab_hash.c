@@ -0,0 +1,213 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   The System V ELF hash function.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashname(FAR const char *name)
+{
+  FAR const unsigned char *ptr = (FAR const unsigned char *)name;
+  uint32_t hash = 0;
+  uint32_t high;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash << 4) + *ptr++;
+      high = hash & 0xf0000000;
+      if (high != 0)
+        {
+          hash ^= high >> 24;
+        }
+
+      hash &= ~high;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_inithash
+ *
+ * Description:
+ *   Build a hash index over a symbol table.
+ *
+ ****************************************************************************/
+
+int symtab_inithash(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms)
+{
+  uint32_t nbuckets;
+  uint32_t bucket;
+  int i;
+
+  DEBUGASSERT(hash != NULL && (symtab != NULL || nsyms == 0));
+
+  hash->sh_symtab   = symtab;
+  hash->sh_nsyms    = nsyms;
+  hash->sh_buckets  = NULL;
+  hash->sh_chain    = NULL;
+  hash->sh_nbuckets = 0;
+
+  /* Symbols are referenced by 16-bit (index + 1) values */
+
+  if (nsyms <= 0 || nsyms >= UINT16_MAX)
+    {
+      return nsyms <= 0 ? OK : -E2BIG;
+    }
+
+  /* Use about two symbols per bucket */
+
+  nbuckets = 1;
+  while (nbuckets < (uint32_t)nsyms / 2)
+    {
+      nbuckets <<= 1;
+    }
+
+  hash->sh_buckets = (FAR uint16_t *)
+    lib_zalloc((nbuckets + nsyms) * sizeof(uint16_t));
+  if (hash->sh_buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->sh_chain    = hash->sh_buckets + nbuckets;
+  hash->sh_nbuckets = nbuckets;
+
+  /* Insert in reverse order so that the first of several symbols with the
+   * same name is at the head of its bucket.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      bucket = symtab_hashname(symtab[i].sym_name) & (nbuckets - 1);
+      hash->sh_chain[i]        = hash->sh_buckets[bucket];
+      hash->sh_buckets[bucket] = i + 1;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name using a hash index.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name)
+{
+  FAR const struct symtab_s *symbol;
+  uint16_t ndx;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->sh_buckets == NULL)
+    {
+      if (hash->sh_nsyms <= 0)
+        {
+          return NULL;
+        }
+
+#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+      return symtab_findorderedbyname(hash->sh_symtab, name,
+                                      hash->sh_nsyms);
+#else
+      return symtab_findbyname(hash->sh_symtab, name, hash->sh_nsyms);
+#endif
+    }
+
+  ndx = hash->sh_buckets[symtab_hashname(name) & (hash->sh_nbuckets - 1)];
+  while (ndx != 0)
+    {
+      symbol = &hash->sh_symtab[ndx - 1];
+      if (strcmp(name, symbol->sym_name) == 0)
+        {
+          return symbol;
+        }
+
+      ndx = hash->sh_chain[ndx - 1];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: symtab_freehash
+ *
+ * Description:
+ *   Free the memory allocated by symtab_inithash().
+ *
+ ****************************************************************************/
+
+void symtab_freehash(FAR struct symtab_hash_s *hash)
+{
+  if (hash->sh_buckets != NULL)
+    {
+      lib_free(hash->sh_buckets);
+      hash->sh_buckets = NULL;
+      hash->sh_chain   = NULL;
+    }
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <syscall.h>
+
+#include <nuttx/clock.h>
+
+#if defined(CONFIG_CLOCK_TIMEPAGE) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The time page.  This is maintained by the kernel (see
+ * sched/clock/clock_timepage.c) and located through the us_timepage field
+ * of the struct userspace_s header.
+ */
+
+struct clock_timepage_s g_clock_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   User-space implementation of clock_gettime() for the protected build.
+ *   The time is derived from the kernel time page without a system call.
+ *   The result is the same as that of the kernel implementation in
+ *   sched/clock/clock_gettime.c.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR struct clock_timepage_s *page = &g_clock_timepage;
+  clock_t systimer;
+  time_t basesec;
+  long basensec;
+  uint32_t seq;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t usecs;
+#else
+  clock_t msecs;
+#endif
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC)
+#else
+  if (clock_id != CLOCK_REALTIME)
+#endif
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Take a consistent snapshot of the time page.  Retry if the kernel
+   * updated the page while we were reading it.
+   */
+
+  do
+    {
+      seq = page->seq;
+      if (seq == 0)
+        {
+          /* The kernel does not know about the time page.  Fall back to
+           * the system call.
+           */
+
+          return (int)sys_call2((unsigned int)SYS_clock_gettime,
+                                (uintptr_t)clock_id, (uintptr_t)tp);
+        }
+
+      systimer = page->systimer;
+      basesec  = page->basesec;
+      basensec = page->basensec;
+    }
+  while ((seq & 1) != 0 || seq != page->seq);
+
+  /* Convert the system timer to the time since power up exactly as
+   * clock_systimespec() does.
+   */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  usecs       = (uint64_t)TICK2USEC((uint64_t)systimer);
+  tp->tv_sec  = (time_t)(usecs / USEC_PER_SEC);
+  tp->tv_nsec = (long)(usecs % USEC_PER_SEC) * NSEC_PER_USEC;
+#else
+  msecs       = TICK2MSEC(systimer);
+  tp->tv_sec  = (time_t)(msecs / MSEC_PER_SEC);
+  tp->tv_nsec = (long)(msecs % MSEC_PER_SEC) * NSEC_PER_MSEC;
+#endif
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      /* Add the time-of-day base and handle the carry to seconds */
+
+      tp->tv_sec  += basesec;
+      tp->tv_nsec += basensec;
+
+      if (tp->tv_nsec >= NSEC_PER_SEC)
+        {
+          tp->tv_sec++;
+          tp->tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_TIMEPAGE && !__KERNEL__ */
@@ -42,11 +42,19 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
 #include <nuttx/mm/iob.h>
 
+#if CONFIG_IOB_PERCPU_CACHE > 0 && defined(CONFIG_SMP)
+#  include <nuttx/spinlock.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -83,6 +91,75 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* Per-CPU state is indexed by the CPU index */
+
+#ifdef CONFIG_SMP
+#  define IOB_NCPUS          CONFIG_SMP_NCPUS
+#  define iob_cpu()          up_cpu_index()
+#else
+#  define IOB_NCPUS          1
+#  define iob_cpu()          (0)
+#endif
+
+/* Per-CPU caches are refilled from the free list this many at a time */
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+#  define IOB_CACHE_BATCH    ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+#endif
+
+/* Statistics helpers */
+
+#ifdef CONFIG_IOB_STATISTICS
+#  define iob_stats_add(f,n) \
+  do \
+    { \
+      irqstate_t _flags = up_irq_save(); \
+      g_iob_stats[iob_cpu()].f += (n); \
+      up_irq_restore(_flags); \
+    } \
+  while (0)
+
+/* Must be called in a critical section after taking IOBs from the free
+ * list.
+ */
+
+#  define iob_stats_used() \
+  do \
+    { \
+      int16_t _used = CONFIG_IOB_NBUFFERS - \
+                      (g_iob_sem.semcount > 0 ? g_iob_sem.semcount : 0); \
+      if (_used > (int16_t)g_iob_maxused) \
+        { \
+          g_iob_maxused = _used; \
+        } \
+    } \
+  while (0)
+#else
+#  define iob_stats_add(f,n)
+#  define iob_stats_used()
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* A per-CPU cache of free I/O buffers.  Every IOB in a cache still holds
+ * the count that was taken from g_iob_sem (and g_throttle_sem) when it
+ * left the free list, so the counting semaphores are adjusted only when
+ * IOBs move between the caches and the free list.
+ */
+
+struct iob_cache_s
+{
+  FAR struct iob_s *ic_head;     /* List of cached IOBs */
+  uint16_t ic_count;             /* Number of IOBs in the list */
+#ifdef CONFIG_SMP
+  spinlock_t ic_lock;            /* Needed only to flush from another CPU */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +192,26 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+/* The number of tasks that are waiting (or about to wait) for an IOB.  IOBs
+ * are returned to the free list in batches and kept in the per-CPU caches
+ * only when this is zero.
+ */
+
+extern volatile uint16_t g_iob_nwaiters;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* One cache of free IOBs for each CPU */
+
+extern struct iob_cache_s g_iob_cache[IOB_NCPUS];
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+/* Per-CPU usage statistics and the high water mark of the free list */
+
+extern struct iob_stats_s g_iob_stats[IOB_NCPUS];
+extern uint16_t g_iob_maxused;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -154,6 +251,101 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_tryalloc_batch
+ *
+ * Description:
+ *   Take 'nbufs' I/O buffers from the free list in one critical section,
+ *   adjusting the counting semaphores once.  The IOBs are returned as an
+ *   empty chain linked via io_flink.  NULL is returned if fewer than
+ *   'nbufs' IOBs are available.  This function is intended only for
+ *   internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_batch(unsigned int nbufs, bool throttled);
+
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return one I/O buffer to the free list (or to the committed list if a
+ *   task is waiting for it) and wake up any waiter.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_free_notify
+ *
+ * Description:
+ *   'nbufs' IOBs have just been freed.  Signal any IOB notifiers if the
+ *   number of available IOBs crossed a multiple of the notification
+ *   divider.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_NOTIFIER
+void iob_free_notify(unsigned int nbufs);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  Returns NULL if no IOB
+ *   could be obtained this way.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+FAR struct iob_s *iob_cache_alloc(bool throttled);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Add the list of 'nbufs' IOBs from 'head' to 'tail' to the cache of the
+ *   current CPU.  Returns false, leaving the IOBs to the caller, if the
+ *   list does not fit in the cache or if any task is waiting for an IOB.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+bool iob_cache_free(FAR struct iob_s *head, FAR struct iob_s *tail,
+                    unsigned int nbufs);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the IOBs held in all per-CPU caches to the free list.  Must be
+ *   called in a critical section with g_iob_nwaiters non-zero.  Returns
+ *   the number of IOBs that were returned.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_cache_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the total number of IOBs held in all per-CPU caches.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_cache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -82,6 +82,7 @@ static FAR struct iob_s *iob_alloc_committed(void)
       /* Remove the I/O buffer from the committed list */
 
       g_iob_committed = iob->io_flink;
+      iob_stats_used();
 
       /* Put the I/O buffer in a known state */
 
@@ -95,6 +96,102 @@ static FAR struct iob_s *iob_alloc_committed(void)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the cache of this CPU or from the
+ *   head of the free list without waiting for a buffer to become free.
+ *   This is the common logic of iob_tryalloc() and iob_allocwait() without
+ *   the statistics.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+#if CONFIG_IOB_THROTTLE > 0
+  FAR sem_t *sem;
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Try the cache of this CPU first.  That does not involve the counting
+   * semaphores or the global critical section.
+   */
+
+  iob = iob_cache_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Select the semaphore count to check. */
+
+  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* If there are free I/O buffers for this allocation */
+
+  if (sem->semcount > 0)
+#endif
+    {
+      /* Take the I/O buffer from the head of the free list */
+
+      iob = g_iob_freelist;
+      if (iob != NULL)
+        {
+          /* Remove the I/O buffer from the free list and decrement the
+           * counting semaphore(s) that tracks the number of available
+           * IOBs.
+           */
+
+          g_iob_freelist = iob->io_flink;
+
+          /* Take a semaphore count.  Note that we cannot do this in
+           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
+           * because this function may be called from an interrupt
+           * handler. Fortunately we know at at least one free buffer
+           * so a simple decrement is all that is needed.
+           */
+
+          g_iob_sem.semcount--;
+          DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+          /* The throttle semaphore is a little more complicated because
+           * it can be negative!  Decrementing is still safe, however.
+           */
+
+          g_throttle_sem.semcount--;
+          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
+          iob_stats_used();
+          leave_critical_section(flags);
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          return iob;
+        }
+    }
+
+  leave_critical_section(flags);
+  return NULL;
+}
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -131,64 +228,110 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
    * decremented atomically.
    */
 
-  iob = iob_tryalloc(throttled);
-  while (ret == OK && iob == NULL)
+  iob = iob_tryalloc_internal(throttled);
+  if (iob == NULL)
     {
-      /* If not successful, then the semaphore count was less than or equal
-       * to zero (meaning that there are no free buffers).  We need to wait
-       * for an I/O buffer to be released and placed in the committed
-       * list.
+      /* We will probably have to wait.  From now on, freed IOBs must not be
+       * kept in the per-CPU caches or returned to the free list in batches
+       * because that would not wake us up.
+       */
+
+      g_iob_nwaiters++;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* Free IOBs may be idle in the caches of other CPUs.  Return them
+       * all to the free list and try again before waiting.
        */
 
-      ret = nxsem_wait(sem);
-      if (ret < 0)
+      if (iob_cache_flush() > 0)
         {
-          /* EINTR is not an error!  EINTR simply means that we were
-           * awakened by a signal and we should try again.
-           *
-           * REVISIT:  Many end-user interfaces are required to return with
-           * an error if EINTR is set.  Most uses of this function are in
-           * internal, non-user logic.  But are there cases where the error
-           * should be returned.
-           */
+          iob = iob_tryalloc_internal(throttled);
+        }
+#endif
 
-          if (ret == -EINTR)
+#ifdef CONFIG_IOB_STATISTICS
+      if (iob == NULL)
+        {
+          if (throttled)
             {
-              /* Force a success indication so that we will continue looping. */
-
-              ret = OK;
+              iob_stats_add(nthrottled, 1);
+            }
+          else
+            {
+              iob_stats_add(nwaits, 1);
             }
         }
-      else
+#endif
+
+      while (ret == OK && iob == NULL)
         {
-          /* When we wake up from wait successfully, an I/O buffer was
-           * freed and we hold a count for one IOB.  Unless somehting
-           * failed, we should have an IOB waiting for us in the
+          /* If not successful, then the semaphore count was less than or
+           * equal to zero (meaning that there are no free buffers).  We
+           * need to wait for an I/O buffer to be released and placed in the
            * committed list.
            */
 
-          iob = iob_alloc_committed();
-          DEBUGASSERT(iob != NULL);
-
-          if (iob == NULL)
+          ret = nxsem_wait(sem);
+          if (ret < 0)
             {
-              /* This should not fail, but we allow for that possibility to
-               * handle any potential, non-obvious race condition.  Perhaps
-               * the free IOB ended up in the g_iob_free list?
+              /* EINTR is not an error!  EINTR simply means that we were
+               * awakened by a signal and we should try again.
                *
-               * We need release our count so that it is available to
-               * iob_tryalloc(), perhaps allowing another thread to take our
-               * count.  In that event, iob_tryalloc() will fail above and
-               * we will have to wait again.
+               * REVISIT:  Many end-user interfaces are required to return
+               * with an error if EINTR is set.  Most uses of this function
+               * are in internal, non-user logic.  But are there cases where
+               * the error should be returned.
                */
 
-              nxsem_post(sem);
-              iob = iob_tryalloc(throttled);
+              if (ret == -EINTR)
+                {
+                  /* Force a success indication so that we will continue
+                   * looping.
+                   */
+
+                  ret = OK;
+                }
+            }
+          else
+            {
+              /* When we wake up from wait successfully, an I/O buffer was
+               * freed and we hold a count for one IOB.  Unless somehting
+               * failed, we should have an IOB waiting for us in the
+               * committed list.
+               */
+
+              iob = iob_alloc_committed();
+              DEBUGASSERT(iob != NULL);
+
+              if (iob == NULL)
+                {
+                  /* This should not fail, but we allow for that possibility
+                   * to handle any potential, non-obvious race condition.
+                   * Perhaps the free IOB ended up in the g_iob_free list?
+                   *
+                   * We need release our count so that it is available to
+                   * iob_tryalloc(), perhaps allowing another thread to take
+                   * our count.  In that event, iob_tryalloc() will fail
+                   * above and we will have to wait again.
+                   */
+
+                  nxsem_post(sem);
+                  iob = iob_tryalloc_internal(throttled);
+                }
             }
         }
+
+      DEBUGASSERT(g_iob_nwaiters > 0);
+      g_iob_nwaiters--;
     }
 
   leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      iob_stats_add(nallocs, 1);
+    }
+
   return iob;
 }
 
@@ -234,71 +377,200 @@ FAR struct iob_s *iob_alloc(bool throttled)
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
   FAR struct iob_s *iob;
+
+  iob = iob_tryalloc_internal(throttled);
+
+#ifdef CONFIG_IOB_STATISTICS
+  if (iob != NULL)
+    {
+      iob_stats_add(nallocs, 1);
+    }
+  else
+    {
+      iob_stats_add(nfailed, 1);
+    }
+#endif
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_batch
+ *
+ * Description:
+ *   Take 'nbufs' I/O buffers from the free list in one critical section,
+ *   adjusting the counting semaphores once.  The IOBs are returned as an
+ *   empty chain linked via io_flink.  NULL is returned if fewer than
+ *   'nbufs' IOBs are available.  This function is intended only for
+ *   internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_batch(unsigned int nbufs, bool throttled)
+{
+  FAR struct iob_s *head;
+  FAR struct iob_s *tail;
+  FAR struct iob_s *iob;
   irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
   FAR sem_t *sem;
-#endif
+  unsigned int i;
+
+  if (nbufs == 0 || nbufs > CONFIG_IOB_NBUFFERS)
+    {
+      return NULL;
+    }
 
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
 
   sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#else
+  sem = &g_iob_sem;
 #endif
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
-
   flags = enter_critical_section();
 
-#if CONFIG_IOB_THROTTLE > 0
-  /* If there are free I/O buffers for this allocation */
+  /* Are there enough free I/O buffers for this allocation? */
 
-  if (sem->semcount > 0)
-#endif
+  if (sem->semcount < (int)nbufs)
     {
-      /* Take the I/O buffer from the head of the free list */
+      leave_critical_section(flags);
+      return NULL;
+    }
 
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
+  /* Find the last of the IOBs to be taken.  The free list should hold at
+   * least as many IOBs as the semaphore count indicates, but don't trust
+   * that blindly.
+   */
 
-          g_iob_freelist = iob->io_flink;
+  head = g_iob_freelist;
+  tail = head;
 
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling nxsem_wait() or nxsem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+  for (i = 1; tail != NULL && i < nbufs; i++)
+    {
+      tail = tail->io_flink;
+    }
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+  if (tail == NULL)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  /* Remove the IOBs from the free list and take all of the semaphore
+   * counts at once.  As in iob_tryalloc(), a simple subtraction is
+   * sufficient because we know that the IOBs are free.
+   */
+
+  g_iob_freelist = tail->io_flink;
+  tail->io_flink = NULL;
+
+  g_iob_sem.semcount -= nbufs;
+  DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
+  g_throttle_sem.semcount -= nbufs;
+  DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+#endif
 
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+  iob_stats_used();
+  leave_critical_section(flags);
+
+  /* Put the I/O buffers in a known state, keeping the chain links */
+
+  for (iob = head; iob != NULL; iob = iob->io_flink)
+    {
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return head;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_chain
+ *
+ * Description:
+ *   Try to allocate a chain of 'nbufs' empty I/O buffers from the free list
+ *   in one batch without waiting.  NULL is returned if not that many
+ *   buffers are available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_chain(unsigned int nbufs, bool throttled)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_tryalloc_batch(nbufs, throttled);
+
+#ifdef CONFIG_IOB_STATISTICS
+  if (iob != NULL)
+    {
+      iob_stats_add(nallocs, nbufs);
+    }
+  else
+    {
+      iob_stats_add(nfailed, 1);
+    }
 #endif
-          leave_critical_section(flags);
 
-          /* Put the I/O buffer in a known state */
+  return iob;
+}
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
+/****************************************************************************
+ * Name: iob_alloc_chain
+ *
+ * Description:
+ *   Allocate a chain of 'nbufs' empty I/O buffers linked via io_flink.  If
+ *   that many buffers are free, they are all taken from the free list at
+ *   once, adjusting the counting semaphores only once for the whole batch.
+ *   Otherwise, the buffers are allocated one at a time, waiting as
+ *   necessary.  NULL is returned on any failure.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_chain(unsigned int nbufs, bool throttled)
+{
+  FAR struct iob_s *head;
+  FAR struct iob_s *iob;
+  unsigned int i;
+
+  /* Were we called from the interrupt level? */
+
+  if (up_interrupt_context() || sched_idletask())
+    {
+      /* Yes, then try to allocate the chain without waiting */
+
+      return iob_tryalloc_chain(nbufs, throttled);
+    }
+
+  /* Try to take the whole chain from the free list at once */
+
+  head = iob_tryalloc_batch(nbufs, throttled);
+  if (head != NULL)
+    {
+      iob_stats_add(nallocs, nbufs);
+      return head;
+    }
+
+  /* There are not enough free I/O buffers.  Build the chain one I/O buffer
+   * at a time, waiting as necessary.
+   */
+
+  head = NULL;
+  for (i = 0; i < nbufs; i++)
+    {
+      iob = iob_allocwait(throttled);
+      if (iob == NULL)
+        {
+          iob_free_chain(head);
+          return NULL;
         }
+
+      iob->io_flink = head;
+      head          = iob;
     }
 
-  leave_critical_section(flags);
-  return NULL;
+  return head;
 }
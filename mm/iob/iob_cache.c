@@ -0,0 +1,309 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef NULL
+#  define NULL ((FAR void *)0)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_lock and iob_cache_unlock
+ *
+ * Description:
+ *   Get exclusive access to the cache of the current CPU.  Only local
+ *   interrupts are disabled.  In the SMP case, the spinlock of the cache
+ *   is also taken; it is contended only while iob_cache_flush() runs on
+ *   another CPU.
+ *
+ *   No other IOB lock may be taken while a cache is locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct iob_cache_s *iob_cache_lock(FAR irqstate_t *flags)
+{
+  FAR struct iob_cache_s *cache;
+
+  *flags = up_irq_save();
+  cache  = &g_iob_cache[iob_cpu()];
+#ifdef CONFIG_SMP
+  spin_lock(&cache->ic_lock);
+#endif
+  return cache;
+}
+
+static inline void iob_cache_unlock(FAR struct iob_cache_s *cache,
+                                    irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&cache->ic_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  Returns NULL if no IOB
+ *   could be obtained this way.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  unsigned int nbufs;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Cached IOBs still hold their count of g_throttle_sem.  A throttled
+   * allocation may take one only if it would have succeeded with all of
+   * the cached IOBs back in the free list.
+   */
+
+  if (throttled && g_throttle_sem.semcount + iob_cache_navail() <= 0)
+    {
+      return NULL;
+    }
+#endif
+
+  cache = iob_cache_lock(&flags);
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+    }
+
+  iob_cache_unlock(cache, flags);
+
+  if (iob == NULL)
+    {
+      /* The cache is empty.  Refill it with a batch of IOBs from the free
+       * list, but never while tasks are waiting for IOBs and never from
+       * the IOBs reserved by the throttle.
+       */
+
+      if (g_iob_nwaiters > 0)
+        {
+          return NULL;
+        }
+
+      iob = iob_tryalloc_batch(IOB_CACHE_BATCH, true);
+      if (iob == NULL)
+        {
+          return NULL;
+        }
+
+      /* Keep the first IOB for this allocation and cache the rest */
+
+      next = iob->io_flink;
+      if (next != NULL)
+        {
+          for (nbufs = 1, tail = next; tail->io_flink != NULL; nbufs++)
+            {
+              tail = tail->io_flink;
+            }
+
+          if (!iob_cache_free(next, tail, nbufs))
+            {
+              /* A task started waiting for an IOB in the meantime */
+
+              for (; next != NULL; next = tail)
+                {
+                  tail = next->io_flink;
+                  iob_free_pool(next);
+                }
+            }
+        }
+    }
+
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Add the list of 'nbufs' IOBs from 'head' to 'tail' to the cache of the
+ *   current CPU.  Returns false, leaving the IOBs to the caller, if the
+ *   list does not fit in the cache or if any task is waiting for an IOB.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *head, FAR struct iob_s *tail,
+                    unsigned int nbufs)
+{
+  FAR struct iob_cache_s *cache;
+  irqstate_t flags;
+  bool ret = false;
+
+  /* g_iob_nwaiters is checked with the cache locked.  A task that is
+   * about to wait increments g_iob_nwaiters before it flushes the caches,
+   * so either it sees these IOBs when it flushes this cache or we see its
+   * count here.
+   */
+
+  cache = iob_cache_lock(&flags);
+
+  if (g_iob_nwaiters == 0 &&
+      cache->ic_count + nbufs <= CONFIG_IOB_PERCPU_CACHE)
+    {
+      tail->io_flink  = cache->ic_head;
+      cache->ic_head  = head;
+      cache->ic_count += nbufs;
+      ret = true;
+    }
+
+  iob_cache_unlock(cache, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the IOBs held in all per-CPU caches to the free list.  Must be
+ *   called in a critical section with g_iob_nwaiters non-zero.  Returns
+ *   the number of IOBs that were returned.
+ *
+ ****************************************************************************/
+
+int iob_cache_flush(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int nflushed = 0;
+  int cpu;
+
+  DEBUGASSERT(g_iob_nwaiters > 0);
+
+  for (cpu = 0; cpu < IOB_NCPUS; cpu++)
+    {
+      /* Detach the whole list from the cache */
+
+      cache = &g_iob_cache[cpu];
+      flags = up_irq_save();
+#ifdef CONFIG_SMP
+      spin_lock(&cache->ic_lock);
+#endif
+
+      iob             = cache->ic_head;
+      nflushed       += cache->ic_count;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+
+#ifdef CONFIG_SMP
+      spin_unlock(&cache->ic_lock);
+#endif
+      up_irq_restore(flags);
+
+      /* Then return the IOBs to the free list one at a time so that any
+       * task already waiting for an IOB is awakened.
+       */
+
+      for (; iob != NULL; iob = next)
+        {
+          next = iob->io_flink;
+          iob_free_pool(iob);
+        }
+    }
+
+  return nflushed;
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the total number of IOBs held in all per-CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int ncached = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < IOB_NCPUS; cpu++)
+    {
+      ncached += g_iob_cache[cpu].ic_count;
+    }
+
+  return ncached;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
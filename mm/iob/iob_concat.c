@@ -59,6 +59,8 @@
 
 void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2)
 {
+  FAR struct iob_s *head = iob1;
+
   /* Find the last buffer in the iob1 buffer chain */
 
   while (iob1->io_flink)
@@ -70,7 +72,9 @@ void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2)
 
   iob1->io_flink = iob2;
 
-  /* Combine the total packet size */
+  /* Combine the total packet size.  The packet size is kept in the head of
+   * the chain.
+   */
 
-  iob1->io_pktlen += iob2->io_pktlen;
+  head->io_pktlen += iob2->io_pktlen;
 }
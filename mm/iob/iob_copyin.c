@@ -84,6 +84,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
                                bool throttled, bool can_block)
 {
   FAR struct iob_s *head = iob;
+  FAR struct iob_s *spare = NULL;
   FAR struct iob_s *next;
   FAR uint8_t *dest;
   unsigned int ncopy;
@@ -196,13 +197,36 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
-           *
-           * Copy as many bytes as possible.  If we have successfully copied
-           * any already don't block, otherwise block if we're allowed.
+          /* Yes.. allocate a new buffer.  The first time, try to get all
+           * of the buffers needed for the rest of the copy from the free
+           * list in one batch.
            */
 
-          if (!can_block || len < total)
+          if (spare == NULL && len > CONFIG_IOB_BUFSIZE)
+            {
+              unsigned int nbufs = (len + CONFIG_IOB_BUFSIZE - 1) /
+                                   CONFIG_IOB_BUFSIZE;
+
+              spare = iob_tryalloc_batch(nbufs, throttled);
+              if (spare != NULL)
+                {
+                  iob_stats_add(nallocs, nbufs);
+                }
+            }
+
+          if (spare != NULL)
+            {
+              next           = spare;
+              spare          = next->io_flink;
+              next->io_flink = NULL;
+            }
+
+          /* Otherwise, copy as many bytes as possible.  If we have
+           * successfully copied any already don't block, otherwise block if
+           * we're allowed.
+           */
+
+          else if (!can_block || len < total)
             {
               next = iob_tryalloc(throttled);
             }
@@ -227,6 +251,13 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
       offset = 0;
     }
 
+  /* All of the batch should have been used, but make sure */
+
+  if (spare != NULL)
+    {
+      iob_free_chain(spare);
+    }
+
   return 0;
 }
 
@@ -77,55 +77,50 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_free_notify
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   'nbufs' IOBs have just been freed.  Signal any IOB notifiers if the
+ *   number of available IOBs crossed a multiple of the notification
+ *   divider.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
-{
-  FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
+void iob_free_notify(unsigned int nbufs)
+{
   int16_t navail;
-#endif
 
-  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
-          iob, iob->io_pktlen, iob->io_len, next);
-
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
    */
 
-  if (next != NULL)
+  navail = iob_navail(false);
+  if (navail > 0 &&
+      (navail & ~IOB_MASK) != ((navail - (int16_t)nbufs) & ~IOB_MASK))
     {
-      /* Copy and decrement the total packet length, being careful to
-       * do nothing too crazy.
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
        */
 
-      if (iob->io_pktlen > iob->io_len)
-        {
-          /* Adjust packet length and move it to the next entry */
-
-          next->io_pktlen = iob->io_pktlen - iob->io_len;
-          DEBUGASSERT(next->io_pktlen >= next->io_len);
-        }
-      else
-        {
-          /* This can only happen if the next entry is last entry in the
-           * chain... and if it is empty
-           */
+      iob_notifier_signal();
+    }
+}
+#endif
 
-          next->io_pktlen = 0;
-          DEBUGASSERT(next->io_len == 0 && next->io_flink == NULL);
-        }
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return one I/O buffer to the free list (or to the committed list if a
+ *   task is waiting for it) and wake up any waiter.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
 
-      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
-              next, next->io_pktlen, next->io_len);
-    }
+void iob_free_pool(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
 
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
@@ -170,22 +165,77 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #endif
 
 #ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
+  iob_free_notify(1);
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
+  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
+          iob, iob->io_pktlen, iob->io_len, next);
+
+  /* Copy the data that only exists in the head of a I/O buffer chain into
+   * the next entry.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (next != NULL)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
+      /* Copy and decrement the total packet length, being careful to
+       * do nothing too crazy.
        */
 
-      iob_notifier_signal();
+      if (iob->io_pktlen > iob->io_len)
+        {
+          /* Adjust packet length and move it to the next entry */
+
+          next->io_pktlen = iob->io_pktlen - iob->io_len;
+          DEBUGASSERT(next->io_pktlen >= next->io_len);
+        }
+      else
+        {
+          /* This can only happen if the next entry is last entry in the
+           * chain... and if it is empty
+           */
+
+          next->io_pktlen = 0;
+          DEBUGASSERT(next->io_len == 0 && next->io_flink == NULL);
+        }
+
+      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
+              next, next->io_pktlen, next->io_len);
+    }
+
+  iob_stats_add(nfrees, 1);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU if there is room and if
+   * no task is waiting for an IOB.
+   */
+
+  iob->io_flink = NULL;
+  if (iob_cache_free(iob, iob, 1))
+    {
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_free_notify(1);
+#endif
+      return next;
     }
 #endif
 
-  leave_critical_section(flags);
+  iob_free_pool(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
@@ -39,6 +39,9 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
+
+#include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/mm/iob.h>
 
@@ -53,15 +56,79 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  If no task is waiting for an I/O buffer, the whole chain
+ *   is returned to the free list at once.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *tail;
   FAR struct iob_s *next;
+  irqstate_t flags;
+  unsigned int nbufs;
+
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  /* Find the end of the chain */
+
+  for (nbufs = 1, tail = iob; tail->io_flink != NULL; nbufs++)
+    {
+      tail = tail->io_flink;
+    }
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the whole chain in the cache of this CPU if it fits */
+
+  if (iob_cache_free(iob, tail, nbufs))
+    {
+      iob_stats_add(nfrees, nbufs);
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_free_notify(nbufs);
+#endif
+      return;
+    }
+#endif
+
+  flags = enter_critical_section();
+
+  if (g_iob_nwaiters == 0)
+    {
+      /* No task is waiting for an IOB, so there is nobody to wake up and
+       * nothing to put on the committed list.  Return the whole chain to
+       * the free list and give back all of the semaphore counts at once.
+       */
+
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+      tail->io_flink  = g_iob_freelist;
+      g_iob_freelist  = iob;
+
+      g_iob_sem.semcount += nbufs;
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+      g_throttle_sem.semcount += nbufs;
+#endif
+
+      iob_stats_add(nfrees, nbufs);
+
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_free_notify(nbufs);
+#endif
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  /* Otherwise, free each IOB in the chain -- one at a time to keep the
+   * count straight and to wake up the waiters.
+   */
 
   for (; iob; iob = next)
     {
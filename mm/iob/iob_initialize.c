@@ -97,6 +97,23 @@ sem_t g_throttle_sem;       /* Counts available I/O buffers when throttled */
 sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 #endif
 
+/* The number of tasks that are waiting (or about to wait) for an IOB */
+
+volatile uint16_t g_iob_nwaiters;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* One cache of free IOBs for each CPU */
+
+struct iob_cache_s g_iob_cache[IOB_NCPUS];
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+/* Per-CPU usage statistics and the high water mark of the free list */
+
+struct iob_stats_s g_iob_stats[IOB_NCPUS];
+uint16_t g_iob_maxused;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -155,6 +172,13 @@ void iob_initialize(void)
       nxsem_init(&g_qentry_sem, 0, CONFIG_IOB_NCHAINS);
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0 && defined(CONFIG_SMP)
+      for (i = 0; i < IOB_NCPUS; i++)
+        {
+          spin_initialize(&g_iob_cache[i].ic_lock, SP_UNLOCKED);
+        }
+#endif
+
       initialized = true;
     }
 }
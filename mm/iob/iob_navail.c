@@ -71,6 +71,17 @@ int iob_navail(bool throttled)
     {
       ret = navail;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* IOBs in the per-CPU caches are free, too */
+
+      if (ret < 0)
+        {
+          ret = 0;
+        }
+
+      ret += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
       /* Subtract the throttle value is so requested */
 
@@ -425,6 +425,75 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr);
 
 void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr);
 
+/****************************************************************************
+ * Name: arp_enqueue
+ *
+ * Description:
+ *   Save the IPv4 packet in d_buf until the MAC address of ipaddr is
+ *   resolved.  At most CONFIG_NET_ARP_PENDQ_SIZE packets are held for each
+ *   address; the oldest is discarded when that limit is reached.  The
+ *   packets are sent by arp_txpoll() when the ARP response arrives or are
+ *   discarded if there is no response within CONFIG_NET_ARP_PENDQ_TIMEOUT
+ *   seconds.
+ *
+ * Input Parameters:
+ *   dev    - The device that holds the outgoing IPv4 packet
+ *   ipaddr - The next hop IPv4 address to be resolved
+ *
+ * Returned Value:
+ *   Zero (OK) if the packet was queued.  A negated errno value is returned
+ *   if no I/O buffers were available.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDQ
+int arp_enqueue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: arp_refresh
+ *
+ * Description:
+ *   Called when the mapping for ipaddr is used to send a packet.  If the
+ *   mapping will expire within CONFIG_NET_ARP_REFRESH seconds, an ARP
+ *   request is scheduled so that the mapping is renewed before it expires.
+ *
+ * Input Parameters:
+ *   dev    - The device that is sending the packet
+ *   ipaddr - The next hop IPv4 address
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDQ
+void arp_refresh(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: arp_txpoll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address mapping that is now
+ *   available and any scheduled ARP refresh requests.  Packets that waited
+ *   too long for a mapping are discarded.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and devif_timer().  The network must be locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDQ
+int arp_txpoll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
+#else
+#  define arp_txpoll(d,c) (0)
+#endif
+
 /****************************************************************************
  * Name: arp_dump
  *
@@ -460,6 +529,7 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_delete(i)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
+#  define arp_txpoll(d,c) (0)
 #  define arp_dump(arp)
 
 #endif /* CONFIG_NET_ARP */
@@ -52,6 +52,7 @@
 #include <nuttx/net/arp.h>
 
 #include "arp/arp.h"
+#include "pcap/pcap.h"
 
 #ifdef CONFIG_NET_ARP
 
@@ -95,6 +96,8 @@ void arp_arpin(FAR struct net_driver_s *dev)
   FAR struct arp_hdr_s *arp = ARPBUF;
   in_addr_t ipaddr;
 
+  pcap_input(dev);
+
   if (dev->d_len < (sizeof(struct arp_hdr_s) + ETH_HDRLEN))
     {
       nerr("ERROR: Packet Too small\n");
@@ -136,6 +139,8 @@ void arp_arpin(FAR struct net_driver_s *dev)
 
             eth->type           = HTONS(ETHTYPE_ARP);
             dev->d_len          = sizeof(struct arp_hdr_s) + ETH_HDRLEN;
+
+            pcap_output(dev);
           }
         break;
 
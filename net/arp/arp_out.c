@@ -52,6 +52,7 @@
 
 #include "route/route.h"
 #include "arp/arp.h"
+#include "pcap/pcap.h"
 
 #ifdef CONFIG_NET_ARP
 
@@ -125,9 +126,11 @@ static const uint8_t g_multicast_ethaddr[3] =
  *
  *   If no ARP cache entry is found for the destination IP address, the
  *   packet in the d_buf is replaced by an ARP request packet for the
- *   IP address. The IP packet is dropped and it is assumed that the
- *   higher level protocols (e.g., TCP) eventually will retransmit the
- *   dropped packet.
+ *   IP address.  If CONFIG_NET_ARP_PENDQ is enabled, the IP packet is
+ *   first saved and will be sent by arp_txpoll() as soon as the ARP
+ *   response is received.  Otherwise, the IP packet is dropped and it is
+ *   assumed that the higher level protocols (e.g., TCP) eventually will
+ *   retransmit the dropped packet.
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf buffer and the d_len field holds the length of the Ethernet
@@ -144,9 +147,10 @@ void arp_out(FAR struct net_driver_s *dev)
   in_addr_t destipaddr;
   int ret;
 
-#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND)
+#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND) || \
+    defined(CONFIG_NET_ARP_PENDQ)
   /* Skip sending ARP requests when the frame to be transmitted was
-   * written into a packet socket.
+   * written into a packet socket or is itself an ARP request.
    */
 
   if (IFF_IS_NOARP(dev->d_flags))
@@ -154,6 +158,7 @@ void arp_out(FAR struct net_driver_s *dev)
       /* Clear the indication and let the packet continue on its way. */
 
       IFF_CLR_NOARP(dev->d_flags);
+      pcap_output(dev);
       return;
     }
 #endif
@@ -256,15 +261,34 @@ void arp_out(FAR struct net_driver_s *dev)
     {
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
+#ifdef CONFIG_NET_ARP_PENDQ
+      /* Save the IP packet so that it can be sent when the ARP response
+       * is received.
+       */
+
+      ret = arp_enqueue(dev, ipaddr);
+      if (ret < 0)
+        {
+          nwarn("WARNING: Failed to queue packet: %d\n", ret);
+        }
+#endif
+
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
        */
 
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
+      pcap_output(dev);
       return;
     }
 
+#ifdef CONFIG_NET_ARP_PENDQ
+  /* Renew the mapping if it is about to expire */
+
+  arp_refresh(dev, ipaddr);
+#endif
+
   /* Build an Ethernet header. */
 
   memcpy(peth->dest, ethaddr.ether_addr_octet, ETHER_ADDR_LEN);
@@ -275,6 +299,7 @@ finish_header:
   memcpy(peth->src, dev->d_mac.ether.ether_addr_octet, ETHER_ADDR_LEN);
   peth->type  = HTONS(ETHTYPE_IP);
   dev->d_len += ETH_HDRLEN;
+  pcap_output(dev);
 }
 
 #endif /* CONFIG_NET_ARP */
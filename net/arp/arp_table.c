@@ -60,6 +60,9 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
+#ifdef CONFIG_NET_ARP_PENDQ
+#  include <nuttx/mm/iob.h>
+#endif
 
 #include <arp/arp.h>
 #include <netdev/netdev.h>
@@ -72,6 +75,37 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifdef CONFIG_NET_ARP_PENDQ
+#  define ARP_PENDQ_TICK  SEC2TICK(CONFIG_NET_ARP_PENDQ_TIMEOUT)
+#  define ARP_REFRESH_TICK SEC2TICK(CONFIG_NET_ARP_REFRESH)
+#endif
+
+/* Size of the hash index.  This must be a power of two. */
+
+#if CONFIG_NET_ARPTAB_SIZE <= 8
+#  define ARP_HASH_SIZE 8
+#elif CONFIG_NET_ARPTAB_SIZE <= 32
+#  define ARP_HASH_SIZE 32
+#elif CONFIG_NET_ARPTAB_SIZE <= 128
+#  define ARP_HASH_SIZE 128
+#else
+#  define ARP_HASH_SIZE 256
+#endif
+
+/* Fold all four octets of the address so that the hash does not depend on
+ * the host byte order.
+ */
+
+#define ARP_HASH(a) \
+  ((unsigned int)((a) ^ ((a) >> 8) ^ ((a) >> 16) ^ ((a) >> 24)) & \
+   (ARP_HASH_SIZE - 1))
+
+/* Values of ac_flags */
+
+#define ARP_FLAG_INCOMPLETE (1 << 0) /* Awaiting the ARP response */
+#define ARP_FLAG_REFRESH    (1 << 1) /* A refresh request must be sent */
+#define ARP_FLAG_REFRESHED  (1 << 2) /* A refresh request has been sent */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -82,13 +116,39 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+/* One entry in the ARP table.  Hash chains are linked by table index plus
+ * one so that zero can be used as the end-of-chain marker.
+ */
+
+struct arp_cache_s
+{
+  struct arp_entry_s ac_entry;        /* Must be first: See arp_lookup() */
+  uint16_t           ac_next;         /* Next entry in the hash chain */
+  uint8_t            ac_flags;        /* See ARP_FLAG_* definitions */
+#ifdef CONFIG_NET_ARP_PENDQ
+  uint8_t            ac_npending;     /* Number of queued packets */
+  FAR struct net_driver_s *ac_dev;    /* Device that queued the packets */
+  FAR struct iob_s  *ac_pending[CONFIG_NET_ARP_PENDQ_SIZE];
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_cache_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+
+/* Heads of the hash chains (table index plus one) */
+
+static uint16_t g_arphash[ARP_HASH_SIZE];
+
+#ifdef CONFIG_NET_ARP_PENDQ
+/* True if arp_txpoll() may have something to do */
+
+static bool g_arppoll;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -140,34 +200,158 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_hash_find
+ *
+ * Description:
+ *   Find the table entry for an IP address, whatever its state.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_cache_s *arp_hash_find(in_addr_t ipaddr)
+{
+  FAR struct arp_cache_s *tabptr;
+  uint16_t ndx;
+
+  for (ndx = g_arphash[ARP_HASH(ipaddr)]; ndx != 0; ndx = tabptr->ac_next)
+    {
+      tabptr = &g_arptable[ndx - 1];
+      if (net_ipv4addr_cmp(ipaddr, tabptr->ac_entry.at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash_remove
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Remove an entry from its hash chain.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_hash_remove(FAR struct arp_cache_s *tabptr)
 {
-  if (e1->at_ipaddr == 0)
+  FAR uint16_t *link = &g_arphash[ARP_HASH(tabptr->ac_entry.at_ipaddr)];
+  uint16_t ndx = (uint16_t)(tabptr - g_arptable) + 1;
+
+  while (*link != 0)
     {
-      return e1;
+      if (*link == ndx)
+        {
+          *link = tabptr->ac_next;
+          break;
+        }
+
+      link = &g_arptable[*link - 1].ac_next;
     }
-  else if (e2->at_ipaddr == 0)
+
+  tabptr->ac_next = 0;
+}
+
+#ifdef CONFIG_NET_ARP_PENDQ
+/****************************************************************************
+ * Name: arp_pending_free
+ *
+ * Description:
+ *   Discard all packets queued on an entry.
+ *
+ ****************************************************************************/
+
+static void arp_pending_free(FAR struct arp_cache_s *tabptr)
+{
+  while (tabptr->ac_npending > 0)
     {
-      return e2;
+      iob_free_chain(tabptr->ac_pending[--tabptr->ac_npending]);
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+}
+
+/****************************************************************************
+ * Name: arp_pending_remove
+ *
+ * Description:
+ *   Remove the oldest packet queued on an entry.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *arp_pending_remove(FAR struct arp_cache_s *tabptr)
+{
+  FAR struct iob_s *iob = tabptr->ac_pending[0];
+
+  tabptr->ac_npending--;
+  memmove(&tabptr->ac_pending[0], &tabptr->ac_pending[1],
+          tabptr->ac_npending * sizeof(FAR struct iob_s *));
+  return iob;
+}
+#else
+#  define arp_pending_free(t)
+#endif
+
+/****************************************************************************
+ * Name: arp_entry_free
+ *
+ * Description:
+ *   Return an entry to the unused state.
+ *
+ ****************************************************************************/
+
+static void arp_entry_free(FAR struct arp_cache_s *tabptr)
+{
+  arp_pending_free(tabptr);
+  arp_hash_remove(tabptr);
+
+  tabptr->ac_entry.at_ipaddr = 0;
+  tabptr->ac_flags           = 0;
+}
+
+/****************************************************************************
+ * Name: arp_entry_alloc
+ *
+ * Description:
+ *   Allocate an entry for a new IP address, replacing the oldest entry if
+ *   the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_cache_s *arp_entry_alloc(in_addr_t ipaddr)
+{
+  FAR struct arp_cache_s *tabptr = &g_arptable[0];
+  unsigned int hash;
+  int i;
+
+  /* Find an unused entry or, failing that, the oldest one */
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      return e1;
+      if (g_arptable[i].ac_entry.at_ipaddr == 0)
+        {
+          tabptr = &g_arptable[i];
+          break;
+        }
+
+      if ((int)(g_arptable[i].ac_entry.at_time -
+                tabptr->ac_entry.at_time) < 0)
+        {
+          tabptr = &g_arptable[i];
+        }
     }
-  else
+
+  if (tabptr->ac_entry.at_ipaddr != 0)
     {
-      return e2;
+      arp_entry_free(tabptr);
     }
+
+  /* Insert it at the head of the hash chain for the new address */
+
+  hash                       = ARP_HASH(ipaddr);
+  tabptr->ac_entry.at_ipaddr = ipaddr;
+  tabptr->ac_next            = g_arphash[hash];
+  g_arphash[hash]            = (uint16_t)(tabptr - g_arptable) + 1;
+
+  return tabptr;
 }
 
 /****************************************************************************
@@ -196,43 +380,38 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_cache_s *tabptr;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Find the existing entry for this address.  If there is none, the
+   * IP -> MAC address mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr);
+  if (tabptr == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      tabptr = arp_entry_alloc(ipaddr);
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = clock_systimer();
+  memcpy(tabptr->ac_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  tabptr->ac_entry.at_time = clock_systimer();
+  tabptr->ac_flags         = 0;
+
+#ifdef CONFIG_NET_ARP_PENDQ
+  /* If packets were waiting for this mapping, have the device poll for
+   * them now rather than at the next poll timer.
+   */
+
+  if (tabptr->ac_npending > 0)
+    {
+      netdev_txnotify_dev(tabptr->ac_dev);
+    }
+#endif
+
   return OK;
 }
 
@@ -282,19 +461,16 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_cache_s *tabptr;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr);
+  if (tabptr != NULL &&
+      (tabptr->ac_flags & ARP_FLAG_INCOMPLETE) == 0 &&
+      clock_systimer() - tabptr->ac_entry.at_time <= ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systimer() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return &tabptr->ac_entry;
     }
 
   /* Not found */
@@ -381,19 +557,238 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
 
 void arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_cache_s *tabptr;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
+  tabptr = arp_hash_find(ipaddr);
   if (tabptr != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Discard any queued packets and release the entry */
+
+      arp_entry_free(tabptr);
+    }
+}
+
+#ifdef CONFIG_NET_ARP_PENDQ
+/****************************************************************************
+ * Name: arp_enqueue
+ *
+ * Description:
+ *   Save the IPv4 packet in d_buf until the MAC address of ipaddr is
+ *   resolved.  At most CONFIG_NET_ARP_PENDQ_SIZE packets are held for each
+ *   address; the oldest is discarded when that limit is reached.  The
+ *   packets are sent by arp_txpoll() when the ARP response arrives or are
+ *   discarded if there is no response within CONFIG_NET_ARP_PENDQ_TIMEOUT
+ *   seconds.
+ *
+ * Input Parameters:
+ *   dev    - The device that holds the outgoing IPv4 packet
+ *   ipaddr - The next hop IPv4 address to be resolved
+ *
+ * Returned Value:
+ *   Zero (OK) if the packet was queued.  A negated errno value is returned
+ *   if no I/O buffers were available.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int arp_enqueue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_cache_s *tabptr;
+  FAR struct iob_s *iob;
+  clock_t now = clock_systimer();
+  int ret;
+
+  tabptr = arp_hash_find(ipaddr);
+  if (tabptr == NULL)
+    {
+      tabptr                   = arp_entry_alloc(ipaddr);
+      tabptr->ac_flags         = ARP_FLAG_INCOMPLETE;
+      tabptr->ac_entry.at_time = now;
+    }
+  else if ((tabptr->ac_flags & ARP_FLAG_INCOMPLETE) == 0)
+    {
+      /* The old mapping has expired.  Start a new resolution. */
+
+      tabptr->ac_flags         = ARP_FLAG_INCOMPLETE;
+      tabptr->ac_entry.at_time = now;
+    }
+  else if (now - tabptr->ac_entry.at_time > ARP_PENDQ_TICK)
+    {
+      /* The previous resolution timed out.  Drop its packets and start
+       * over.
+       */
+
+      arp_pending_free(tabptr);
+      tabptr->ac_entry.at_time = now;
+    }
+
+  /* Make room in the queue by discarding the oldest packet */
+
+  if (tabptr->ac_npending >= CONFIG_NET_ARP_PENDQ_SIZE)
+    {
+      iob_free_chain(arp_pending_remove(tabptr));
+    }
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[ETH_HDRLEN], dev->d_len, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  tabptr->ac_dev = dev;
+  tabptr->ac_pending[tabptr->ac_npending++] = iob;
+  g_arppoll = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: arp_refresh
+ *
+ * Description:
+ *   Called when the mapping for ipaddr is used to send a packet.  If the
+ *   mapping will expire within CONFIG_NET_ARP_REFRESH seconds, an ARP
+ *   request is scheduled so that the mapping is renewed before it expires.
+ *
+ * Input Parameters:
+ *   dev    - The device that is sending the packet
+ *   ipaddr - The next hop IPv4 address
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_refresh(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_cache_s *tabptr;
+
+  tabptr = arp_hash_find(ipaddr);
+  if (tabptr != NULL && tabptr->ac_flags == 0 &&
+      clock_systimer() - tabptr->ac_entry.at_time >
+      ARP_MAXAGE_TICK - ARP_REFRESH_TICK)
+    {
+      tabptr->ac_flags = ARP_FLAG_REFRESH;
+      tabptr->ac_dev   = dev;
+      g_arppoll        = true;
+    }
+}
 
-      tabptr->at_ipaddr = 0;
+/****************************************************************************
+ * Name: arp_txpoll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address mapping that is now
+ *   available and any scheduled ARP refresh requests.  Packets that waited
+ *   too long for a mapping are discarded.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and devif_timer().  The network must be locked.
+ *
+ ****************************************************************************/
+
+int arp_txpoll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+{
+  FAR struct arp_cache_s *tabptr;
+  FAR struct iob_s *iob;
+  clock_t now;
+  bool more = false;
+  int i;
+
+  if (!g_arppoll)
+    {
+      return 0;
+    }
+
+  now = clock_systimer();
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = &g_arptable[i];
+      if (tabptr->ac_entry.at_ipaddr == 0 ||
+          (tabptr->ac_npending == 0 && tabptr->ac_flags != ARP_FLAG_REFRESH))
+        {
+          continue;
+        }
+
+      if ((tabptr->ac_flags & ARP_FLAG_INCOMPLETE) != 0)
+        {
+          /* Still waiting for the ARP response */
+
+          if (now - tabptr->ac_entry.at_time > ARP_PENDQ_TICK)
+            {
+              ninfo("ARP timeout for IP %08lx\n",
+                    (unsigned long)tabptr->ac_entry.at_ipaddr);
+              arp_entry_free(tabptr);
+            }
+          else
+            {
+              more = true;
+            }
+
+          continue;
+        }
+
+      if (tabptr->ac_dev != dev)
+        {
+          more = true;
+          continue;
+        }
+
+      if (tabptr->ac_flags == ARP_FLAG_REFRESH)
+        {
+          /* Send an ARP request for the mapping that is about to expire.
+           * arp_out() must leave the frame alone.
+           */
+
+          tabptr->ac_flags = ARP_FLAG_REFRESHED;
+
+          arp_format(dev, tabptr->ac_entry.at_ipaddr);
+          IFF_SET_IPv4(dev->d_flags);
+          IFF_SET_NOARP(dev->d_flags);
+
+          if (callback(dev))
+            {
+              return 1;
+            }
+        }
+
+      while (tabptr->ac_npending > 0)
+        {
+          /* Restore the IPv4 packet into d_buf.  The driver will call
+           * arp_out() which will now find the mapping.
+           */
+
+          iob = arp_pending_remove(tabptr);
+
+          dev->d_len    = iob->io_pktlen;
+          dev->d_sndlen = 0;
+          (void)iob_copyout(&dev->d_buf[ETH_HDRLEN], iob, iob->io_pktlen, 0);
+          iob_free_chain(iob);
+
+          IFF_SET_IPv4(dev->d_flags);
+          if (callback(dev))
+            {
+              return 1;
+            }
+        }
     }
+
+  g_arppoll = more;
+  return 0;
 }
+#endif /* CONFIG_NET_ARP_PENDQ */
 
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
-
@@ -113,6 +113,8 @@ const struct sock_intf_s g_bluetooth_sockif =
   NULL,                   /* si_sendfile */
 #endif
   bluetooth_recvfrom,    /* si_recvfrom */
+  NULL,                  /* si_sendmsg */
+  NULL,                  /* si_recvmsg */
   bluetooth_close        /* si_close */
 };
 
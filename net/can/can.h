@@ -0,0 +1,385 @@
+/****************************************************************************
+ * net/can/can.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_CAN_CAN_H
+#define __NET_CAN_CAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <queue.h>
+
+#include <netpacket/can.h>
+#include <nuttx/mm/iob.h>
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Allocate a new PF_CAN socket data callback */
+
+#define can_callback_alloc(dev,conn) \
+  devif_callback_alloc(dev, &conn->list)
+#define can_callback_free(dev,conn,cb) \
+  devif_conn_callback_free(dev, cb, &conn->list)
+
+/* Bit definitions for the flags field of struct can_conn_s */
+
+#define CAN_CONN_LOOPBACK  (1 << 0)  /* CAN_RAW_LOOPBACK */
+#define CAN_CONN_RECVOWN   (1 << 1)  /* CAN_RAW_RECV_OWN_MSGS */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* This is the content of one IOB in the read-ahead queue of a socket:  The
+ * received frame together with the time and the device of reception.
+ */
+
+struct can_rxframe_s
+{
+  struct timeval rf_ts;                /* Time of reception */
+  int rf_ifindex;                      /* Receiving device */
+  struct can_frame rf_frame;           /* The received frame */
+};
+
+/* Representation of a PF_CAN socket connection */
+
+struct devif_callback_s;               /* Forward reference */
+
+struct can_conn_s
+{
+  dq_entry_t node;                     /* Supports a double linked list */
+  uint8_t ifindex;                     /* Bound device, 0 = all CAN devices */
+  uint8_t crefs;                       /* Reference counts on this instance */
+  uint8_t flags;                       /* See CAN_CONN_* definitions */
+  uint8_t nfilters;                    /* Number of valid entries in filters[] */
+  uint8_t backlog;                     /* Number of frames in the read-ahead queue */
+  can_err_mask_t err_mask;             /* Error frames to be received */
+  struct can_filter filters[CONFIG_NET_CAN_NFILTERS];
+
+  /* Queue of received frames, one struct can_rxframe_s per IOB */
+
+  struct iob_queue_s readahead;
+
+  /* Defines the list of PF_CAN callbacks */
+
+  FAR struct devif_callback_s *list;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/* The PF_CAN socket interface */
+
+EXTERN const struct sock_intf_s g_can_sockif;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+struct net_driver_s;  /* Forward reference */
+struct socket;        /* Forward reference */
+struct sockaddr;      /* Forward reference */
+struct msghdr;        /* Forward reference */
+struct pollfd;        /* Forward reference */
+
+/****************************************************************************
+ * Name: can_initialize()
+ *
+ * Description:
+ *   Initialize the PF_CAN connection structures.  Called once and only
+ *   from the networking layer.
+ *
+ ****************************************************************************/
+
+void can_initialize(void);
+
+/****************************************************************************
+ * Name: can_alloc()
+ *
+ * Description:
+ *   Allocate a new PF_CAN connection structure.  The structure is returned
+ *   with the default filter (accept all frames) and local loopback enabled.
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_alloc(void);
+
+/****************************************************************************
+ * Name: can_free()
+ *
+ * Description:
+ *   Free a PF_CAN connection structure that is no longer in use.  Any
+ *   frames remaining in the read-ahead queue are discarded.
+ *
+ ****************************************************************************/
+
+void can_free(FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: can_nextconn()
+ *
+ * Description:
+ *   Traverse the list of allocated PF_CAN connections
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_nextconn(FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: can_find_device
+ *
+ * Description:
+ *   Return the CAN device with the interface index 'ifindex'.
+ *
+ * Returned Value:
+ *   A pointer to the network driver.  NULL is returned if there is no
+ *   device with this index or if it is not a CAN device.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *can_find_device(int ifindex);
+
+/****************************************************************************
+ * Name: can_callback
+ *
+ * Description:
+ *   Inform the application holding the PF_CAN socket of a change in state.
+ *
+ * Returned Value:
+ *   The updated flags as modified by the callback functions.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+uint16_t can_callback(FAR struct net_driver_s *dev,
+                      FAR struct can_conn_s *conn, uint16_t flags);
+
+/****************************************************************************
+ * Name: can_deliver
+ *
+ * Description:
+ *   Queue a copy of 'frame' on every socket bound to 'dev' whose filters
+ *   accept it and wake up any readers.  This is the common back end of
+ *   can_input() and of the local loopback of sent frames.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the frame was received or sent
+ *   frame  - The frame
+ *   origin - The sending socket for locally looped back frames; NULL for
+ *            frames received from the bus.
+ *
+ * Returned Value:
+ *   The number of sockets that accepted the frame.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+int can_deliver(FAR struct net_driver_s *dev,
+                FAR const struct can_frame *frame,
+                FAR struct can_conn_s *origin);
+
+/****************************************************************************
+ * Name: can_poll
+ *
+ * Description:
+ *   Poll a PF_CAN "connection" structure for availability of TX data
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The PF_CAN "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_poll(FAR struct net_driver_s *dev, FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: psock_can_sendto
+ *
+ * Description:
+ *   Send one struct can_frame on a PF_CAN socket.  The frame is sent on the
+ *   device selected by 'to' or, if 'to' is NULL, on the device to which the
+ *   socket is bound.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      The frame to send
+ *   len      Length of the frame; must be CAN_MTU
+ *   flags    Send flags
+ *   to       Address of recipient (may be NULL)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See sendto() for the complete list
+ *   of return values.
+ *
+ ****************************************************************************/
+
+ssize_t psock_can_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen);
+
+/****************************************************************************
+ * Name: can_recvfrom
+ *
+ * Description:
+ *   Implements the socket recvfrom interface for PF_CAN sockets.  Exactly
+ *   one frame is returned by each call.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  Otherwise, on
+ *   errors, a negated errno value is returned (see recvfrom() for the list
+ *   of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t can_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
+                     int flags, FAR struct sockaddr *from,
+                     FAR socklen_t *fromlen);
+
+/****************************************************************************
+ * Name: can_recvmsg
+ *
+ * Description:
+ *   Implements the socket recvmsg interface for PF_CAN sockets.  In
+ *   addition to can_recvfrom() the time of reception is returned as an
+ *   SCM_TIMESTAMP control message if msg_control provides room for it.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  Otherwise, on
+ *   errors, a negated errno value is returned (see recvmsg() for the list
+ *   of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                    int flags);
+
+/****************************************************************************
+ * Name: can_setsockopt and can_getsockopt
+ *
+ * Description:
+ *   Set or get the value of a SOL_CAN_RAW level socket option.  See
+ *   include/netpacket/can.h for the supported options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to get or set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int can_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+int can_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: can_pollsetup and can_pollteardown
+ *
+ * Description:
+ *   Setup or tear down the monitoring of events on one PF_CAN socket.
+ *   POLLIN is reported while the read-ahead queue is not empty; POLLOUT is
+ *   always reported because a send never needs to wait for buffer space.
+ *
+ * Input Parameters:
+ *   psock - The PF_CAN socket of interest
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int can_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+int can_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_CAN */
+#endif /* __NET_CAN_CAN_H */
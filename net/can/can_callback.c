@@ -1,7 +1,7 @@
 /****************************************************************************
- * libc/net/lib_sendmsg.c
+ * net/can/can_callback.c
  *
- *   Copyright (C) 2007, 2008, 2012, 2018 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,51 +39,50 @@
 
 #include <nuttx/config.h>
 
-#ifdef CONFIG_NET
+#include <stdint.h>
+#include <debug.h>
 
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <errno.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: sendmsg
+ * Name: can_callback
  *
  * Description:
- *   The sendmsg() call is identical to sendto() with a NULL from parameter.
- *
- * Parameters:
- *   sockfd   Socket descriptor of socket
- *   buf      Buffer to send data
- *   len      Length of buffer
- *   flags    Receive flags
+ *   Inform the application holding the PF_CAN socket of a change in state.
  *
  * Returned Value:
- *  (see sendto)
+ *   The updated flags as modified by the callback functions.
  *
  * Assumptions:
+ *   This function is called from network logic with the network locked.
  *
  ****************************************************************************/
 
-ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags)
+uint16_t can_callback(FAR struct net_driver_s *dev,
+                      FAR struct can_conn_s *conn, uint16_t flags)
 {
-  FAR void *buf           = msg->msg_iov->iov_base;
-  FAR struct sockaddr *to = msg->msg_name;
-  socklen_t tolen         = msg->msg_namelen;
-  size_t len              = msg->msg_iov->iov_len;
+  ninfo("flags: %04x\n", flags);
 
-  if (msg->msg_iovlen == 1)
-    {
-      return sendto(sockfd, buf, len, flags, to, tolen);
-    }
-  else
+  /* Some sanity checking */
+
+  if (conn != NULL)
     {
-      set_errno(ENOTSUP);
-      return ERROR;
+      /* Perform the callback */
+
+      flags = devif_conn_event(dev, conn, flags, conn->list);
     }
+
+  return flags;
 }
 
-#endif /* CONFIG_NET */
+#endif /* CONFIG_NET_CAN */
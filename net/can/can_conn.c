@@ -0,0 +1,226 @@
+/****************************************************************************
+ * net/can/can_conn.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The array containing all PF_CAN socket connections.  Protected via the
+ * network lock.
+ */
+
+static struct can_conn_s g_can_connections[CONFIG_NET_CAN_NCONNS];
+
+/* A list of all free PF_CAN socket connections */
+
+static dq_queue_t g_free_can_connections;
+
+/* A list of all allocated PF_CAN socket connections */
+
+static dq_queue_t g_active_can_connections;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_initialize()
+ *
+ * Description:
+ *   Initialize the PF_CAN connection structures.  Called once and only
+ *   from the networking layer.
+ *
+ ****************************************************************************/
+
+void can_initialize(void)
+{
+  int i;
+
+  /* Initialize the queues */
+
+  dq_init(&g_free_can_connections);
+  dq_init(&g_active_can_connections);
+
+  for (i = 0; i < CONFIG_NET_CAN_NCONNS; i++)
+    {
+      /* Link each pre-allocated connection structure into the free list. */
+
+      dq_addlast(&g_can_connections[i].node, &g_free_can_connections);
+    }
+}
+
+/****************************************************************************
+ * Name: can_alloc()
+ *
+ * Description:
+ *   Allocate a new PF_CAN connection structure.  The structure is returned
+ *   with the default filter (accept all frames) and local loopback enabled.
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_alloc(void)
+{
+  FAR struct can_conn_s *conn;
+
+  /* The free list is protected by the network lock */
+
+  net_lock();
+  conn = (FAR struct can_conn_s *)dq_remfirst(&g_free_can_connections);
+  if (conn != NULL)
+    {
+      /* Enqueue the connection into the active list.  As with SocketCAN, a
+       * new socket receives every frame (one filter with an all zero mask)
+       * and frames it sends are looped back to the other local sockets.
+       */
+
+      memset(conn, 0, sizeof(struct can_conn_s));
+      conn->flags               = CAN_CONN_LOOPBACK;
+      conn->nfilters            = 1;
+      conn->filters[0].can_id   = 0;
+      conn->filters[0].can_mask = 0;
+      IOB_QINIT(&conn->readahead);
+
+      dq_addlast(&conn->node, &g_active_can_connections);
+    }
+
+  net_unlock();
+  return conn;
+}
+
+/****************************************************************************
+ * Name: can_free()
+ *
+ * Description:
+ *   Free a PF_CAN connection structure that is no longer in use.  Any
+ *   frames remaining in the read-ahead queue are discarded.
+ *
+ ****************************************************************************/
+
+void can_free(FAR struct can_conn_s *conn)
+{
+  /* The free list is protected by the network lock. */
+
+  DEBUGASSERT(conn != NULL && conn->crefs == 0);
+
+  net_lock();
+
+  /* Remove the connection from the active list */
+
+  dq_rem(&conn->node, &g_active_can_connections);
+
+  /* Release any frames that were never read */
+
+  iob_free_queue(&conn->readahead);
+  conn->backlog = 0;
+
+  /* Free the connection */
+
+  dq_addlast(&conn->node, &g_free_can_connections);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: can_nextconn()
+ *
+ * Description:
+ *   Traverse the list of allocated PF_CAN connections
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_nextconn(FAR struct can_conn_s *conn)
+{
+  if (conn == NULL)
+    {
+      return (FAR struct can_conn_s *)g_active_can_connections.head;
+    }
+  else
+    {
+      return (FAR struct can_conn_s *)conn->node.flink;
+    }
+}
+
+/****************************************************************************
+ * Name: can_find_device
+ *
+ * Description:
+ *   Return the CAN device with the interface index 'ifindex'.
+ *
+ * Returned Value:
+ *   A pointer to the network driver.  NULL is returned if there is no
+ *   device with this index or if it is not a CAN device.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *can_find_device(int ifindex)
+{
+  FAR struct net_driver_s *dev;
+
+  dev = netdev_findbyindex(ifindex);
+  if (dev == NULL || dev->d_lltype != NET_LL_CAN)
+    {
+      return NULL;
+    }
+
+  return dev;
+}
+
+#endif /* CONFIG_NET_CAN */
@@ -0,0 +1,311 @@
+/****************************************************************************
+ * net/can/can_input.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/can.h>
+
+#include "devif/devif.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Return true if the frame with the CAN ID 'id' passes the receive
+ *   filters of the connection.  Error frames are selected by the error
+ *   mask alone; data and remote frames must match at least one filter.
+ *
+ ****************************************************************************/
+
+static bool can_filter_match(FAR struct can_conn_s *conn, canid_t id)
+{
+  FAR const struct can_filter *filter;
+  canid_t mask;
+  bool match;
+  int i;
+
+  if ((id & CAN_ERR_FLAG) != 0)
+    {
+      return (id & CAN_ERR_MASK & conn->err_mask) != 0;
+    }
+
+  for (i = 0; i < conn->nfilters; i++)
+    {
+      /* CAN_INV_FILTER shares its bit with CAN_ERR_FLAG, which is never set
+       * in the ID of a frame that gets here.  Keep it out of the comparison.
+       */
+
+      filter = &conn->filters[i];
+      mask   = filter->can_mask & ~CAN_INV_FILTER;
+      match  = ((id ^ filter->can_id) & mask) == 0;
+
+      if ((filter->can_id & CAN_INV_FILTER) != 0)
+        {
+          match = !match;
+        }
+
+      if (match)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: can_datahandler
+ *
+ * Description:
+ *   Add one received frame to the read-ahead queue of the connection.  If
+ *   the backlog limit has been reached, the oldest frame is discarded.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value if no I/O buffer was available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int can_datahandler(FAR struct can_conn_s *conn,
+                           FAR const struct can_rxframe_s *rxframe)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  /* Make room by dropping the oldest frame if the reader has fallen behind */
+
+  if (conn->backlog >= CONFIG_NET_CAN_BACKLOG)
+    {
+      iob = iob_remove_queue(&conn->readahead);
+      if (iob != NULL)
+        {
+          ninfo("Backlog full, dropping oldest frame\n");
+          iob_free_chain(iob);
+          conn->backlog--;
+        }
+    }
+
+  /* Try to allocate an I/O buffer without waiting.  If we would have to
+   * wait, then drop the frame.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to allocate an I/O buffer\n");
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)rxframe,
+                      sizeof(struct can_rxframe_s), 0, true);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to copy the frame: %d\n", ret);
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  ret = iob_tryadd_queue(iob, &conn->readahead);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to queue the frame: %d\n", ret);
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  conn->backlog++;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_deliver
+ *
+ * Description:
+ *   Queue a copy of 'frame' on every socket bound to 'dev' whose filters
+ *   accept it and wake up any readers.  This is the common back end of
+ *   can_input() and of the local loopback of sent frames.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the frame was received or sent
+ *   frame  - The frame
+ *   origin - The sending socket for locally looped back frames; NULL for
+ *            frames received from the bus.
+ *
+ * Returned Value:
+ *   The number of sockets that accepted the frame.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+int can_deliver(FAR struct net_driver_s *dev,
+                FAR const struct can_frame *frame,
+                FAR struct can_conn_s *origin)
+{
+  FAR struct can_conn_s *conn = NULL;
+  struct can_rxframe_s rxframe;
+  struct timespec ts;
+  bool stamped = false;
+  int ndelivered = 0;
+
+  while ((conn = can_nextconn(conn)) != NULL)
+    {
+      /* Skip sockets bound to a different device */
+
+      if (conn->ifindex != 0 && conn->ifindex != dev->d_ifindex)
+        {
+          continue;
+        }
+
+      /* A socket sees its own frames only if it asked for them */
+
+      if (conn == origin && (conn->flags & CAN_CONN_RECVOWN) == 0)
+        {
+          continue;
+        }
+
+      if (!can_filter_match(conn, frame->can_id))
+        {
+          continue;
+        }
+
+      /* Sample the time of reception once, for the first socket that wants
+       * the frame.  Frames that nobody listens to cost only the filters.
+       */
+
+      if (!stamped)
+        {
+          (void)clock_gettime(CLOCK_REALTIME, &ts);
+          rxframe.rf_ts.tv_sec  = ts.tv_sec;
+          rxframe.rf_ts.tv_usec = ts.tv_nsec / 1000;
+          rxframe.rf_ifindex    = dev->d_ifindex;
+          memcpy(&rxframe.rf_frame, frame, sizeof(struct can_frame));
+          stamped = true;
+        }
+
+      if (can_datahandler(conn, &rxframe) < 0)
+        {
+          NETDEV_RXDROPPED(dev);
+          continue;
+        }
+
+      /* Notify any waiting readers and pollers */
+
+      ndelivered++;
+      (void)can_callback(dev, conn, CAN_NEWDATA);
+    }
+
+  return ndelivered;
+}
+
+/****************************************************************************
+ * Name: can_input
+ *
+ * Description:
+ *   Handle incoming CAN frames
+ *
+ *   This function provides the interface between CAN device drivers and the
+ *   PF_CAN socket logic.  A CAN driver registers with the link layer type
+ *   NET_LL_CAN and passes each received frame to can_input() as one
+ *   struct can_frame in dev->d_buf with dev->d_len set to CAN_MTU.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received frame
+ *
+ * Returned Value:
+ *   OK     The frame has been processed and can be released.
+ *   -EINVAL The frame is malformed and was dropped.
+ *
+ * Assumptions:
+ *   Called from the network driver with the network locked.
+ *
+ ****************************************************************************/
+
+int can_input(FAR struct net_driver_s *dev)
+{
+  FAR struct can_frame *frame;
+
+  DEBUGASSERT(dev != NULL && dev->d_lltype == NET_LL_CAN);
+
+  frame = (FAR struct can_frame *)dev->d_buf;
+  if (dev->d_len < CAN_MTU || frame->can_dlc > CAN_MAX_DLC)
+    {
+      nwarn("WARNING: Malformed frame: len=%u\n", dev->d_len);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      return -EINVAL;
+    }
+
+  (void)can_deliver(dev, frame, NULL);
+
+  /* The frame has been consumed and there is never a response */
+
+  dev->d_len = 0;
+  return OK;
+}
+
+#endif /* CONFIG_NET_CAN */
@@ -0,0 +1,209 @@
+/****************************************************************************
+ * net/can/can_netpoll.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "can/can.h"
+
+#if defined(CONFIG_NET_CAN) && !defined(CONFIG_DISABLE_POLL)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_poll_eventhandler
+ *
+ * Description:
+ *   Report POLLIN when a frame is queued on the socket.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static uint16_t can_poll_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *conn,
+                                      FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pollfd *fds = (FAR struct pollfd *)pvpriv;
+  pollevent_t eventset;
+
+  ninfo("flags: %04x\n", flags);
+
+  /* 'fds' might be null in some race conditions (?) */
+
+  if (fds != NULL && (flags & CAN_NEWDATA) != 0)
+    {
+      eventset = (POLLIN & fds->events);
+      if (eventset != 0)
+        {
+          fds->revents |= eventset;
+          nxsem_post(fds->sem);
+        }
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_pollsetup
+ *
+ * Description:
+ *   Setup to monitor events on one PF_CAN socket.  The callback reference
+ *   is kept in fds->priv so no container needs to be allocated.
+ *
+ * Input Parameters:
+ *   psock - The PF_CAN socket of interest
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int can_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct can_conn_s *conn = (FAR struct can_conn_s *)psock->s_conn;
+  FAR struct devif_callback_s *cb;
+
+  DEBUGASSERT(conn != NULL && fds != NULL);
+
+  net_lock();
+
+  /* Allocate a callback on the connection.  It is not associated with a
+   * device because the socket may receive from all CAN devices.
+   */
+
+  cb = can_callback_alloc(NULL, conn);
+  if (cb == NULL)
+    {
+      net_unlock();
+      return -EBUSY;
+    }
+
+  cb->flags = 0;
+  cb->priv  = (FAR void *)fds;
+  cb->event = can_poll_eventhandler;
+
+  if ((fds->events & POLLIN) != 0)
+    {
+      cb->flags |= CAN_NEWDATA;
+    }
+
+  fds->priv = (FAR void *)cb;
+
+  /* Check for read data availability now */
+
+  if (!IOB_QEMPTY(&conn->readahead))
+    {
+      fds->revents |= (POLLRDNORM & fds->events);
+    }
+
+  /* A send never waits for buffer space */
+
+  fds->revents |= (POLLWRNORM & fds->events);
+
+  /* Check if any requested events are already in effect */
+
+  if (fds->revents != 0)
+    {
+      nxsem_post(fds->sem);
+    }
+
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_pollteardown
+ *
+ * Description:
+ *   Teardown monitoring of events on a PF_CAN socket
+ *
+ * Input Parameters:
+ *   psock - The PF_CAN socket of interest
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int can_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct can_conn_s *conn = (FAR struct can_conn_s *)psock->s_conn;
+  FAR struct devif_callback_s *cb;
+
+  DEBUGASSERT(conn != NULL && fds != NULL);
+
+  cb = (FAR struct devif_callback_s *)fds->priv;
+  if (cb != NULL)
+    {
+      /* Release the callback */
+
+      net_lock();
+      can_callback_free(NULL, conn, cb);
+      net_unlock();
+
+      /* Release the poll/select data slot */
+
+      fds->priv = NULL;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_CAN && !CONFIG_DISABLE_POLL */
@@ -0,0 +1,447 @@
+/****************************************************************************
+ * net/can/can_recvfrom.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct can_recvfrom_s
+{
+  FAR struct socket *ir_sock;           /* Points to the parent socket structure */
+  FAR struct devif_callback_s *ir_cb;   /* Reference to callback instance */
+  FAR struct can_rxframe_s *ir_rxframe; /* Location to return the frame */
+  sem_t ir_sem;                         /* Semaphore signals recv completion */
+  int ir_result;                        /* Success:OK, failure:negated errno */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_recvfrom_rxqueue
+ *
+ * Description:
+ *   Remove the oldest frame from the read-ahead queue of the connection.
+ *
+ * Returned Value:
+ *   OK if a frame was returned; -EAGAIN if the queue is empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int can_recvfrom_rxqueue(FAR struct can_conn_s *conn,
+                                FAR struct can_rxframe_s *rxframe)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_remove_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  DEBUGASSERT(conn->backlog > 0);
+  conn->backlog--;
+
+  (void)iob_copyout((FAR uint8_t *)rxframe, iob,
+                    sizeof(struct can_rxframe_s), 0);
+  iob_free_chain(iob);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_recvfrom_eventhandler
+ *
+ * Description:
+ *   Complete a waiting receive when a new frame has been queued.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
+                                          FAR void *pvconn,
+                                          FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct can_recvfrom_s *pstate = (FAR struct can_recvfrom_s *)pvpriv;
+  FAR struct can_conn_s *conn = (FAR struct can_conn_s *)pvconn;
+
+  ninfo("flags: %04x\n", flags);
+
+  /* 'pstate' might be null in some race conditions (?) */
+
+  if (pstate != NULL && conn != NULL && (flags & CAN_NEWDATA) != 0)
+    {
+      if (can_recvfrom_rxqueue(conn, pstate->ir_rxframe) == OK)
+        {
+          /* Don't allow any further call backs. */
+
+          pstate->ir_cb->flags = 0;
+          pstate->ir_cb->priv  = NULL;
+          pstate->ir_cb->event = NULL;
+          pstate->ir_result    = OK;
+
+          /* Indicate that the data has been consumed */
+
+          flags &= ~CAN_NEWDATA;
+
+          /* Wake up the waiting thread */
+
+          nxsem_post(&pstate->ir_sem);
+        }
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: can_recvframe
+ *
+ * Description:
+ *   Receive one frame from a PF_CAN socket, waiting for it if necessary
+ *   (and permitted).  This is the common part of can_recvfrom() and
+ *   can_recvmsg().
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.  -EAGAIN is returned
+ *   if no frame is available on a non-blocking socket or when the
+ *   SO_RCVTIMEO timeout expires.
+ *
+ ****************************************************************************/
+
+static int can_recvframe(FAR struct socket *psock, int flags,
+                         FAR struct can_rxframe_s *rxframe)
+{
+  FAR struct can_conn_s *conn = (FAR struct can_conn_s *)psock->s_conn;
+  FAR struct timespec *ptimeo = NULL;
+  struct can_recvfrom_s state;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec abstime;
+#endif
+  int ret;
+
+  DEBUGASSERT(conn != NULL);
+
+  if (psock->s_type != SOCK_RAW)
+    {
+      nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
+      return -EPROTONOSUPPORT;
+    }
+
+  /* Before we wait for data, let's check if there are already frame(s)
+   * waiting in the read-ahead queue.
+   */
+
+  net_lock();
+  ret = can_recvfrom_rxqueue(conn, rxframe);
+  if (ret == OK || _SS_ISNONBLOCK(psock->s_flags) ||
+      (flags & MSG_DONTWAIT) != 0)
+    {
+      net_unlock();
+      return ret;
+    }
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (psock->s_rcvtimeo != 0)
+    {
+      DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
+
+      abstime.tv_sec  += psock->s_rcvtimeo / DSEC_PER_SEC;
+      abstime.tv_nsec += (psock->s_rcvtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (abstime.tv_nsec >= NSEC_PER_SEC)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      ptimeo = &abstime;
+    }
+#endif
+
+  /* We will have to wait.  This semaphore is used for signaling and,
+   * hence, should not have priority inheritance enabled.
+   */
+
+  memset(&state, 0, sizeof(struct can_recvfrom_s));
+  state.ir_sock    = psock;
+  state.ir_rxframe = rxframe;
+  state.ir_result  = -EAGAIN;
+
+  (void)nxsem_init(&state.ir_sem, 0, 0); /* Doesn't really fail */
+  (void)nxsem_setprotocol(&state.ir_sem, SEM_PRIO_NONE);
+
+  /* Set up the callback in the connection.  It is not associated with any
+   * one device:  A socket may receive from all CAN devices.
+   */
+
+  state.ir_cb = can_callback_alloc(NULL, conn);
+  if (state.ir_cb != NULL)
+    {
+      state.ir_cb->flags = CAN_NEWDATA;
+      state.ir_cb->priv  = (FAR void *)&state;
+      state.ir_cb->event = can_recvfrom_eventhandler;
+
+      /* Wait for either the receive to complete or for an error/timeout to
+       * occur.  NOTES:  (1) net_timedwait will also terminate if a signal
+       * is received, (2) the network is locked!  It will be un-locked while
+       * the task sleeps and automatically re-locked when the task restarts.
+       */
+
+      ret = net_timedwait(&state.ir_sem, ptimeo);
+      if (ret >= 0)
+        {
+          ret = state.ir_result;
+        }
+      else if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+        }
+
+      /* Make sure that no further events are processed */
+
+      can_callback_free(NULL, conn, state.ir_cb);
+    }
+  else
+    {
+      ret = -EBUSY;
+    }
+
+  nxsem_destroy(&state.ir_sem);
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_recvfrom
+ *
+ * Description:
+ *   Implements the socket recvfrom interface for PF_CAN sockets.  Exactly
+ *   one frame is returned by each call.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  Otherwise, on
+ *   errors, a negated errno value is returned (see recvfrom() for the list
+ *   of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t can_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
+                     int flags, FAR struct sockaddr *from,
+                     FAR socklen_t *fromlen)
+{
+  FAR struct sockaddr_can *caddr;
+  struct can_rxframe_s rxframe;
+  int ret;
+
+  /* If a 'from' address has been provided, verify that it is large
+   * enough to hold this address family.
+   */
+
+  if (from != NULL && *fromlen < sizeof(struct sockaddr_can))
+    {
+      return -EINVAL;
+    }
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+  ret = can_recvframe(psock, flags, &rxframe);
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (from != NULL)
+    {
+      caddr              = (FAR struct sockaddr_can *)from;
+      caddr->can_family  = AF_CAN;
+      caddr->can_ifindex = rxframe.rf_ifindex;
+      *fromlen           = sizeof(struct sockaddr_can);
+    }
+
+  /* Copy the frame, truncating it if the buffer is too small */
+
+  if (len > CAN_MTU)
+    {
+      len = CAN_MTU;
+    }
+
+  memcpy(buf, &rxframe.rf_frame, len);
+  return len;
+}
+
+/****************************************************************************
+ * Name: can_recvmsg
+ *
+ * Description:
+ *   Implements the socket recvmsg interface for PF_CAN sockets.  In
+ *   addition to can_recvfrom() the time of reception is returned as an
+ *   SCM_TIMESTAMP control message if msg_control provides room for it.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  Otherwise, on
+ *   errors, a negated errno value is returned (see recvmsg() for the list
+ *   of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                    int flags)
+{
+  FAR struct sockaddr_can *caddr;
+  FAR struct cmsghdr *cmsg;
+  FAR const uint8_t *src;
+  struct can_rxframe_s rxframe;
+  size_t offset;
+  size_t ncopy;
+  unsigned long i;
+  int ret;
+
+  if (msg->msg_name != NULL &&
+      msg->msg_namelen < (int)sizeof(struct sockaddr_can))
+    {
+      return -EINVAL;
+    }
+
+  ret = can_recvframe(psock, flags, &rxframe);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (msg->msg_name != NULL)
+    {
+      caddr              = (FAR struct sockaddr_can *)msg->msg_name;
+      caddr->can_family  = AF_CAN;
+      caddr->can_ifindex = rxframe.rf_ifindex;
+      msg->msg_namelen   = sizeof(struct sockaddr_can);
+    }
+
+  /* Scatter the frame into the caller's segments */
+
+  src = (FAR const uint8_t *)&rxframe.rf_frame;
+  for (i = 0, offset = 0; i < msg->msg_iovlen && offset < CAN_MTU; i++)
+    {
+      ncopy = msg->msg_iov[i].iov_len;
+      if (ncopy > CAN_MTU - offset)
+        {
+          ncopy = CAN_MTU - offset;
+        }
+
+      memcpy(msg->msg_iov[i].iov_base, &src[offset], ncopy);
+      offset += ncopy;
+    }
+
+  if (offset < CAN_MTU)
+    {
+      msg->msg_flags |= MSG_TRUNC;
+    }
+
+  /* Return the time of reception if there is room for it */
+
+  cmsg = CMSG_FIRSTHDR(msg);
+  if (cmsg != NULL &&
+      msg->msg_controllen >= CMSG_LEN(sizeof(struct timeval)))
+    {
+      cmsg->cmsg_len      = CMSG_LEN(sizeof(struct timeval));
+      cmsg->cmsg_level    = SOL_SOCKET;
+      cmsg->cmsg_type     = SCM_TIMESTAMP;
+      memcpy(CMSG_DATA(cmsg), &rxframe.rf_ts, sizeof(struct timeval));
+      msg->msg_controllen = CMSG_LEN(sizeof(struct timeval));
+    }
+  else
+    {
+      if (msg->msg_control != NULL && msg->msg_controllen > 0)
+        {
+          msg->msg_flags |= MSG_CTRUNC;
+        }
+
+      msg->msg_controllen = 0;
+    }
+
+  return offset;
+}
+
+#endif /* CONFIG_NET_CAN */
@@ -0,0 +1,300 @@
+/****************************************************************************
+ * net/can/can_sendto.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <net/if.h>
+#include <netpacket/can.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "socket/socket.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of the send operation until it can be
+ * operated upon by the event handler.
+ */
+
+struct can_send_s
+{
+  FAR struct socket *snd_sock;         /* Points to the parent socket structure */
+  FAR struct devif_callback_s *snd_cb; /* Reference to callback instance */
+  FAR struct net_driver_s *snd_dev;    /* The device to send on */
+  sem_t snd_sem;                       /* Used to wake up the waiting thread */
+  struct can_frame snd_frame;          /* The frame to send */
+  ssize_t snd_result;                  /* Success:size, failure:negated errno */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_send_eventhandler
+ *
+ * Description:
+ *   Place the frame in the device buffer when the device polls for TX data
+ *   and loop it back to the other local sockets.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t can_send_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *pvconn,
+                                      FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct can_send_s *pstate = (FAR struct can_send_s *)pvpriv;
+  FAR struct can_conn_s *conn;
+
+  ninfo("flags: %04x\n", flags);
+
+  /* 'pstate' might be null in some race conditions (?) */
+
+  if (pstate == NULL || dev != pstate->snd_dev)
+    {
+      return flags;
+    }
+
+  conn = (FAR struct can_conn_s *)pstate->snd_sock->s_conn;
+
+  if ((flags & NETDEV_DOWN) != 0)
+    {
+      /* The device went down while we were waiting */
+
+      pstate->snd_result = -ENETDOWN;
+    }
+  else if ((flags & CAN_POLL) != 0 && dev->d_sndlen == 0)
+    {
+      /* The device buffer is ours.  Copy the frame into it. */
+
+      memcpy(dev->d_buf, &pstate->snd_frame, CAN_MTU);
+      dev->d_len         = CAN_MTU;
+      dev->d_sndlen      = CAN_MTU;
+      pstate->snd_result = CAN_MTU;
+    }
+  else
+    {
+      /* Another socket has claimed this poll.  Wait for the next one. */
+
+      return flags;
+    }
+
+  /* Don't allow any further call backs. */
+
+  pstate->snd_cb->flags = 0;
+  pstate->snd_cb->priv  = NULL;
+  pstate->snd_cb->event = NULL;
+
+  /* Local loopback:  The other sockets on this device see the frame as if
+   * it had been received from the bus.
+   */
+
+  if (pstate->snd_result > 0 && (conn->flags & CAN_CONN_LOOPBACK) != 0)
+    {
+      (void)can_deliver(dev, &pstate->snd_frame, conn);
+    }
+
+  /* Wake up the waiting thread */
+
+  nxsem_post(&pstate->snd_sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_can_sendto
+ *
+ * Description:
+ *   Send one struct can_frame on a PF_CAN socket.  The frame is sent on the
+ *   device selected by 'to' or, if 'to' is NULL, on the device to which the
+ *   socket is bound.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      The frame to send
+ *   len      Length of the frame; must be CAN_MTU
+ *   flags    Send flags
+ *   to       Address of recipient (may be NULL)
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See sendto() for the complete list
+ *   of return values.
+ *
+ ****************************************************************************/
+
+ssize_t psock_can_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  FAR const struct can_frame *frame = (FAR const struct can_frame *)buf;
+  FAR struct can_conn_s *conn;
+  struct can_send_s state;
+  int ifindex;
+  ssize_t ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  /* Exactly one classic CAN frame is sent at a time */
+
+  if (buf == NULL || len != CAN_MTU || frame->can_dlc > CAN_MAX_DLC)
+    {
+      return -EINVAL;
+    }
+
+  /* Select the device:  An explicit address overrides the binding */
+
+  if (to != NULL)
+    {
+      if (tolen < sizeof(struct sockaddr_can) || to->sa_family != AF_CAN)
+        {
+          return -EINVAL;
+        }
+
+      ifindex = ((FAR const struct sockaddr_can *)to)->can_ifindex;
+    }
+  else
+    {
+      ifindex = conn->ifindex;
+    }
+
+  /* Perform the send operation.  Initialize the state structure.  This is
+   * done with the network locked because we don't want anything to happen
+   * until we are ready.
+   */
+
+  net_lock();
+  memset(&state, 0, sizeof(struct can_send_s));
+
+  state.snd_dev = ifindex > 0 ? can_find_device(ifindex) : NULL;
+  if (state.snd_dev == NULL)
+    {
+      ret = -ENXIO;
+      goto errout_with_lock;
+    }
+
+  if (!IFF_IS_UP(state.snd_dev->d_flags))
+    {
+      ret = -ENETDOWN;
+      goto errout_with_lock;
+    }
+
+  state.snd_sock = psock;
+  memcpy(&state.snd_frame, frame, CAN_MTU);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)nxsem_init(&state.snd_sem, 0, 0); /* Doesn't really fail */
+  (void)nxsem_setprotocol(&state.snd_sem, SEM_PRIO_NONE);
+
+  /* Set the socket state to sending */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  /* Allocate the callback that will be invoked when the device polls */
+
+  state.snd_cb = can_callback_alloc(state.snd_dev, conn);
+  if (state.snd_cb != NULL)
+    {
+      state.snd_cb->flags = (CAN_POLL | NETDEV_DOWN);
+      state.snd_cb->priv  = (FAR void *)&state;
+      state.snd_cb->event = can_send_eventhandler;
+
+      /* Notify the device driver that new TX data is available. */
+
+      netdev_txnotify_dev(state.snd_dev);
+
+      /* Wait for the send to complete or an error to occur.  NOTES:
+       * net_lockedwait will also terminate if a signal is received and the
+       * network is unlocked while the task sleeps.
+       */
+
+      ret = net_lockedwait(&state.snd_sem);
+      if (ret >= 0)
+        {
+          ret = state.snd_result;
+        }
+
+      /* Make sure that no further events are processed */
+
+      can_callback_free(state.snd_dev, conn, state.snd_cb);
+    }
+  else
+    {
+      ret = -EBUSY;
+    }
+
+  /* Set the socket state to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+  nxsem_destroy(&state.snd_sem);
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_CAN */
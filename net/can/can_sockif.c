@@ -0,0 +1,520 @@
+/****************************************************************************
+ * net/can/can_sockif.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int        can_setup(FAR struct socket *psock, int protocol);
+static sockcaps_t can_sockcaps(FAR struct socket *psock);
+static void       can_addref(FAR struct socket *psock);
+static int        can_bind(FAR struct socket *psock,
+                    FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        can_getsockname(FAR struct socket *psock,
+                    FAR struct sockaddr *addr, FAR socklen_t *addrlen);
+static int        can_getpeername(FAR struct socket *psock,
+                    FAR struct sockaddr *addr, FAR socklen_t *addrlen);
+static int        can_listen(FAR struct socket *psock, int backlog);
+static int        can_connect(FAR struct socket *psock,
+                    FAR const struct sockaddr *addr, socklen_t addrlen);
+static int        can_accept(FAR struct socket *psock,
+                    FAR struct sockaddr *addr, FAR socklen_t *addrlen,
+                    FAR struct socket *newsock);
+#ifndef CONFIG_DISABLE_POLL
+static int        can_poll_local(FAR struct socket *psock,
+                    FAR struct pollfd *fds, bool setup);
+#endif
+static ssize_t    can_send(FAR struct socket *psock, FAR const void *buf,
+                    size_t len, int flags);
+static ssize_t    can_sendto(FAR struct socket *psock, FAR const void *buf,
+                    size_t len, int flags, FAR const struct sockaddr *to,
+                    socklen_t tolen);
+static int        can_close(FAR struct socket *psock);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct sock_intf_s g_can_sockif =
+{
+  can_setup,        /* si_setup */
+  can_sockcaps,     /* si_sockcaps */
+  can_addref,       /* si_addref */
+  can_bind,         /* si_bind */
+  can_getsockname,  /* si_getsockname */
+  can_getpeername,  /* si_getpeername */
+  can_listen,       /* si_listen */
+  can_connect,      /* si_connect */
+  can_accept,       /* si_accept */
+#ifndef CONFIG_DISABLE_POLL
+  can_poll_local,   /* si_poll */
+#endif
+  can_send,         /* si_send */
+  can_sendto,       /* si_sendto */
+#ifdef CONFIG_NET_SENDFILE
+  NULL,             /* si_sendfile */
+#endif
+  can_recvfrom,     /* si_recvfrom */
+  NULL,             /* si_sendmsg */
+  can_recvmsg,      /* si_recvmsg */
+  can_close         /* si_close */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_setup
+ *
+ * Description:
+ *   Called for socket() to verify that the provided socket type and
+ *   protocol are usable by this address family.  Perform any family-
+ *   specific socket fields.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a user allocated socket structure to be
+ *            initialized.
+ *   protocol (see sys/socket.h)
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  Otherwise, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+static int can_setup(FAR struct socket *psock, int protocol)
+{
+  FAR struct can_conn_s *conn;
+
+  /* Only SOCK_RAW and the CAN_RAW protocol are supported */
+
+  if (psock->s_type != SOCK_RAW || (protocol != 0 && protocol != CAN_RAW))
+    {
+      return -EPROTONOSUPPORT;
+    }
+
+  /* Allocate the PF_CAN connection structure and save it in the new
+   * socket instance.
+   */
+
+  conn = can_alloc();
+  if (conn == NULL)
+    {
+      /* Failed to reserve a connection structure */
+
+      return -ENOMEM;
+    }
+
+  /* Set the reference count on the connection structure.  This reference
+   * count will be incremented only if the socket is dup'ed
+   */
+
+  DEBUGASSERT(conn->crefs == 0);
+  conn->crefs   = 1;
+  psock->s_conn = conn;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_sockcaps
+ *
+ * Description:
+ *   Return the bit encoded capabilities of this socket.
+ *
+ * Input Parameters:
+ *   psock - Socket structure of the socket whose capabilities are being
+ *           queried.
+ *
+ * Returned Value:
+ *   The set of socket cababilities is returned.
+ *
+ ****************************************************************************/
+
+static sockcaps_t can_sockcaps(FAR struct socket *psock)
+{
+  return SOCKCAP_NONBLOCKING;
+}
+
+/****************************************************************************
+ * Name: can_addref
+ *
+ * Description:
+ *   Increment the refernce count on the underlying connection structure.
+ *
+ * Input Parameters:
+ *   psock - Socket structure of the socket whose reference count will be
+ *           incremented.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void can_addref(FAR struct socket *psock)
+{
+  FAR struct can_conn_s *conn;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL &&
+              psock->s_type == SOCK_RAW);
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn->crefs > 0 && conn->crefs < 255);
+  conn->crefs++;
+}
+
+/****************************************************************************
+ * Name: can_bind
+ *
+ * Description:
+ *   can_bind() binds the socket to the CAN device with the interface index
+ *   in the struct sockaddr_can.  An index of zero selects all CAN devices
+ *   for reception; such a socket must name the device in each sendto().
+ *
+ * Input Parameters:
+ *   psock    Socket structure of the socket to bind
+ *   addr     Socket local address
+ *   addrlen  Length of 'addr'
+ *
+ * Returned Value:
+ *   0 on success;  A negated errno value is returned on failure.  See
+ *   bind() for a list a appropriate error values.
+ *
+ ****************************************************************************/
+
+static int can_bind(FAR struct socket *psock,
+                    FAR const struct sockaddr *addr, socklen_t addrlen)
+{
+  FAR const struct sockaddr_can *caddr;
+  FAR struct can_conn_s *conn;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && addr != NULL);
+
+  /* Verify that a valid address has been provided */
+
+  if (addr->sa_family != AF_CAN || addrlen < sizeof(struct sockaddr_can))
+    {
+      nerr("ERROR: Invalid family: %u or address length: %d < %d\n",
+           addr->sa_family, addrlen, sizeof(struct sockaddr_can));
+      return -EBADF;
+    }
+
+  caddr = (FAR const struct sockaddr_can *)addr;
+  conn  = (FAR struct can_conn_s *)psock->s_conn;
+
+  /* Verify that the device exists and is a CAN device */
+
+  net_lock();
+  if (caddr->can_ifindex < 0 ||
+      (caddr->can_ifindex > 0 && can_find_device(caddr->can_ifindex) == NULL))
+    {
+      nerr("ERROR: No CAN device with index %d\n", caddr->can_ifindex);
+      ret = -ENODEV;
+    }
+  else
+    {
+      /* A socket may be re-bound.  The new binding applies to frames
+       * received from now on.
+       */
+
+      conn->ifindex  = (uint8_t)caddr->can_ifindex;
+      psock->s_flags |= _SF_BOUND;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_getsockname
+ *
+ * Description:
+ *   The can_getsockname() function retrieves the locally-bound name of the
+ *   specified PF_CAN socket, i.e. the interface index of the bound device.
+ *
+ * Input Parameters:
+ *   psock    Socket structure of the socket to be queried
+ *   addr     sockaddr structure to receive data [out]
+ *   addrlen  Length of sockaddr structure [in/out]
+ *
+ * Returned Value:
+ *   On success, 0 is returned, the 'addr' argument points to the address
+ *   of the socket, and the 'addrlen' argument points to the length of the
+ *   address.  Otherwise, a negated errno value is returned.  See
+ *   getsockname() for the list of appropriate error numbers.
+ *
+ ****************************************************************************/
+
+static int can_getsockname(FAR struct socket *psock,
+                           FAR struct sockaddr *addr,
+                           FAR socklen_t *addrlen)
+{
+  FAR struct can_conn_s *conn;
+  struct sockaddr_can tmp;
+  socklen_t copylen;
+
+  DEBUGASSERT(psock != NULL && addr != NULL && addrlen != NULL);
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
+  /* Create a copy of the full address on the stack */
+
+  memset(&tmp, 0, sizeof(struct sockaddr_can));
+  tmp.can_family  = AF_CAN;
+  tmp.can_ifindex = conn->ifindex;
+
+  /* Copy to the user buffer, truncating if necessary */
+
+  copylen = sizeof(struct sockaddr_can);
+  if (copylen > *addrlen)
+    {
+      copylen = *addrlen;
+    }
+
+  memcpy(addr, &tmp, copylen);
+
+  /* Return the actual size transferred */
+
+  *addrlen = copylen;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: can_getpeername
+ *
+ * Description:
+ *   CAN is a broadcast bus and PF_CAN sockets have no peer.
+ *
+ ****************************************************************************/
+
+static int can_getpeername(FAR struct socket *psock,
+                           FAR struct sockaddr *addr,
+                           FAR socklen_t *addrlen)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: can_listen
+ *
+ * Description:
+ *   PF_CAN sockets are connectionless:  listen() is not supported.
+ *
+ ****************************************************************************/
+
+static int can_listen(FAR struct socket *psock, int backlog)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: can_connect
+ *
+ * Description:
+ *   PF_CAN sockets are connectionless:  connect() is not supported.  Use
+ *   bind() to select the device used by send().
+ *
+ ****************************************************************************/
+
+static int can_connect(FAR struct socket *psock,
+                       FAR const struct sockaddr *addr, socklen_t addrlen)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: can_accept
+ *
+ * Description:
+ *   PF_CAN sockets are connectionless:  accept() is not supported.
+ *
+ ****************************************************************************/
+
+static int can_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
+                      FAR socklen_t *addrlen, FAR struct socket *newsock)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: can_poll_local
+ *
+ * Description:
+ *   The standard poll() operation redirects operations on socket descriptors
+ *   to net_poll which, indiectly, calls to function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored, OR NULL if
+ *           this is a request to stop monitoring events.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int can_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
+                          bool setup)
+{
+  if (setup)
+    {
+      return can_pollsetup(psock, fds);
+    }
+  else
+    {
+      return can_pollteardown(psock, fds);
+    }
+}
+#endif /* !CONFIG_DISABLE_POLL */
+
+/****************************************************************************
+ * Name: can_send
+ *
+ * Description:
+ *   Socket send() method for the PF_CAN socket.  The frame is sent on the
+ *   device to which the socket is bound.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t can_send(FAR struct socket *psock, FAR const void *buf,
+                        size_t len, int flags)
+{
+  return psock_can_sendto(psock, buf, len, flags, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: can_sendto
+ *
+ * Description:
+ *   Socket sendto() method for the PF_CAN socket.  The device is taken from
+ *   'to' if it is not NULL.
+ *
+ ****************************************************************************/
+
+static ssize_t can_sendto(FAR struct socket *psock, FAR const void *buf,
+                          size_t len, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen)
+{
+  return psock_can_sendto(psock, buf, len, flags, to, tolen);
+}
+
+/****************************************************************************
+ * Name: can_close
+ *
+ * Description:
+ *   Performs the close operation on a PF_CAN socket instance
+ *
+ * Input Parameters:
+ *   psock   Socket instance
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value is returned on any failure.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static int can_close(FAR struct socket *psock)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+
+  /* Only SOCK_RAW is supported */
+
+  if (psock->s_type != SOCK_RAW || conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  /* Is this the last reference to the connection structure (there could be
+   * more if the socket was dup'ed).
+   */
+
+  if (conn->crefs <= 1)
+    {
+      /* Yes... free the connection structure */
+
+      conn->crefs = 0;          /* No more references on the connection */
+      can_free(conn);           /* Free network resources */
+    }
+  else
+    {
+      /* No.. Just decrement the reference count */
+
+      conn->crefs--;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET_CAN */
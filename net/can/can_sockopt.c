@@ -0,0 +1,285 @@
+/****************************************************************************
+ * net/can/can_sockopt.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/can.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "can/can.h"
+
+#if defined(CONFIG_NET_CAN) && defined(CONFIG_NET_SOCKOPTS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_setflag
+ *
+ * Description:
+ *   Set or clear one of the boolean CAN_CONN_* flags from an int option
+ *   value.
+ *
+ ****************************************************************************/
+
+static int can_setflag(FAR struct can_conn_s *conn, uint8_t flag,
+                       FAR const void *value, socklen_t value_len)
+{
+  if (value == NULL || value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  if (*(FAR const int *)value != 0)
+    {
+      conn->flags |= flag;
+    }
+  else
+    {
+      conn->flags &= ~flag;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_setsockopt
+ *
+ * Description:
+ *   can_setsockopt() sets the SOL_CAN_RAW option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument for the socket
+ *   specified by the 'psock' argument.
+ *
+ *   See <netpacket/can.h> for the a complete list of values of CAN_RAW
+ *   socket options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_setcockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int can_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct can_conn_s *conn;
+  int nfilters;
+  int ret;
+
+  DEBUGASSERT(psock != NULL);
+
+  if (psock->s_domain != PF_CAN || psock->s_conn == NULL)
+    {
+      nerr("ERROR:  Not a PF_CAN socket\n");
+      return -ENOPROTOOPT;
+    }
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  /* The receive path evaluates the filters with the network locked */
+
+  net_lock();
+  switch (option)
+    {
+      case CAN_RAW_FILTER:
+        /* Replace the complete filter set.  An empty set disables the
+         * reception of data and remote frames.
+         */
+
+        nfilters = value_len / sizeof(struct can_filter);
+        if ((value == NULL && value_len > 0) ||
+            value_len % sizeof(struct can_filter) != 0 ||
+            nfilters > CONFIG_NET_CAN_NFILTERS)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        if (nfilters > 0)
+          {
+            memcpy(conn->filters, value, value_len);
+          }
+
+        conn->nfilters = nfilters;
+        ret = OK;
+        break;
+
+      case CAN_RAW_ERR_FILTER:
+        if (value == NULL || value_len != sizeof(can_err_mask_t))
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        conn->err_mask = *(FAR const can_err_mask_t *)value & CAN_ERR_MASK;
+        ret = OK;
+        break;
+
+      case CAN_RAW_LOOPBACK:
+        ret = can_setflag(conn, CAN_CONN_LOOPBACK, value, value_len);
+        break;
+
+      case CAN_RAW_RECV_OWN_MSGS:
+        ret = can_setflag(conn, CAN_CONN_RECVOWN, value, value_len);
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized CAN_RAW option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: can_getsockopt
+ *
+ * Description:
+ *   can_getsockopt() retrieves the value of the SOL_CAN_RAW option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  -ERANGE is returned if the
+ *   buffer cannot hold the complete filter set; *value_len then holds the
+ *   required size.
+ *
+ ****************************************************************************/
+
+int can_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct can_conn_s *conn;
+  socklen_t size;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && value_len != NULL);
+
+  if (psock->s_domain != PF_CAN || psock->s_conn == NULL)
+    {
+      nerr("ERROR:  Not a PF_CAN socket\n");
+      return -ENOPROTOOPT;
+    }
+
+  conn = (FAR struct can_conn_s *)psock->s_conn;
+
+  net_lock();
+  switch (option)
+    {
+      case CAN_RAW_FILTER:
+        size = conn->nfilters * sizeof(struct can_filter);
+        if (*value_len < size)
+          {
+            ret = -ERANGE;
+          }
+        else if (size > 0)
+          {
+            memcpy(value, conn->filters, size);
+          }
+
+        *value_len = size;
+        break;
+
+      case CAN_RAW_ERR_FILTER:
+        if (*value_len < sizeof(can_err_mask_t))
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        *(FAR can_err_mask_t *)value = conn->err_mask;
+        *value_len = sizeof(can_err_mask_t);
+        break;
+
+      case CAN_RAW_LOOPBACK:
+      case CAN_RAW_RECV_OWN_MSGS:
+        if (*value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        *(FAR int *)value =
+          (conn->flags & (option == CAN_RAW_LOOPBACK ?
+                          CAN_CONN_LOOPBACK : CAN_CONN_RECVOWN)) != 0;
+        *value_len = sizeof(int);
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized CAN_RAW option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_CAN && CONFIG_NET_SOCKOPTS */
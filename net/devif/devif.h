@@ -76,6 +76,7 @@
  *   PKT_NEWDATA          that the new data was consumed, suppressing further
  *   BLUETOOTH_NEWDATA    attempts to process the new data.
  *   IEEE802154_NEWDATA
+ *   CAN_NEWDATA
  *
  *   TCP_SNDACK       IN: Not used; always zero
  *                   OUT: Set by the socket layer if the new data was consumed
@@ -90,7 +91,7 @@
  *   PKT_POLL             operations, and (2) to check if the socket layer has
  *   BLUETOOTH_POLL       data that it wants to send.  These are socket oriented
  *   IEEE802154_POLL      callbacks where the context depends on the specific
- *                        set
+ *   CAN_POLL             set
  *                   OUT: Not used
  *
  *   TCP_BACKLOG      IN: There is a new connection in the backlog list set
@@ -183,6 +184,7 @@
 #define PKT_NEWDATA        TCP_NEWDATA
 #define WPAN_NEWDATA       TCP_NEWDATA
 #define IPFWD_NEWDATA      TCP_NEWDATA
+#define CAN_NEWDATA        TCP_NEWDATA
 #define TCP_SNDACK         (1 << 2)
 #define TCP_REXMIT         (1 << 3)
 #define TCP_POLL           (1 << 4)
@@ -191,6 +193,7 @@
 #define BLUETOOTH_POLL     TCP_POLL
 #define IEEE802154_POLL    TCP_POLL
 #define WPAN_POLL          TCP_POLL
+#define CAN_POLL           TCP_POLL
 #define TCP_BACKLOG        (1 << 5)
 #define TCP_CLOSE          (1 << 6)
 #define TCP_ABORT          (1 << 7)
@@ -261,6 +264,7 @@
  */
 
 struct net_driver_s;       /* Forward reference */
+struct iovec;              /* Forward reference */
 
 typedef CODE uint16_t (*devif_callback_event_t)(FAR struct net_driver_s *dev,
                                                 FAR void *pvconn,
@@ -289,12 +293,6 @@ extern "C"
 #define EXTERN extern
 #endif
 
-#ifdef CONFIG_NET_IPv4_REASSEMBLY
-/* Reassembly timer (units: deci-seconds) */
-
-EXTERN uint8_t g_reassembly_timer;
-#endif
-
 /* Time of last poll */
 
 EXTERN clock_t g_polltime;
@@ -474,6 +472,25 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, void *pvconn,
 
 void devif_send(FAR struct net_driver_s *dev, FAR const void *buf, int len);
 
+/****************************************************************************
+ * Name: devif_iovsend
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is
+ *   gathered from an array of buffers, rather than a flat buffer.  'len'
+ *   is the total size of all of the buffers.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_iovsend(FAR struct net_driver_s *dev, FAR const struct iovec *iov,
+                   int iovcnt, int len);
+
 /****************************************************************************
  * Name: devif_iob_send
  *
@@ -516,6 +533,31 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
                     unsigned int len);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_process and ipv6_process
+ *
+ * Description:
+ *   Process an IPv4 or IPv6 packet in dev->d_buf.  These are the bodies of
+ *   ipv4_input() and ipv6_input() without the packet capture tap.  They
+ *   are used to re-inject reassembled datagrams so that these are not
+ *   captured a second time.
+ *
+ * Returned Value:
+ *   See ipv4_input() and ipv6_input()
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipv4_process(FAR struct net_driver_s *dev);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_process(FAR struct net_driver_s *dev);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
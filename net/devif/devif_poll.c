@@ -50,16 +50,19 @@
 
 #include "devif/devif.h"
 #include "arp/arp.h"
+#include "neighbor/neighbor.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
 #include "pkt/pkt.h"
 #include "bluetooth/bluetooth.h"
 #include "ieee802154/ieee802154.h"
+#include "can/can.h"
 #include "icmp/icmp.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "mld/mld.h"
 #include "ipforward/ipforward.h"
+#include "ipfrag/ipfrag.h"
 #include "sixlowpan/sixlowpan.h"
 
 /****************************************************************************
@@ -276,6 +279,42 @@ static int devif_poll_bluetooth_connections(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_BLUETOOTH */
 
+/****************************************************************************
+ * Name: devif_poll_can_connections
+ *
+ * Description:
+ *   Poll all PF_CAN connections for pending frames to send.
+ *
+ * Assumptions:
+ *   This function is called from the CAN device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN
+static int devif_poll_can_connections(FAR struct net_driver_s *dev,
+                                      devif_poll_callback_t callback)
+{
+  FAR struct can_conn_s *can_conn = NULL;
+  int bstop = 0;
+
+  /* Traverse all of the allocated CAN connections and perform the poll action */
+
+  while (!bstop && (can_conn = can_nextconn(can_conn)))
+    {
+      /* Perform the CAN frame TX poll */
+
+      can_poll(dev, can_conn);
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+    }
+
+  return bstop;
+}
+#endif /* CONFIG_NET_CAN */
+
 /****************************************************************************
  * Name: devif_poll_ieee802154_connections
  *
@@ -614,10 +653,37 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
    * action.
    */
 
+#ifdef CONFIG_NET_IPFRAG
+  /* Send the remaining fragments of a datagram */
+
+  bstop = ipfrag_txpoll(dev, callback);
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_ARP_PENDQ
+    {
+      /* Send packets that were waiting for ARP resolution */
+
+      bstop = arp_txpoll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+    {
+      /* Send packets that were waiting for IPv6 neighbor resolution */
+
+      bstop = neighbor_txpoll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_ARP_SEND
-  /* Check for pending ARP requests */
+    {
+      /* Check for pending ARP requests */
+
+      bstop = arp_poll(dev, callback);
+    }
 
-  bstop = arp_poll(dev, callback);
   if (!bstop)
 #endif
 #ifdef CONFIG_NET_PKT
@@ -638,6 +704,15 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
   if (!bstop)
 #endif
+#ifdef CONFIG_NET_CAN
+    {
+      /* Check for pending PF_CAN socket transfer */
+
+      bstop = devif_poll_can_connections(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_IEEE802154
     {
       /* Check for pending PF_IEEE802154 socket transfer */
@@ -776,14 +851,10 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
       /* Perform periodic activitives that depend on hsec > 0 */
 
-#ifdef CONFIG_NET_IPv4_REASSEMBLY
-      /* Increment the timer used by the IP reassembly logic */
+#ifdef CONFIG_NET_IPFRAG
+      /* Expire incomplete datagrams and unsent fragments */
 
-      if (g_reassembly_timer != 0 &&
-          g_reassembly_timer < CONFIG_NET_IPv4_REASS_MAXAGE)
-        {
-          g_reassembly_timer += hsec;
-        }
+      ipfrag_timer(hsec);
 #endif
 
 #ifdef NET_TCP_HAVE_STACK
@@ -41,6 +41,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/uio.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -72,3 +73,35 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
 }
+
+/****************************************************************************
+ * Name: devif_iovsend
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is
+ *   gathered from an array of buffers, rather than a flat buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void devif_iovsend(FAR struct net_driver_s *dev, FAR const struct iovec *iov,
+                   int iovcnt, int len)
+{
+  FAR uint8_t *dest = dev->d_appdata;
+  int i;
+
+  DEBUGASSERT(dev != NULL && len > 0 && len < NETDEV_PKTSIZE(dev));
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      memcpy(dest, iov[i].iov_base, iov[i].iov_len);
+      dest += iov[i].iov_len;
+    }
+
+  dev->d_sndlen = len;
+}
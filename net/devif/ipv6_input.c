@@ -103,8 +103,10 @@
 
 #include "netdev/netdev.h"
 #include "ipforward/ipforward.h"
+#include "ipfrag/ipfrag.h"
 #include "inet/inet.h"
 #include "devif/devif.h"
+#include "pcap/pcap.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -246,11 +248,12 @@ static bool check_destipaddr(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: ipv6_input
+ * Name: ipv6_process
  *
  * Description:
- *   Receive an IPv6 packet from the network device.  Verify and forward to
- *   L3 packet handling logic if the packet is destined for us.
+ *   Process an IPv6 packet.  Verify and forward to L3 packet handling logic
+ *   if the packet is destined for us.  This is ipv6_input() without the
+ *   packet capture tap.
  *
  * Input Parameters:
  *   dev   - The device on which the packet was received and which contains
@@ -271,7 +274,7 @@ static bool check_destipaddr(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-int ipv6_input(FAR struct net_driver_s *dev)
+int ipv6_process(FAR struct net_driver_s *dev)
 {
   FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
   FAR uint8_t *payload;
@@ -363,6 +366,17 @@ int ipv6_input(FAR struct net_driver_s *dev)
       FAR struct ipv6_extension_s *exthdr;
       uint16_t extlen;
 
+#ifdef CONFIG_NET_IPFRAG
+      /* Stop at the Fragment header; what follows is only part of a
+       * larger datagram.
+       */
+
+      if (nxthdr == NEXT_FRAGMENT_EH)
+        {
+          break;
+        }
+
+#endif
       /* Just skip over the extension header */
 
       exthdr    = (FAR struct ipv6_extension_s *)payload;
@@ -456,6 +470,24 @@ int ipv6_input(FAR struct net_driver_s *dev)
         }
     }
 
+#ifdef CONFIG_NET_IPFRAG
+  /* Hold fragments for reassembly.  If this completes a datagram, the
+   * datagram is processed now.  Only a Fragment header immediately after
+   * the IPv6 header is supported.
+   */
+
+  if (nxthdr == NEXT_FRAGMENT_EH)
+    {
+      if (iphdrlen != IPv6_HDRLEN)
+        {
+          nwarn("WARNING: Fragment header after extension headers\n");
+          goto drop;
+        }
+
+      return ipv6_reassemble(dev);
+    }
+
+#endif
   /* Now process the incoming packet according to the protocol specified in
    * the next header IPv6 field.
    */
@@ -566,4 +598,30 @@ drop:
   dev->d_len = 0;
   return OK;
 }
+
+/****************************************************************************
+ * Name: ipv6_input
+ *
+ * Description:
+ *   Receive an IPv6 packet from the network device.  The packet is offered
+ *   to the packet capture tap and then processed.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv6 packet.
+ *
+ * Returned Value:
+ *   See ipv6_process()
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv6_input(FAR struct net_driver_s *dev)
+{
+  pcap_input(dev);
+  return ipv6_process(dev);
+}
+
 #endif /* CONFIG_NET_IPv6 */
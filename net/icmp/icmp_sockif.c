@@ -106,6 +106,8 @@ const struct sock_intf_s g_icmp_sockif =
   NULL,             /* si_sendfile */
 #endif
   icmp_recvfrom,    /* si_recvfrom */
+  NULL,             /* si_sendmsg */
+  NULL,             /* si_recvmsg */
   icmp_close        /* si_close */
 };
 
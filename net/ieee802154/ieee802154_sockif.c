@@ -111,6 +111,8 @@ const struct sock_intf_s g_ieee802154_sockif =
   NULL,                   /* si_sendfile */
 #endif
   ieee802154_recvfrom,    /* si_recvfrom */
+  NULL,                   /* si_sendmsg */
+  NULL,                   /* si_recvmsg */
   ieee802154_close        /* si_close */
 };
 
@@ -287,6 +287,31 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       int flags, FAR struct sockaddr *from,
                       FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: inet_recvmsg
+ *
+ * Description:
+ *   Implements the socket recvmsg interface for the case of the AF_INET
+ *   and AF_INET6 address families.  One message is received and scattered
+ *   across the buffers in msg->msg_iov.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message and, optionally, its source
+ *            address
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   zero is returned.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvfrom() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t inet_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                     int flags);
+
 /****************************************************************************
  * Name: inet_close
  *
@@ -43,6 +43,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -97,8 +98,11 @@ struct inet_recvfrom_s
 #endif
   FAR struct devif_callback_s *ir_cb;    /* Reference to callback instance */
   sem_t                    ir_sem;       /* Semaphore signals recv completion */
-  size_t                   ir_buflen;    /* Length of receive buffer */
-  uint8_t                 *ir_buffer;    /* Pointer to receive buffer */
+  size_t                   ir_buflen;    /* Space left in all receive buffers */
+  size_t                   ir_seglen;    /* Space left in the current buffer */
+  uint8_t                 *ir_buffer;    /* Pointer into the current buffer */
+  FAR const struct iovec  *ir_iov;       /* Receive buffers not yet started */
+  int                      ir_iovcnt;    /* Number of buffers not yet started */
   FAR struct sockaddr     *ir_from;      /* Address of sender */
   FAR socklen_t           *ir_fromlen;   /* Number of bytes allocated for address of sender */
   ssize_t                  ir_recvlen;   /* The received length */
@@ -138,11 +142,120 @@ static inline void inet_update_recvlen(FAR struct inet_recvfrom_s *pstate,
     }
 
   pstate->ir_recvlen += recvlen;
-  pstate->ir_buffer  += recvlen;
   pstate->ir_buflen  -= recvlen;
 }
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
+/****************************************************************************
+ * Name: inet_recvfrom_nextseg
+ *
+ * Description:
+ *   Make sure that there is space in the current receive buffer, moving on
+ *   to the next buffer in the I/O vector if necessary.
+ *
+ * Input Parameters:
+ *   pstate   recvfrom state structure
+ *
+ * Returned Value:
+ *   The space available in the current receive buffer.  Zero if all of the
+ *   receive buffers are full.
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) || defined(NET_TCP_HAVE_STACK)
+static size_t inet_recvfrom_nextseg(FAR struct inet_recvfrom_s *pstate)
+{
+  while (pstate->ir_seglen == 0 && pstate->ir_iovcnt > 0)
+    {
+      pstate->ir_buffer = (FAR uint8_t *)pstate->ir_iov->iov_base;
+      pstate->ir_seglen = pstate->ir_iov->iov_len;
+      pstate->ir_iov++;
+      pstate->ir_iovcnt--;
+    }
+
+  return pstate->ir_seglen;
+}
+#endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
+
+/****************************************************************************
+ * Name: inet_recvfrom_copy
+ *
+ * Description:
+ *   Scatter data from a flat buffer into the receive buffers.  The caller
+ *   must assure that 'len' does not exceed pstate->ir_buflen.
+ *
+ * Input Parameters:
+ *   pstate   recvfrom state structure
+ *   src      The data to copy
+ *   len      The size of the data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(NET_UDP_HAVE_STACK) || defined(NET_TCP_HAVE_STACK)
+static void inet_recvfrom_copy(FAR struct inet_recvfrom_s *pstate,
+                               FAR const uint8_t *src, size_t len)
+{
+  size_t ncopy;
+
+  while (len > 0 && inet_recvfrom_nextseg(pstate) > 0)
+    {
+      ncopy = len < pstate->ir_seglen ? len : pstate->ir_seglen;
+      memcpy(pstate->ir_buffer, src, ncopy);
+
+      pstate->ir_buffer += ncopy;
+      pstate->ir_seglen -= ncopy;
+      src               += ncopy;
+      len               -= ncopy;
+    }
+}
+#endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
+
+/****************************************************************************
+ * Name: inet_recvfrom_iobcopy
+ *
+ * Description:
+ *   Scatter data from an I/O buffer chain into the receive buffers.
+ *
+ * Input Parameters:
+ *   pstate   recvfrom state structure
+ *   iob      The I/O buffer chain holding the data
+ *   offset   Offset of the data in the I/O buffer chain
+ *
+ * Returned Value:
+ *   The number of bytes copied.
+ *
+ ****************************************************************************/
+
+#if (defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_READAHEAD)) || \
+    (defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_READAHEAD))
+static size_t inet_recvfrom_iobcopy(FAR struct inet_recvfrom_s *pstate,
+                                    FAR struct iob_s *iob,
+                                    unsigned int offset)
+{
+  size_t total = 0;
+  int ncopy;
+
+  while (inet_recvfrom_nextseg(pstate) > 0)
+    {
+      ncopy = iob_copyout(pstate->ir_buffer, iob, pstate->ir_seglen, offset);
+      if (ncopy <= 0)
+        {
+          break;
+        }
+
+      pstate->ir_buffer += ncopy;
+      pstate->ir_seglen -= ncopy;
+      offset            += ncopy;
+      total             += ncopy;
+    }
+
+  return total;
+}
+#endif
+
 /****************************************************************************
  * Name: inet_recvfrom_newdata
  *
@@ -180,7 +293,7 @@ static size_t inet_recvfrom_newdata(FAR struct net_driver_s *dev,
 
   /* Copy the new appdata into the user buffer */
 
-  memcpy(pstate->ir_buffer, dev->d_appdata, recvlen);
+  inet_recvfrom_copy(pstate, dev->d_appdata, recvlen);
   ninfo("Received %d bytes (of %d)\n", (int)recvlen, (int)dev->d_len);
 
   /* Update the accumulated size of the data read */
@@ -332,7 +445,7 @@ static inline void inet_tcp_readahead(struct inet_recvfrom_s *pstate)
        * the user buffer.
        */
 
-      recvlen = iob_copyout(pstate->ir_buffer, iob, pstate->ir_buflen, 0);
+      recvlen = inet_recvfrom_iobcopy(pstate, iob, 0);
       ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
       /* Update the accumulated size of the data read */
@@ -430,15 +543,14 @@ static inline void inet_udp_readahead(struct inet_recvfrom_s *pstate)
 
       if (pstate->ir_buflen > 0)
         {
-          recvlen = iob_copyout(pstate->ir_buffer, iob, pstate->ir_buflen,
-                                src_addr_size + sizeof(uint8_t));
+          recvlen = inet_recvfrom_iobcopy(pstate, iob,
+                                          src_addr_size + sizeof(uint8_t));
 
           ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
           /* Update the accumulated size of the data read */
 
           pstate->ir_recvlen  = recvlen;
-          pstate->ir_buffer  += recvlen;
           pstate->ir_buflen  -= recvlen;
         }
       else
@@ -1072,8 +1184,8 @@ static uint16_t inet_udp_eventhandler(FAR struct net_driver_s *dev,
  *
  * Input Parameters:
  *   psock    Pointer to the socket structure for the socket
- *   buf      Buffer to receive data
- *   len      Length of buffer
+ *   iov      Buffers to receive data
+ *   iovcnt   Number of buffers
  *   pstate   A pointer to the state structure to be initialized
  *
  * Returned Value:
@@ -1084,11 +1196,14 @@ static uint16_t inet_udp_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #if defined(NET_UDP_HAVE_STACK) || defined(NET_TCP_HAVE_STACK)
-static void inet_recvfrom_initialize(FAR struct socket *psock, FAR void *buf,
-                                     size_t len, FAR struct sockaddr *infrom,
+static void inet_recvfrom_initialize(FAR struct socket *psock,
+                                     FAR const struct iovec *iov, int iovcnt,
+                                     FAR struct sockaddr *infrom,
                                      FAR socklen_t *fromlen,
                                      FAR struct inet_recvfrom_s *pstate)
 {
+  int i;
+
   /* Initialize the state structure. */
 
   memset(pstate, 0, sizeof(struct inet_recvfrom_s));
@@ -1100,8 +1215,13 @@ static void inet_recvfrom_initialize(FAR struct socket *psock, FAR void *buf,
   (void)nxsem_init(&pstate->ir_sem, 0, 0); /* Doesn't really fail */
   (void)nxsem_setprotocol(&pstate->ir_sem, SEM_PRIO_NONE);
 
-  pstate->ir_buflen    = len;
-  pstate->ir_buffer    = buf;
+  for (i = 0; i < iovcnt; i++)
+    {
+      pstate->ir_buflen += iov[i].iov_len;
+    }
+
+  pstate->ir_iov       = iov;
+  pstate->ir_iovcnt    = iovcnt;
   pstate->ir_from      = infrom;
   pstate->ir_fromlen   = fromlen;
 
@@ -1175,8 +1295,9 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  *
  * Input Parameters:
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
- *   buf    Buffer to receive data
- *   len    Length of buffer
+ *   iov    Buffers to receive data
+ *   iovcnt Number of buffers
+ *   flags  Receive flags
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1188,8 +1309,10 @@ static ssize_t inet_recvfrom_result(int result, struct inet_recvfrom_s *pstate)
  ****************************************************************************/
 
 #ifdef NET_UDP_HAVE_STACK
-static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+static ssize_t inet_udp_recvfrom(FAR struct socket *psock,
+                                 FAR const struct iovec *iov, int iovcnt,
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1203,7 +1326,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
    */
 
   net_lock();
-  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+  inet_recvfrom_initialize(psock, iov, iovcnt, from, fromlen, &state);
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Copy the read-ahead data from the packet */
@@ -1229,7 +1352,7 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Handle non-blocking UDP sockets */
 
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1303,8 +1426,9 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  *
  * Input Parameters:
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
- *   buf    Buffer to receive data
- *   len    Length of buffer
+ *   iov    Buffers to receive data
+ *   iovcnt Number of buffers
+ *   flags  Receive flags
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1316,8 +1440,10 @@ static ssize_t inet_udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  ****************************************************************************/
 
 #ifdef NET_TCP_HAVE_STACK
-static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                                 FAR struct sockaddr *from, FAR socklen_t *fromlen)
+static ssize_t inet_tcp_recvfrom(FAR struct socket *psock,
+                                 FAR const struct iovec *iov, int iovcnt,
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   struct inet_recvfrom_s state;
   int               ret;
@@ -1327,7 +1453,7 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
    */
 
   net_lock();
-  inet_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
+  inet_recvfrom_initialize(psock, iov, iovcnt, from, fromlen, &state);
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
@@ -1391,7 +1517,7 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 
   else
 #ifdef CONFIG_NET_TCP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1469,17 +1595,11 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
 #endif /* NET_TCP_HAVE_STACK */
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: inet_recvfrom
+ * Name: inet_recvfrom_iov
  *
  * Description:
- *   Implements the socket recvfrom interface for the case of the AF_INET
- *   and AF_INET6 address families.  inet_recvfrom() receives messages from
- *   a socket, and may be used to receive data on a socket whether or not it
- *   is connection-oriented.
+ *   Common logic of inet_recvfrom() and inet_recvmsg().  The received data
+ *   is scattered across all of the buffers in the I/O vector.
  *
  *   If 'from' is not NULL, and the underlying protocol provides the source
  *   address, this source address is filled in.  The argument 'fromlen' is
@@ -1489,8 +1609,8 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Buffer to receive data
- *   len      Length of buffer
+ *   iov      Buffers to receive data
+ *   iovcnt   Number of buffers
  *   flags    Receive flags
  *   from     Address of source (may be NULL)
  *   fromlen  The length of the address structure
@@ -1503,9 +1623,10 @@ static ssize_t inet_tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t
  *
  ****************************************************************************/
 
-ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                      int flags, FAR struct sockaddr *from,
-                      FAR socklen_t *fromlen)
+static ssize_t inet_recvfrom_iov(FAR struct socket *psock,
+                                 FAR const struct iovec *iov, int iovcnt,
+                                 int flags, FAR struct sockaddr *from,
+                                 FAR socklen_t *fromlen)
 {
   ssize_t ret;
 
@@ -1557,7 +1678,8 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_STREAM:
       {
 #ifdef NET_TCP_HAVE_STACK
-        ret = inet_tcp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_tcp_recvfrom(psock, iov, iovcnt, flags, from,
+                                fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -1569,7 +1691,8 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
     case SOCK_DGRAM:
       {
 #ifdef NET_UDP_HAVE_STACK
-        ret = inet_udp_recvfrom(psock, buf, len, from, fromlen);
+        ret = inet_udp_recvfrom(psock, iov, iovcnt, flags, from,
+                                fromlen);
 #else
         ret = -ENOSYS;
 #endif
@@ -1588,4 +1711,97 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_recvfrom
+ *
+ * Description:
+ *   Implements the socket recvfrom interface for the case of the AF_INET
+ *   and AF_INET6 address families.  inet_recvfrom() receives messages from
+ *   a socket, and may be used to receive data on a socket whether or not it
+ *   is connection-oriented.
+ *
+ *   If 'from' is not NULL, and the underlying protocol provides the source
+ *   address, this source address is filled in.  The argument 'fromlen' is
+ *   initialized to the size of the buffer associated with from, and
+ *   modified on return to indicate the actual size of the address stored
+ *   there.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   recv() will return 0.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvfrom() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen)
+{
+  struct iovec iov;
+
+  iov.iov_base = buf;
+  iov.iov_len  = len;
+
+  return inet_recvfrom_iov(psock, &iov, 1, flags, from, fromlen);
+}
+
+/****************************************************************************
+ * Name: inet_recvmsg
+ *
+ * Description:
+ *   Implements the socket recvmsg interface for the case of the AF_INET
+ *   and AF_INET6 address families.  One message is received and scattered
+ *   across the buffers in msg->msg_iov.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message and, optionally, its source
+ *            address
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   zero is returned.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvfrom() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t inet_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                     int flags)
+{
+  FAR struct sockaddr *from = (FAR struct sockaddr *)msg->msg_name;
+  socklen_t fromlen = msg->msg_namelen;
+  ssize_t ret;
+
+  ret = inet_recvfrom_iov(psock, msg->msg_iov, msg->msg_iovlen, flags,
+                          from, from != NULL ? &fromlen : NULL);
+  if (ret >= 0)
+    {
+      if (from != NULL)
+        {
+          msg->msg_namelen = fromlen;
+        }
+
+      /* Ancillary data is not supported */
+
+      msg->msg_controllen = 0;
+    }
+
+  return ret;
+}
+
 #endif /* CONFIG_NET */
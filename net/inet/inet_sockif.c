@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
@@ -92,6 +93,8 @@ static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendfile(FAR struct socket *psock, FAR struct file *infile,
                     FAR off_t *offset, size_t count);
 #endif
+static ssize_t    inet_sendmsg(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
 
 /****************************************************************************
  * Private Data
@@ -117,6 +120,8 @@ static const struct sock_intf_s g_inet_sockif =
   inet_sendfile,    /* si_sendfile */
 #endif
   inet_recvfrom,    /* si_recvfrom */
+  inet_sendmsg,     /* si_sendmsg */
+  inet_recvmsg,     /* si_recvmsg */
   inet_close        /* si_close */
 };
 
@@ -1165,35 +1170,25 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 }
 
 /****************************************************************************
- * Name: inet_sendto
+ * Name: inet_addrlen
  *
  * Description:
- *   Implements the sendto() operation for the case of the AF_INET and
- *   AF_INET6 sockets.
+ *   Verify that a destination address belongs to a supported address
+ *   family and is large enough.
  *
  * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error, a negated
- *   errno value is returned (see send_to() for the list of appropriate error
- *   values.
+ *   The minimum length of an address of that family on success; a negated
+ *   errno value on failure.
  *
  ****************************************************************************/
 
-static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags, FAR const struct sockaddr *to,
-                           socklen_t tolen)
+static int inet_addrlen(FAR const struct sockaddr *to, socklen_t tolen)
 {
   socklen_t minlen;
-  ssize_t nsent;
-
-  /* Verify that a valid address has been provided */
 
   switch (to->sa_family)
     {
@@ -1220,6 +1215,48 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+  return minlen;
+}
+
+/****************************************************************************
+ * Name: inet_sendto
+ *
+ * Description:
+ *   Implements the sendto() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
+                           size_t len, int flags, FAR const struct sockaddr *to,
+                           socklen_t tolen)
+{
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_6LOWPAN)
+  socklen_t minlen;
+#endif
+  ssize_t nsent;
+
+  /* Verify that a valid address has been provided */
+
+  nsent = inet_addrlen(to, tolen);
+  if (nsent < 0)
+    {
+      return nsent;
+    }
+
 #ifdef CONFIG_NET_UDP
   /* If this is a connected socket, then return EISCONN */
 
@@ -1234,7 +1271,8 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
 #if defined(CONFIG_NET_6LOWPAN)
   /* Try 6LoWPAN UDP packet sendto() */
 
-  nsent = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, minlen);
+  minlen = (socklen_t)nsent;
+  nsent  = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, minlen);
 
 #ifdef NET_UDP_HAVE_STACK
   if (nsent < 0)
@@ -1294,6 +1332,111 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
 }
 #endif
 
+/****************************************************************************
+ * Name: inet_sendmsg
+ *
+ * Description:
+ *   Implements the sendmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  The data in all of the buffers is sent as one
+ *   message.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.  -ENOSYS is returned if the message must instead be sent
+ *   through sendto().
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                            int flags)
+{
+  FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+  socklen_t tolen = msg->msg_namelen;
+  ssize_t nsent = -ENOSYS;
+
+  if (to == NULL || tolen <= 0)
+    {
+      to    = NULL;
+      tolen = 0;
+    }
+
+  switch (psock->s_type)
+    {
+#ifdef CONFIG_NET_TCP
+      case SOCK_STREAM:
+        {
+          FAR const struct iovec *iov = msg->msg_iov;
+          unsigned long i;
+          ssize_t ret;
+
+          /* Queue each buffer in turn.  The network stays locked so that
+           * data sent by other threads cannot be interleaved (unless we
+           * have to wait for buffer space).
+           */
+
+          net_lock();
+          for (i = 0, nsent = 0; i < msg->msg_iovlen; i++)
+            {
+              if (iov[i].iov_len == 0)
+                {
+                  continue;
+                }
+
+              ret = inet_send(psock, iov[i].iov_base, iov[i].iov_len, flags);
+              if (ret < 0)
+                {
+                  nsent = nsent > 0 ? nsent : ret;
+                  break;
+                }
+
+              nsent += ret;
+              if (ret < iov[i].iov_len)
+                {
+                  break;
+                }
+            }
+
+          net_unlock();
+        }
+        break;
+#endif /* CONFIG_NET_TCP */
+
+#if defined(NET_UDP_HAVE_STACK) && !defined(CONFIG_NET_6LOWPAN)
+      case SOCK_DGRAM:
+        {
+          /* Gather the buffers directly into one UDP datagram.  6LoWPAN
+           * does not support this, so with 6LoWPAN the message is sent
+           * through sendto() instead.
+           */
+
+          if (to != NULL)
+            {
+              nsent = inet_addrlen(to, tolen);
+              if (nsent < 0)
+                {
+                  break;
+                }
+            }
+
+          nsent = psock_udp_sendmsg(psock, msg->msg_iov, msg->msg_iovlen,
+                                    flags, to, tolen);
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  return nsent;
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
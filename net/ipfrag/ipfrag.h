@@ -0,0 +1,392 @@
+/****************************************************************************
+ * net/ipfrag/ipfrag.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_IPFRAG_IPFRAG_H
+#define __NET_IPFRAG_IPFRAG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The unfragmentable part of a datagram that is saved for reassembly and
+ * the size of the addresses that identify it.
+ */
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFRAG_HDRLEN   40  /* IPv6_HDRLEN */
+#  define IPFRAG_ADDRLEN  16  /* sizeof(net_ipv6addr_t) */
+#else
+#  define IPFRAG_HDRLEN   20  /* IPv4_HDRLEN */
+#  define IPFRAG_ADDRLEN  4   /* sizeof(in_addr_t) */
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct iob_s;  /* Forward reference */
+
+/* One fragment of a datagram being reassembled */
+
+struct ipfrag_frag_s
+{
+  FAR struct iob_s *ff_iob;            /* Fragment payload */
+  uint16_t ff_offset;                  /* Payload offset in the datagram */
+};
+
+/* A datagram being reassembled.  Datagrams are identified by the source
+ * and destination addresses, the protocol and the IP identification field.
+ */
+
+struct ipfrag_reass_s
+{
+  uint8_t  fr_domain;                  /* PF_INET or PF_INET6; 0 if free */
+  uint8_t  fr_proto;                   /* Upper layer protocol */
+  uint8_t  fr_nfrags;                  /* Number of fragments held */
+  bool     fr_last;                    /* The final fragment was received */
+  uint16_t fr_ttl;                     /* Remaining life (half seconds) */
+  uint16_t fr_datalen;                 /* Total payload size if fr_last */
+  uint32_t fr_id;                      /* IP identification */
+  uint8_t  fr_addr[2 * IPFRAG_ADDRLEN]; /* Source then destination address */
+  uint8_t  fr_hdr[IPFRAG_HDRLEN];      /* IP header */
+  struct ipfrag_frag_s fr_frags[CONFIG_NET_IPFRAG_MAXFRAGS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ipfrag_find
+ *
+ * Description:
+ *   Find the reassembly entry for a datagram, allocating a new one if this
+ *   is the first fragment seen.  When all entries are in use, the entry
+ *   closest to its timeout is recycled.  A new entry has fr_nfrags == 0.
+ *
+ * Input Parameters:
+ *   domain  - PF_INET or PF_INET6
+ *   proto   - The upper layer protocol
+ *   id      - The IP identification of the datagram
+ *   addr    - The source address followed by the destination address
+ *   addrlen - The size of one address
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipfrag_reass_s *ipfrag_find(uint8_t domain, uint8_t proto,
+                                       uint32_t id, FAR const void *addr,
+                                       unsigned int addrlen);
+
+/****************************************************************************
+ * Name: ipfrag_insert
+ *
+ * Description:
+ *   Add the payload of one fragment to a datagram being reassembled.
+ *   Duplicate fragments are ignored.  Overlapping fragments, fragments
+ *   beyond the end of the datagram and fragments that cannot be buffered
+ *   cause the whole datagram to be discarded.
+ *
+ * Input Parameters:
+ *   fr     - The reassembly entry returned by ipfrag_find()
+ *   data   - The fragment payload
+ *   len    - The size of the fragment payload
+ *   offset - The offset of the payload in the datagram
+ *   last   - True if this is the final fragment
+ *
+ * Returned Value:
+ *   A positive value if the datagram is now complete, zero if more
+ *   fragments are expected, or a negated errno value if the datagram was
+ *   discarded.
+ *
+ ****************************************************************************/
+
+int ipfrag_insert(FAR struct ipfrag_reass_s *fr, FAR const uint8_t *data,
+                  unsigned int len, unsigned int offset, bool last);
+
+/****************************************************************************
+ * Name: ipfrag_free
+ *
+ * Description:
+ *   Release a reassembly entry and all of the fragments that it holds.
+ *
+ ****************************************************************************/
+
+void ipfrag_free(FAR struct ipfrag_reass_s *fr);
+
+/****************************************************************************
+ * Name: ipfrag_deliver
+ *
+ * Description:
+ *   Copy a completely reassembled datagram into the device packet buffer,
+ *   switching to the large fragmentation buffer if it will not fit, and
+ *   release the reassembly entry.  On return d_len holds the size of the
+ *   datagram including the link layer header, as ipv4_input() and
+ *   ipv6_input() expect.  The caller must call ipfrag_txfinish() after the
+ *   datagram has been processed.
+ *
+ * Input Parameters:
+ *   dev    - The device that received the final fragment
+ *   fr     - The complete reassembly entry
+ *   hdrlen - The size of the IP header saved in fr_hdr
+ *
+ * Returned Value:
+ *   The address of the IP header in the device buffer or NULL if the
+ *   datagram could not be delivered.  The entry is released in any case.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *ipfrag_deliver(FAR struct net_driver_s *dev,
+                            FAR struct ipfrag_reass_s *fr,
+                            unsigned int hdrlen);
+
+/****************************************************************************
+ * Name: ipfrag_timer
+ *
+ * Description:
+ *   Age the datagrams being reassembled and the queued outgoing fragments,
+ *   discarding those that have expired.
+ *
+ * Input Parameters:
+ *   hsec - The elapsed time in half seconds
+ *
+ * Assumptions:
+ *   Called from devif_timer() with the network locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_timer(int hsec);
+
+/****************************************************************************
+ * Name: ipfrag_txsetup
+ *
+ * Description:
+ *   Prepare to send a datagram that may be larger than the MTU of the
+ *   device.  If the packet will not fit in d_buf, the device is switched
+ *   to the large fragmentation buffer and d_appdata is adjusted so that
+ *   the payload can be copied in as usual.  ipfrag_txfinish() must be
+ *   called once the IP header has been built.
+ *
+ * Input Parameters:
+ *   dev - The device that will send the datagram
+ *   len - The size of the payload that will be copied to d_appdata
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EMSGSIZE if the datagram is larger than
+ *   CONFIG_NET_IPFRAG_MAXSIZE, or -EBUSY if the large buffer is in use.
+ *
+ ****************************************************************************/
+
+int ipfrag_txsetup(FAR struct net_driver_s *dev, unsigned int len);
+
+/****************************************************************************
+ * Name: ipfrag_txfinish
+ *
+ * Description:
+ *   Restore the device packet buffer after ipfrag_txsetup() or
+ *   ipfrag_deliver().  If the outgoing packet is larger than the MTU, it
+ *   is fragmented:  the first fragment is left in d_buf and the remaining
+ *   fragments are queued for ipfrag_txpoll().  Nothing is done if the
+ *   device buffer was not switched.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfrag_txfinish(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: ipfrag_txavail
+ *
+ * Description:
+ *   Return the number of free entries in the outgoing fragment queue.
+ *
+ ****************************************************************************/
+
+unsigned int ipfrag_txavail(void);
+
+/****************************************************************************
+ * Name: ipfrag_txenqueue
+ *
+ * Description:
+ *   Queue one outgoing fragment.  The caller must have checked that there
+ *   is room with ipfrag_txavail().
+ *
+ * Input Parameters:
+ *   dev - The device that will send the fragment
+ *   iob - The complete IP packet
+ *
+ ****************************************************************************/
+
+void ipfrag_txenqueue(FAR struct net_driver_s *dev, FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: ipfrag_txdiscard
+ *
+ * Description:
+ *   Remove the most recently queued fragments.  This is used to back out
+ *   a datagram that could only be partly queued.
+ *
+ ****************************************************************************/
+
+void ipfrag_txdiscard(unsigned int nfrags);
+
+/****************************************************************************
+ * Name: ipfrag_txpoll
+ *
+ * Description:
+ *   Send the queued fragments for this device.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and devif_timer().  The network must be locked.
+ *
+ ****************************************************************************/
+
+int ipfrag_txpoll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback);
+
+/****************************************************************************
+ * Name: ipfrag_txtimer
+ *
+ * Description:
+ *   Discard queued fragments that their device has not sent in time.
+ *
+ ****************************************************************************/
+
+void ipfrag_txtimer(int hsec);
+
+/****************************************************************************
+ * Name: ipv4_reassemble
+ *
+ * Description:
+ *   Handle a received IPv4 fragment.  ipv4_input() has already removed the
+ *   link layer header from d_len.  When the fragment completes a datagram,
+ *   the datagram is passed back through ipv4_input().
+ *
+ * Returned Value:
+ *   OK.  d_len is non-zero if there is a response to send.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipv4_reassemble(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_fragment
+ *
+ * Description:
+ *   Split the d_len byte IPv4 datagram at ipbuf into fragments that fit the
+ *   MTU of the device.  The first fragment is placed in d_buf;  the rest
+ *   are queued.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value if the datagram could
+ *   not be fragmented.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int ipv4_fragment(FAR struct net_driver_s *dev, FAR const uint8_t *ipbuf);
+#endif
+
+/****************************************************************************
+ * Name: ipv6_reassemble
+ *
+ * Description:
+ *   Handle a received IPv6 packet whose base header is followed by a
+ *   Fragment header.  ipv6_input() has already removed the link layer
+ *   header from d_len.  When the fragment completes a datagram, the
+ *   datagram is passed back through ipv6_input().
+ *
+ * Returned Value:
+ *   OK.  d_len is non-zero if there is a response to send.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_reassemble(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: ipv6_fragment
+ *
+ * Description:
+ *   Split the d_len byte IPv6 datagram at ipbuf into fragments that fit the
+ *   MTU of the device, inserting a Fragment header after the IPv6 header.
+ *   The first fragment is placed in d_buf;  the rest are queued.
+ *
+ * Returned Value:
+ *   Zero (OK) on success or a negated errno value if the datagram could
+ *   not be fragmented.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int ipv6_fragment(FAR struct net_driver_s *dev, FAR const uint8_t *ipbuf);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_IPFRAG */
+#endif /* __NET_IPFRAG_IPFRAG_H */
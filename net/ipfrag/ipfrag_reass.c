@@ -0,0 +1,311 @@
+/****************************************************************************
+ * net/ipfrag/ipfrag_reass.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipfrag/ipfrag.h"
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Reassembly timeout in units of half seconds */
+
+#define IPFRAG_REASS_TTL (2 * CONFIG_NET_IPFRAG_MAXAGE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The datagrams that are being reassembled */
+
+static struct ipfrag_reass_s g_ipfrag_reass[CONFIG_NET_IPFRAG_NREASS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfrag_free
+ *
+ * Description:
+ *   Release a reassembly entry and all of the fragments that it holds.
+ *
+ ****************************************************************************/
+
+void ipfrag_free(FAR struct ipfrag_reass_s *fr)
+{
+  while (fr->fr_nfrags > 0)
+    {
+      iob_free_chain(fr->fr_frags[--fr->fr_nfrags].ff_iob);
+    }
+
+  fr->fr_domain = 0;
+}
+
+/****************************************************************************
+ * Name: ipfrag_find
+ *
+ * Description:
+ *   Find the reassembly entry for a datagram, allocating a new one if this
+ *   is the first fragment seen.
+ *
+ ****************************************************************************/
+
+FAR struct ipfrag_reass_s *ipfrag_find(uint8_t domain, uint8_t proto,
+                                       uint32_t id, FAR const void *addr,
+                                       unsigned int addrlen)
+{
+  FAR struct ipfrag_reass_s *fr;
+  FAR struct ipfrag_reass_s *victim = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFRAG_NREASS; i++)
+    {
+      fr = &g_ipfrag_reass[i];
+      if (fr->fr_domain == 0)
+        {
+          if (victim == NULL || victim->fr_domain != 0)
+            {
+              victim = fr;
+            }
+        }
+      else if (fr->fr_domain == domain && fr->fr_proto == proto &&
+               fr->fr_id == id && memcmp(fr->fr_addr, addr, 2 * addrlen) == 0)
+        {
+          return fr;
+        }
+      else if (victim == NULL ||
+               (victim->fr_domain != 0 && fr->fr_ttl < victim->fr_ttl))
+        {
+          victim = fr;
+        }
+    }
+
+  if (victim->fr_domain != 0)
+    {
+      nwarn("WARNING: Reassembly table full, dropping datagram %lu\n",
+            (unsigned long)victim->fr_id);
+      ipfrag_free(victim);
+    }
+
+  victim->fr_domain  = domain;
+  victim->fr_proto   = proto;
+  victim->fr_last    = false;
+  victim->fr_ttl     = IPFRAG_REASS_TTL;
+  victim->fr_datalen = 0;
+  victim->fr_id      = id;
+  memcpy(victim->fr_addr, addr, 2 * addrlen);
+  return victim;
+}
+
+/****************************************************************************
+ * Name: ipfrag_insert
+ *
+ * Description:
+ *   Add the payload of one fragment to a datagram being reassembled.
+ *
+ ****************************************************************************/
+
+int ipfrag_insert(FAR struct ipfrag_reass_s *fr, FAR const uint8_t *data,
+                  unsigned int len, unsigned int offset, bool last)
+{
+  FAR struct ipfrag_frag_s *ff;
+  FAR struct iob_s *iob;
+  unsigned int expected;
+  unsigned int end = offset + len;
+  int ret;
+  int i;
+
+  /* Check the fragment against the datagram size, if known */
+
+  if (last)
+    {
+      if (fr->fr_last ? end != fr->fr_datalen :
+          (fr->fr_nfrags > 0 &&
+           end < fr->fr_frags[fr->fr_nfrags - 1].ff_offset +
+                 fr->fr_frags[fr->fr_nfrags - 1].ff_iob->io_pktlen))
+        {
+          goto errout_inval;
+        }
+    }
+  else if (fr->fr_last && end >= fr->fr_datalen)
+    {
+      goto errout_inval;
+    }
+
+  /* Find the insertion point.  Fragments are kept sorted by offset. */
+
+  for (i = 0; i < fr->fr_nfrags; i++)
+    {
+      if (fr->fr_frags[i].ff_offset >= offset)
+        {
+          break;
+        }
+    }
+
+  /* Ignore exact duplicates; discard the datagram on any other overlap */
+
+  if (i < fr->fr_nfrags && fr->fr_frags[i].ff_offset == offset &&
+      fr->fr_frags[i].ff_iob->io_pktlen == len)
+    {
+      return 0;
+    }
+
+  if ((i < fr->fr_nfrags && end > fr->fr_frags[i].ff_offset) ||
+      (i > 0 && fr->fr_frags[i - 1].ff_offset +
+                fr->fr_frags[i - 1].ff_iob->io_pktlen > offset))
+    {
+      goto errout_inval;
+    }
+
+  if (fr->fr_nfrags >= CONFIG_NET_IPFRAG_MAXFRAGS)
+    {
+      nwarn("WARNING: Too many fragments\n");
+      ret = -E2BIG;
+      goto errout;
+    }
+
+  /* Copy the payload into an I/O buffer chain */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = iob_trycopyin(iob, data, len, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      goto errout;
+    }
+
+  ff = &fr->fr_frags[i];
+  memmove(ff + 1, ff, (fr->fr_nfrags - i) * sizeof(struct ipfrag_frag_s));
+  ff->ff_iob    = iob;
+  ff->ff_offset = offset;
+  fr->fr_nfrags++;
+
+  if (last)
+    {
+      fr->fr_last    = true;
+      fr->fr_datalen = end;
+    }
+
+  /* The datagram is complete when the final fragment has been received
+   * and there are no holes.
+   */
+
+  if (!fr->fr_last)
+    {
+      return 0;
+    }
+
+  expected = 0;
+  for (i = 0; i < fr->fr_nfrags; i++)
+    {
+      if (fr->fr_frags[i].ff_offset != expected)
+        {
+          return 0;
+        }
+
+      expected += fr->fr_frags[i].ff_iob->io_pktlen;
+    }
+
+  return 1;
+
+errout_inval:
+  nwarn("WARNING: Bad fragment offset=%u len=%u\n", offset, len);
+  ret = -EINVAL;
+
+errout:
+  ipfrag_free(fr);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfrag_timer
+ *
+ * Description:
+ *   Age the datagrams being reassembled and the queued outgoing fragments,
+ *   discarding those that have expired.
+ *
+ ****************************************************************************/
+
+void ipfrag_timer(int hsec)
+{
+  FAR struct ipfrag_reass_s *fr;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFRAG_NREASS; i++)
+    {
+      fr = &g_ipfrag_reass[i];
+      if (fr->fr_domain != 0)
+        {
+          if (fr->fr_ttl <= hsec)
+            {
+              ninfo("Reassembly of datagram %lu timed out\n",
+                    (unsigned long)fr->fr_id);
+              ipfrag_free(fr);
+            }
+          else
+            {
+              fr->fr_ttl -= hsec;
+            }
+        }
+    }
+
+  ipfrag_txtimer(hsec);
+}
+
+#endif /* CONFIG_NET_IPFRAG */
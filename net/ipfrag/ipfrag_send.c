@@ -0,0 +1,472 @@
+/****************************************************************************
+ * net/ipfrag/ipfrag_send.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ethernet.h>
+
+#include "netdev/netdev.h"
+#include "ipfrag/ipfrag.h"
+
+#ifdef CONFIG_NET_IPFRAG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room reserved for the link layer header in the large buffer */
+
+#ifdef CONFIG_NET_ETHERNET
+#  define IPFRAG_LLHDRLEN  ETH_HDRLEN
+#else
+#  define IPFRAG_LLHDRLEN  0
+#endif
+
+#define IPFRAG_BUFSIZE \
+  (IPFRAG_LLHDRLEN + CONFIG_NET_IPFRAG_MAXSIZE + CONFIG_NET_GUARDSIZE)
+
+/* Queued fragments are discarded after two seconds */
+
+#define IPFRAG_TX_TTL      4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ipfrag_txentry_s
+{
+  FAR struct net_driver_s *te_dev;     /* The device that will send it */
+  FAR struct iob_s *te_iob;            /* The fragment */
+  uint8_t te_ttl;                      /* Remaining life (half seconds) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The large packet buffer.  It is declared as uint16_t to get the same
+ * alignment as the device buffers.
+ */
+
+static uint16_t g_ipfrag_buffer[(IPFRAG_BUFSIZE + 1) / 2];
+
+/* The device that is currently using the large buffer and the packet
+ * buffer and size that it had before.
+ */
+
+static FAR struct net_driver_s *g_ipfrag_dev;
+static FAR uint8_t *g_ipfrag_savebuf;
+static uint16_t g_ipfrag_savesize;
+
+/* Outgoing fragments waiting to be sent, in order */
+
+static struct ipfrag_txentry_s g_ipfrag_txq[CONFIG_NET_IPFRAG_TXQSIZE];
+static uint8_t g_ipfrag_txhead;
+static uint8_t g_ipfrag_txcount;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfrag_bufswap
+ *
+ * Description:
+ *   Switch the device to the large packet buffer.  The link layer header
+ *   and any packet data in d_buf are not preserved.
+ *
+ ****************************************************************************/
+
+static int ipfrag_bufswap(FAR struct net_driver_s *dev)
+{
+  if (g_ipfrag_dev == dev)
+    {
+      return OK;
+    }
+
+  if (g_ipfrag_dev != NULL || NET_LL_HDRLEN(dev) > IPFRAG_LLHDRLEN)
+    {
+      return -EBUSY;
+    }
+
+  g_ipfrag_dev      = dev;
+  g_ipfrag_savebuf  = dev->d_buf;
+  g_ipfrag_savesize = dev->d_pktsize;
+
+  dev->d_buf        = (FAR uint8_t *)g_ipfrag_buffer;
+  dev->d_pktsize    = NET_LL_HDRLEN(dev) + CONFIG_NET_IPFRAG_MAXSIZE;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txremove
+ *
+ * Description:
+ *   Remove the fragment at the head of the queue.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *ipfrag_txremove(void)
+{
+  FAR struct iob_s *iob = g_ipfrag_txq[g_ipfrag_txhead].te_iob;
+
+  g_ipfrag_txq[g_ipfrag_txhead].te_iob = NULL;
+  if (++g_ipfrag_txhead >= CONFIG_NET_IPFRAG_TXQSIZE)
+    {
+      g_ipfrag_txhead = 0;
+    }
+
+  g_ipfrag_txcount--;
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfrag_deliver
+ *
+ * Description:
+ *   Copy a completely reassembled datagram into the device packet buffer
+ *   and release the reassembly entry.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *ipfrag_deliver(FAR struct net_driver_s *dev,
+                            FAR struct ipfrag_reass_s *fr,
+                            unsigned int hdrlen)
+{
+  FAR struct ipfrag_frag_s *ff;
+  FAR uint8_t *ipbuf = NULL;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int total = hdrlen + fr->fr_datalen;
+  int i;
+
+  if (total > CONFIG_NET_IPFRAG_MAXSIZE)
+    {
+      nwarn("WARNING: Reassembled datagram too large: %u\n", total);
+      goto errout;
+    }
+
+  if (llhdrlen + total > NETDEV_PKTSIZE(dev) && ipfrag_bufswap(dev) < 0)
+    {
+      nwarn("WARNING: Large buffer not available\n");
+      goto errout;
+    }
+
+  ipbuf = &dev->d_buf[llhdrlen];
+  memcpy(ipbuf, fr->fr_hdr, hdrlen);
+
+  for (i = 0; i < fr->fr_nfrags; i++)
+    {
+      ff = &fr->fr_frags[i];
+      (void)iob_copyout(&ipbuf[hdrlen + ff->ff_offset], ff->ff_iob,
+                        ff->ff_iob->io_pktlen, 0);
+    }
+
+  dev->d_len = llhdrlen + total;
+
+errout:
+  ipfrag_free(fr);
+  return ipbuf;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txsetup
+ *
+ * Description:
+ *   Prepare to send a datagram that may be larger than the MTU of the
+ *   device.
+ *
+ ****************************************************************************/
+
+int ipfrag_txsetup(FAR struct net_driver_s *dev, unsigned int len)
+{
+  FAR uint8_t *oldbuf = dev->d_buf;
+  unsigned int hdrlen = dev->d_appdata - dev->d_buf;
+  int ret;
+
+  if (hdrlen + len <= NETDEV_PKTSIZE(dev))
+    {
+      return OK;
+    }
+
+  if (hdrlen - NET_LL_HDRLEN(dev) + len > CONFIG_NET_IPFRAG_MAXSIZE)
+    {
+      return -EMSGSIZE;
+    }
+
+  ret = ipfrag_bufswap(dev);
+  if (ret >= 0)
+    {
+      dev->d_appdata = dev->d_buf + (dev->d_appdata - oldbuf);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txfinish
+ *
+ * Description:
+ *   Restore the device packet buffer and fragment the outgoing packet if
+ *   it is larger than the MTU.
+ *
+ ****************************************************************************/
+
+void ipfrag_txfinish(FAR struct net_driver_s *dev)
+{
+  FAR const uint8_t *ipbuf;
+  unsigned int llhdrlen;
+  int ret = -EAFNOSUPPORT;
+
+  if (g_ipfrag_dev != dev)
+    {
+      return;
+    }
+
+  llhdrlen       = NET_LL_HDRLEN(dev);
+  ipbuf          = &dev->d_buf[llhdrlen];
+
+  dev->d_buf     = g_ipfrag_savebuf;
+  dev->d_pktsize = g_ipfrag_savesize;
+  g_ipfrag_dev   = NULL;
+
+  if (dev->d_len == 0)
+    {
+      return;
+    }
+
+  /* Copy the packet back if it turned out to fit */
+
+  if (llhdrlen + dev->d_len <= NETDEV_PKTSIZE(dev))
+    {
+      memcpy(&dev->d_buf[llhdrlen], ipbuf, dev->d_len);
+      return;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ipbuf[0] & 0xf0) == IPv4_VERSION)
+    {
+      ret = ipv4_fragment(dev, ipbuf);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ipbuf[0] & 0xf0) == IPv6_VERSION)
+    {
+      ret = ipv6_fragment(dev, ipbuf);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      nwarn("WARNING: Failed to fragment %u byte datagram: %d\n",
+            dev->d_len, ret);
+      dev->d_len = 0;
+    }
+  else
+    {
+      /* Make sure that the device comes back for the other fragments */
+
+      netdev_txnotify_dev(dev);
+    }
+}
+
+/****************************************************************************
+ * Name: ipfrag_txavail
+ *
+ * Description:
+ *   Return the number of free entries in the outgoing fragment queue.
+ *
+ ****************************************************************************/
+
+unsigned int ipfrag_txavail(void)
+{
+  return CONFIG_NET_IPFRAG_TXQSIZE - g_ipfrag_txcount;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txenqueue
+ *
+ * Description:
+ *   Queue one outgoing fragment.
+ *
+ ****************************************************************************/
+
+void ipfrag_txenqueue(FAR struct net_driver_s *dev, FAR struct iob_s *iob)
+{
+  FAR struct ipfrag_txentry_s *te;
+  unsigned int ndx;
+
+  DEBUGASSERT(g_ipfrag_txcount < CONFIG_NET_IPFRAG_TXQSIZE);
+
+  ndx = g_ipfrag_txhead + g_ipfrag_txcount;
+  if (ndx >= CONFIG_NET_IPFRAG_TXQSIZE)
+    {
+      ndx -= CONFIG_NET_IPFRAG_TXQSIZE;
+    }
+
+  te         = &g_ipfrag_txq[ndx];
+  te->te_dev = dev;
+  te->te_iob = iob;
+  te->te_ttl = IPFRAG_TX_TTL;
+  g_ipfrag_txcount++;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txdiscard
+ *
+ * Description:
+ *   Remove the most recently queued fragments.
+ *
+ ****************************************************************************/
+
+void ipfrag_txdiscard(unsigned int nfrags)
+{
+  unsigned int ndx;
+
+  DEBUGASSERT(nfrags <= g_ipfrag_txcount);
+
+  while (nfrags-- > 0)
+    {
+      ndx = g_ipfrag_txhead + --g_ipfrag_txcount;
+      if (ndx >= CONFIG_NET_IPFRAG_TXQSIZE)
+        {
+          ndx -= CONFIG_NET_IPFRAG_TXQSIZE;
+        }
+
+      iob_free_chain(g_ipfrag_txq[ndx].te_iob);
+      g_ipfrag_txq[ndx].te_iob = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfrag_txpoll
+ *
+ * Description:
+ *   Send the queued fragments for this device.  The queue is strictly FIFO
+ *   so that the fragments of a datagram leave in order;  fragments queued
+ *   for another device hold up the queue until that device is polled.
+ *
+ ****************************************************************************/
+
+int ipfrag_txpoll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback)
+{
+  FAR struct iob_s *iob;
+
+  while (g_ipfrag_txcount > 0 && g_ipfrag_txq[g_ipfrag_txhead].te_dev == dev)
+    {
+      iob = ipfrag_txremove();
+
+      dev->d_len    = iob->io_pktlen;
+      dev->d_sndlen = 0;
+      (void)iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)], iob,
+                        iob->io_pktlen, 0);
+
+      if ((dev->d_buf[NET_LL_HDRLEN(dev)] & 0xf0) == IPv6_VERSION)
+        {
+          IFF_SET_IPv6(dev->d_flags);
+        }
+      else
+        {
+          IFF_SET_IPv4(dev->d_flags);
+        }
+
+      iob_free_chain(iob);
+
+      if (callback(dev))
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ipfrag_txtimer
+ *
+ * Description:
+ *   Discard queued fragments that their device has not sent in time.
+ *
+ ****************************************************************************/
+
+void ipfrag_txtimer(int hsec)
+{
+  FAR struct ipfrag_txentry_s *te;
+  unsigned int ndx = g_ipfrag_txhead;
+  int i;
+
+  for (i = 0; i < g_ipfrag_txcount; i++)
+    {
+      te         = &g_ipfrag_txq[ndx];
+      te->te_ttl = te->te_ttl > hsec ? te->te_ttl - hsec : 0;
+
+      if (++ndx >= CONFIG_NET_IPFRAG_TXQSIZE)
+        {
+          ndx = 0;
+        }
+    }
+
+  /* The oldest fragments are at the head of the queue */
+
+  while (g_ipfrag_txcount > 0 && g_ipfrag_txq[g_ipfrag_txhead].te_ttl == 0)
+    {
+      nwarn("WARNING: Discarding unsent fragment\n");
+      iob_free_chain(ipfrag_txremove());
+    }
+}
+
+#endif /* CONFIG_NET_IPFRAG */
@@ -0,0 +1,300 @@
+/****************************************************************************
+ * net/ipfrag/ipv4_frag.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_IPFRAG) && defined(CONFIG_NET_IPv4)
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+
+#include "devif/devif.h"
+#include "ipfrag/ipfrag.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_buildfrag
+ *
+ * Description:
+ *   Build one fragment of the datagram at ipbuf in d_buf.
+ *
+ ****************************************************************************/
+
+static void ipv4_buildfrag(FAR struct net_driver_s *dev,
+                           FAR const uint8_t *ipbuf, unsigned int offset,
+                           unsigned int len, bool more)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  uint16_t total = IPv4_HDRLEN + len;
+  uint16_t fragoff = offset >> 3;
+
+  if (more)
+    {
+      fragoff |= IP_FLAG_MOREFRAGS;
+    }
+
+  memcpy(ipv4, ipbuf, IPv4_HDRLEN);
+  memcpy((FAR uint8_t *)ipv4 + IPv4_HDRLEN, ipbuf + IPv4_HDRLEN + offset,
+         len);
+
+  ipv4->len[0]      = total >> 8;
+  ipv4->len[1]      = total & 0xff;
+  ipv4->ipoffset[0] = fragoff >> 8;
+  ipv4->ipoffset[1] = fragoff & 0xff;
+  ipv4->ipchksum    = 0;
+  ipv4->ipchksum    = ~ipv4_chksum(dev);
+
+  dev->d_len        = total;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_reassemble
+ *
+ * Description:
+ *   Handle a received IPv4 fragment.  When the fragment completes a
+ *   datagram, the datagram is passed back through ipv4_process().
+ *
+ ****************************************************************************/
+
+int ipv4_reassemble(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct ipfrag_reass_s *fr;
+  uint8_t addr[2 * sizeof(in_addr_t)];
+  unsigned int offset;
+  unsigned int len;
+  uint16_t total;
+  uint16_t id;
+  bool last;
+  int ret;
+
+  if (ipv4_chksum(dev) != 0xffff)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.chkerr++;
+#endif
+      nwarn("WARNING: Bad IP checksum\n");
+      goto drop;
+    }
+
+  offset = (((uint16_t)ipv4->ipoffset[0] << 8 | ipv4->ipoffset[1]) &
+            ~(IP_FLAG_RESERVED | IP_FLAG_DONTFRAG | IP_FLAG_MOREFRAGS)) << 3;
+  last   = (ipv4->ipoffset[0] & (IP_FLAG_MOREFRAGS >> 8)) == 0;
+  len    = dev->d_len - IPv4_HDRLEN;
+
+  /* All fragments but the last must hold a multiple of 8 bytes */
+
+  if (len == 0 || (!last && (len & 7) != 0) ||
+      IPv4_HDRLEN + offset + len > CONFIG_NET_IPFRAG_MAXSIZE)
+    {
+      nwarn("WARNING: Bad fragment offset=%u len=%u\n", offset, len);
+      goto fragerr;
+    }
+
+  memcpy(addr, ipv4->srcipaddr, sizeof(in_addr_t));
+  memcpy(&addr[sizeof(in_addr_t)], ipv4->destipaddr, sizeof(in_addr_t));
+  id = (uint16_t)ipv4->ipid[0] << 8 | ipv4->ipid[1];
+
+  fr = ipfrag_find(PF_INET, ipv4->proto, id, addr, sizeof(in_addr_t));
+  if (fr->fr_nfrags == 0 || offset == 0)
+    {
+      memcpy(fr->fr_hdr, ipv4, IPv4_HDRLEN);
+    }
+
+  ret = ipfrag_insert(fr, (FAR uint8_t *)ipv4 + IPv4_HDRLEN, len, offset,
+                      last);
+  if (ret < 0)
+    {
+      goto fragerr;
+    }
+  else if (ret == 0)
+    {
+      /* More fragments are expected */
+
+      dev->d_len = 0;
+      return OK;
+    }
+
+  /* The datagram is complete.  Present it as an unfragmented packet. */
+
+  ipv4 = (FAR struct ipv4_hdr_s *)ipfrag_deliver(dev, fr, IPv4_HDRLEN);
+  if (ipv4 == NULL)
+    {
+      goto fragerr;
+    }
+
+  total             = dev->d_len - NET_LL_HDRLEN(dev);
+  ipv4->len[0]      = total >> 8;
+  ipv4->len[1]      = total & 0xff;
+  ipv4->ipoffset[0] = 0;
+  ipv4->ipoffset[1] = 0;
+  ipv4->ipchksum    = 0;
+  ipv4->ipchksum    = ~ipv4_chksum(dev);
+
+  ninfo("Reassembled %u byte datagram %u\n", total, id);
+
+  /* The reassembled datagram cannot be held for a later retry, so the
+   * result of ipv4_process() is not returned.  Any response is fragmented
+   * as necessary and moved back into d_buf.
+   */
+
+  (void)ipv4_process(dev);
+  ipfrag_txfinish(dev);
+  return OK;
+
+fragerr:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.fragerr++;
+#endif
+
+drop:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.drop++;
+#endif
+  dev->d_len = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipv4_fragment
+ *
+ * Description:
+ *   Split the d_len byte IPv4 datagram at ipbuf into fragments that fit the
+ *   MTU of the device.  The first fragment is placed in d_buf;  the rest
+ *   are queued.
+ *
+ ****************************************************************************/
+
+int ipv4_fragment(FAR struct net_driver_s *dev, FAR const uint8_t *ipbuf)
+{
+  FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ipbuf;
+  FAR struct iob_s *iob;
+  unsigned int datalen = dev->d_len - IPv4_HDRLEN;
+  unsigned int fraglen;
+  unsigned int nqueued = 0;
+  unsigned int offset;
+  unsigned int len;
+  int ret;
+
+  if ((ipv4->ipoffset[0] & (IP_FLAG_DONTFRAG >> 8)) != 0)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Fragment payloads must be a multiple of 8 bytes */
+
+  fraglen = (NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - IPv4_HDRLEN) & ~7;
+  if (fraglen == 0)
+    {
+      return -EMSGSIZE;
+    }
+
+  if ((datalen - 1) / fraglen > ipfrag_txavail())
+    {
+      return -ENOBUFS;
+    }
+
+  /* Queue all but the first fragment, building each one in d_buf */
+
+  for (offset = fraglen; offset < datalen; offset += fraglen)
+    {
+      len = datalen - offset;
+      if (len > fraglen)
+        {
+          len = fraglen;
+        }
+
+      ipv4_buildfrag(dev, ipbuf, offset, len, offset + len < datalen);
+
+      iob = iob_tryalloc(true);
+      if (iob == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)IPv4BUF, dev->d_len, 0,
+                          true);
+      if (ret < 0)
+        {
+          iob_free_chain(iob);
+          goto errout;
+        }
+
+      ipfrag_txenqueue(dev, iob);
+      nqueued++;
+    }
+
+  /* The first fragment is sent from d_buf */
+
+  ipv4_buildfrag(dev, ipbuf, 0, fraglen, true);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.sent += nqueued;
+#endif
+  return OK;
+
+errout:
+  ipfrag_txdiscard(nqueued);
+  return ret;
+}
+
+#endif /* CONFIG_NET_IPFRAG && CONFIG_NET_IPv4 */
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * net/ipfrag/ipv6_frag.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_IPFRAG) && defined(CONFIG_NET_IPv6)
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/ipv6ext.h>
+
+#include "devif/devif.h"
+#include "ipfrag/ipfrag.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv6BUF     ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define FRAGHDR_LEN sizeof(struct ipv6_fragment_extension_s)
+#define FRAG_M      0x01  /* More fragments flag in lsoffset */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Identification for the next fragmented datagram */
+
+static uint32_t g_ipv6_fragid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv6_buildfrag
+ *
+ * Description:
+ *   Build one fragment of the datagram at ipbuf in d_buf.
+ *
+ ****************************************************************************/
+
+static void ipv6_buildfrag(FAR struct net_driver_s *dev,
+                           FAR const uint8_t *ipbuf, unsigned int offset,
+                           unsigned int len, bool more, uint32_t id)
+{
+  FAR const struct ipv6_hdr_s *orig = (FAR const struct ipv6_hdr_s *)ipbuf;
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  FAR struct ipv6_fragment_extension_s *frag;
+  uint16_t paylen = FRAGHDR_LEN + len;
+
+  memcpy(ipv6, ipbuf, IPv6_HDRLEN);
+  ipv6->proto    = NEXT_FRAGMENT_EH;
+  ipv6->len[0]   = paylen >> 8;
+  ipv6->len[1]   = paylen & 0xff;
+
+  frag = (FAR struct ipv6_fragment_extension_s *)
+    ((FAR uint8_t *)ipv6 + IPv6_HDRLEN);
+
+  frag->nxthdr   = orig->proto;
+  frag->reserved = 0;
+  frag->msoffset = offset >> 8;
+  frag->lsoffset = (offset & 0xf8) | (more ? FRAG_M : 0);
+  frag->id[0]    = id >> 24;
+  frag->id[1]    = (id >> 16) & 0xff;
+  frag->id[2]    = (id >> 8) & 0xff;
+  frag->id[3]    = id & 0xff;
+
+  memcpy((FAR uint8_t *)frag + FRAGHDR_LEN, ipbuf + IPv6_HDRLEN + offset,
+         len);
+
+  dev->d_len     = IPv6_HDRLEN + paylen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv6_reassemble
+ *
+ * Description:
+ *   Handle a received IPv6 packet whose base header is followed by a
+ *   Fragment header.  When the fragment completes a datagram, the datagram
+ *   is passed back through ipv6_process().
+ *
+ ****************************************************************************/
+
+int ipv6_reassemble(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  FAR struct ipv6_fragment_extension_s *frag;
+  FAR struct ipfrag_reass_s *fr;
+  uint8_t addr[2 * sizeof(net_ipv6addr_t)];
+  unsigned int offset;
+  unsigned int len;
+  uint16_t paylen;
+  uint32_t id;
+  uint8_t proto;
+  bool last;
+  int ret;
+
+  if (dev->d_len <= IPv6_HDRLEN + FRAGHDR_LEN)
+    {
+      nwarn("WARNING: Packet shorter than fragment header\n");
+      goto drop;
+    }
+
+  frag   = (FAR struct ipv6_fragment_extension_s *)
+    ((FAR uint8_t *)ipv6 + IPv6_HDRLEN);
+
+  offset = ((uint16_t)frag->msoffset << 8 | frag->lsoffset) & 0xfff8;
+  last   = (frag->lsoffset & FRAG_M) == 0;
+  len    = dev->d_len - IPv6_HDRLEN - FRAGHDR_LEN;
+
+  /* All fragments but the last must hold a multiple of 8 bytes */
+
+  if ((!last && (len & 7) != 0) ||
+      IPv6_HDRLEN + offset + len > CONFIG_NET_IPFRAG_MAXSIZE)
+    {
+      nwarn("WARNING: Bad fragment offset=%u len=%u\n", offset, len);
+      goto drop;
+    }
+
+  memcpy(addr, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+  memcpy(&addr[sizeof(net_ipv6addr_t)], ipv6->destipaddr,
+         sizeof(net_ipv6addr_t));
+  id    = (uint32_t)frag->id[0] << 24 | (uint32_t)frag->id[1] << 16 |
+          (uint32_t)frag->id[2] << 8 | frag->id[3];
+  proto = frag->nxthdr;
+
+  fr = ipfrag_find(PF_INET6, proto, id, addr, sizeof(net_ipv6addr_t));
+  if (fr->fr_nfrags == 0 || offset == 0)
+    {
+      memcpy(fr->fr_hdr, ipv6, IPv6_HDRLEN);
+    }
+
+  ret = ipfrag_insert(fr, (FAR uint8_t *)frag + FRAGHDR_LEN, len, offset,
+                      last);
+  if (ret < 0)
+    {
+      goto drop;
+    }
+  else if (ret == 0)
+    {
+      /* More fragments are expected */
+
+      dev->d_len = 0;
+      return OK;
+    }
+
+  /* The datagram is complete.  Remove the Fragment header. */
+
+  ipv6 = (FAR struct ipv6_hdr_s *)ipfrag_deliver(dev, fr, IPv6_HDRLEN);
+  if (ipv6 == NULL)
+    {
+      goto drop;
+    }
+
+  paylen       = dev->d_len - NET_LL_HDRLEN(dev) - IPv6_HDRLEN;
+  ipv6->proto  = proto;
+  ipv6->len[0] = paylen >> 8;
+  ipv6->len[1] = paylen & 0xff;
+
+  ninfo("Reassembled %u byte datagram %lu\n", paylen, (unsigned long)id);
+
+  /* The reassembled datagram cannot be held for a later retry, so the
+   * result of ipv6_process() is not returned.
+   */
+
+  (void)ipv6_process(dev);
+  ipfrag_txfinish(dev);
+  return OK;
+
+drop:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv6.drop++;
+#endif
+  dev->d_len = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipv6_fragment
+ *
+ * Description:
+ *   Split the d_len byte IPv6 datagram at ipbuf into fragments that fit the
+ *   MTU of the device.  The first fragment is placed in d_buf;  the rest
+ *   are queued.
+ *
+ ****************************************************************************/
+
+int ipv6_fragment(FAR struct net_driver_s *dev, FAR const uint8_t *ipbuf)
+{
+  FAR struct iob_s *iob;
+  unsigned int datalen = dev->d_len - IPv6_HDRLEN;
+  unsigned int fraglen;
+  unsigned int nqueued = 0;
+  unsigned int offset;
+  unsigned int len;
+  uint32_t id;
+  int ret;
+
+  /* Fragment payloads must be a multiple of 8 bytes */
+
+  fraglen = (NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - IPv6_HDRLEN -
+             FRAGHDR_LEN) & ~7;
+  if (fraglen == 0)
+    {
+      return -EMSGSIZE;
+    }
+
+  if ((datalen - 1) / fraglen > ipfrag_txavail())
+    {
+      return -ENOBUFS;
+    }
+
+  id = ++g_ipv6_fragid;
+
+  /* Queue all but the first fragment, building each one in d_buf */
+
+  for (offset = fraglen; offset < datalen; offset += fraglen)
+    {
+      len = datalen - offset;
+      if (len > fraglen)
+        {
+          len = fraglen;
+        }
+
+      ipv6_buildfrag(dev, ipbuf, offset, len, offset + len < datalen, id);
+
+      iob = iob_tryalloc(true);
+      if (iob == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)IPv6BUF, dev->d_len, 0,
+                          true);
+      if (ret < 0)
+        {
+          iob_free_chain(iob);
+          goto errout;
+        }
+
+      ipfrag_txenqueue(dev, iob);
+      nqueued++;
+    }
+
+  /* The first fragment is sent from d_buf */
+
+  ipv6_buildfrag(dev, ipbuf, 0, fraglen, true, id);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv6.sent += nqueued;
+#endif
+  return OK;
+
+errout:
+  ipfrag_txdiscard(nqueued);
+  return ret;
+}
+
+#endif /* CONFIG_NET_IPFRAG && CONFIG_NET_IPv6 */
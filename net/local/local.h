@@ -1,5 +1,5 @@
 /****************************************************************************
- * net/local/loal.h
+ * net/local/local.h
  *
  *   Copyright (C) 2015 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -60,22 +61,38 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration */
+
+#ifndef CONFIG_NET_LOCAL_NMSGS
+#  define CONFIG_NET_LOCAL_NMSGS 16
+#endif
+
+#ifndef CONFIG_NET_LOCAL_RCVBUF
+#  define CONFIG_NET_LOCAL_RCVBUF 1024
+#endif
+
+/* Large messages may be handed off directly from the sender's buffers.
+ * That is not possible in the kernel build where the sender and the
+ * receiver live in different address spaces.
+ */
+
+#undef HAVE_LOCAL_HANDOFF
+#if defined(CONFIG_NET_LOCAL_HANDOFF) && CONFIG_NET_LOCAL_HANDOFF > 0 && \
+    !defined(CONFIG_BUILD_KERNEL)
+#  define HAVE_LOCAL_HANDOFF 1
+#endif
+
 #undef HAVE_LOCAL_POLL
 #ifndef CONFIG_DISABLE_POLL
 #  define HAVE_LOCAL_POLL 1
-#  define LOCAL_ACCEPT_NPOLLWAITERS 2
+#  define LOCAL_NPOLLWAITERS 4
 #endif
 
-/* Packet format in FIFO:
- *
- * 1. Sync bytes (7 at most)
- * 2. End/Start byte
- * 3. 16-bit packet length (in host order)
- * 4. Packet data (in host order)
- */
+/* The maximum number of descriptors that may be passed in one message */
 
-#define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
-#define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
+#ifdef CONFIG_NET_LOCAL_SCM
+#  define LOCAL_NCONTROLFDS 4
+#endif
 
 /****************************************************************************
  * Public Type Definitions
@@ -111,6 +128,66 @@ enum local_state_s
   LOCAL_STATE_DISCONNECTED     /* Peer disconnected */
 };
 
+#ifdef CONFIG_NET_LOCAL_SCM
+/* One file or socket descriptor in flight.  The sender's descriptor is
+ * duplicated into this structure by sendmsg() and re-installed in the
+ * receiving task by recvmsg().
+ */
+
+struct local_fd_s
+{
+  bool lf_issock;              /* True: u.lf_sock is valid */
+  union
+  {
+#if CONFIG_NFILE_DESCRIPTORS > 0
+    struct file lf_file;       /* Reference to an open file */
+#endif
+    struct socket lf_sock;     /* Reference to a socket */
+  } u;
+};
+
+/* The descriptors passed with one message (SCM_RIGHTS) */
+
+struct local_rights_s
+{
+  uint8_t lr_nfds;             /* Number of descriptors in lr_fds[] */
+  struct local_fd_s lr_fds[LOCAL_NCONTROLFDS];
+};
+#endif
+
+/* One message in the receive queue of a local socket.  There are two kinds
+ * of messages:
+ *
+ * 1. Buffered.  The data was copied into an IOB chain by the sender and
+ *    the sender has already returned.  The message descriptor comes from
+ *    a pre-allocated pool.
+ * 2. Hand-off.  lm_iob is NULL; the receiver copies directly from the
+ *    sender's buffers.  The message descriptor lives on the stack of the
+ *    sender which waits on lm_donesem until the message has been removed
+ *    from the queue.
+ */
+
+struct local_msg_s
+{
+  sq_entry_t lm_node;          /* Supports a singly linked list */
+  FAR struct local_conn_s *lm_conn; /* Receiving connection (while queued) */
+  FAR struct iob_s *lm_iob;    /* Buffered message data */
+  size_t lm_len;               /* Total size of the message */
+  size_t lm_offset;            /* Number of bytes already received */
+#ifdef HAVE_LOCAL_HANDOFF
+  FAR const struct iovec *lm_iov; /* The sender's buffers (hand-off) */
+  int lm_iovcnt;               /* Number of buffers in lm_iov */
+  int lm_result;               /* Result of the hand-off */
+  sem_t lm_donesem;            /* Posted when the hand-off completes */
+#endif
+#ifdef CONFIG_NET_LOCAL_SCM
+  FAR struct local_rights_s *lm_rights; /* Descriptors passed (if any) */
+#endif
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  char lm_path[UNIX_PATH_MAX]; /* Address of the sender (SOCK_DGRAM) */
+#endif
+};
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -125,15 +202,20 @@ enum local_state_s
  * And
  *
  * 4. Connectionless.  Like a peer but using a connectionless datagram
- *    style of communication.  SOCK_DRAM support has not yet been
- *    implemented.
+ *    style of communication.
+ *
+ * Data is not passed through the file system.  A sender places each
+ * message directly in the receive queue of the receiving connection:  The
+ * connected peer for SOCK_STREAM or the socket bound to the destination
+ * path for SOCK_DGRAM.
  */
 
 struct local_conn_s
 {
   /* lc_node supports a doubly linked list: Listening SOCK_STREAM servers
    * will be linked into a list of listeners; SOCK_STREAM clients will be
-   * linked to the lc_waiters and lc_conn lists.
+   * linked to the lc_waiters list; bound SOCK_DGRAM sockets are linked
+   * into the list of datagram receivers.
    */
 
   dq_entry_t lc_node;          /* Supports a doubly linked list */
@@ -144,28 +226,28 @@ struct local_conn_s
   uint8_t lc_proto;            /* SOCK_STREAM or SOCK_DGRAM */
   uint8_t lc_type;             /* See enum local_type_e */
   uint8_t lc_state;            /* See enum local_state_e */
-  struct file lc_infile;       /* File for read-only FIFO (peers) */
-  struct file lc_outfile;      /* File descriptor of write-only FIFO (peers) */
   char lc_path[UNIX_PATH_MAX]; /* Path assigned by bind() */
-  int32_t lc_instance_id;      /* Connection instance ID for stream
-                                * server<->client connection pair */
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-  /* SOCK_STREAM fields common to both client and server */
-
-  sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
+  sq_queue_t lc_rxq;           /* Received messages (struct local_msg_s) */
+  size_t lc_rxlen;             /* Number of bytes buffered in lc_rxq */
+  sem_t lc_rxsem;              /* Receivers wait here for a message */
 
 #ifdef HAVE_LOCAL_POLL
   /* The following is a list if poll structures of threads waiting for
-   * socket accept events.
+   * socket events.
    */
 
-  struct pollfd *lc_accept_fds[LOCAL_ACCEPT_NPOLLWAITERS];
+  FAR struct pollfd *lc_fds[LOCAL_NPOLLWAITERS];
 #endif
 
-  /* Union of fields unique to SOCK_STREAM client, server, and connected
-   * peers.
-   */
+#ifdef CONFIG_NET_LOCAL_STREAM
+  /* SOCK_STREAM fields common to both client and server */
+
+  sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
+  sem_t lc_txsem;              /* Senders wait here for room in the peer */
+  FAR struct local_conn_s *lc_peer; /* The connected peer (if any) */
+
+  /* Union of fields unique to SOCK_STREAM client and server */
 
   union
   {
@@ -182,16 +264,8 @@ struct local_conn_s
 
     struct
     {
-      uint16_t lc_remaining;   /* (For binary compatibility with peer) */
       volatile int lc_result;  /* Result of the connection operation (client)*/
     } client;
-
-    /* Fields common to connected peers (connected or accepted) */
-
-    struct
-    {
-      uint16_t lc_remaining;   /* Bytes remaining in the incoming stream */
-    } peer;
   } u;
 #endif /* CONFIG_NET_LOCAL_STREAM */
 };
@@ -218,12 +292,24 @@ EXTERN const struct sock_intf_s g_local_sockif;
 EXTERN dq_queue_t g_local_listeners;
 #endif
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
+/* A list of all SOCK_DGRAM connections bound to a path */
+
+EXTERN dq_queue_t g_local_dgrams;
+
+/* SOCK_DGRAM senders wait here for room in the receive queue */
+
+EXTERN sem_t g_local_dgramsem;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 struct sockaddr; /* Forward reference */
 struct socket;   /* Forward reference */
+struct msghdr;   /* Forward reference */
+struct local_rights_s; /* Forward reference */
 
 /****************************************************************************
  * Name: local_initialize
@@ -252,12 +338,33 @@ FAR struct local_conn_s *local_alloc(void);
  *
  * Description:
  *   Free a local connection structure that is no longer in use. This should
- *   be done by the implementation of close().
+ *   be done by the implementation of close().  Any messages still queued
+ *   for the connection are discarded.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
 void local_free(FAR struct local_conn_s *conn);
 
+/****************************************************************************
+ * Name: local_findconn
+ *
+ * Description:
+ *   Find the listening SOCK_STREAM server or the bound SOCK_DGRAM
+ *   connection with the given path.
+ *
+ * Returned Value:
+ *   The matching connection or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct local_conn_s *local_findconn(FAR const char *path, int proto);
+
 /****************************************************************************
  * Name: psock_local_bind
  *
@@ -371,20 +478,23 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags (ignored for now)
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
+ *   flags    Send flags
+ *   rights   Descriptors to pass with the data (may be NULL).  Ownership
+ *            passes to this function in all cases.
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
- *   -1 is returned, and errno is set appropriately (see send() for the
- *   list of errno numbers).
+ *   a negated errno value is returned (see send() for the list of errno
+ *   numbers).
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags);
+ssize_t psock_local_send(FAR struct socket *psock,
+                         FAR const struct iovec *iov, int iovcnt, int flags,
+                         FAR struct local_rights_s *rights);
 #endif
 
 /****************************************************************************
@@ -396,11 +506,13 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
+ *   rights   Descriptors to pass with the data (may be NULL).  Ownership
+ *            passes to this function in all cases.
  *
  *   NOTE: All input parameters were verified by sendto() before this
  *   function was called.
@@ -413,30 +525,39 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
-ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags, FAR const struct sockaddr *to,
-                           socklen_t tolen);
+ssize_t psock_local_sendto(FAR struct socket *psock,
+                           FAR const struct iovec *iov, int iovcnt,
+                           int flags, FAR const struct sockaddr *to,
+                           socklen_t tolen,
+                           FAR struct local_rights_s *rights);
 #endif
 
 /****************************************************************************
  * Name: local_send_packet
  *
  * Description:
- *   Send a packet on the write-only FIFO.
+ *   Send one message to a local socket:  To the connected peer of a
+ *   SOCK_STREAM socket or to the SOCK_DGRAM socket bound to 'path'.  The
+ *   packet data is gathered from all of the buffers.
  *
  * Input Parameters:
- *   filep    File structure of write-only FIFO.
- *   buf      Data to send
- *   len      Length of data to send
+ *   psock    The sending socket
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
+ *   flags    Send flags
+ *   path     Destination path (SOCK_DGRAM only)
+ *   rights   Descriptors to pass with the data (may be NULL)
  *
  * Returned Value:
- *   Zero is returned on success; a negated errno value is returned on any
- *   failure.
+ *   The number of bytes sent is returned on success; a negated errno value
+ *   is returned on any failure.
  *
  ****************************************************************************/
 
-int local_send_packet(FAR struct file *filep, FAR const uint8_t *buf,
-                      size_t len);
+ssize_t local_send_packet(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const char *path,
+                          FAR struct local_rights_s *rights);
 
 /****************************************************************************
  * Name: local_recvfrom
@@ -454,7 +575,7 @@ int local_send_packet(FAR struct file *filep, FAR const uint8_t *buf,
  *   psock    A pointer to a NuttX-specific, internal socket structure
  *   buf      Buffer to receive data
  *   len      Length of buffer
- *   flags    Receive flags (ignored for now)
+ *   flags    Receive flags
  *   from     Address of source (may be NULL)
  *   fromlen  The length of the address structure
  *
@@ -471,35 +592,35 @@ ssize_t local_recvfrom(FAR struct socket *psock, FAR void *buf,
                        FAR socklen_t *fromlen);
 
 /****************************************************************************
- * Name: local_fifo_read
+ * Name: local_recvmsg
  *
  * Description:
- *   Read a data from the read-only FIFO.
+ *   Receive one message from a local socket, scattering the data directly
+ *   into the buffers of 'msg'.  Descriptors passed with SCM_RIGHTS are
+ *   installed in the calling task and returned as control data.
  *
  * Input Parameters:
- *   filep - File structure of write-only FIFO.
- *   buf   - Local to store the received data
- *   len   - Length of data to receive [in]
- *           Length of data actually received [out]
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message
+ *   flags    Receive flags
  *
  * Returned Value:
- *   Zero is returned on success; a negated errno value is returned on any
- *   failure.  If -ECONNRESET is received, then the sending side has closed
- *   the FIFO. In this case, the returned data may still be valid (if the
- *   returned len > 0).
+ *   On success, returns the number of characters received.  Otherwise, a
+ *   negated errno value is returned.
  *
  ****************************************************************************/
 
-int local_fifo_read(FAR struct file *filep, FAR uint8_t *buf, size_t *len);
+ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
 
 /****************************************************************************
  * Name: local_getaddr
  *
  * Description:
- *   Return the Unix domain address of a connection.
+ *   Return the Unix domain address corresponding to a path.
  *
  * Input Parameters:
- *   conn - The connection
+ *   path - The path of the connection
  *   addr - The location to return the address
  *   addrlen - The size of the memory allocat by the caller to receive the
  *             address.
@@ -509,158 +630,197 @@ int local_fifo_read(FAR struct file *filep, FAR uint8_t *buf, size_t *len);
  *
  ****************************************************************************/
 
-int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
+int local_getaddr(FAR const char *path, FAR struct sockaddr *addr,
                   FAR socklen_t *addrlen);
 
 /****************************************************************************
- * Name: local_sync
+ * Name: local_msg_initialize
  *
  * Description:
- *   Read a sync bytes until the start of the packet is found.
+ *   Initialize the pool of message descriptors.
  *
- * Input Parameters:
- *   filep - File structure of write-only FIFO.
+ ****************************************************************************/
+
+void local_msg_initialize(void);
+
+/****************************************************************************
+ * Name: local_msg_alloc
+ *
+ * Description:
+ *   Allocate a buffered message descriptor from the pool, waiting if
+ *   necessary (and permitted).
  *
  * Returned Value:
- *   The non-zero size of the following packet is returned on success; a
- *   negated errno value is returned on any failure.
+ *   The zeroed message descriptor or NULL if 'nonblock' is true and the
+ *   pool is empty.
+ *
+ * Assumptions:
+ *   The network is NOT locked.
  *
  ****************************************************************************/
 
-int local_sync(FAR struct file *filep);
+FAR struct local_msg_s *local_msg_alloc(bool nonblock);
 
 /****************************************************************************
- * Name: local_create_fifos
+ * Name: local_msg_free
  *
  * Description:
- *   Create the FIFO pair needed for a SOCK_STREAM connection.
+ *   Return a buffered message descriptor to the pool, releasing its IOB
+ *   chain and any descriptors that were not delivered.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_create_fifos(FAR struct local_conn_s *conn);
-#endif
+void local_msg_free(FAR struct local_msg_s *msg);
 
 /****************************************************************************
- * Name: local_create_halfduplex
+ * Name: local_msg_enqueue
  *
  * Description:
- *   Create the half-duplex FIFO needed for SOCK_DGRAM communication.
+ *   Add a message to the receive queue of 'conn' and wake up any readers.
+ *   Small SOCK_STREAM messages may be merged into the message at the tail
+ *   of the queue in which case 'msg' is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_create_halfduplex(FAR struct local_conn_s *conn,
-                            FAR const char *path);
-#endif
+void local_msg_enqueue(FAR struct local_conn_s *conn,
+                       FAR struct local_msg_s *msg);
 
 /****************************************************************************
- * Name: local_release_fifos
+ * Name: local_msg_copyout
  *
  * Description:
- *   Release references to the FIFO pair used for a SOCK_STREAM connection.
+ *   Copy up to 'len' unread bytes of 'msg' into the buffers described by
+ *   'iov', beginning 'iovoff' bytes into those buffers.
+ *
+ * Returned Value:
+ *   The number of bytes copied.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_release_fifos(FAR struct local_conn_s *conn);
-#endif
+size_t local_msg_copyout(FAR struct local_conn_s *conn,
+                         FAR struct local_msg_s *msg,
+                         FAR const struct iovec *iov, int iovcnt,
+                         size_t iovoff, size_t len);
 
 /****************************************************************************
- * Name: local_release_halfduplex
+ * Name: local_msg_complete
  *
  * Description:
- *   Release a reference to the FIFO used for SOCK_DGRAM communication
+ *   Remove a message from the receive queue of 'conn'.  Buffered messages
+ *   are freed; the sender of a hand-off message is woken up with 'result'.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_release_halfduplex(FAR struct local_conn_s *conn);
-#endif
+void local_msg_complete(FAR struct local_conn_s *conn,
+                        FAR struct local_msg_s *msg, int result);
 
 /****************************************************************************
- * Name: local_open_client_rx
+ * Name: local_msg_drain
  *
  * Description:
- *   Only the client-side Rx FIFO.
+ *   Discard all messages in the receive queue of 'conn'.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_rx(FAR struct local_conn_s *client, bool nonblock);
-#endif
+void local_msg_drain(FAR struct local_conn_s *conn);
 
 /****************************************************************************
- * Name: local_open_client_tx
+ * Name: local_txnotify
  *
  * Description:
- *   Only the client-side Tx FIFO.
+ *   Called after data has been removed from the receive queue of 'conn'.
+ *   Wake up senders that may be waiting for room in the queue.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_tx(FAR struct local_conn_s *client, bool nonblock);
-#endif
+void local_txnotify(FAR struct local_conn_s *conn);
 
 /****************************************************************************
- * Name: local_open_server_rx
+ * Name: local_wakeup
  *
  * Description:
- *   Only the server-side Rx FIFO.
+ *   Wake up all threads waiting on a semaphore.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock);
-#endif
+void local_wakeup(FAR sem_t *sem);
 
 /****************************************************************************
- * Name: local_open_server_tx
+ * Name: local_rights_alloc
  *
  * Description:
- *   Only the server-side Tx FIFO.
+ *   Collect the descriptors passed in the SCM_RIGHTS control messages of
+ *   'msg'.  Each descriptor is duplicated so that it remains valid even if
+ *   the sender closes it before the message is received.
+ *
+ * Returned Value:
+ *   Zero (OK) on success with *rights set (NULL if there was nothing to
+ *   pass); a negated errno value on failure.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock);
+#ifdef CONFIG_NET_LOCAL_SCM
+int local_rights_alloc(FAR struct msghdr *msg,
+                       FAR struct local_rights_s **rights);
 #endif
 
 /****************************************************************************
- * Name: local_open_receiver
+ * Name: local_rights_recv
  *
  * Description:
- *   Only the receiving side of the half duplex FIFO.
+ *   Install passed descriptors in the calling task and return them as an
+ *   SCM_RIGHTS control message in 'msg'.  Descriptors that do not fit are
+ *   closed and MSG_CTRUNC is reported.  'rights' is freed in all cases.
+ *
+ * Assumptions:
+ *   The network is NOT locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock);
+#ifdef CONFIG_NET_LOCAL_SCM
+void local_rights_recv(FAR struct local_rights_s *rights,
+                       FAR struct msghdr *msg);
 #endif
 
 /****************************************************************************
- * Name: local_open_sender
+ * Name: local_rights_free
  *
  * Description:
- *   Only the sending side of the half duplex FIFO.
+ *   Close all descriptors in flight and free the structure.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
-                      bool nonblock);
+#ifdef CONFIG_NET_LOCAL_SCM
+void local_rights_free(FAR struct local_rights_s *rights);
 #endif
 
-
 /****************************************************************************
- * Name: local_accept_pollnotify
+ * Name: local_pollnotify
+ *
+ * Description:
+ *   Report poll events on a local socket.
+ *
  ****************************************************************************/
 
 #ifdef HAVE_LOCAL_POLL
-void local_accept_pollnotify(FAR struct local_conn_s *conn,
-                             pollevent_t eventset);
+void local_pollnotify(FAR struct local_conn_s *conn, pollevent_t eventset);
 #else
-#define local_accept_pollnotify(conn, eventset) ((void)(conn))
+#  define local_pollnotify(conn, eventset) ((void)(conn))
 #endif
 
 /****************************************************************************
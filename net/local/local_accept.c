@@ -58,6 +58,10 @@
 
 /****************************************************************************
  * Name: local_waitlisten
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
 static int local_waitlisten(FAR struct local_conn_s *server)
@@ -70,7 +74,7 @@ static int local_waitlisten(FAR struct local_conn_s *server)
     {
       /* No.. wait for a connection or a signal */
 
-      ret = nxsem_wait(&server->lc_waitsem);
+      ret = net_lockedwait(&server->lc_waitsem);
       if (ret < 0)
         {
           DEBUGASSERT(ret == -EINTR || ret == -ECANCELED);
@@ -145,6 +149,7 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   /* Loop as necessary if we have to wait for a connection */
 
+  net_lock();
   for (; ; )
     {
       /* Are there pending connections.  Remove the client from the
@@ -173,7 +178,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
             }
           else
             {
-              /* Initialize the new connection structure */
+              /* Initialize the new connection structure and connect it
+               * directly to the client.  Each peer sends into the receive
+               * queue of the other.
+               */
 
               conn->lc_crefs  = 1;
               conn->lc_proto  = SOCK_STREAM;
@@ -182,69 +190,41 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
               strncpy(conn->lc_path, client->lc_path, UNIX_PATH_MAX-1);
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
-              conn->lc_instance_id = client->lc_instance_id;
 
-              /* Open the server-side write-only FIFO.  This should not
-               * block.
-               */
-
-              ret = local_open_server_tx(conn,
-                                         _SS_ISNONBLOCK(psock->s_flags));
-              if (ret < 0)
-                {
-                   nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-                        conn->lc_path, ret);
-                }
-            }
-
-          /* Do we have a connection?  Is the write-side FIFO opened? */
-
-          if (ret == OK)
-            {
-              DEBUGASSERT(conn->lc_outfile.f_inode != NULL);
-
-              /* Open the server-side read-only FIFO.  This should not
-               * block because the client side has already opening it
-               * for writing.
-               */
-
-              ret = local_open_server_rx(conn,
-                                         _SS_ISNONBLOCK(psock->s_flags));
-              if (ret < 0)
-                {
-                   nerr("ERROR: Failed to open read-only FIFOs for %s: %d\n",
-                        conn->lc_path, ret);
-                }
-            }
-
-          /* Do we have a connection?  Are the FIFOs opened? */
-
-          if (ret == OK)
-            {
-              DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+              conn->lc_peer    = client;
+              client->lc_peer  = conn;
+              client->lc_state = LOCAL_STATE_CONNECTED;
 
               /* Return the address family */
 
+              ret = OK;
               if (addr != NULL)
                 {
-                  ret = local_getaddr(client, addr, addrlen);
+                  ret = local_getaddr(client->lc_path, addr, addrlen);
                 }
-            }
 
-          if (ret == OK)
-            {
-              /* Setup the client socket structure */
+              if (ret == OK)
+                {
+                  /* Setup the client socket structure */
 
-              newsock->s_domain = psock->s_domain;
-              newsock->s_type   = SOCK_STREAM;
-              newsock->s_sockif = psock->s_sockif;
-              newsock->s_conn   = (FAR void *)conn;
+                  newsock->s_domain = psock->s_domain;
+                  newsock->s_type   = SOCK_STREAM;
+                  newsock->s_sockif = psock->s_sockif;
+                  newsock->s_conn   = (FAR void *)conn;
+                }
+              else
+                {
+                  client->lc_peer  = NULL;
+                  client->lc_state = LOCAL_STATE_BOUND;
+                  local_free(conn);
+                }
             }
 
           /* Signal the client with the result of the connection */
 
           client->u.client.lc_result = ret;
           nxsem_post(&client->lc_waitsem);
+          net_unlock();
           return ret;
         }
 
@@ -258,7 +238,8 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
         {
           /* Yes.. return EAGAIN */
 
-          return -EAGAIN;
+          ret = -EAGAIN;
+          break;
         }
 
       /* Otherwise, listen for a connection and try again. */
@@ -266,9 +247,12 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
       ret = local_waitlisten(server);
       if (ret < 0)
         {
-          return ret;
+          break;
         }
     }
+
+  net_unlock();
+  return ret;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM */
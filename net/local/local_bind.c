@@ -42,6 +42,8 @@
 
 #include <sys/socket.h>
 #include <string.h>
+#include <errno.h>
+#include <queue.h>
 #include <assert.h>
 
 #include <nuttx/net/net.h>
@@ -75,6 +77,28 @@ int psock_local_bind(FAR struct socket *psock,
 
   conn = (FAR struct local_conn_s *)psock->s_conn;
 
+  /* A socket can be bound only once */
+
+  if (conn->lc_state != LOCAL_STATE_UNBOUND)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  /* Datagrams are delivered by path so the path of a datagram socket must
+   * be unique.
+   */
+
+  net_lock();
+  if (psock->s_type == SOCK_DGRAM && addrlen > sizeof(sa_family_t) &&
+      unaddr->sun_path[0] != '\0' &&
+      local_findconn(unaddr->sun_path, SOCK_DGRAM) != NULL)
+    {
+      net_unlock();
+      return -EADDRINUSE;
+    }
+#endif
+
   /* Save the address family */
 
   conn->lc_proto = psock->s_type;
@@ -109,11 +133,22 @@ int psock_local_bind(FAR struct socket *psock,
 
           (void)strncpy(conn->lc_path, unaddr->sun_path, UNIX_PATH_MAX-1);
           conn->lc_path[UNIX_PATH_MAX-1] = '\0';
-          conn->lc_instance_id = -1;
         }
     }
 
   conn->lc_state = LOCAL_STATE_BOUND;
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  /* Senders find a bound datagram socket in the list of receivers */
+
+  if (conn->lc_proto == SOCK_DGRAM && conn->lc_type == LOCAL_TYPE_PATHNAME)
+    {
+      dq_addlast(&conn->lc_node, &g_local_dgrams);
+    }
+
+  net_unlock();
+#endif
+
   return OK;
 }
 
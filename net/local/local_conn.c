@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
 
+#include <sys/socket.h>
 #include <semaphore.h>
 #include <string.h>
 #include <assert.h>
@@ -49,6 +50,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
 
 #include "local/local.h"
 
@@ -70,6 +72,19 @@ void local_initialize(void)
 #ifdef CONFIG_NET_LOCAL_STREAM
   dq_init(&g_local_listeners);
 #endif
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  dq_init(&g_local_dgrams);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&g_local_dgramsem, 0, 0);
+  nxsem_setprotocol(&g_local_dgramsem, SEM_PRIO_NONE);
+#endif
+
+  local_msg_initialize();
 }
 
 /****************************************************************************
@@ -89,22 +104,21 @@ FAR struct local_conn_s *local_alloc(void)
 
   if (conn)
     {
-      /* Initialize non-zero elements the new connection structure */
-
-      conn->lc_infile.f_inode  = NULL;
-      conn->lc_outfile.f_inode = NULL;
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-      /* This semaphore is used for signaling and, hence, should not have
+      /* Initialize non-zero elements the new connection structure.  These
+       * semaphores are used for signaling and, hence, should not have
        * priority inheritance enabled.
        */
 
+      sq_init(&conn->lc_rxq);
+      nxsem_init(&conn->lc_rxsem, 0, 0);
+      nxsem_setprotocol(&conn->lc_rxsem, SEM_PRIO_NONE);
+
+#ifdef CONFIG_NET_LOCAL_STREAM
       nxsem_init(&conn->lc_waitsem, 0, 0);
       nxsem_setprotocol(&conn->lc_waitsem, SEM_PRIO_NONE);
 
-#ifdef HAVE_LOCAL_POLL
-      memset(conn->lc_accept_fds, 0, sizeof(conn->lc_accept_fds));
-#endif
+      nxsem_init(&conn->lc_txsem, 0, 0);
+      nxsem_setprotocol(&conn->lc_txsem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -116,7 +130,11 @@ FAR struct local_conn_s *local_alloc(void)
  *
  * Description:
  *   Free a packet Unix domain connection structure that is no longer in use.
- *   This should be done by the implementation of close().
+ *   This should be done by the implementation of close().  Any messages
+ *   still queued for the connection are discarded.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
@@ -124,32 +142,69 @@ void local_free(FAR struct local_conn_s *conn)
 {
   DEBUGASSERT(conn != NULL);
 
-  /* Make sure that the read-only FIFO is closed */
+  /* Discard all unread messages, waking up any hand-off senders */
+
+  local_msg_drain(conn);
+  nxsem_destroy(&conn->lc_rxsem);
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+  nxsem_destroy(&conn->lc_waitsem);
+  nxsem_destroy(&conn->lc_txsem);
+#endif
+
+  /* And free the connection structure */
+
+  kmm_free(conn);
+}
+
+/****************************************************************************
+ * Name: local_findconn
+ *
+ * Description:
+ *   Find the listening SOCK_STREAM server or the bound SOCK_DGRAM
+ *   connection with the given path.
+ *
+ * Returned Value:
+ *   The matching connection or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-  if (conn->lc_infile.f_inode != NULL)
+FAR struct local_conn_s *local_findconn(FAR const char *path, int proto)
+{
+  FAR struct local_conn_s *conn = NULL;
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (proto == SOCK_STREAM)
     {
-      file_close(&conn->lc_infile);
-      conn->lc_infile.f_inode = NULL;
+      conn = (FAR struct local_conn_s *)g_local_listeners.head;
     }
+#endif
 
-  /* Make sure that the write-only FIFO is closed */
-
-  if (conn->lc_outfile.f_inode != NULL)
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (proto == SOCK_DGRAM)
     {
-      file_close(&conn->lc_outfile);
-      conn->lc_outfile.f_inode = NULL;
+      conn = (FAR struct local_conn_s *)g_local_dgrams.head;
     }
+#endif
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-  /* Destroy all FIFOs associted with the connection */
+  for (; conn != NULL;
+       conn = (FAR struct local_conn_s *)dq_next(&conn->lc_node))
+    {
+      /* Only connections bound to a path are kept in these lists */
 
-  local_release_fifos(conn);
-  nxsem_destroy(&conn->lc_waitsem);
-#endif
+      DEBUGASSERT(conn->lc_type == LOCAL_TYPE_PATHNAME &&
+                  conn->lc_proto == proto);
 
-  /* And free the connection structure */
+      if (strncmp(conn->lc_path, path, UNIX_PATH_MAX - 1) == 0)
+        {
+          break;
+        }
+    }
 
-  kmm_free(conn);
+  return conn;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL */
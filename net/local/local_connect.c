@@ -39,8 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/socket.h>
 #include <string.h>
-#include <unistd.h>
 #include <assert.h>
 #include <errno.h>
 #include <queue.h>
@@ -49,9 +49,6 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 
-#include <arch/irq.h>
-
-#include "utils/utils.h"
 #include "socket/socket.h"
 #include "local/local.h"
 
@@ -61,55 +58,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_generate_instance_id
- ****************************************************************************/
-
-static int32_t local_generate_instance_id(void)
-{
-  static int32_t g_next_instance_id = 0;
-  int32_t id;
-
-  /* Called from local_connect with net_lock held. */
-
-  id = g_next_instance_id++;
-  if (g_next_instance_id < 0)
-    {
-      g_next_instance_id = 0;
-    }
-
-  return id;
-}
-
-/****************************************************************************
- * Name: _local_semtake() and _local_semgive()
- *
- * Description:
- *   Take/give semaphore
- *
- ****************************************************************************/
-
-static inline void _local_semtake(sem_t *sem)
-{
-  int ret;
-
-  do
-    {
-      /* Take the semaphore (perhaps waiting) */
-
-      ret = nxsem_wait(sem);
-
-      /* The only case that an error should occur here is if the wait was
-       * awakened by a signal.
-       */
-
-      DEBUGASSERT(ret == OK || ret == -EINTR);
-    }
-  while (ret == -EINTR);
-}
-
-#define _local_semgive(sem) nxsem_post(sem)
-
 /****************************************************************************
  * Name: local_stream_connect
  *
@@ -129,8 +77,7 @@ static inline void _local_semtake(sem_t *sem)
  ****************************************************************************/
 
 static int inline local_stream_connect(FAR struct local_conn_s *client,
-                                       FAR struct local_conn_s *server,
-                                       bool nonblock)
+                                       FAR struct local_conn_s *server)
 {
   int ret;
   int sval;
@@ -156,53 +103,28 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
-  /* Create the FIFOs needed for the connection */
-
-  ret = local_create_fifos(client);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
-           client->lc_path, ret);
-
-      net_unlock();
-      return ret;
-    }
-
-  /* Open the client-side write-only FIFO.  This should not block and should
-   * prevent the server-side from blocking as well.
+  /* Add ourself to the list of waiting connections and notify the server.
+   * The result must be initialized first because the server may accept
+   * the connection as soon as the network is unlocked.
    */
 
-  ret = local_open_client_tx(client, nonblock);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-           client->lc_path, ret);
-
-      net_unlock();
-      goto errout_with_fifos;
-    }
-
-  DEBUGASSERT(client->lc_outfile.f_inode != NULL);
-
-  /* Add ourself to the list of waiting connections and notify the server. */
-
+  client->u.client.lc_result = -EBUSY;
   dq_addlast(&client->lc_node, &server->u.server.lc_waiters);
   client->lc_state = LOCAL_STATE_ACCEPT;
-  local_accept_pollnotify(server, POLLIN);
+  local_pollnotify(server, POLLIN);
 
   if (nxsem_getvalue(&server->lc_waitsem, &sval) >= 0 && sval < 1)
     {
-      _local_semgive(&server->lc_waitsem);
+      nxsem_post(&server->lc_waitsem);
     }
 
-  net_unlock();
-
-  /* Wait for the server to accept the connections */
+  /* Wait for the server to accept the connection.  The server connects
+   * the two peers; no further setup is needed on this side.
+   */
 
-  client->u.client.lc_result = -EBUSY;
   do
     {
-      _local_semtake(&client->lc_waitsem);
+      (void)net_lockedwait(&client->lc_waitsem);
       ret = client->u.client.lc_result;
     }
   while (ret == -EBUSY);
@@ -212,30 +134,15 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
-      goto errout_with_outfd;
+      client->lc_state = LOCAL_STATE_BOUND;
     }
-
-  /* Yes.. open the read-only FIFO */
-
-  ret = local_open_client_rx(client, nonblock);
-  if (ret < 0)
+  else
     {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-           client->lc_path, ret);
-      goto errout_with_outfd;
+      DEBUGASSERT(client->lc_state == LOCAL_STATE_CONNECTED &&
+                  client->lc_peer != NULL);
     }
 
-  DEBUGASSERT(client->lc_infile.f_inode != NULL);
-  client->lc_state = LOCAL_STATE_CONNECTED;
-  return OK;
-
-errout_with_outfd:
-  (void)file_close(&client->lc_outfile);
-  client->lc_outfile.f_inode = NULL;
-
-errout_with_fifos:
-  (void)local_release_fifos(client);
-  client->lc_state = LOCAL_STATE_BOUND;
+  net_unlock();
   return ret;
 }
 
@@ -318,7 +225,6 @@ int psock_local_connect(FAR struct socket *psock,
                 client->lc_proto = conn->lc_proto;
                 strncpy(client->lc_path, unaddr->sun_path, UNIX_PATH_MAX-1);
                 client->lc_path[UNIX_PATH_MAX-1] = '\0';
-                client->lc_instance_id = local_generate_instance_id();
 
                 /* The client is now bound to an address */
 
@@ -328,8 +234,7 @@ int psock_local_connect(FAR struct socket *psock,
 
                 if (conn->lc_proto == SOCK_STREAM)
                   {
-                    ret = local_stream_connect(client, conn,
-                                               _SS_ISNONBLOCK(psock->s_flags));
+                    ret = local_stream_connect(client, conn);
                   }
                 else
                   {
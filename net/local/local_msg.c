@@ -0,0 +1,538 @@
+/****************************************************************************
+ * net/local/local_msg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Package all globals used by this logic into a structure */
+
+struct local_msgpool_s
+{
+  /* Counts the available message descriptors */
+
+  sem_t sem;
+
+  /* This is the list of available message descriptors */
+
+  sq_queue_t freemsgs;
+
+  /* These are the pre-allocated message descriptors */
+
+  struct local_msg_s msgs[CONFIG_NET_LOCAL_NMSGS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the state of the message descriptor pool */
+
+static struct local_msgpool_s g_local_msgpool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_iob_copyout
+ *
+ * Description:
+ *   Copy 'len' bytes from the beginning of an IOB chain into the buffers
+ *   described by 'iov', beginning 'iovoff' bytes into those buffers.
+ *
+ ****************************************************************************/
+
+static void local_iob_copyout(FAR const struct iovec *iov, int iovcnt,
+                              size_t iovoff, FAR struct iob_s *iob,
+                              size_t len)
+{
+  size_t srcoff = 0;
+  size_t ncopy;
+  int i;
+
+  for (i = 0; i < iovcnt && len > 0; i++)
+    {
+      if (iovoff >= iov[i].iov_len)
+        {
+          iovoff -= iov[i].iov_len;
+          continue;
+        }
+
+      ncopy = MIN(iov[i].iov_len - iovoff, len);
+      (void)iob_copyout((FAR uint8_t *)iov[i].iov_base + iovoff, iob,
+                        ncopy, srcoff);
+
+      srcoff += ncopy;
+      len    -= ncopy;
+      iovoff  = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: local_iovcopy
+ *
+ * Description:
+ *   Copy 'len' bytes directly between two sets of buffers:  From 'srcoff'
+ *   bytes into 'src' to 'dstoff' bytes into 'dst'.  This is the single
+ *   copy of a hand-off message.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_HANDOFF
+static void local_iovcopy(FAR const struct iovec *dst, int dstcnt,
+                          size_t dstoff, FAR const struct iovec *src,
+                          int srccnt, size_t srcoff, size_t len)
+{
+  size_t ncopy;
+  int i = 0;
+  int j = 0;
+
+  /* Skip to the buffers containing the starting offsets */
+
+  while (i < dstcnt && dstoff >= dst[i].iov_len)
+    {
+      dstoff -= dst[i++].iov_len;
+    }
+
+  while (j < srccnt && srcoff >= src[j].iov_len)
+    {
+      srcoff -= src[j++].iov_len;
+    }
+
+  /* Then copy segment by segment */
+
+  while (len > 0 && i < dstcnt && j < srccnt)
+    {
+      ncopy = MIN(dst[i].iov_len - dstoff, src[j].iov_len - srcoff);
+      ncopy = MIN(ncopy, len);
+
+      memcpy((FAR uint8_t *)dst[i].iov_base + dstoff,
+             (FAR const uint8_t *)src[j].iov_base + srcoff, ncopy);
+
+      dstoff += ncopy;
+      srcoff += ncopy;
+      len    -= ncopy;
+
+      if (dstoff >= dst[i].iov_len)
+        {
+          dstoff = 0;
+          i++;
+        }
+
+      if (srcoff >= src[j].iov_len)
+        {
+          srcoff = 0;
+          j++;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_msg_initialize
+ *
+ * Description:
+ *   Initialize the pool of message descriptors.
+ *
+ ****************************************************************************/
+
+void local_msg_initialize(void)
+{
+  int i;
+
+  sq_init(&g_local_msgpool.freemsgs);
+
+  for (i = 0; i < CONFIG_NET_LOCAL_NMSGS; i++)
+    {
+      sq_addfirst(&g_local_msgpool.msgs[i].lm_node,
+                  &g_local_msgpool.freemsgs);
+    }
+
+  nxsem_init(&g_local_msgpool.sem, 0, CONFIG_NET_LOCAL_NMSGS);
+}
+
+/****************************************************************************
+ * Name: local_msg_alloc
+ *
+ * Description:
+ *   Allocate a buffered message descriptor from the pool, waiting if
+ *   necessary (and permitted).
+ *
+ * Returned Value:
+ *   The zeroed message descriptor or NULL if 'nonblock' is true and the
+ *   pool is empty.
+ *
+ * Assumptions:
+ *   The network is NOT locked.
+ *
+ ****************************************************************************/
+
+FAR struct local_msg_s *local_msg_alloc(bool nonblock)
+{
+  FAR struct local_msg_s *msg;
+  int ret;
+
+  if (nonblock)
+    {
+      ret = nxsem_trywait(&g_local_msgpool.sem);
+      if (ret < 0)
+        {
+          return NULL;
+        }
+    }
+  else
+    {
+      do
+        {
+          /* The only case that an error should occur here is if the wait
+           * was awakened by a signal.
+           */
+
+          ret = nxsem_wait(&g_local_msgpool.sem);
+          DEBUGASSERT(ret == OK || ret == -EINTR);
+        }
+      while (ret == -EINTR);
+    }
+
+  /* Now, we are guaranteed to have a message descriptor reserved for us in
+   * the free list.
+   */
+
+  net_lock();
+  msg = (FAR struct local_msg_s *)sq_remfirst(&g_local_msgpool.freemsgs);
+  net_unlock();
+
+  DEBUGASSERT(msg != NULL);
+  memset(msg, 0, sizeof(struct local_msg_s));
+  return msg;
+}
+
+/****************************************************************************
+ * Name: local_msg_free
+ *
+ * Description:
+ *   Return a buffered message descriptor to the pool, releasing its IOB
+ *   chain and any descriptors that were not delivered.
+ *
+ ****************************************************************************/
+
+void local_msg_free(FAR struct local_msg_s *msg)
+{
+  DEBUGASSERT(msg != NULL && msg->lm_conn == NULL);
+
+  if (msg->lm_iob != NULL)
+    {
+      iob_free_chain(msg->lm_iob);
+      msg->lm_iob = NULL;
+    }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (msg->lm_rights != NULL)
+    {
+      local_rights_free(msg->lm_rights);
+      msg->lm_rights = NULL;
+    }
+#endif
+
+  net_lock();
+  sq_addlast(&msg->lm_node, &g_local_msgpool.freemsgs);
+  net_unlock();
+
+  nxsem_post(&g_local_msgpool.sem);
+}
+
+/****************************************************************************
+ * Name: local_msg_enqueue
+ *
+ * Description:
+ *   Add a message to the receive queue of 'conn' and wake up any readers.
+ *   Small SOCK_STREAM messages may be merged into the message at the tail
+ *   of the queue in which case 'msg' is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_msg_enqueue(FAR struct local_conn_s *conn,
+                       FAR struct local_msg_s *msg)
+{
+#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct local_msg_s *tail;
+
+  /* A byte stream has no message boundaries:  Append the data to the
+   * buffered message at the tail of the queue if there is room.  This keeps
+   * a stream of small writes from consuming all of the message descriptors.
+   * Passed descriptors must stay with the first byte of their own message.
+   */
+
+  tail = (FAR struct local_msg_s *)sq_tail(&conn->lc_rxq);
+  if (conn->lc_proto == SOCK_STREAM && msg->lm_iob != NULL &&
+#ifdef CONFIG_NET_LOCAL_SCM
+      msg->lm_rights == NULL &&
+#endif
+      tail != NULL && tail->lm_iob != NULL &&
+      tail->lm_len - tail->lm_offset + msg->lm_len <= CONFIG_NET_LOCAL_RCVBUF)
+    {
+      iob_concat(tail->lm_iob, msg->lm_iob);
+      tail->lm_len   += msg->lm_len;
+      conn->lc_rxlen += msg->lm_len;
+
+      msg->lm_iob = NULL;
+      local_msg_free(msg);
+    }
+  else
+#endif
+    {
+      msg->lm_conn = conn;
+      sq_addlast(&msg->lm_node, &conn->lc_rxq);
+
+      if (msg->lm_iob != NULL)
+        {
+          conn->lc_rxlen += msg->lm_len;
+        }
+    }
+
+  /* Wake up any threads waiting for data */
+
+  local_wakeup(&conn->lc_rxsem);
+  local_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: local_msg_copyout
+ *
+ * Description:
+ *   Copy up to 'len' unread bytes of 'msg' into the buffers described by
+ *   'iov', beginning 'iovoff' bytes into those buffers.
+ *
+ * Returned Value:
+ *   The number of bytes copied.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+size_t local_msg_copyout(FAR struct local_conn_s *conn,
+                         FAR struct local_msg_s *msg,
+                         FAR const struct iovec *iov, int iovcnt,
+                         size_t iovoff, size_t len)
+{
+  len = MIN(len, msg->lm_len - msg->lm_offset);
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (msg->lm_iob != NULL)
+    {
+      /* Copy from the head of the IOB chain, then free the consumed I/O
+       * buffers right away.
+       */
+
+      local_iob_copyout(iov, iovcnt, iovoff, msg->lm_iob, len);
+      msg->lm_iob = iob_trimhead(msg->lm_iob, len);
+
+      DEBUGASSERT(conn->lc_rxlen >= len);
+      conn->lc_rxlen -= len;
+    }
+#ifdef HAVE_LOCAL_HANDOFF
+  else
+    {
+      /* Copy directly from the buffers of the waiting sender */
+
+      local_iovcopy(iov, iovcnt, iovoff, msg->lm_iov, msg->lm_iovcnt,
+                    msg->lm_offset, len);
+    }
+#endif
+
+  msg->lm_offset += len;
+  return len;
+}
+
+/****************************************************************************
+ * Name: local_msg_complete
+ *
+ * Description:
+ *   Remove a message from the receive queue of 'conn'.  Buffered messages
+ *   are freed; the sender of a hand-off message is woken up with 'result'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_msg_complete(FAR struct local_conn_s *conn,
+                        FAR struct local_msg_s *msg, int result)
+{
+  DEBUGASSERT(msg->lm_conn == conn);
+
+  sq_rem(&msg->lm_node, &conn->lc_rxq);
+  msg->lm_conn = NULL;
+
+  if (msg->lm_iob != NULL)
+    {
+      /* Account for any unread data that is being discarded */
+
+      DEBUGASSERT(conn->lc_rxlen >= msg->lm_len - msg->lm_offset);
+      conn->lc_rxlen -= msg->lm_len - msg->lm_offset;
+      local_msg_free(msg);
+    }
+#ifdef HAVE_LOCAL_HANDOFF
+  else
+    {
+      /* Let the sender of the hand-off message return */
+
+      msg->lm_result = result;
+      nxsem_post(&msg->lm_donesem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: local_msg_drain
+ *
+ * Description:
+ *   Discard all messages in the receive queue of 'conn'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_msg_drain(FAR struct local_conn_s *conn)
+{
+  FAR struct local_msg_s *msg;
+
+  while ((msg = (FAR struct local_msg_s *)sq_peek(&conn->lc_rxq)) != NULL)
+    {
+      local_msg_complete(conn, msg, -ECONNRESET);
+    }
+
+  DEBUGASSERT(conn->lc_rxlen == 0);
+}
+
+/****************************************************************************
+ * Name: local_txnotify
+ *
+ * Description:
+ *   Called after data has been removed from the receive queue of 'conn'.
+ *   Wake up senders that may be waiting for room in the queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_txnotify(FAR struct local_conn_s *conn)
+{
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (conn->lc_proto == SOCK_STREAM)
+    {
+      /* Only the connected peer sends to a stream socket */
+
+      if (conn->lc_peer != NULL)
+        {
+          local_wakeup(&conn->lc_peer->lc_txsem);
+          local_pollnotify(conn->lc_peer, POLLOUT);
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      /* Any datagram socket may be waiting to send to this one */
+
+      local_wakeup(&g_local_dgramsem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: local_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on a semaphore.
+ *
+ ****************************************************************************/
+
+void local_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL */
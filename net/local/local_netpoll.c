@@ -39,14 +39,15 @@
 
 #include <nuttx/config.h>
 
-#include <unistd.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <queue.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
-#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
-#include <nuttx/fs/fs.h>
 
 #include "socket/socket.h"
 #include "local/local.h"
@@ -54,101 +55,104 @@
 #ifdef HAVE_LOCAL_POLL
 
 /****************************************************************************
- * Name: local_accept_pollsetup
+ * Private Functions
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-static int local_accept_pollsetup(FAR struct local_conn_s *conn,
-                                  FAR struct pollfd *fds,
-                                  bool setup)
+/****************************************************************************
+ * Name: local_pollstate
+ *
+ * Description:
+ *   Return the set of poll events that are currently true for 'conn'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static pollevent_t local_pollstate(FAR struct local_conn_s *conn)
 {
-  pollevent_t eventset;
-  int ret = OK;
-  int i;
+  pollevent_t eventset = 0;
 
-  net_lock();
-  if (setup)
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (conn->lc_state == LOCAL_STATE_LISTENING)
     {
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
+      /* A listener is readable when a client is waiting to be accepted */
 
-      for (i = 0; i < LOCAL_ACCEPT_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!conn->lc_accept_fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              conn->lc_accept_fds[i] = fds;
-              fds->priv = &conn->lc_accept_fds[i];
-              break;
-            }
-        }
-
-      if (i >= LOCAL_ACCEPT_NPOLLWAITERS)
-        {
-          fds->priv = NULL;
-          ret = -EBUSY;
-          goto errout;
-        }
-
-      eventset = 0;
-      if (dq_peek(&conn->u.server.lc_waiters) != NULL)
+      if (!dq_empty(&conn->u.server.lc_waiters))
         {
           eventset |= POLLIN;
         }
 
-      if (eventset)
-        {
-          local_accept_pollnotify(conn, eventset);
-        }
+      return eventset;
     }
-  else
+#endif
+
+  if (!sq_empty(&conn->lc_rxq))
     {
-      /* This is a request to tear down the poll. */
+      eventset |= POLLIN;
+    }
 
-      struct pollfd **slot = (struct pollfd **)fds->priv;
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (conn->lc_proto == SOCK_STREAM)
+    {
+      /* A stream is writable while there is room in the receive queue of
+       * the peer.  After the peer has disconnected, reads return the end-of-
+       * file.
+       */
 
-      if (!slot)
+      if (conn->lc_state == LOCAL_STATE_CONNECTED && conn->lc_peer != NULL &&
+          conn->lc_peer->lc_rxlen < CONFIG_NET_LOCAL_RCVBUF)
         {
-          ret = -EIO;
-          goto errout;
+          eventset |= POLLOUT;
         }
+      else if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
+        {
+          eventset |= (POLLHUP | POLLIN);
+        }
+    }
+#endif
 
-      /* Remove all memory of the poll setup */
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto != SOCK_STREAM)
+    {
+      /* The receiver of a datagram is not known until it is sent */
 
-      *slot = NULL;
-      fds->priv = NULL;
+      eventset |= POLLOUT;
     }
+#endif
 
-errout:
-  net_unlock();
-  return ret;
+  return eventset;
 }
-#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: local_accept_pollnotify
+ * Name: local_pollnotify
+ *
+ * Description:
+ *   Report events to all threads polling on 'conn'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
-void local_accept_pollnotify(FAR struct local_conn_s *conn,
-                             pollevent_t eventset)
+void local_pollnotify(FAR struct local_conn_s *conn, pollevent_t eventset)
 {
-#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct pollfd *fds;
   int i;
 
-  for (i = 0; i < LOCAL_ACCEPT_NPOLLWAITERS; i++)
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
     {
-      struct pollfd *fds = conn->lc_accept_fds[i];
-      if (fds)
+      fds = conn->lc_fds[i];
+      if (fds != NULL)
         {
-          fds->revents |= (fds->events & eventset);
+          /* POLLERR and POLLHUP are always reported */
+
+          fds->revents |= (fds->events & eventset) |
+                          (eventset & (POLLERR | POLLHUP));
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
@@ -156,7 +160,6 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
             }
         }
     }
-#endif
 }
 
 /****************************************************************************
@@ -178,125 +181,47 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
 int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 {
   FAR struct local_conn_s *conn;
-  int ret = -ENOSYS;
+  pollevent_t eventset;
+  int ret = OK;
+  int i;
 
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && fds != NULL);
   conn = (FAR struct local_conn_s *)psock->s_conn;
 
-  if (conn->lc_proto == SOCK_DGRAM)
-    {
-      return ret;
-    }
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-  if (conn->lc_state == LOCAL_STATE_LISTENING &&
-      conn->lc_type  == LOCAL_TYPE_PATHNAME)
-    {
-      return local_accept_pollsetup(conn, fds, true);
-    }
+  net_lock();
 
-  if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
-    {
-      fds->priv = NULL;
-      goto pollerr;
-    }
+  /* Find an available slot for the poll structure reference */
 
-  switch (fds->events & (POLLIN | POLLOUT))
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
     {
-      case (POLLIN | POLLOUT):
+      if (conn->lc_fds[i] == NULL)
         {
-          FAR struct pollfd *shadowfds;
-
-          /* Poll wants to check state for both input and output. */
-
-          if (conn->lc_infile.f_inode == NULL ||
-              conn->lc_outfile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
-
-          /* Allocate shadow pollfds. */
-
-          shadowfds = kmm_zalloc(2 * sizeof(struct pollfd));
-          if (!shadowfds)
-            {
-              return -ENOMEM;
-            }
-
-          shadowfds[0].fd     = 0; /* Does not matter */
-          shadowfds[0].sem    = fds->sem;
-          shadowfds[0].events = fds->events & ~POLLOUT;
+          /* Bind the poll structure and this slot */
 
-          shadowfds[1].fd     = 1; /* Does not matter */
-          shadowfds[1].sem    = fds->sem;
-          shadowfds[1].events = fds->events & ~POLLIN;
-
-          /* Setup poll for both shadow pollfds. */
-
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], true);
-          if (ret >= 0)
-            {
-              ret = file_poll(&conn->lc_outfile, &shadowfds[1], true);
-              if (ret < 0)
-                {
-                  (void)file_poll(&conn->lc_infile, &shadowfds[0], false);
-                }
-            }
-
-          if (ret < 0)
-            {
-              kmm_free(shadowfds);
-              fds->priv = NULL;
-              goto pollerr;
-            }
-          else
-            {
-              fds->priv = shadowfds;
-              ret = OK;
-            }
+          conn->lc_fds[i] = fds;
+          fds->priv       = &conn->lc_fds[i];
+          break;
         }
-        break;
-
-      case POLLIN:
-        {
-          /* Poll wants to check state for input only. */
-
-          if (conn->lc_infile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
-
-          ret = file_poll(&conn->lc_infile, fds, true);
-        }
-        break;
-
-      case POLLOUT:
-        {
-          /* Poll wants to check state for output only. */
+    }
 
-          if (conn->lc_outfile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
+  if (i >= LOCAL_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
 
-          ret = file_poll(&conn->lc_outfile, fds, true);
-        }
-        break;
+  /* Report any events that are already true */
 
-      default:
-        ret = OK;
-        break;
+  eventset = local_pollstate(conn);
+  if (eventset != 0)
+    {
+      local_pollnotify(conn, eventset);
     }
-#endif
 
+errout:
+  net_unlock();
   return ret;
-
-pollerr:
-  fds->revents |= POLLERR;
-  nxsem_post(fds->sem);
-  return OK;
 }
 
 /****************************************************************************
@@ -317,88 +242,22 @@ pollerr:
 
 int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 {
-  FAR struct local_conn_s *conn;
-  int status = OK;
-  int ret = -ENOSYS;
-
-  conn = (FAR struct local_conn_s *)psock->s_conn;
-
-  if (conn->lc_proto == SOCK_DGRAM)
-    {
-      return ret;
-    }
+  FAR struct pollfd **slot;
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-  if (conn->lc_state == LOCAL_STATE_LISTENING &&
-      conn->lc_type  == LOCAL_TYPE_PATHNAME)
-    {
-      return local_accept_pollsetup(conn, fds, false);
-    }
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL && fds != NULL);
 
-  if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
-    {
-      return OK;
-    }
-
-  switch (fds->events & (POLLIN | POLLOUT))
+  net_lock();
+  slot = (FAR struct pollfd **)fds->priv;
+  if (slot != NULL)
     {
-      case (POLLIN | POLLOUT):
-        {
-          FAR struct pollfd *shadowfds = fds->priv;
-
-          if (shadowfds == NULL)
-            {
-              return OK;
-            }
-
-          /* Teardown for both shadow pollfds. */
-
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], false);
-          if (ret < 0)
-            {
-              status = ret;
-            }
-
-          ret = file_poll(&conn->lc_outfile, &shadowfds[1], false);
-          if (ret < 0)
-            {
-              status = ret;
-            }
-
-          fds->revents |= shadowfds[0].revents | shadowfds[1].revents;
-          fds->priv = NULL;
-          kmm_free(shadowfds);
-        }
-        break;
-
-      case POLLIN:
-        {
-          if (fds->priv == NULL)
-            {
-              return OK;
-            }
-
-          status = file_poll(&conn->lc_infile, fds, false);
-        }
-        break;
-
-      case POLLOUT:
-        {
-          if (fds->priv == NULL)
-            {
-              return OK;
-            }
-
-          status = file_poll(&conn->lc_outfile, fds, false);
-        }
-        break;
+      /* Remove all memory of the poll setup */
 
-      default:
-        break;
+      *slot     = NULL;
+      fds->priv = NULL;
     }
-#endif
 
-  return status;
+  net_unlock();
+  return slot != NULL ? OK : -EIO;
 }
 
 #endif /* HAVE_LOCAL_POLL */
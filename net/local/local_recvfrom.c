@@ -42,7 +42,8 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <unistd.h>
+#include <sys/uio.h>
+#include <queue.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -53,65 +54,69 @@
 #include "local/local.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-#ifndef MIN
-#  define MIN(a,b) ((a) < (b) ? (a) : (b))
-#endif
-
 /****************************************************************************
- * Private Functions
+ * Name: local_recvaddr
+ *
+ * Description:
+ *   Return the address of the sender in msg->msg_name (if requested).
+ *
  ****************************************************************************/
 
+static void local_recvaddr(FAR struct msghdr *msg, FAR const char *path)
+{
+  socklen_t namelen;
+
+  if (msg->msg_name != NULL && msg->msg_namelen >= sizeof(sa_family_t))
+    {
+      namelen = msg->msg_namelen;
+      (void)local_getaddr(path, (FAR struct sockaddr *)msg->msg_name,
+                          &namelen);
+      msg->msg_namelen = namelen;
+    }
+}
+
 /****************************************************************************
- * Name: psock_fifo_read
+ * Name: local_rxwait
  *
  * Description:
- *   A thin layer around local_fifo_read that handles socket-related loss-of-
- *   connection events.
+ *   Wait until there is a message in the receive queue of 'conn'.
+ *
+ * Returned Value:
+ *   Zero (OK) if there is a message; a negated errno value otherwise.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
-                           FAR size_t *readlen)
+static int local_rxwait(FAR struct local_conn_s *conn, bool nonblock)
 {
-  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
   int ret;
 
-  ret = local_fifo_read(&conn->lc_infile, buf, readlen);
-  if (ret < 0)
+  while (sq_empty(&conn->lc_rxq))
     {
-      /* -ECONNRESET is a special case.  We may or not have received
-       * data, then the peer closed the connection.
-       */
+#ifdef CONFIG_NET_LOCAL_STREAM
+      /* An orderly shutdown of a stream is reported as end-of-file */
 
-      if (ret == -ECONNRESET)
+      if (conn->lc_proto == SOCK_STREAM &&
+          conn->lc_state != LOCAL_STATE_CONNECTED)
         {
-          nerr("ERROR: Lost connection: %d\n", ret);
-
-          /* Report an ungraceful loss of connection.  This should
-           * eventually be reported as ENOTCONN.
-           */
-
-          psock->s_flags &= ~(_SF_CONNECTED | _SF_CLOSED);
-          conn->lc_state  = LOCAL_STATE_DISCONNECTED;
-
-          /* Did we receive any data? */
-
-          if (*readlen <= 0)
-            {
-              /* No.. return the ECONNRESET error now.  Otherwise,
-               * process the received data and return ENOTCONN the
-               * next time that psock_recvfrom() is calle.
-               */
+          return conn->lc_state == LOCAL_STATE_DISCONNECTED ?
+                 -ECONNRESET : -ENOTCONN;
+        }
+#endif
 
-              return ret;
-            }
+      if (nonblock)
+        {
+          return -EAGAIN;
         }
-      else
+
+      ret = net_lockedwait(&conn->lc_rxsem);
+      if (ret < 0)
         {
-          nerr("ERROR: Failed to read packet: %d\n", ret);
           return ret;
         }
     }
@@ -120,139 +125,103 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 }
 
 /****************************************************************************
- * Name: psock_stream_recvfrom
+ * Name: local_stream_recvmsg
  *
  * Description:
- *   psock_stream_recvfrom() receives messages from a local stream socket.
- *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Buffer to receive data
- *   len      Length of buffer
- *   flags    Receive flags
- *   from     Address of source (may be NULL)
- *   fromlen  The length of the address structure
+ *   Receive data from a local stream socket.  Data is copied out of as many
+ *   queued messages as fit into the caller's buffers.
  *
  * Returned Value:
  *   On success, returns the number of characters received.  If no data is
  *   available to be received and the peer has performed an orderly shutdown,
- *   recv() will return 0.  Otherwise, on errors, -1 is returned, and errno
- *   is set appropriately (see receive from for the complete list).
+ *   zero is returned.  Otherwise, a negated errno value is returned.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-static inline ssize_t
-psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                      int flags, FAR struct sockaddr *from,
-                      FAR socklen_t *fromlen)
+static ssize_t local_stream_recvmsg(FAR struct socket *psock,
+                                    FAR struct msghdr *msg, size_t buflen,
+                                    bool nonblock,
+                                    FAR struct local_rights_s **rights)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
-  size_t readlen;
+  FAR struct local_msg_s *lmsg;
+  size_t nrecv = 0;
   int ret;
 
-  /* Verify that this is a connected peer socket */
-
-  if (conn->lc_state != LOCAL_STATE_CONNECTED)
+  net_lock();
+  ret = local_rxwait(conn, nonblock);
+  if (ret < 0)
     {
-      nerr("ERROR: not connected\n");
-      return -ENOTCONN;
-    }
-
-  /* The incoming FIFO should be open */
-
-  DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+      /* Report the orderly shutdown of the connection as end-of-file */
 
-  /* Are there still bytes in the FIFO from the last packet? */
+      net_unlock();
+      return ret == -ECONNRESET ? 0 : ret;
+    }
 
-  if (conn->u.peer.lc_remaining == 0)
+  while (nrecv < buflen &&
+         (lmsg = (FAR struct local_msg_s *)sq_peek(&conn->lc_rxq)) != NULL)
     {
-      /* No.. Sync to the start of the next packet in the stream and get
-       * the size of the next packet.
+#ifdef CONFIG_NET_LOCAL_SCM
+      /* Passed descriptors are received with the first byte of their
+       * message.  Do not merge them into a read that already has data.
        */
 
-      ret = local_sync(&conn->lc_infile);
-      if (ret < 0)
-        {
-          nerr("ERROR: Failed to get packet length: %d\n", ret);
-          return ret;
-        }
-      else if (ret > UINT16_MAX)
+      if (lmsg->lm_rights != NULL)
         {
-          nerr("ERROR: Packet is too big: %d\n", ret);
-          return -E2BIG;
-        }
-
-      conn->u.peer.lc_remaining = (uint16_t)ret;
-    }
-
-  /* Read the packet */
-
-  readlen = MIN(conn->u.peer.lc_remaining, len);
-  ret     = psock_fifo_read(psock, buf, &readlen);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Adjust the number of bytes remaining to be read from the packet */
+          if (nrecv > 0)
+            {
+              break;
+            }
 
-  DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
-  conn->u.peer.lc_remaining -= readlen;
+          *rights         = lmsg->lm_rights;
+          lmsg->lm_rights = NULL;
+        }
+#endif
 
-  /* Return the address family */
+      nrecv += local_msg_copyout(conn, lmsg, msg->msg_iov, msg->msg_iovlen,
+                                 nrecv, buflen - nrecv);
 
-  if (from)
-    {
-      ret = local_getaddr(conn, from, fromlen);
-      if (ret < 0)
+      if (lmsg->lm_offset >= lmsg->lm_len)
         {
-          return ret;
+          local_msg_complete(conn, lmsg, OK);
         }
     }
 
-  return readlen;
+  /* There may now be room for a waiting sender */
+
+  local_txnotify(conn);
+  local_recvaddr(msg, conn->lc_path);
+
+  net_unlock();
+  return nrecv;
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
 /****************************************************************************
- * Name: psock_dgram_recvfrom
+ * Name: local_dgram_recvmsg
  *
  * Description:
- *   psock_dgram_recvfrom() receives messages from a local datagram socket.
- *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Buffer to receive data
- *   len      Length of buffer
- *   flags    Receive flags
- *   from     Address of source (may be NULL)
- *   fromlen  The length of the address structure
+ *   Receive one datagram from a local datagram socket.  The part of the
+ *   datagram that does not fit into the caller's buffers is discarded.
  *
  * Returned Value:
- *   On success, returns the number of characters received.  Otherwise, on
- *   errors, -1 is returned, and errno is set appropriately (see receive
- *   from for the complete list).
+ *   On success, returns the number of characters received.  Otherwise, a
+ *   negated errno value is returned.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
-static inline ssize_t
-psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                     int flags, FAR struct sockaddr *from,
-                     FAR socklen_t *fromlen)
+static ssize_t local_dgram_recvmsg(FAR struct socket *psock,
+                                   FAR struct msghdr *msg, size_t buflen,
+                                   bool nonblock,
+                                   FAR struct local_rights_s **rights)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
-  uint16_t pktlen;
-  size_t readlen;
+  FAR struct local_msg_s *lmsg;
+  ssize_t nrecv;
   int ret;
 
-  /* We keep packet sizes in a uint16_t, so there is a upper limit to the
-   * 'len' that can be supported.
-   */
-
-  DEBUGASSERT(len <= UINT16_MAX);
-
   /* Verify that this is a bound, un-connected peer socket */
 
   if (conn->lc_state != LOCAL_STATE_BOUND)
@@ -263,128 +232,127 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -EISCONN;
     }
 
-  /* The incoming FIFO should not be open */
-
-  DEBUGASSERT(conn->lc_infile.f_inode == NULL);
-
-  /* Make sure that half duplex FIFO has been created */
-
-  ret = local_create_halfduplex(conn, conn->lc_path);
+  net_lock();
+  ret = local_rxwait(conn, nonblock);
   if (ret < 0)
     {
-      nerr("ERROR: Failed to create FIFO for %s: %d\n",
-           conn->lc_path, ret);
+      net_unlock();
       return ret;
     }
 
-  /* Open the receiving side of the transfer */
-
-  ret = local_open_receiver(conn, _SS_ISNONBLOCK(psock->s_flags));
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to open FIFO for %s: %d\n",
-           conn->lc_path, ret);
-      goto errout_with_halfduplex;
-      return ret;
-    }
+  lmsg = (FAR struct local_msg_s *)sq_peek(&conn->lc_rxq);
+  DEBUGASSERT(lmsg != NULL);
 
-  /* Sync to the start of the next packet in the stream and get the size of
-   * the next packet.
-   */
+#ifdef CONFIG_NET_LOCAL_SCM
+  *rights         = lmsg->lm_rights;
+  lmsg->lm_rights = NULL;
+#endif
 
-  ret = local_sync(&conn->lc_infile);
-  if (ret < 0)
+  nrecv = local_msg_copyout(conn, lmsg, msg->msg_iov, msg->msg_iovlen, 0,
+                            buflen);
+  if ((size_t)nrecv < lmsg->lm_len)
     {
-      nerr("ERROR: Failed to get packet length: %d\n", ret);
-      goto errout_with_infd;
-    }
-  else if (ret > UINT16_MAX)
-    {
-      nerr("ERROR: Packet is too big: %d\n", ret);
-      goto errout_with_infd;
+      msg->msg_flags |= MSG_TRUNC;
     }
 
-  pktlen = ret;
+  /* Return the address of the sender, then discard the datagram */
 
-  /* Read the packet */
+  local_recvaddr(msg, lmsg->lm_path);
+  local_msg_complete(conn, lmsg, OK);
+  local_txnotify(conn);
 
-  readlen = MIN(pktlen, len);
-  ret     = psock_fifo_read(psock, buf, &readlen);
-  if (ret < 0)
-    {
-      goto errout_with_infd;
-    }
-
-  /* If there are unread bytes remaining in the packet, flush the remainder
-   * of the packet to the bit bucket.
-   */
+  net_unlock();
+  return nrecv;
+}
+#endif /* CONFIG_NET_LOCAL_DGRAM */
 
-  DEBUGASSERT(readlen <= pktlen);
-  if (readlen < pktlen)
-    {
-      uint8_t bitbucket[32];
-      uint16_t remaining;
-      size_t tmplen;
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      remaining = pktlen - readlen;
-      do
-        {
-          /* Read 32 bytes into the bit bucket */
+/****************************************************************************
+ * Name: local_recvmsg
+ *
+ * Description:
+ *   local_recvmsg() receives messages from a local socket and may be used
+ *   to receive data on a socket whether or not it is connection-oriented.
+ *   The data is scattered into the buffers of msg->msg_iov.  Descriptors
+ *   passed by the sender are returned in the SCM_RIGHTS control message.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffers to receive the message and, optionally, its source
+ *            address and control data
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   zero is returned.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvmsg() for the complete list of appropriate error
+ *   values).
+ *
+ ****************************************************************************/
 
-          readlen = MIN(remaining, 32);
-          ret     = psock_fifo_read(psock, bitbucket, &tmplen);
-          if (ret < 0)
-            {
-              goto errout_with_infd;
-            }
+ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR struct local_rights_s *rights = NULL;
+  size_t buflen;
+  ssize_t ret;
+  bool nonblock;
+  unsigned long i;
 
-          /* Adjust the number of bytes remaining to be read from the packet */
+  DEBUGASSERT(psock && psock->s_conn && msg);
 
-          DEBUGASSERT(tmplen <= remaining);
-          remaining -= tmplen;
-        }
-      while (remaining > 0);
+  for (i = 0, buflen = 0; i < msg->msg_iovlen; i++)
+    {
+      buflen += msg->msg_iov[i].iov_len;
     }
 
-  /* Now we can close the read-only file descriptor */
-
-  file_close(&conn->lc_infile);
-  conn->lc_infile.f_inode = NULL;
-
-  /* Release our reference to the half duplex FIFO */
-
-  (void)local_release_halfduplex(conn);
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
 
-  /* Return the address family */
+  /* Check for a stream socket */
 
-  if (from)
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (psock->s_type == SOCK_STREAM)
     {
-      ret = local_getaddr(conn, from, fromlen);
-      if (ret < 0)
-        {
-          return ret;
-        }
+      ret = local_stream_recvmsg(psock, msg, buflen, nonblock, &rights);
     }
+  else
+#endif
 
-  return readlen;
-
-errout_with_infd:
-  /* Close the read-only file descriptor */
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      ret = local_dgram_recvmsg(psock, msg, buflen, nonblock, &rights);
+    }
+  else
+#endif
+    {
+      DEBUGPANIC();
+      nerr("ERROR: Unrecognized socket type: %d\n", psock->s_type);
+      ret = -EINVAL;
+    }
 
-  file_close(&conn->lc_infile);
-  conn->lc_infile.f_inode = NULL;
+  /* Install any passed descriptors in the receiving task.  That must be
+   * done with the network unlocked.
+   */
 
-errout_with_halfduplex:
-  /* Release our reference to the half duplex FIFO */
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (rights != NULL)
+    {
+      local_rights_recv(rights, msg);
+    }
+  else
+#endif
+  if (ret >= 0)
+    {
+      msg->msg_controllen = 0;
+    }
 
-  (void)local_release_halfduplex(conn);
   return ret;
 }
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
 
 /****************************************************************************
  * Name: local_recvfrom
@@ -419,30 +387,30 @@ ssize_t local_recvfrom(FAR struct socket *psock, FAR void *buf,
                        size_t len, int flags, FAR struct sockaddr *from,
                        FAR socklen_t *fromlen)
 {
+  struct msghdr msg;
+  struct iovec iov;
+  ssize_t ret;
+
   DEBUGASSERT(psock && psock->s_conn && buf);
 
-  /* Check for a stream socket */
+  iov.iov_base       = buf;
+  iov.iov_len        = len;
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-  if (psock->s_type == SOCK_STREAM)
-    {
-      return psock_stream_recvfrom(psock, buf, len, flags, from, fromlen);
-    }
-  else
-#endif
+  msg.msg_name       = from;
+  msg.msg_namelen    = (from != NULL && fromlen != NULL) ? *fromlen : 0;
+  msg.msg_iov        = &iov;
+  msg.msg_iovlen     = 1;
+  msg.msg_control    = NULL;
+  msg.msg_controllen = 0;
+  msg.msg_flags      = 0;
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-  if (psock->s_type == SOCK_DGRAM)
-    {
-      return psock_dgram_recvfrom(psock, buf, len, flags, from, fromlen);
-    }
-  else
-#endif
+  ret = local_recvmsg(psock, &msg, flags);
+  if (ret >= 0 && from != NULL && fromlen != NULL)
     {
-      DEBUGPANIC();
-      nerr("ERROR: Unrecognized socket type: %s\n", psock->s_type);
-      return -EINVAL;
+      *fromlen = msg.msg_namelen;
     }
+
+  return ret;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL */
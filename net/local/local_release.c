@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
 
+#include <sys/socket.h>
 #include <semaphore.h>
 #include <errno.h>
 #include <queue.h>
@@ -48,8 +49,6 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 
-#include <arch/irq.h>
-
 #include "local/local.h"
 
 /****************************************************************************
@@ -88,9 +87,26 @@ int local_release(FAR struct local_conn_s *conn)
   if (conn->lc_state == LOCAL_STATE_CONNECTED ||
       conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
+      FAR struct local_conn_s *peer = conn->lc_peer;
+
       DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
 
-      /* Just free the connection structure */
+      /* Disconnect the peer.  It will read any data that is still queued
+       * for it and then see the end-of-file.  Wake up threads that may be
+       * waiting to send or receive on it.
+       */
+
+      if (peer != NULL)
+        {
+          DEBUGASSERT(peer->lc_peer == conn);
+
+          peer->lc_peer  = NULL;
+          peer->lc_state = LOCAL_STATE_DISCONNECTED;
+
+          local_wakeup(&peer->lc_rxsem);
+          local_wakeup(&peer->lc_txsem);
+          local_pollnotify(peer, POLLHUP | POLLIN);
+        }
     }
 
   /* Is the socket is listening socket (SOCK_STREAM server) */
@@ -119,11 +135,26 @@ int local_release(FAR struct local_conn_s *conn)
     }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  /* Is this a datagram socket bound to a path? */
+
+  if (conn->lc_proto == SOCK_DGRAM && conn->lc_state == LOCAL_STATE_BOUND &&
+      conn->lc_type == LOCAL_TYPE_PATHNAME)
+    {
+      /* Remove it from the list of datagram receivers.  Senders waiting
+       * for room in its receive queue will find that it is gone.
+       */
+
+      dq_rem(&conn->lc_node, &g_local_dgrams);
+      local_wakeup(&g_local_dgramsem);
+    }
+#endif
+
   /* For the remaining states (LOCAL_STATE_UNBOUND and LOCAL_STATE_UNBOUND),
    * we simply free the connection structure.
    */
 
-  /* Free the connection structure */
+  /* Free the connection structure.  Any unread messages are discarded. */
 
   local_free(conn);
   net_unlock();
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * net/local/local_scm.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_SCM)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_fd_dup
+ *
+ * Description:
+ *   Take a reference to the open file or socket 'fd' of the sending task.
+ *
+ ****************************************************************************/
+
+static int local_fd_dup(int fd, FAR struct local_fd_s *lfd)
+{
+  FAR struct socket *psock;
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+  int ret;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      lfd->lf_issock = false;
+      return file_dup2(filep, &lfd->u.lf_file);
+    }
+#endif
+
+  psock = sockfd_socket(fd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  lfd->lf_issock = true;
+  return net_clone(psock, &lfd->u.lf_sock);
+}
+
+/****************************************************************************
+ * Name: local_fd_install
+ *
+ * Description:
+ *   Create a new descriptor in the receiving task that refers to the same
+ *   open file or socket as 'lfd'.
+ *
+ * Returned Value:
+ *   The new descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int local_fd_install(FAR struct local_fd_s *lfd)
+{
+  FAR struct socket *psock;
+  int sockfd;
+  int ret;
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  if (!lfd->lf_issock)
+    {
+      return file_dup(&lfd->u.lf_file, 0);
+    }
+#endif
+
+  sockfd = sockfd_allocate(0);
+  if (sockfd < 0)
+    {
+      return -ENFILE;
+    }
+
+  psock = sockfd_socket(sockfd);
+  DEBUGASSERT(psock != NULL);
+
+  ret = net_clone(&lfd->u.lf_sock, psock);
+  if (ret < 0)
+    {
+      sockfd_release(sockfd);
+      return ret;
+    }
+
+  return sockfd;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_rights_alloc
+ *
+ * Description:
+ *   Take references to all descriptors passed in the SCM_RIGHTS control
+ *   messages of 'msg'.  The references keep the files and sockets open
+ *   while the message is in flight, even if the sender closes them.
+ *
+ * Input Parameters:
+ *   msg    - The message passed to sendmsg()
+ *   rights - Location to return the allocated structure.  NULL is returned
+ *            if there are no SCM_RIGHTS control messages.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_rights_alloc(FAR struct msghdr *msg,
+                       FAR struct local_rights_s **rights)
+{
+  FAR struct local_rights_s *lr = NULL;
+  FAR struct cmsghdr *cmsg;
+  FAR const int *fds;
+  FAR uint8_t *ctlend;
+  int nfds;
+  int ret;
+  int i;
+
+  *rights = NULL;
+  ctlend  = (FAR uint8_t *)msg->msg_control + msg->msg_controllen;
+
+  for (cmsg = CMSG_FIRSTHDR(msg);
+       cmsg != NULL;
+       cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+      if (cmsg->cmsg_len < CMSG_LEN(0) ||
+          (FAR uint8_t *)cmsg + cmsg->cmsg_len > ctlend)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      /* Other types of control data are ignored */
+
+      if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+        {
+          continue;
+        }
+
+      if (lr == NULL)
+        {
+          lr = (FAR struct local_rights_s *)
+            kmm_zalloc(sizeof(struct local_rights_s));
+          if (lr == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+
+      fds  = (FAR const int *)CMSG_DATA(cmsg);
+      nfds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+      if (lr->lr_nfds + nfds > LOCAL_NCONTROLFDS)
+        {
+          ret = -ETOOMANYREFS;
+          goto errout;
+        }
+
+      for (i = 0; i < nfds; i++)
+        {
+          ret = local_fd_dup(fds[i], &lr->lr_fds[lr->lr_nfds]);
+          if (ret < 0)
+            {
+              nerr("ERROR: Cannot pass descriptor %d: %d\n", fds[i], ret);
+              goto errout;
+            }
+
+          lr->lr_nfds++;
+        }
+    }
+
+  *rights = lr;
+  return OK;
+
+errout:
+  if (lr != NULL)
+    {
+      local_rights_free(lr);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_rights_recv
+ *
+ * Description:
+ *   Install the passed descriptors in the receiving task and return them in
+ *   one SCM_RIGHTS control message.  Descriptors that do not fit into the
+ *   control buffer are closed and MSG_CTRUNC is reported.  The structure is
+ *   freed in any event.
+ *
+ * Assumptions:
+ *   The network is NOT locked.
+ *
+ ****************************************************************************/
+
+void local_rights_recv(FAR struct local_rights_s *rights,
+                       FAR struct msghdr *msg)
+{
+  FAR struct cmsghdr *cmsg;
+  FAR int *fds;
+  int maxfds = 0;
+  int nfds = 0;
+  int fd;
+  int i;
+
+  cmsg = CMSG_FIRSTHDR(msg);
+  if (cmsg != NULL && msg->msg_controllen >= CMSG_LEN(0))
+    {
+      maxfds = (msg->msg_controllen - CMSG_LEN(0)) / sizeof(int);
+    }
+
+  for (i = 0; i < rights->lr_nfds; i++)
+    {
+      if (nfds >= maxfds)
+        {
+          msg->msg_flags |= MSG_CTRUNC;
+          break;
+        }
+
+      fd = local_fd_install(&rights->lr_fds[i]);
+      if (fd < 0)
+        {
+          nerr("ERROR: Failed to install descriptor: %d\n", fd);
+          msg->msg_flags |= MSG_CTRUNC;
+          continue;
+        }
+
+      fds = (FAR int *)CMSG_DATA(cmsg);
+      fds[nfds++] = fd;
+    }
+
+  if (nfds > 0)
+    {
+      cmsg->cmsg_len      = CMSG_LEN(nfds * sizeof(int));
+      cmsg->cmsg_level    = SOL_SOCKET;
+      cmsg->cmsg_type     = SCM_RIGHTS;
+      msg->msg_controllen = CMSG_LEN(nfds * sizeof(int));
+    }
+  else
+    {
+      msg->msg_controllen = 0;
+    }
+
+  /* Release the in-flight references */
+
+  local_rights_free(rights);
+}
+
+/****************************************************************************
+ * Name: local_rights_free
+ *
+ * Description:
+ *   Release the in-flight references to passed descriptors and free the
+ *   structure.
+ *
+ ****************************************************************************/
+
+void local_rights_free(FAR struct local_rights_s *rights)
+{
+  int i;
+
+  for (i = 0; i < rights->lr_nfds; i++)
+    {
+      if (rights->lr_fds[i].lf_issock)
+        {
+          (void)psock_close(&rights->lr_fds[i].u.lf_sock);
+        }
+#if CONFIG_NFILE_DESCRIPTORS > 0
+      else
+        {
+          (void)file_close(&rights->lr_fds[i].u.lf_file);
+        }
+#endif
+    }
+
+  kmm_free(rights);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_SCM */
@@ -62,9 +62,11 @@
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags (ignored for now)
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
+ *   flags    Send flags
+ *   rights   Descriptors to pass with the data (may be NULL).  These are
+ *            always consumed.
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -73,33 +75,17 @@
  *
  ****************************************************************************/
 
-ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags)
+ssize_t psock_local_send(FAR struct socket *psock,
+                         FAR const struct iovec *iov, int iovcnt, int flags,
+                         FAR struct local_rights_s *rights)
 {
-  FAR struct local_conn_s *peer;
-  int ret;
+  DEBUGASSERT(psock && psock->s_conn && iov);
 
-  DEBUGASSERT(psock && psock->s_conn && buf);
-  peer = (FAR struct local_conn_s *)psock->s_conn;
-
-  /* Verify that this is a connected peer socket and that it has opened the
-   * outgoing FIFO for write-only access.
+  /* Send the packet directly to the receive queue of the connected peer.
+   * local_send_packet() will verify that the socket is connected.
    */
 
-  if (peer->lc_state != LOCAL_STATE_CONNECTED ||
-      peer->lc_outfile.f_inode == NULL)
-    {
-      nerr("ERROR: not connected\n");
-      return -ENOTCONN;
-    }
-
-  /* Send the packet */
-
-  ret = local_send_packet(&peer->lc_outfile, (FAR uint8_t *)buf, len);
-
-  /* If the send was successful, then the full packet will have been sent */
-
-  return ret < 0 ? ret : len;
+  return local_send_packet(psock, iov, iovcnt, flags, NULL, rights);
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
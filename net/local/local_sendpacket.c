@@ -40,14 +40,19 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdint.h>
-#include <unistd.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
-#include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
@@ -56,67 +61,276 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LOCAL_PREAMBLE_SIZE 8
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
 
 /****************************************************************************
- * Private Data
+ * Private Functions
  ****************************************************************************/
 
-static const uint8_t g_preamble[LOCAL_PREAMBLE_SIZE] =
-{
-  LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE,
-  LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_END_BYTE
-};
-
 /****************************************************************************
- * Private Functions
+ * Name: local_receiver
+ *
+ * Description:
+ *   Return the connection that receives the data sent on 'conn':  The
+ *   connected peer of a SOCK_STREAM socket or the SOCK_DGRAM socket bound
+ *   to 'path'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
  ****************************************************************************/
 
+static FAR struct local_conn_s *
+local_receiver(FAR struct local_conn_s *conn, FAR const char *path,
+               FAR int *errcode)
+{
+  FAR struct local_conn_s *receiver = NULL;
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+  if (conn->lc_proto == SOCK_STREAM)
+    {
+      receiver = conn->lc_peer;
+      if (conn->lc_state != LOCAL_STATE_CONNECTED || receiver == NULL)
+        {
+          nerr("ERROR: not connected\n");
+          *errcode = conn->lc_state == LOCAL_STATE_DISCONNECTED ?
+                     -EPIPE : -ENOTCONN;
+          return NULL;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      receiver = local_findconn(path, SOCK_DGRAM);
+      if (receiver == NULL)
+        {
+          nerr("ERROR: No socket bound to %s\n", path);
+          *errcode = -ECONNREFUSED;
+          return NULL;
+        }
+    }
+#endif
+
+  if (receiver == NULL)
+    {
+      *errcode = -EINVAL;
+    }
+
+  return receiver;
+}
+
 /****************************************************************************
- * Name: local_fifo_write
+ * Name: local_txwait
  *
  * Description:
- *   Write a data on the write-only FIFO.
+ *   Wait for room in the receive queue of the receiver.
  *
- * Input Parameters:
- *   filep    File structure of write-only FIFO.
- *   buf      Data to send
- *   len      Length of data to send
+ * Assumptions:
+ *   The network is locked.
  *
- * Returned Value:
- *   Zero is returned on success; a negated errno value is returned on any
- *   failure.
+ ****************************************************************************/
+
+static int local_txwait(FAR struct local_conn_s *conn)
+{
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      /* A datagram receiver does not know its senders */
+
+      return net_lockedwait(&g_local_dgramsem);
+    }
+#endif
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+  return net_lockedwait(&conn->lc_txsem);
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: local_iob_copyin
+ *
+ * Description:
+ *   Copy 'len' bytes, beginning 'iovoff' bytes into the buffers described
+ *   by 'iov', into an IOB chain.
  *
  ****************************************************************************/
 
-static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
-                            size_t len)
+static int local_iob_copyin(FAR struct iob_s *iob,
+                            FAR const struct iovec *iov, int iovcnt,
+                            size_t iovoff, size_t len, bool nonblock)
 {
-  ssize_t nwritten;
+  FAR const uint8_t *src;
+  unsigned int offset = 0;
+  size_t ncopy;
+  int ret;
+  int i;
 
-  while (len > 0)
+  for (i = 0; i < iovcnt && len > 0; i++)
     {
-      nwritten = file_write(filep, buf, len);
-      if (nwritten < 0)
+      if (iovoff >= iov[i].iov_len)
+        {
+          iovoff -= iov[i].iov_len;
+          continue;
+        }
+
+      src    = (FAR const uint8_t *)iov[i].iov_base + iovoff;
+      ncopy  = MIN(iov[i].iov_len - iovoff, len);
+      len   -= ncopy;
+      iovoff = 0;
+
+      /* iob_copyin() will not block once it has copied some data so it
+       * may have to be called more than once.
+       */
+
+      while (ncopy > 0)
         {
-          if (nwritten != -EINTR)
+          if (nonblock)
             {
-              nerr("ERROR: nx_write failed: %d\n", nwritten);
-              return (int)nwritten;
+              ret = iob_trycopyin(iob, src, ncopy, offset, true);
+            }
+          else
+            {
+              ret = iob_copyin(iob, src, ncopy, offset, true);
             }
 
-          ninfo("Ignoring signal\n");
+          if (ret <= 0)
+            {
+              nerr("ERROR: Failed to buffer the message: %d\n", ret);
+              return nonblock ? -EAGAIN : -ENOMEM;
+            }
+
+          offset += ret;
+          src    += ret;
+          ncopy  -= ret;
         }
-      else
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_send_handoff
+ *
+ * Description:
+ *   Send a large message without buffering it.  The message refers to the
+ *   caller's buffers and the caller waits until the receiver has copied
+ *   the data out of them directly.
+ *
+ * Returned Value:
+ *   The number of bytes sent or a negated errno value.  Zero is returned
+ *   if no receiver is waiting; the message must then be buffered.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_HANDOFF
+static ssize_t local_send_handoff(FAR struct local_conn_s *conn,
+                                  FAR const struct iovec *iov, int iovcnt,
+                                  size_t len, FAR const char *path,
+                                  FAR struct local_rights_s *rights)
+{
+  FAR struct local_conn_s *receiver;
+  struct local_msg_s msg;
+  ssize_t ret;
+  int errcode;
+  int sval;
+
+  memset(&msg, 0, sizeof(struct local_msg_s));
+  msg.lm_len    = len;
+  msg.lm_iov    = iov;
+  msg.lm_iovcnt = iovcnt;
+#ifdef CONFIG_NET_LOCAL_SCM
+  msg.lm_rights = rights;
+#endif
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_type == LOCAL_TYPE_PATHNAME)
+    {
+      strncpy(msg.lm_path, conn->lc_path, UNIX_PATH_MAX - 1);
+    }
+#endif
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&msg.lm_donesem, 0, 0);
+  nxsem_setprotocol(&msg.lm_donesem, SEM_PRIO_NONE);
+
+  net_lock();
+  receiver = local_receiver(conn, path, &errcode);
+  if (receiver == NULL)
+    {
+      ret = errcode;
+      goto errout_with_lock;
+    }
+
+  /* Only hand the message to a receiver that is already blocked in recv()
+   * with nothing queued.  Otherwise the sender would wait until the
+   * receiver next reads, which never happens if the receiver is this same
+   * thread, and the data would not be limited by CONFIG_NET_LOCAL_RCVBUF.
+   */
+
+  if (!sq_empty(&receiver->lc_rxq) ||
+      nxsem_getvalue(&receiver->lc_rxsem, &sval) < 0 || sval >= 0)
+    {
+      /* The caller still owns the descriptors */
+
+#ifdef CONFIG_NET_LOCAL_SCM
+      msg.lm_rights = NULL;
+#endif
+      ret = 0;
+      goto errout_with_lock;
+    }
+
+  local_msg_enqueue(receiver, &msg);
+
+  /* Wait until the receiver has taken all of the data.  The message is
+   * removed from the queue when it has been received or discarded.
+   */
+
+  while (msg.lm_conn != NULL)
+    {
+      errcode = net_lockedwait(&msg.lm_donesem);
+      if (errcode < 0 && msg.lm_conn != NULL)
         {
-          DEBUGASSERT(nwritten > 0 && nwritten <= len);
-          len -= nwritten;
-          buf += nwritten;
+          /* Interrupted by a signal.  Withdraw the rest of the message. */
+
+          local_msg_complete(msg.lm_conn, &msg, errcode);
         }
     }
 
-  return OK;
+  /* A stream reports the part of the message that was received */
+
+  if (conn->lc_proto == SOCK_STREAM && msg.lm_offset > 0)
+    {
+      ret = msg.lm_offset;
+    }
+  else
+    {
+      ret = msg.lm_result < 0 ? msg.lm_result : (ssize_t)len;
+    }
+
+errout_with_lock:
+  net_unlock();
+  nxsem_destroy(&msg.lm_donesem);
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  /* Release any descriptors that were not delivered */
+
+  if (msg.lm_rights != NULL)
+    {
+      local_rights_free(msg.lm_rights);
+    }
+#endif
+
+  return ret;
 }
+#endif /* HAVE_LOCAL_HANDOFF */
 
 /****************************************************************************
  * Public Functions
@@ -126,44 +340,190 @@ static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
  * Name: local_send_packet
  *
  * Description:
- *   Send a packet on the write-only FIFO.
+ *   Send one message to a local socket:  To the connected peer of a
+ *   SOCK_STREAM socket or to the SOCK_DGRAM socket bound to 'path'.  The
+ *   packet data is gathered from all of the buffers.
+ *
+ *   The data is copied into an IOB chain and placed directly in the
+ *   receive queue of the receiving socket.  If that queue already holds
+ *   CONFIG_NET_LOCAL_RCVBUF bytes, the sender waits for the receiver.
+ *   Stream data is split into chunks of at most that size.
  *
  * Input Parameters:
- *   filep    File structure of write-only FIFO.
- *   buf      Data to send
- *   len      Length of data to send
+ *   psock    The sending socket
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
+ *   flags    Send flags
+ *   path     Destination path (SOCK_DGRAM only)
+ *   rights   Descriptors to pass with the data (may be NULL)
  *
  * Returned Value:
- *   Zero is returned on success; a negated errno value is returned on any
- *   failure.
+ *   The number of bytes sent is returned on success; a negated errno value
+ *   is returned on any failure.
  *
  ****************************************************************************/
 
-int local_send_packet(FAR struct file *filep, FAR const uint8_t *buf,
-                      size_t len)
+ssize_t local_send_packet(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const char *path,
+                          FAR struct local_rights_s *rights)
 {
-  uint16_t len16;
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR struct local_conn_s *receiver;
+  FAR struct local_msg_s *msg = NULL;
+  bool nonblock;
+  size_t sent = 0;
+  size_t seglen;
+  size_t len;
   int ret;
+  int i;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
 
-  /* Send the packet preamble */
+  /* There is nothing to send in an empty stream write */
 
-  ret = local_fifo_write(filep, g_preamble, LOCAL_PREAMBLE_SIZE);
-  if (ret == OK)
+  if (conn->lc_proto == SOCK_STREAM && len == 0)
     {
-      /* Send the packet length */
+      ret = 0;
+      goto errout;
+    }
+
+#ifdef HAVE_LOCAL_HANDOFF
+  /* Large messages are handed off directly to a waiting receiver, unless
+   * the caller cannot wait for the receiver.
+   */
 
-      len16 = len;
-      ret = local_fifo_write(filep, (FAR const uint8_t *)&len16,
-                             sizeof(uint16_t));
-      if (ret == OK)
+  if (!nonblock && len > CONFIG_NET_LOCAL_HANDOFF)
+    {
+      ssize_t nsent;
+
+      nsent = local_send_handoff(conn, iov, iovcnt, len, path, rights);
+      if (nsent != 0)
         {
-          /* Send the packet data */
+          return nsent;
+        }
+    }
+#endif
+
+  /* A datagram must fit into one IOB chain */
+
+  if (conn->lc_proto != SOCK_STREAM && len > UINT16_MAX)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
 
-          ret = local_fifo_write(filep, buf, len);
+  do
+    {
+      seglen = len - sent;
+      if (conn->lc_proto == SOCK_STREAM && seglen > CONFIG_NET_LOCAL_RCVBUF)
+        {
+          seglen = CONFIG_NET_LOCAL_RCVBUF;
         }
+
+      /* Buffer the data before locking the network.  We may have to wait
+       * for a message descriptor or for I/O buffers.
+       */
+
+      msg = local_msg_alloc(nonblock);
+      if (msg == NULL)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      msg->lm_len = seglen;
+      msg->lm_iob = nonblock ? iob_tryalloc(true) : iob_alloc(true);
+      if (msg->lm_iob == NULL)
+        {
+          nerr("ERROR: Failed to allocate I/O buffer\n");
+          ret = nonblock ? -EAGAIN : -ENOMEM;
+          goto errout_with_msg;
+        }
+
+      ret = local_iob_copyin(msg->lm_iob, iov, iovcnt, sent, seglen,
+                             nonblock);
+      if (ret < 0)
+        {
+          goto errout_with_msg;
+        }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+      /* Passed descriptors travel with the first byte of the message */
+
+      msg->lm_rights = rights;
+      rights         = NULL;
+#endif
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+      if (conn->lc_type == LOCAL_TYPE_PATHNAME)
+        {
+          strncpy(msg->lm_path, conn->lc_path, UNIX_PATH_MAX - 1);
+        }
+#endif
+
+      /* Find the receiver and wait until there is room in its queue.  A
+       * message is always accepted into an empty queue so that one large
+       * datagram cannot stall the receiver forever.
+       */
+
+      net_lock();
+      for (; ; )
+        {
+          receiver = local_receiver(conn, path, &ret);
+          if (receiver == NULL)
+            {
+              goto errout_with_lock;
+            }
+
+          if (receiver->lc_rxlen == 0 ||
+              receiver->lc_rxlen + seglen <= CONFIG_NET_LOCAL_RCVBUF)
+            {
+              break;
+            }
+
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = local_txwait(conn);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+
+      local_msg_enqueue(receiver, msg);
+      net_unlock();
+
+      sent += seglen;
     }
+  while (sent < len);
 
-  return ret;
+  return sent;
+
+errout_with_lock:
+  net_unlock();
+
+errout_with_msg:
+  local_msg_free(msg);
+
+errout:
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (rights != NULL)
+    {
+      local_rights_free(rights);
+    }
+#endif
+
+  return sent > 0 ? (ssize_t)sent : ret;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL */
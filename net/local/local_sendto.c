@@ -52,6 +52,18 @@
 #include "socket/socket.h"
 #include "local/local.h"
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* A list of all SOCK_DGRAM sockets bound to a path */
+
+dq_queue_t g_local_dgrams;
+
+/* Posted whenever a datagram is taken from any receive queue */
+
+sem_t g_local_dgramsem;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,11 +77,13 @@
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Buffers holding the data to send
+ *   iovcnt   Number of buffers
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
+ *   rights   Descriptors to pass with the data (may be NULL).  These are
+ *            always consumed.
  *
  *   NOTE: All input parameters were verified by sendto() before this
  *   function was called.
@@ -81,20 +95,17 @@
  *
  ****************************************************************************/
 
-ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags, FAR const struct sockaddr *to,
-                           socklen_t tolen)
+ssize_t psock_local_sendto(FAR struct socket *psock,
+                           FAR const struct iovec *iov, int iovcnt,
+                           int flags, FAR const struct sockaddr *to,
+                           socklen_t tolen,
+                           FAR struct local_rights_s *rights)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
   FAR struct sockaddr_un *unaddr = (FAR struct sockaddr_un *)to;
   ssize_t nsent;
-  int ret;
 
-  /* We keep packet sizes in a uint16_t, so there is a upper limit to the
-   * 'len' that can be supported.
-   */
-
-  DEBUGASSERT(buf && len <= UINT16_MAX);
+  DEBUGASSERT(iov != NULL);
 
   /* Verify that this is not a connected peer socket.  It need not be
    * bound, however.  If unbound, recvfrom will see this as a nameless
@@ -107,70 +118,41 @@ ssize_t psock_local_sendto(FAR struct socket *psock, FAR const void *buf,
       /* Either not bound to address or it is connected */
 
       nerr("ERROR: Connected state\n");
-      return -EISCONN;
+      nsent = -EISCONN;
+      goto errout;
     }
 
-  /* The outgoing FIFO should not be open */
-
-  DEBUGASSERT(conn->lc_outfile.f_inode == 0);
-
   /* At present, only standard pathname type address are support */
 
   if (tolen < sizeof(sa_family_t) + 2)
     {
      /* EFAULT - An invalid user space address was specified for a parameter */
 
-     return -EFAULT;
+     nsent = -EFAULT;
+     goto errout;
     }
 
-  /* Make sure that half duplex FIFO has been created.
-   * REVISIT:  Or should be just make sure that it already exists?
+  /* Send the packet directly to the receive queue of the socket bound to
+   * the destination path.
    */
 
-  ret = local_create_halfduplex(conn, unaddr->sun_path);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to create FIFO for %s: %d\n",
-           conn->lc_path, ret);
-      return ret;
-    }
-
-  /* Open the sending side of the transfer */
-
-  ret = local_open_sender(conn, unaddr->sun_path,
-                          _SS_ISNONBLOCK(psock->s_flags));
-  if (ret < 0)
+  nsent = local_send_packet(psock, iov, iovcnt, flags, unaddr->sun_path,
+                            rights);
+  if (nsent < 0)
     {
-      nerr("ERROR: Failed to open FIFO for %s: %d\n",
-           unaddr->sun_path, ret);
-
-      nsent = ret;
-      goto errout_with_halfduplex;
+      nerr("ERROR: Failed to send the packet: %d\n", (int)nsent);
     }
 
-  /* Send the packet */
+  return nsent;
 
-  nsent = local_send_packet(&conn->lc_outfile, buf, len);
-  if (nsent < 0)
+errout:
+#ifdef CONFIG_NET_LOCAL_SCM
+  if (rights != NULL)
     {
-      nerr("ERROR: Failed to send the packet: %d\n", ret);
+      local_rights_free(rights);
     }
-  else
-    {
-      /* local_send_packet returns 0 if all 'len' bytes were sent */
-
-      nsent = len;
-    }
-
-  /* Now we can close the write-only socket descriptor */
-
-  file_close(&conn->lc_outfile);
-  conn->lc_outfile.f_inode = NULL;
-
-errout_with_halfduplex:
-  /* Release our reference to the half duplex FIFO */
+#endif
 
-  (void)local_release_halfduplex(conn);
   return nsent;
 }
 
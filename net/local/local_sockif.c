@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -88,6 +89,8 @@ static ssize_t    local_send(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    local_sendto(FAR struct socket *psock, FAR const void *buf,
                     size_t len, int flags, FAR const struct sockaddr *to,
                     socklen_t tolen);
+static ssize_t    local_sendmsg(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
 static int        local_close(FAR struct socket *psock);
 
 /****************************************************************************
@@ -114,6 +117,8 @@ const struct sock_intf_s g_local_sockif =
   NULL,              /* si_sendfile */
 #endif
   local_recvfrom,    /* si_recvfrom */
+  local_sendmsg,     /* si_sendmsg */
+  local_recvmsg,     /* si_recvmsg */
   local_close        /* si_close */
 };
 
@@ -148,6 +153,7 @@ static int local_sockif_alloc(FAR struct socket *psock)
 
   DEBUGASSERT(conn->lc_crefs == 0);
   conn->lc_crefs = 1;
+  conn->lc_proto = psock->s_type;
 
   /* Save the pre-allocated connection in the socket structure */
 
@@ -684,8 +690,12 @@ static int local_poll(FAR struct socket *psock, FAR struct pollfd *fds,
 static ssize_t local_send(FAR struct socket *psock, FAR const void *buf,
                           size_t len, int flags)
 {
+  struct iovec iov;
   ssize_t ret;
 
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
   switch (psock->s_type)
     {
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -693,7 +703,7 @@ static ssize_t local_send(FAR struct socket *psock, FAR const void *buf,
         {
           /* Local TCP packet send */
 
-          ret = psock_local_send(psock, buf, len, flags);
+          ret = psock_local_send(psock, &iov, 1, flags, NULL);
         }
         break;
 #endif /* CONFIG_NET_LOCAL_STREAM */
@@ -747,6 +757,7 @@ ssize_t local_sendto(FAR struct socket *psock, FAR const void *buf,
                      size_t len, int flags, FAR const struct sockaddr *to,
                      socklen_t tolen)
 {
+  struct iovec iov;
   ssize_t nsent;
 
   /* Verify that a valid address has been provided */
@@ -769,7 +780,10 @@ ssize_t local_sendto(FAR struct socket *psock, FAR const void *buf,
 
   /* Now handle the local UDP sendto() operation */
 
-  nsent = psock_local_sendto(psock, buf, len, flags, to, tolen);
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  nsent = psock_local_sendto(psock, &iov, 1, flags, to, tolen, NULL);
 #else
   nsent = -EISCONN;
 #endif /* CONFIG_NET_LOCAL_DGRAM */
@@ -777,6 +791,105 @@ ssize_t local_sendto(FAR struct socket *psock, FAR const void *buf,
   return nsent;
 }
 
+/****************************************************************************
+ * Name: local_sendmsg
+ *
+ * Description:
+ *   Implements the sendmsg() operation for the case of the local, Unix
+ *   socket.  The data in all of the buffers is sent as one packet.
+ *   Descriptors in SCM_RIGHTS control messages are passed to the receiver
+ *   if CONFIG_NET_LOCAL_SCM is enabled.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                             int flags)
+{
+  FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+  FAR struct local_rights_s *rights = NULL;
+  socklen_t tolen = msg->msg_namelen;
+  ssize_t ret;
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  /* Take references to any descriptors passed in SCM_RIGHTS control
+   * messages.  These travel with the data to the receiver.
+   */
+
+  if (msg->msg_control != NULL && msg->msg_controllen > 0)
+    {
+      ret = local_rights_alloc(msg, &rights);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  switch (psock->s_type)
+    {
+#ifdef CONFIG_NET_LOCAL_STREAM
+      case SOCK_STREAM:
+        {
+          ret = psock_local_send(psock, msg->msg_iov, msg->msg_iovlen,
+                                 flags, rights);
+          rights = NULL;
+        }
+        break;
+#endif /* CONFIG_NET_LOCAL_STREAM */
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+      case SOCK_DGRAM:
+        {
+          if (to == NULL || tolen <= 0)
+            {
+              ret = -EDESTADDRREQ;
+            }
+          else if (to->sa_family != AF_LOCAL ||
+                   tolen < sizeof(sa_family_t))
+            {
+              nerr("ERROR: Unrecognized address family: %d\n",
+                   to->sa_family);
+              ret = -EAFNOSUPPORT;
+            }
+          else
+            {
+              ret = psock_local_sendto(psock, msg->msg_iov, msg->msg_iovlen,
+                                       flags, to, tolen, rights);
+              rights = NULL;
+            }
+        }
+        break;
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
+      default:
+        {
+          ret = -EDESTADDRREQ;
+        }
+        break;
+    }
+
+#ifdef CONFIG_NET_LOCAL_SCM
+  /* Release the descriptors if they were not sent */
+
+  if (rights != NULL)
+    {
+      local_rights_free(rights);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: local_close
  *
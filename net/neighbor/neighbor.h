@@ -54,6 +54,10 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
 
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+#  include <nuttx/mm/iob.h>
+#endif
+
 #ifdef CONFIG_NET_IPv6
 
 /****************************************************************************
@@ -95,8 +99,19 @@ struct neighbor_entry
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   clock_t                ne_time;    /* For aging, units of tick */
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+  uint8_t                ne_npending; /* Number of queued packets */
+  FAR struct net_driver_s *ne_dev;   /* Device that queued the packets */
+  FAR struct iob_s      *ne_pending[CONFIG_NET_IPv6_NCONF_PENDQ_SIZE];
+#endif
 };
 
+/* An entry that is awaiting a Neighbor Advertisement has no link layer
+ * address yet.
+ */
+
+#define NEIGHBOR_RESOLVED(n) ((n)->ne_addr.na_llsize > 0)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -221,6 +236,62 @@ void neighbor_update(const net_ipv6addr_t ipaddr);
 void neighbor_ethernet_out(FAR struct net_driver_s *dev);
 #endif
 
+/****************************************************************************
+ * Name: neighbor_enqueue
+ *
+ * Description:
+ *   Save the IPv6 packet in d_buf until the link layer address of ipaddr
+ *   is resolved.  At most CONFIG_NET_IPv6_NCONF_PENDQ_SIZE packets are held
+ *   for each address; the oldest is discarded when that limit is reached.
+ *
+ * Input Parameters:
+ *   dev    - The device that holds the outgoing IPv6 packet
+ *   ipaddr - The next hop IPv6 address to be resolved
+ *
+ * Returned Value:
+ *   Zero (OK) if the packet was queued.  A negated errno value is returned
+ *   if no I/O buffers were available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+int neighbor_enqueue(FAR struct net_driver_s *dev,
+                     FAR const net_ipv6addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_free
+ *
+ * Description:
+ *   Discard all packets queued on a Neighbor Table entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+void neighbor_pending_free(FAR struct neighbor_entry *neighbor);
+#else
+#  define neighbor_pending_free(n)
+#endif
+
+/****************************************************************************
+ * Name: neighbor_txpoll
+ *
+ * Description:
+ *   Send the packets that were waiting for a link layer address that is
+ *   now available.  Packets that waited more than
+ *   CONFIG_NET_IPv6_NCONF_PENDQ_TIMEOUT seconds are discarded.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and devif_timer().  The network must be locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+int neighbor_txpoll(FAR struct net_driver_s *dev,
+                    devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: neighbor_dumpentry
  *
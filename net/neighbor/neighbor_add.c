@@ -110,9 +110,14 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
     }
 
   /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
+   * "oldest_ndx" variable).  Packets queued on a replaced entry are lost.
    */
 
+  if (!net_ipv6addr_cmp(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr))
+    {
+      neighbor_pending_free(&g_neighbors[oldest_ndx]);
+    }
+
   g_neighbors[oldest_ndx].ne_time = clock_systimer();
   net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
 
@@ -125,4 +130,15 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   /* Dump the contents of the new entry */
 
   neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+  /* If packets were waiting for this address, have the device poll for
+   * them now rather than at the next poll timer.
+   */
+
+  if (g_neighbors[oldest_ndx].ne_npending > 0)
+    {
+      netdev_txnotify_dev(g_neighbors[oldest_ndx].ne_dev);
+    }
+#endif
 }
@@ -101,9 +101,12 @@
  *
  *   If no Neighbor Table entry is found for the destination IPv6 address,
  *   the packet in the d_buf is replaced by an ICMPv6 Neighbor Solicit
- *   request packet for the IPv6 address. The IPv6 packet is dropped and
- *   it is assumed that the higher level protocols (e.g., TCP) eventually
- *   will retransmit the dropped packet.
+ *   request packet for the IPv6 address.  If CONFIG_NET_IPv6_NCONF_PENDQ
+ *   is enabled, the IPv6 packet is first saved and will be sent by
+ *   neighbor_txpoll() when the Neighbor Advertisement is received.
+ *   Otherwise, the IPv6 packet is dropped and it is assumed that the
+ *   higher level protocols (e.g., TCP) eventually will retransmit the
+ *   dropped packet.
  *
  *   Upon return in either the case, a packet to be sent is present in the
  *   d_buf buffer and the d_len field holds the length of the Ethernet
@@ -179,6 +182,17 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
         {
            ninfo("IPv6 Neighbor solicitation for IPv6\n");
 
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+          /* Save the IPv6 packet so that it can be sent when the Neighbor
+           * Advertisement is received.
+           */
+
+          if (neighbor_enqueue(dev, ipaddr) < 0)
+            {
+              nwarn("WARNING: Failed to queue packet\n");
+            }
+#endif
+
           /* The destination address was not in our Neighbor Table, so we
            * overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
            * message.
@@ -43,6 +43,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "neighbor/neighbor.h"
+#include "pcap/pcap.h"
 
 /****************************************************************************
  * Public Functions
@@ -81,6 +82,7 @@ void neighbor_out(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_ETHERNET
       case NET_LL_ETHERNET:
         neighbor_ethernet_out(dev);
+        pcap_output(dev);
         break;
 #endif
 
@@ -0,0 +1,292 @@
+/****************************************************************************
+ * net/neighbor/neighbor_pending.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "neighbor/neighbor.h"
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NEIGHBOR_PENDQ_TICK SEC2TICK(CONFIG_NET_IPv6_NCONF_PENDQ_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* True if neighbor_txpoll() may have something to do */
+
+static bool g_neighbor_poll;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_pending_remove
+ *
+ * Description:
+ *   Remove the oldest packet queued on an entry.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *
+neighbor_pending_remove(FAR struct neighbor_entry *neighbor)
+{
+  FAR struct iob_s *iob = neighbor->ne_pending[0];
+
+  neighbor->ne_npending--;
+  memmove(&neighbor->ne_pending[0], &neighbor->ne_pending[1],
+          neighbor->ne_npending * sizeof(FAR struct iob_s *));
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_pending_free
+ *
+ * Description:
+ *   Discard all packets queued on a Neighbor Table entry.
+ *
+ ****************************************************************************/
+
+void neighbor_pending_free(FAR struct neighbor_entry *neighbor)
+{
+  while (neighbor->ne_npending > 0)
+    {
+      iob_free_chain(neighbor->ne_pending[--neighbor->ne_npending]);
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_enqueue
+ *
+ * Description:
+ *   Save the IPv6 packet in d_buf until the link layer address of ipaddr
+ *   is resolved.  At most CONFIG_NET_IPv6_NCONF_PENDQ_SIZE packets are held
+ *   for each address; the oldest is discarded when that limit is reached.
+ *
+ * Input Parameters:
+ *   dev    - The device that holds the outgoing IPv6 packet
+ *   ipaddr - The next hop IPv6 address to be resolved
+ *
+ * Returned Value:
+ *   Zero (OK) if the packet was queued.  A negated errno value is returned
+ *   if no I/O buffers were available.
+ *
+ ****************************************************************************/
+
+int neighbor_enqueue(FAR struct net_driver_s *dev,
+                     FAR const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+  FAR struct iob_s *iob;
+  clock_t now = clock_systimer();
+  int ret;
+  int i;
+
+  neighbor = neighbor_findentry(ipaddr);
+  if (neighbor == NULL)
+    {
+      /* Take the oldest entry and mark it unresolved.  neighbor_add() will
+       * find it by address when the Neighbor Advertisement arrives.
+       */
+
+      neighbor = &g_neighbors[0];
+      for (i = 1; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+        {
+          if ((int)(g_neighbors[i].ne_time - neighbor->ne_time) < 0)
+            {
+              neighbor = &g_neighbors[i];
+            }
+        }
+
+      neighbor_pending_free(neighbor);
+
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+      neighbor->ne_addr.na_lltype = dev->d_lltype;
+      neighbor->ne_addr.na_llsize = 0;
+      neighbor->ne_time           = now;
+    }
+  else if (!NEIGHBOR_RESOLVED(neighbor) &&
+           now - neighbor->ne_time > NEIGHBOR_PENDQ_TICK)
+    {
+      /* The previous solicitation timed out.  Drop its packets and start
+       * over.
+       */
+
+      neighbor_pending_free(neighbor);
+      neighbor->ne_time = now;
+    }
+
+  /* Make room in the queue by discarding the oldest packet */
+
+  if (neighbor->ne_npending >= CONFIG_NET_IPv6_NCONF_PENDQ_SIZE)
+    {
+      iob_free_chain(neighbor_pending_remove(neighbor));
+    }
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[NET_LL_HDRLEN(dev)], dev->d_len, 0,
+                      true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  neighbor->ne_dev = dev;
+  neighbor->ne_pending[neighbor->ne_npending++] = iob;
+  g_neighbor_poll = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: neighbor_txpoll
+ *
+ * Description:
+ *   Send the packets that were waiting for a link layer address that is
+ *   now available.  Packets that waited more than
+ *   CONFIG_NET_IPv6_NCONF_PENDQ_TIMEOUT seconds are discarded.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and devif_timer().  The network must be locked.
+ *
+ ****************************************************************************/
+
+int neighbor_txpoll(FAR struct net_driver_s *dev,
+                    devif_poll_callback_t callback)
+{
+  FAR struct neighbor_entry *neighbor;
+  FAR struct iob_s *iob;
+  clock_t now;
+  bool more = false;
+  int i;
+
+  if (!g_neighbor_poll)
+    {
+      return 0;
+    }
+
+  now = clock_systimer();
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+    {
+      neighbor = &g_neighbors[i];
+      if (neighbor->ne_npending == 0)
+        {
+          continue;
+        }
+
+      if (!NEIGHBOR_RESOLVED(neighbor))
+        {
+          /* Still waiting for the Neighbor Advertisement */
+
+          if (now - neighbor->ne_time > NEIGHBOR_PENDQ_TICK)
+            {
+              neighbor_dumpentry("Resolution timed out", neighbor);
+              neighbor_pending_free(neighbor);
+              memset(neighbor->ne_ipaddr, 0, sizeof(net_ipv6addr_t));
+            }
+          else
+            {
+              more = true;
+            }
+
+          continue;
+        }
+
+      if (neighbor->ne_dev != dev)
+        {
+          more = true;
+          continue;
+        }
+
+      while (neighbor->ne_npending > 0)
+        {
+          /* Restore the IPv6 packet into d_buf.  The driver will call
+           * neighbor_out() which will now find the link layer address.
+           */
+
+          iob = neighbor_pending_remove(neighbor);
+
+          dev->d_len    = iob->io_pktlen;
+          dev->d_sndlen = 0;
+          (void)iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)], iob,
+                            iob->io_pktlen, 0);
+          iob_free_chain(iob);
+
+          IFF_SET_IPv6(dev->d_flags);
+          if (callback(dev))
+            {
+              return 1;
+            }
+        }
+    }
+
+  g_neighbor_poll = more;
+  return 0;
+}
+
+#endif /* CONFIG_NET_IPv6_NCONF_PENDQ */
@@ -56,8 +56,10 @@
 #include "tcp/tcp.h"
 #include "udp/udp.h"
 #include "pkt/pkt.h"
+#include "pcap/pcap.h"
 #include "bluetooth/bluetooth.h"
 #include "ieee802154/ieee802154.h"
+#include "can/can.h"
 #include "local/local.h"
 #include "netlink/netlink.h"
 #include "igmp/igmp.h"
@@ -128,6 +130,12 @@ void net_initialize(void)
   pkt_initialize();
 #endif
 
+#ifdef CONFIG_NET_PCAP
+  /* Register the packet capture device */
+
+  pcap_initialize();
+#endif
+
 #ifdef CONFIG_NET_ICMP_SOCKET
   /* Initialize IPPPROTO_ICMP socket support */
 
@@ -152,6 +160,12 @@ void net_initialize(void)
   ieee802154_initialize();
 #endif
 
+#ifdef CONFIG_NET_CAN
+  /* Initialize PF_CAN socket support */
+
+  can_initialize();
+#endif
+
 #ifdef CONFIG_NET_LOCAL
   /* Initialize the local, "Unix domain" socket support */
 
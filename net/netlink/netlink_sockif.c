@@ -108,6 +108,8 @@ const struct sock_intf_s g_netlink_sockif =
   NULL,                 /* si_sendfile */
 #endif
   netlink_recvfrom,     /* si_recvfrom */
+  NULL,                 /* si_sendmsg */
+  NULL,                 /* si_recvmsg */
   netlink_close         /* si_close */
 };
 
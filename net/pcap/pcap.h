@@ -0,0 +1,172 @@
+/****************************************************************************
+ * net/pcap/pcap.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef _NET_PCAP_PCAP_H
+#define _NET_PCAP_PCAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <poll.h>
+
+#include <nuttx/net/pcap.h>
+
+#ifdef CONFIG_NET_PCAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NET_PCAP_RINGSIZE < 256 || \
+    (CONFIG_NET_PCAP_RINGSIZE & (CONFIG_NET_PCAP_RINGSIZE - 1)) != 0
+#  error CONFIG_NET_PCAP_RINGSIZE must be a power of two (>= 256)
+#endif
+
+/* Capture taps.  These are placed where frames enter and leave the device
+ * interface layer.  They must be called with the network locked.  The only
+ * cost when capture is not active is the test of pd_active.
+ */
+
+#define pcap_input(dev) \
+  do \
+    { \
+      if (g_pcap.pd_active) \
+        { \
+          pcap_capture(dev, PCAP_DIR_IN); \
+        } \
+    } \
+  while (0)
+
+#define pcap_output(dev) \
+  do \
+    { \
+      if (g_pcap.pd_active) \
+        { \
+          pcap_capture(dev, PCAP_DIR_OUT); \
+        } \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* State of the packet capture device.  All fields are protected by the
+ * network lock.
+ */
+
+struct pcap_dev_s
+{
+  volatile bool pd_active;         /* True: capture is running */
+  bool pd_open;                    /* True: the device is open */
+  struct pcap_filter_s pd_filter;  /* The current capture filter */
+  FAR struct pcap_ring_s *pd_ring; /* The shared ring (NULL if closed) */
+  uint32_t pd_head;                /* Kernel copy of pd_ring->pr_head */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *pd_fds;       /* The poll() waiter, if any */
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+EXTERN struct pcap_dev_s g_pcap;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+struct net_driver_s; /* Forward reference */
+
+/****************************************************************************
+ * Name: pcap_initialize
+ *
+ * Description:
+ *   Register the packet capture device at /dev/pcap.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence.
+ *
+ ****************************************************************************/
+
+void pcap_initialize(void);
+
+/****************************************************************************
+ * Name: pcap_capture
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the capture ring if it passes the
+ *   capture filter.  Normally called through pcap_input() or
+ *   pcap_output().
+ *
+ * Input Parameters:
+ *   dev - The device that is receiving or sending the frame
+ *   dir - PCAP_DIR_IN or PCAP_DIR_OUT
+ *
+ * Returned Value:
+ *   None.  If the ring is full, the frame is counted in pr_drops.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void pcap_capture(FAR struct net_driver_s *dev, uint8_t dir);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#else /* CONFIG_NET_PCAP */
+
+#  define pcap_input(dev)
+#  define pcap_output(dev)
+
+#endif /* CONFIG_NET_PCAP */
+#endif /* _NET_PCAP_PCAP_H */
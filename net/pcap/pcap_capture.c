@@ -0,0 +1,273 @@
+/****************************************************************************
+ * net/pcap/pcap_capture.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "pcap/pcap.h"
+
+#ifdef CONFIG_NET_PCAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHBUF ((FAR struct eth_hdr_s *)&dev->d_buf[0])
+
+/* The record must be visible to the reader before the new head.  Without
+ * CONFIG_SPINLOCK there is no architecture barrier, but the compiler must
+ * still not move the record stores past the update of pr_head.
+ */
+
+#ifndef CONFIG_SPINLOCK
+#  undef SP_DMB
+#  ifdef __GNUC__
+#    define SP_DMB() __asm__ __volatile__ ("" : : : "memory")
+#  else
+#    define SP_DMB()
+#  endif
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The state of the packet capture device */
+
+struct pcap_dev_s g_pcap;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pcap_ethertype
+ *
+ * Description:
+ *   Return the ethertype of the frame in dev->d_buf (host order).  For
+ *   devices without an Ethernet header, the type is derived from the IP
+ *   version field.  Zero is returned if the type cannot be determined.
+ *
+ ****************************************************************************/
+
+static uint16_t pcap_ethertype(FAR struct net_driver_s *dev)
+{
+  uint8_t vhl;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET)
+    {
+      return dev->d_len >= ETH_HDRLEN ? NTOHS(ETHBUF->type) : 0;
+    }
+#endif
+
+  if (dev->d_len <= NET_LL_HDRLEN(dev))
+    {
+      return 0;
+    }
+
+  vhl = dev->d_buf[NET_LL_HDRLEN(dev)] & 0xf0;
+  if (vhl == 0x40)
+    {
+      return ETHTYPE_IP;
+    }
+  else if (vhl == 0x60)
+    {
+      return ETHTYPE_IP6;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: pcap_notify
+ *
+ * Description:
+ *   Wake up the reader if it is waiting in poll().
+ *
+ ****************************************************************************/
+
+static void pcap_notify(void)
+{
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds = g_pcap.pd_fds;
+
+  if (fds != NULL)
+    {
+      fds->revents |= (fds->events & POLLIN);
+      if (fds->revents != 0)
+        {
+          nxsem_post(fds->sem);
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pcap_capture
+ *
+ * Description:
+ *   Copy the frame in dev->d_buf into the capture ring if it passes the
+ *   capture filter.  Normally called through pcap_input() or
+ *   pcap_output().
+ *
+ * Input Parameters:
+ *   dev - The device that is receiving or sending the frame
+ *   dir - PCAP_DIR_IN or PCAP_DIR_OUT
+ *
+ * Returned Value:
+ *   None.  If the ring is full, the frame is counted in pr_drops.
+ *
+ * Assumptions:
+ *   Called with the network locked.  The network lock makes this the only
+ *   producer, so no lock is needed on the ring itself.
+ *
+ ****************************************************************************/
+
+void pcap_capture(FAR struct net_driver_s *dev, uint8_t dir)
+{
+  FAR struct pcap_ring_s *ring = g_pcap.pd_ring;
+  FAR struct pcap_rec_s *rec;
+  struct timespec ts;
+  uint32_t head;
+  uint32_t used;
+  uint32_t offset;
+  uint32_t contig;
+  uint32_t needed;
+  uint16_t caplen;
+  uint32_t reclen;
+
+  if (ring == NULL || dev->d_len == 0)
+    {
+      return;
+    }
+
+  /* Apply the capture filter */
+
+  if (g_pcap.pd_filter.pf_ifindex != 0 &&
+      g_pcap.pd_filter.pf_ifindex != dev->d_ifindex)
+    {
+      return;
+    }
+
+  if (g_pcap.pd_filter.pf_ethertype != 0 &&
+      g_pcap.pd_filter.pf_ethertype != pcap_ethertype(dev))
+    {
+      return;
+    }
+
+  caplen = dev->d_len;
+  if (caplen > g_pcap.pd_filter.pf_snaplen)
+    {
+      caplen = g_pcap.pd_filter.pf_snaplen;
+    }
+
+  reclen = PCAP_RECLEN(caplen);
+
+  /* Find space for the record.  If it does not fit in the contiguous space
+   * at the end of the ring, that space is consumed by a wrap marker and the
+   * record is placed at the start of the ring.
+   *
+   * The ring is mapped into the reader, so only pr_tail is taken from it;
+   * the head and the size come from the kernel state.
+   */
+
+  head   = g_pcap.pd_head;
+  used   = head - ring->pr_tail;
+  offset = head & (CONFIG_NET_PCAP_RINGSIZE - 1);
+  contig = CONFIG_NET_PCAP_RINGSIZE - offset;
+  needed = reclen > contig ? contig + reclen : reclen;
+
+  if (used > CONFIG_NET_PCAP_RINGSIZE ||
+      needed > CONFIG_NET_PCAP_RINGSIZE - used)
+    {
+      ring->pr_drops++;
+      return;
+    }
+
+  if (reclen > contig)
+    {
+      rec = (FAR struct pcap_rec_s *)&ring->pr_data[offset];
+      rec->pc_reclen = 0;
+
+      head  += contig;
+      offset = 0;
+    }
+
+  /* Fill in the record */
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+
+  rec             = (FAR struct pcap_rec_s *)&ring->pr_data[offset];
+  rec->pc_reclen  = reclen;
+  rec->pc_caplen  = caplen;
+  rec->pc_len     = dev->d_len;
+  rec->pc_ifindex = dev->d_ifindex;
+  rec->pc_lltype  = dev->d_lltype;
+  rec->pc_dir     = dir;
+  rec->pc_sec     = (uint32_t)ts.tv_sec;
+  rec->pc_usec    = (uint32_t)(ts.tv_nsec / 1000);
+
+  memcpy(rec + 1, dev->d_buf, caplen);
+
+  /* The record must be complete before the reader can see the new head */
+
+  SP_DMB();
+  g_pcap.pd_head = head + reclen;
+  ring->pr_head  = g_pcap.pd_head;
+
+  pcap_notify();
+}
+
+#endif /* CONFIG_NET_PCAP */
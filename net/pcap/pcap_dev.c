@@ -0,0 +1,339 @@
+/****************************************************************************
+ * net/pcap/pcap_dev.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "pcap/pcap.h"
+
+#ifdef CONFIG_NET_PCAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A single record may use at most half of the ring (and must be
+ * representable in pc_reclen).
+ */
+
+#define PCAP_MAXRECLEN \
+  (CONFIG_NET_PCAP_RINGSIZE / 2 < UINT16_MAX - PCAP_ALIGN ? \
+   CONFIG_NET_PCAP_RINGSIZE / 2 : UINT16_MAX - PCAP_ALIGN)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int pcapdev_open(FAR struct file *filep);
+static int pcapdev_close(FAR struct file *filep);
+static int pcapdev_ioctl(FAR struct file *filep, int cmd,
+                         unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int pcapdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_pcapdevops =
+{
+  pcapdev_open,    /* open */
+  pcapdev_close,   /* close */
+  NULL,            /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  pcapdev_ioctl    /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , pcapdev_poll   /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pcapdev_setfilter
+ *
+ * Description:
+ *   Validate and install a new capture filter.
+ *
+ ****************************************************************************/
+
+static int pcapdev_setfilter(FAR const struct pcap_filter_s *filter)
+{
+  uint16_t snaplen = filter->pf_snaplen;
+
+  if (snaplen == 0)
+    {
+      snaplen = CONFIG_NET_PCAP_SNAPLEN;
+    }
+
+  if (PCAP_RECLEN(snaplen) > PCAP_MAXRECLEN)
+    {
+      return -EINVAL;
+    }
+
+  g_pcap.pd_filter.pf_ifindex   = filter->pf_ifindex;
+  g_pcap.pd_filter.pf_ethertype = filter->pf_ethertype;
+  g_pcap.pd_filter.pf_snaplen   = snaplen;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pcapdev_open
+ ****************************************************************************/
+
+static int pcapdev_open(FAR struct file *filep)
+{
+  FAR struct pcap_ring_s *ring;
+  struct pcap_filter_s filter;
+  int ret;
+
+  net_lock();
+
+  /* Only one reader is supported */
+
+  if (g_pcap.pd_open)
+    {
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  /* The ring is shared with the reader, so it must be allocated from
+   * memory that the reader can access.
+   */
+
+  ring = (FAR struct pcap_ring_s *)
+    kumm_zalloc(offsetof(struct pcap_ring_s, pr_data) +
+                CONFIG_NET_PCAP_RINGSIZE);
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ring->pr_size = CONFIG_NET_PCAP_RINGSIZE;
+
+  memset(&filter, 0, sizeof(struct pcap_filter_s));
+  ret = pcapdev_setfilter(&filter);
+  if (ret < 0)
+    {
+      kumm_free(ring);
+      goto errout;
+    }
+
+  g_pcap.pd_ring   = ring;
+  g_pcap.pd_active = false;
+  g_pcap.pd_open   = true;
+
+errout:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pcapdev_close
+ ****************************************************************************/
+
+static int pcapdev_close(FAR struct file *filep)
+{
+  FAR struct pcap_ring_s *ring;
+
+  net_lock();
+  ring             = g_pcap.pd_ring;
+  g_pcap.pd_active = false;
+  g_pcap.pd_ring   = NULL;
+  g_pcap.pd_open   = false;
+  net_unlock();
+
+  if (ring != NULL)
+    {
+      kumm_free(ring);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pcapdev_ioctl
+ ****************************************************************************/
+
+static int pcapdev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  int ret = OK;
+
+  net_lock();
+  switch (cmd)
+    {
+      case FIOC_MMAP:  /* Get the address of the capture ring */
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          *ppv = g_pcap.pd_ring;
+        }
+        break;
+
+      case PCAPIOC_START:  /* Empty the ring and start capturing */
+        {
+          FAR struct pcap_ring_s *ring = g_pcap.pd_ring;
+
+          g_pcap.pd_head   = 0;
+          ring->pr_head    = 0;
+          ring->pr_tail    = 0;
+          ring->pr_drops   = 0;
+          g_pcap.pd_active = true;
+        }
+        break;
+
+      case PCAPIOC_STOP:  /* Stop capturing */
+        g_pcap.pd_active = false;
+        break;
+
+      case PCAPIOC_SETFILTER:  /* Select the frames to capture */
+        {
+          FAR const struct pcap_filter_s *filter =
+            (FAR const struct pcap_filter_s *)((uintptr_t)arg);
+
+          if (filter == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = pcapdev_setfilter(filter);
+            }
+        }
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized cmd: %d\n", cmd);
+        ret = -ENOTTY;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pcapdev_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int pcapdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct pcap_ring_s *ring;
+  int ret = OK;
+
+  net_lock();
+  if (setup)
+    {
+      if (g_pcap.pd_fds != NULL)
+        {
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      g_pcap.pd_fds = fds;
+      fds->priv     = &g_pcap.pd_fds;
+
+      /* Report POLLIN now if there are unread records */
+
+      ring = g_pcap.pd_ring;
+      if (ring != NULL && ring->pr_head != ring->pr_tail)
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      g_pcap.pd_fds = NULL;
+      fds->priv     = NULL;
+    }
+
+errout:
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pcap_initialize
+ *
+ * Description:
+ *   Register the packet capture device at /dev/pcap.
+ *
+ * Assumptions:
+ *   Called early in the initialization sequence.
+ *
+ ****************************************************************************/
+
+void pcap_initialize(void)
+{
+  memset(&g_pcap, 0, sizeof(struct pcap_dev_s));
+  (void)register_driver(PCAP_DEVPATH, &g_pcapdevops, 0444, NULL);
+}
+
+#endif /* CONFIG_NET_PCAP */
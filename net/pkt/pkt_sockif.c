@@ -111,6 +111,8 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_sendfile */
 #endif
   pkt_recvfrom,    /* si_recvfrom */
+  NULL,            /* si_sendmsg */
+  NULL,            /* si_recvmsg */
   pkt_close        /* si_close */
 };
 
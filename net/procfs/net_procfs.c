@@ -85,9 +85,16 @@
 
 #ifdef CONFIG_NET_ROUTE
 #  define ROUTE_INDEX    _ROUTE_INDEX
-#  define DEV_INDEX      (_ROUTE_INDEX + 1)
+#  define _SOCK_INDEX    (_ROUTE_INDEX + 1)
 #else
-#  define DEV_INDEX      _ROUTE_INDEX
+#  define _SOCK_INDEX    _ROUTE_INDEX
+#endif
+
+#ifdef NETPROCFS_HAVE_SOCKETS
+#  define SOCK_INDEX     _SOCK_INDEX
+#  define DEV_INDEX      (_SOCK_INDEX + 1)
+#else
+#  define DEV_INDEX      _SOCK_INDEX
 #endif
 
 /****************************************************************************
@@ -193,6 +200,17 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 #endif
 #endif
 
+#ifdef NETPROCFS_HAVE_SOCKETS
+  /* "net/sockets" reports the buffer usage of each TCP/UDP connection */
+
+  if (strcmp(relpath, "net/sockets") == 0)
+    {
+      entry = NETPROCFS_SUBDIR_SOCKETS;
+      dev   = NULL;
+    }
+  else
+#endif
+
 #ifdef CONFIG_NET_ROUTE
   /* "net/route" is an acceptable value for the relpath only if routing
    * table support is initialized.
@@ -320,6 +338,14 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
 #endif
 #endif
 
+#ifdef NETPROCFS_HAVE_SOCKETS
+      case NETPROCFS_SUBDIR_SOCKETS:
+        /* Show the per-socket buffer usage */
+
+        nreturned = netprocfs_read_sockets(priv, buffer, buflen);
+        break;
+#endif
+
 #ifdef CONFIG_NET_ROUTE
       case NETPROCFS_SUBDIR_ROUTE:
         nerr("ERROR: Cannot read from directory net/route\n");
@@ -442,6 +468,9 @@ static int netprocfs_opendir(FAR const char *relpath,
 #endif
 #ifdef CONFIG_NET_ROUTE
       level1->base.nentries++;
+#endif
+#ifdef NETPROCFS_HAVE_SOCKETS
+      level1->base.nentries++;
 #endif
     }
   else
@@ -555,6 +584,16 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
           strncpy(dir->fd_dir.d_name, "route", NAME_MAX + 1);
         }
       else
+#endif
+#ifdef NETPROCFS_HAVE_SOCKETS
+      if (index == SOCK_INDEX)
+        {
+          /* Copy the socket buffer usage directory entry */
+
+          dir->fd_dir.d_type = DTYPE_FILE;
+          strncpy(dir->fd_dir.d_name, "sockets", NAME_MAX + 1);
+        }
+      else
 #endif
         {
           int ifindex;
@@ -685,6 +724,15 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
   else
+#endif
+#ifdef NETPROCFS_HAVE_SOCKETS
+  /* Check for socket buffer usage "net/sockets" */
+
+  if (strcmp(relpath, "net/sockets") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
 #endif
     {
       FAR struct net_driver_s *dev;
@@ -0,0 +1,273 @@
+/****************************************************************************
+ * net/procfs/net_sockets.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(NETPROCFS_HAVE_SOCKETS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The buffer usage of one connection */
+
+struct netprocfs_sockinfo_s
+{
+  FAR const char *proto;             /* "TCP" or "UDP" */
+  uint16_t lport;                    /* Local port (host order) */
+  uint16_t rport;                    /* Remote port (host order) */
+  uint32_t rxused;                   /* Bytes held in read-ahead buffers */
+  uint32_t rxlimit;                  /* SO_RCVBUF limit (0: none) */
+  uint32_t txused;                   /* Bytes held in write buffers */
+  uint32_t txlimit;                  /* SO_SNDBUF limit (0: none) */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_sockinfo
+ *
+ * Description:
+ *   Get the buffer usage of the n'th active connection.  TCP connections
+ *   are visited first, then UDP connections.
+ *
+ * Returned Value:
+ *   true if the connection exists; false if there are no more connections.
+ *
+ ****************************************************************************/
+
+static bool netprocfs_sockinfo(int index,
+                               FAR struct netprocfs_sockinfo_s *info)
+{
+  bool found = false;
+
+  memset(info, 0, sizeof(struct netprocfs_sockinfo_s));
+  net_lock();
+
+#ifdef CONFIG_NET_TCP
+  {
+    FAR struct tcp_conn_s *conn = NULL;
+
+    while ((conn = tcp_nextconn(conn)) != NULL)
+      {
+        if (index-- == 0)
+          {
+            info->proto   = "TCP";
+            info->lport   = ntohs(conn->lport);
+            info->rport   = ntohs(conn->rport);
+#ifdef CONFIG_NET_TCP_READAHEAD
+            info->rxused  = iob_get_queue_size(&conn->readahead);
+            info->rxlimit = conn->rcvbufs;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+            info->txused  = tcp_wrbuffer_inqueue_size(conn);
+            info->txlimit = conn->sndbufs;
+#endif
+            found = true;
+            break;
+          }
+      }
+  }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (!found)
+    {
+      FAR struct udp_conn_s *conn = NULL;
+
+      while ((conn = udp_nextconn(conn)) != NULL)
+        {
+          if (index-- == 0)
+            {
+              info->proto   = "UDP";
+              info->lport   = ntohs(conn->lport);
+              info->rport   = ntohs(conn->rport);
+#ifdef CONFIG_NET_UDP_READAHEAD
+              info->rxused  = iob_get_queue_size(&conn->readahead);
+              info->rxlimit = conn->rcvbufs;
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+              info->txused  = udp_wrbuffer_inqueue_size(conn);
+              info->txlimit = conn->sndbufs;
+#endif
+              found = true;
+              break;
+            }
+        }
+    }
+#endif
+
+  net_unlock();
+  return found;
+}
+
+/****************************************************************************
+ * Name: netprocfs_sockline
+ *
+ * Description:
+ *   Format the next line into the working buffer.  Line zero is the
+ *   header; each following line describes one connection.
+ *
+ * Returned Value:
+ *   The length of the line or zero if there are no more lines.
+ *
+ ****************************************************************************/
+
+static int netprocfs_sockline(FAR struct netprocfs_file_s *netfile)
+{
+  struct netprocfs_sockinfo_s info;
+
+  if (netfile->lineno == 0)
+    {
+      return snprintf(netfile->line, NET_LINELEN,
+                      "Proto Lport Rport    RxUsed   RxLimit    TxUsed   "
+                      "TxLimit\n");
+    }
+
+  if (!netprocfs_sockinfo(netfile->lineno - 1, &info))
+    {
+      return 0;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-5s %5u %5u %9lu %9lu %9lu %9lu\n",
+                  info.proto, info.lport, info.rport,
+                  (unsigned long)info.rxused, (unsigned long)info.rxlimit,
+                  (unsigned long)info.txused, (unsigned long)info.txlimit);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_sockets
+ *
+ * Description:
+ *   Read and format the buffer usage of each TCP and UDP connection.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which socket status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_sockets(FAR struct netprocfs_file_s *priv,
+                               FAR char *buffer, size_t buflen)
+{
+  size_t xfrsize;
+  ssize_t nreturned = 0;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* The number of connections is not fixed so the line generation table
+   * of netprocfs_read_linegen() cannot be used.  Lines are generated until
+   * the user buffer is full or until no more connections are found.
+   */
+
+  for (; ; )
+    {
+      /* Transfer any line data already buffered */
+
+      if (priv->linesize > 0)
+        {
+          xfrsize = priv->linesize;
+          if (xfrsize > buflen)
+            {
+              xfrsize = buflen;
+            }
+
+          memcpy(buffer, &priv->line[priv->offset], xfrsize);
+
+          buffer         += xfrsize;
+          buflen         -= xfrsize;
+
+          priv->linesize -= xfrsize;
+          priv->offset   += xfrsize;
+          nreturned      += xfrsize;
+        }
+
+      if (buflen == 0 || priv->lineno == UINT8_MAX)
+        {
+          break;
+        }
+
+      /* Read the next line into the working buffer */
+
+      priv->linesize = netprocfs_sockline(priv);
+      priv->offset   = 0;
+
+      if (priv->linesize == 0)
+        {
+          break;
+        }
+
+      priv->lineno++;
+    }
+
+  return nreturned;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && NETPROCFS_HAVE_SOCKETS */
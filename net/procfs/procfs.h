@@ -54,6 +54,13 @@
 #  undef CONFIG_NET_ROUTE
 #endif
 
+/* Per-socket buffer usage is reported if there are TCP or UDP sockets */
+
+#if (defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SOCKETS)
+#  define NETPROCFS_HAVE_SOCKETS 1
+#endif
+
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic.
  */
@@ -78,6 +85,9 @@ enum netprocfs_entry_e
 #ifdef CONFIG_NET_ROUTE
   , NETPROCFS_SUBDIR_ROUTE           /* /proc/net/route */
 #endif
+#ifdef NETPROCFS_HAVE_SOCKETS
+  , NETPROCFS_SUBDIR_SOCKETS         /* /proc/net/sockets */
+#endif
 };
 
 /* This structure describes one open "file" */
@@ -218,6 +228,29 @@ ssize_t netprocfs_read_routes(FAR struct netprocfs_file_s *priv,
                               FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_sockets
+ *
+ * Description:
+ *   Read and format the buffer usage of each TCP and UDP connection.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which socket status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef NETPROCFS_HAVE_SOCKETS
+ssize_t netprocfs_read_sockets(FAR struct netprocfs_file_s *priv,
+                               FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_devstats
  *
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H 1
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one route to the longest prefix match trie.  This must be called
+ *   after the route has been added to the routing table.
+ *
+ * Input Parameters:
+ *   route - The new route
+ *
+ * Returned Value:
+ *   None.  If the trie cannot be updated, it is discarded and rebuilt from
+ *   the routing table by the next lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(FAR const struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(FAR const struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one route from the longest prefix match trie.  This must be
+ *   called after the route has been removed from the routing table.
+ *
+ * Input Parameters:
+ *   target  - The destination network of the route
+ *   netmask - The network address mask of the route
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_dellpm_ipv4(in_addr_t target, in_addr_t netmask);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_dellpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask);
+#endif
+
+/****************************************************************************
+ * Name: net_findlpm_ipv4 and net_findlpm_ipv6
+ *
+ * Description:
+ *   Find the router for the route with the longest network prefix that
+ *   matches the target address.  The trie is built from the routing table
+ *   on first use.
+ *
+ * Input Parameters:
+ *   target - An IPv4/IPv6 address on a remote network
+ *   router - The location to return the router address
+ *
+ * Returned Value:
+ *   Zero (OK) if a route was found, -ENOENT if there is no route to the
+ *   target, or -ENOSYS if the trie cannot be used and the routing table
+ *   must be searched instead.  That happens when memory for the trie is
+ *   not available or when the table holds routes with non-contiguous
+ *   network masks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_findlpm_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_findlpm_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router);
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
@@ -49,6 +49,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -99,7 +100,18 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
   (void)net_closeroute_ipv4(&fshandle);
-  return nwritten >= 0 ? 0 : (int)nwritten;
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+#ifdef CONFIG_ROUTE_LPM
+  /* Add the new entry to the lookup trie */
+
+  net_addlpm_ipv4(&route);
+#endif
+
+  return OK;
 }
 #endif
 
@@ -133,7 +145,18 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
   (void)net_closeroute_ipv6(&fshandle);
-  return nwritten >= 0 ? 0 : (int)nwritten;
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+#ifdef CONFIG_ROUTE_LPM
+  /* Add the new entry to the lookup trie */
+
+  net_addlpm_ipv6(&route);
+#endif
+
+  return OK;
 }
 #endif
 
@@ -53,6 +53,7 @@
 
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -329,6 +330,16 @@ errout_with_fshandle:
 
 errout_with_lock:
   (void)net_unlockroute_ipv4();
+
+#ifdef CONFIG_ROUTE_LPM
+  /* Remove the entry from the lookup trie as well */
+
+  if (ret >= 0)
+    {
+      net_dellpm_ipv4(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -478,6 +489,16 @@ errout_with_fshandle:
 
 errout_with_lock:
   (void)net_unlockroute_ipv6();
+
+#ifdef CONFIG_ROUTE_LPM
+  /* Remove the entry from the lookup trie as well */
+
+  if (ret >= 0)
+    {
+      net_dellpm_ipv6(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -48,6 +48,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -221,7 +222,18 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv4(net_match_ipv4, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+#ifdef CONFIG_ROUTE_LPM
+  /* And from the lookup trie */
+
+  net_dellpm_ipv4(target, netmask);
+#endif
+
+  return OK;
 }
 #endif
 
@@ -238,7 +250,18 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  if (net_foreachroute_ipv6(net_match_ipv6, &match) == 0)
+    {
+      return -ENOENT;
+    }
+
+#ifdef CONFIG_ROUTE_LPM
+  /* And from the lookup trie */
+
+  net_dellpm_ipv6(target, netmask);
+#endif
+
+  return OK;
 }
 #endif
 
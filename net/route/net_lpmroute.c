@@ -0,0 +1,806 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+#include "route/lpmroute.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_ROUTE_LPM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the largest address held in the trie */
+
+#ifdef CONFIG_NET_IPv6
+#  define LPM_KEYLEN 16
+#else
+#  define LPM_KEYLEN 4
+#endif
+
+/* After the trie could not be allocated, lookups use the linear search and
+ * the trie is not rebuilt again until this many ticks have passed.
+ */
+
+#define LPM_RETRY_TICKS SEC2TICK(1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary trie.  A node holds a route if
+ * ln_nroutes is non-zero; otherwise it only joins two subtries that
+ * diverge at bit ln_plen.  Bit ln_plen of an address selects the child.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *ln_child[2];
+  uint16_t ln_nroutes;              /* Routes with exactly this prefix */
+  uint8_t  ln_plen;                 /* Prefix length in bits */
+  uint8_t  ln_prefix[LPM_KEYLEN];   /* Network prefix, host bits zero */
+  uint8_t  ln_router[LPM_KEYLEN];   /* Router of the first such route */
+};
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *lt_root;
+  clock_t  lt_failtime;             /* Time of the last allocation failure */
+  uint16_t lt_nirregular;           /* Routes with non-contiguous masks */
+  uint8_t  lt_keylen;               /* Address size in bytes */
+  bool     lt_valid;                /* Trie matches the routing table */
+  bool     lt_nomem;                /* lt_failtime is valid */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_trie_s g_ipv4_lpm =
+{
+  NULL, 0, 0, sizeof(in_addr_t), false, false
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_trie_s g_ipv6_lpm =
+{
+  NULL, 0, 0, sizeof(net_ipv6addr_t), false, false
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return bit 'n' of an address, counting from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline unsigned int lpm_bit(FAR const uint8_t *addr, unsigned int n)
+{
+  return (addr[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxlen', that two addresses
+ *   have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint8_t *addr1,
+                               FAR const uint8_t *addr2,
+                               unsigned int maxlen)
+{
+  unsigned int nbits = 0;
+  uint8_t diff;
+
+  while (nbits < maxlen)
+    {
+      diff = *addr1++ ^ *addr2++;
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+
+      nbits += 8;
+    }
+
+  return nbits < maxlen ? nbits : maxlen;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Return the number of leading one bits in a network mask or -EINVAL if
+ *   the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *netmask, unsigned int keylen)
+{
+  unsigned int plen = 0;
+  unsigned int i;
+  uint8_t mask;
+
+  for (i = 0; i < keylen && netmask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < keylen)
+    {
+      for (mask = netmask[i++]; (mask & 0x80) != 0; mask <<= 1)
+        {
+          plen++;
+        }
+
+      if (mask != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < keylen; i++)
+        {
+          if (netmask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_alloc
+ *
+ * Description:
+ *   Allocate a node for the first 'plen' bits of 'prefix'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_alloc(FAR struct lpm_trie_s *trie,
+                                        FAR const uint8_t *prefix,
+                                        unsigned int plen,
+                                        FAR const uint8_t *router)
+{
+  FAR struct lpm_node_s *node;
+  unsigned int nbytes = (plen + 7) >> 3;
+
+  node = (FAR struct lpm_node_s *)kmm_zalloc(sizeof(struct lpm_node_s));
+  if (node != NULL)
+    {
+      node->ln_plen = plen;
+      memcpy(node->ln_prefix, prefix, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->ln_prefix[nbytes - 1] &= 0xff << (8 - (plen & 7));
+        }
+
+      if (router != NULL)
+        {
+          node->ln_nroutes = 1;
+          memcpy(node->ln_router, router, trie->lt_keylen);
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_flush
+ *
+ * Description:
+ *   Free every node of the trie and mark it as needing to be rebuilt.
+ *
+ ****************************************************************************/
+
+static void lpm_flush(FAR struct lpm_trie_s *trie)
+{
+  FAR struct lpm_node_s *node = trie->lt_root;
+  FAR struct lpm_node_s *next;
+
+  /* Rotate left children up so that the trie can be freed without
+   * recursion.
+   */
+
+  while (node != NULL)
+    {
+      next = node->ln_child[0];
+      if (next != NULL)
+        {
+          node->ln_child[0] = next->ln_child[1];
+          next->ln_child[1] = node;
+        }
+      else
+        {
+          next = node->ln_child[1];
+          kmm_free(node);
+        }
+
+      node = next;
+    }
+
+  trie->lt_root       = NULL;
+  trie->lt_nirregular = 0;
+  trie->lt_valid      = false;
+}
+
+/****************************************************************************
+ * Name: lpm_nomem
+ *
+ * Description:
+ *   Discard a trie that could not be allocated and hold off rebuilding it
+ *   for LPM_RETRY_TICKS.  Every lookup would otherwise walk the whole
+ *   routing table and allocate nodes only to fail again.
+ *
+ ****************************************************************************/
+
+static void lpm_nomem(FAR struct lpm_trie_s *trie)
+{
+  lpm_flush(trie);
+  trie->lt_failtime = clock_systimer();
+  trie->lt_nomem    = true;
+}
+
+/****************************************************************************
+ * Name: lpm_canbuild
+ *
+ * Description:
+ *   Return true if an invalid trie should be rebuilt now.
+ *
+ ****************************************************************************/
+
+static bool lpm_canbuild(FAR struct lpm_trie_s *trie)
+{
+  if (trie->lt_nomem)
+    {
+      if (clock_systimer() - trie->lt_failtime < LPM_RETRY_TICKS)
+        {
+          return false;
+        }
+
+      trie->lt_nomem = false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a route to the trie.  If there is already a route with the same
+ *   prefix, the router of the first one is kept, as the table scan would
+ *   have found that one first.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_trie_s *trie, FAR const uint8_t *target,
+                      FAR const uint8_t *netmask, FAR const uint8_t *router)
+{
+  FAR struct lpm_node_s **link = &trie->lt_root;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *branch;
+  unsigned int common;
+  int plen;
+
+  plen = lpm_prefixlen(netmask, trie->lt_keylen);
+  if (plen < 0)
+    {
+      trie->lt_nirregular++;
+      return OK;
+    }
+
+  while ((node = *link) != NULL)
+    {
+      common = lpm_common(node->ln_prefix, target,
+                          node->ln_plen < plen ? node->ln_plen : plen);
+
+      if (common < node->ln_plen)
+        {
+          /* The new prefix leaves the path within this node */
+
+          leaf = lpm_alloc(trie, target, plen, router);
+          if (leaf == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          if (common == plen)
+            {
+              /* The new route covers this node */
+
+              leaf->ln_child[lpm_bit(node->ln_prefix, plen)] = node;
+              *link = leaf;
+            }
+          else
+            {
+              /* Join the two with a new branch node */
+
+              branch = lpm_alloc(trie, target, common, NULL);
+              if (branch == NULL)
+                {
+                  kmm_free(leaf);
+                  return -ENOMEM;
+                }
+
+              branch->ln_child[lpm_bit(node->ln_prefix, common)] = node;
+              branch->ln_child[lpm_bit(target, common)] = leaf;
+              *link = branch;
+            }
+
+          return OK;
+        }
+
+      if (node->ln_plen == plen)
+        {
+          if (node->ln_nroutes++ == 0)
+            {
+              memcpy(node->ln_router, router, trie->lt_keylen);
+            }
+
+          return OK;
+        }
+
+      link = &node->ln_child[lpm_bit(target, node->ln_plen)];
+    }
+
+  leaf = lpm_alloc(trie, target, plen, router);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *link = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove a route from the trie.
+ *
+ * Returned Value:
+ *   The node if other routes with the same prefix remain, otherwise NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_remove(FAR struct lpm_trie_s *trie,
+                                         FAR const uint8_t *target,
+                                         FAR const uint8_t *netmask)
+{
+  FAR struct lpm_node_s **plink = NULL;
+  FAR struct lpm_node_s **link = &trie->lt_root;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *parent;
+  int plen;
+
+  plen = lpm_prefixlen(netmask, trie->lt_keylen);
+  if (plen < 0)
+    {
+      if (trie->lt_nirregular > 0)
+        {
+          trie->lt_nirregular--;
+        }
+
+      return NULL;
+    }
+
+  while ((node = *link) != NULL && node->ln_plen < plen)
+    {
+      if (lpm_common(node->ln_prefix, target, node->ln_plen) <
+          node->ln_plen)
+        {
+          return NULL;
+        }
+
+      plink = link;
+      link  = &node->ln_child[lpm_bit(target, node->ln_plen)];
+    }
+
+  if (node == NULL || node->ln_plen != plen || node->ln_nroutes == 0 ||
+      lpm_common(node->ln_prefix, target, plen) < plen)
+    {
+      return NULL;
+    }
+
+  if (--node->ln_nroutes > 0)
+    {
+      return node;
+    }
+
+  /* Keep the node if it still joins two subtries */
+
+  if (node->ln_child[0] != NULL && node->ln_child[1] != NULL)
+    {
+      return NULL;
+    }
+
+  *link = node->ln_child[0] != NULL ? node->ln_child[0] : node->ln_child[1];
+  kmm_free(node);
+
+  /* A parent that holds no route and is left with one child is no longer
+   * needed either.
+   */
+
+  if (plink != NULL)
+    {
+      parent = *plink;
+      if (parent->ln_nroutes == 0 &&
+          (parent->ln_child[0] == NULL || parent->ln_child[1] == NULL))
+        {
+          *plink = parent->ln_child[0] != NULL ? parent->ln_child[0] :
+                                                 parent->ln_child[1];
+          kmm_free(parent);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Return the node with the longest prefix that matches the address.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_lookup(FAR struct lpm_trie_s *trie,
+                                         FAR const uint8_t *addr)
+{
+  FAR struct lpm_node_s *node = trie->lt_root;
+  FAR struct lpm_node_s *best = NULL;
+  unsigned int nbits = trie->lt_keylen << 3;
+
+  while (node != NULL &&
+         lpm_common(node->ln_prefix, addr, node->ln_plen) == node->ln_plen)
+    {
+      if (node->ln_nroutes > 0)
+        {
+          best = node;
+        }
+
+      if (node->ln_plen >= nbits)
+        {
+          break;
+        }
+
+      node = node->ln_child[lpm_bit(addr, node->ln_plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: lpm_build_ipv4 and lpm_build_ipv6
+ *
+ * Description:
+ *   net_foreachroute_ipv4/6() callbacks that add each route to the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_build_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  return lpm_insert(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                    (FAR const uint8_t *)&route->netmask,
+                    (FAR const uint8_t *)&route->router) < 0 ? 1 : 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_build_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  return lpm_insert(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                    (FAR const uint8_t *)route->netmask,
+                    (FAR const uint8_t *)route->router) < 0 ? 1 : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_same_ipv4 and lpm_same_ipv6
+ *
+ * Description:
+ *   net_foreachroute_ipv4/6() callbacks that find the first remaining route
+ *   with a given prefix after a duplicate has been deleted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_same_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  FAR struct net_route_ipv4_s *match = (FAR struct net_route_ipv4_s *)arg;
+
+  if (net_ipv4addr_cmp(route->netmask, match->netmask) &&
+      net_ipv4addr_maskcmp(route->target, match->target, match->netmask))
+    {
+      net_ipv4addr_copy(match->router, route->router);
+      return 1;
+    }
+
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_same_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  FAR struct net_route_ipv6_s *match = (FAR struct net_route_ipv6_s *)arg;
+
+  if (net_ipv6addr_cmp(route->netmask, match->netmask) &&
+      net_ipv6addr_maskcmp(route->target, match->target, match->netmask))
+    {
+      net_ipv6addr_copy(match->router, route->router);
+      return 1;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Add one route to the longest prefix match trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addlpm_ipv4(FAR const struct net_route_ipv4_s *route)
+{
+  net_lock();
+  if (g_ipv4_lpm.lt_valid &&
+      lpm_insert(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                 (FAR const uint8_t *)&route->netmask,
+                 (FAR const uint8_t *)&route->router) < 0)
+    {
+      nwarn("WARNING: No memory for IPv4 route trie\n");
+      lpm_nomem(&g_ipv4_lpm);
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addlpm_ipv6(FAR const struct net_route_ipv6_s *route)
+{
+  net_lock();
+  if (g_ipv6_lpm.lt_valid &&
+      lpm_insert(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                 (FAR const uint8_t *)route->netmask,
+                 (FAR const uint8_t *)route->router) < 0)
+    {
+      nwarn("WARNING: No memory for IPv6 route trie\n");
+      lpm_nomem(&g_ipv6_lpm);
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove one route from the longest prefix match trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_dellpm_ipv4(in_addr_t target, in_addr_t netmask)
+{
+  FAR struct lpm_node_s *node;
+  struct net_route_ipv4_s match;
+
+  net_lock();
+  if (g_ipv4_lpm.lt_valid)
+    {
+      node = lpm_remove(&g_ipv4_lpm, (FAR const uint8_t *)&target,
+                        (FAR const uint8_t *)&netmask);
+      if (node != NULL)
+        {
+          /* Another route with the same prefix remains.  Make sure that the
+           * trie holds its router and not that of the deleted route.
+           */
+
+          net_ipv4addr_copy(match.target, target);
+          net_ipv4addr_copy(match.netmask, netmask);
+          if (net_foreachroute_ipv4(lpm_same_ipv4, &match) > 0)
+            {
+              memcpy(node->ln_router, &match.router, sizeof(in_addr_t));
+            }
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_dellpm_ipv6(const net_ipv6addr_t target,
+                     const net_ipv6addr_t netmask)
+{
+  FAR struct lpm_node_s *node;
+  struct net_route_ipv6_s match;
+
+  net_lock();
+  if (g_ipv6_lpm.lt_valid)
+    {
+      node = lpm_remove(&g_ipv6_lpm, (FAR const uint8_t *)target,
+                        (FAR const uint8_t *)netmask);
+      if (node != NULL)
+        {
+          net_ipv6addr_copy(match.target, target);
+          net_ipv6addr_copy(match.netmask, netmask);
+          if (net_foreachroute_ipv6(lpm_same_ipv6, &match) > 0)
+            {
+              memcpy(node->ln_router, match.router, sizeof(net_ipv6addr_t));
+            }
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_findlpm_ipv4 and net_findlpm_ipv6
+ *
+ * Description:
+ *   Find the router for the route with the longest network prefix that
+ *   matches the target address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_findlpm_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct lpm_node_s *node;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (!g_ipv4_lpm.lt_valid && lpm_canbuild(&g_ipv4_lpm))
+    {
+      /* Build the trie from the routing table */
+
+      g_ipv4_lpm.lt_valid = true;
+      if (net_foreachroute_ipv4(lpm_build_ipv4, NULL) != 0)
+        {
+          nwarn("WARNING: Failed to build IPv4 route trie\n");
+          lpm_nomem(&g_ipv4_lpm);
+        }
+    }
+
+  if (g_ipv4_lpm.lt_valid && g_ipv4_lpm.lt_nirregular == 0)
+    {
+      node = lpm_lookup(&g_ipv4_lpm, (FAR const uint8_t *)&target);
+      if (node != NULL)
+        {
+          memcpy(router, node->ln_router, sizeof(in_addr_t));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_findlpm_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router)
+{
+  FAR struct lpm_node_s *node;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (!g_ipv6_lpm.lt_valid && lpm_canbuild(&g_ipv6_lpm))
+    {
+      /* Build the trie from the routing table */
+
+      g_ipv6_lpm.lt_valid = true;
+      if (net_foreachroute_ipv6(lpm_build_ipv6, NULL) != 0)
+        {
+          nwarn("WARNING: Failed to build IPv6 route trie\n");
+          lpm_nomem(&g_ipv6_lpm);
+        }
+    }
+
+  if (g_ipv6_lpm.lt_valid && g_ipv6_lpm.lt_nirregular == 0)
+    {
+      node = lpm_lookup(&g_ipv6_lpm, (FAR const uint8_t *)target);
+      if (node != NULL)
+        {
+          memcpy(router, node->ln_router, sizeof(net_ipv6addr_t));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_ROUTE_LPM */
@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -122,8 +123,9 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  This linear search
+   * has no concept of the precedence of networks; with CONFIG_ROUTE_LPM
+   * it is only used when the route trie cannot represent the table.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
@@ -165,8 +167,9 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  This linear search
+   * has no concept of the precedence of networks; with CONFIG_ROUTE_LPM
+   * it is only used when the route trie cannot represent the table.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
@@ -221,6 +224,19 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the longest matching prefix in the route trie.  -ENOSYS means
+   * that the trie cannot represent the routing table and it must be
+   * searched instead.
+   */
+
+  ret = net_findlpm_ipv4(target, router);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -296,6 +312,19 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the longest matching prefix in the route trie.  -ENOSYS means
+   * that the trie cannot represent the routing table and it must be
+   * searched instead.
+   */
+
+  ret = net_findlpm_ipv6(target, router);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -50,6 +50,8 @@
 
 #include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "can/can.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -57,6 +59,98 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: psock_bufsize_option
+ *
+ * Description:
+ *   Return the receive (SO_RCVBUF) or send (SO_SNDBUF) buffer limit of a
+ *   TCP or UDP socket.  Zero means that there is no per-socket limit.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    SO_RCVBUF or SO_SNDBUF
+ *   value     Argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.
+ *
+ ****************************************************************************/
+
+static int psock_bufsize_option(FAR struct socket *psock, int option,
+                                FAR void *value, FAR socklen_t *value_len)
+{
+  int ret = -ENOPROTOOPT;
+
+  /* Verify that option is the size of an 'int'.  Should also check
+   * that 'value' is properly aligned for an 'int'
+   */
+
+  if (*value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return -ENOPROTOOPT;
+    }
+
+#ifdef CONFIG_NET_TCP
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          *(FAR int *)value = (int)conn->rcvbufs;
+          ret = OK;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          *(FAR int *)value = (int)conn->sndbufs;
+          ret = OK;
+        }
+#endif
+      UNUSED(conn);
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          *(FAR int *)value = (int)conn->rcvbufs;
+          ret = OK;
+        }
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          *(FAR int *)value = (int)conn->sndbufs;
+          ret = OK;
+        }
+#endif
+      UNUSED(conn);
+    }
+#endif
+
+  if (ret == OK)
+    {
+      *value_len = sizeof(int);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: psock_socketlevel_option
  *
@@ -261,14 +355,16 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+      case SO_RCVBUF:     /* Sets receive buffer size */
+      case SO_SNDBUF:     /* Sets send buffer size */
+        return psock_bufsize_option(psock, option, value, value_len);
+
       /* The following are not yet implemented (return values other than {0,1) */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
       case SO_ERROR:      /* Reports and clears error status. */
       case SO_LINGER:     /* Lingers on a close() if data is present */
-      case SO_RCVBUF:     /* Sets receive buffer size */
       case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
-      case SO_SNDBUF:     /* Sets send buffer size */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       default:
@@ -357,6 +453,12 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
         ret = -ENOSYS;
        break;
 
+#ifdef CONFIG_NET_CAN
+      case SOL_CAN_RAW: /* CAN raw socket options (see include/netpacket/can.h) */
+        ret = can_getsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       default:         /* The provided level is invalid */
         ret = -EINVAL;
        break;
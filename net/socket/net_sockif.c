@@ -51,6 +51,7 @@
 #include "pkt/pkt.h"
 #include "bluetooth/bluetooth.h"
 #include "ieee802154/ieee802154.h"
+#include "can/can.h"
 #include "socket/socket.h"
 
 /****************************************************************************
@@ -128,6 +129,12 @@ FAR const struct sock_intf_s *
       break;
 #endif
 
+#ifdef CONFIG_NET_CAN
+    case PF_CAN:
+      sockif = &g_can_sockif;
+      break;
+#endif
+
     default:
       nerr("ERROR: Address family unsupported: %d\n", family);
     }
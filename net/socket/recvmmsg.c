@@ -0,0 +1,215 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define MMSG_CLOCK CLOCK_MONOTONIC
+#else
+#  define MMSG_CLOCK CLOCK_REALTIME
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg_expired
+ *
+ * Description:
+ *   Return true if the batch deadline has been reached.
+ *
+ ****************************************************************************/
+
+static bool recvmmsg_expired(FAR const struct timespec *deadline)
+{
+  struct timespec now;
+
+  (void)clock_gettime(MMSG_CLOCK, &now);
+  return now.tv_sec > deadline->tv_sec ||
+         (now.tv_sec == deadline->tv_sec &&
+          now.tv_nsec >= deadline->tv_nsec);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives up to vlen messages from a socket with a
+ *   single call.  The network is locked once for the entire batch; it is
+ *   released only while waiting for data to arrive.  The number of bytes
+ *   received for each message is returned in the msg_len member of its
+ *   entry.
+ *
+ *   If MSG_WAITFORONE is set in flags, then MSG_DONTWAIT is applied after
+ *   the first message has been received.  If timeout is not NULL, then no
+ *   further messages are received once the timeout has elapsed.  As with
+ *   Linux, the timeout is only checked after each message is received; a
+ *   blocking receive is not interrupted by it.
+ *
+ *   Local (PF_LOCAL) sockets are serviced through FIFOs that may block
+ *   while reading, so no network lock is held across a batch on those
+ *   sockets.
+ *
+ * Input Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - The array of messages to be received
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Receive flags applied to every message
+ *   timeout - Optional time limit for the batch
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received into msgvec.  On
+ *   a failure to receive the first message, -1 (ERROR) is returned and
+ *   errno is set appropriately (see recvmsg()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  struct timespec deadline;
+  unsigned int count;
+  ssize_t ret = OK;
+  bool locked = false;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if ((msgvec == NULL && vlen > 0) ||
+      (timeout != NULL &&
+       (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+        timeout->tv_nsec >= NSEC_PER_SEC)))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (timeout != NULL)
+    {
+      (void)clock_gettime(MMSG_CLOCK, &deadline);
+      clock_timespec_add(&deadline, timeout, &deadline);
+    }
+
+#ifdef CONFIG_NET_LOCAL
+  if (psock->s_domain != PF_LOCAL)
+#endif
+    {
+      net_lock();
+      locked = true;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = (unsigned int)ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && recvmmsg_expired(&deadline))
+        {
+          count++;
+          break;
+        }
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  /* An error is only reported if no message was received at all.  Running
+   * out of data (EAGAIN) after the first message is the normal way for a
+   * MSG_WAITFORONE batch to end.
+   */
+
+  if (count > 0 || ret >= 0)
+    {
+      leave_cancellation_point();
+      return (int)count;
+    }
+
+errout:
+  set_errno((int)-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+#endif /* CONFIG_NET */
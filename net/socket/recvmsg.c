@@ -0,0 +1,261 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_scatter_recvfrom
+ *
+ * Description:
+ *   Fallback used when the address family does not provide si_recvmsg().
+ *   The message is received into one contiguous kernel buffer and then
+ *   scattered into the caller's segments so that a datagram is never split
+ *   across two receive operations.
+ *
+ ****************************************************************************/
+
+static ssize_t psock_scatter_recvfrom(FAR struct socket *psock,
+                                      FAR struct msghdr *msg, int flags,
+                                      FAR socklen_t *fromlen)
+{
+  FAR const struct iovec *iov = msg->msg_iov;
+  FAR struct sockaddr *from = msg->msg_name;
+  FAR uint8_t *buffer;
+  ssize_t nrecvd;
+  size_t offset;
+  size_t len;
+  unsigned long i;
+
+  /* A single segment needs no scattering */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_recvfrom(psock, iov->iov_base, iov->iov_len, flags,
+                            from, from != NULL ? fromlen : NULL);
+    }
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(len > 0 ? len : 1);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nrecvd = psock_recvfrom(psock, buffer, len, flags, from,
+                          from != NULL ? fromlen : NULL);
+
+  for (i = 0, offset = 0; nrecvd > 0 && offset < (size_t)nrecvd; i++)
+    {
+      size_t ncopy = iov[i].iov_len;
+
+      if (ncopy > (size_t)nrecvd - offset)
+        {
+          ncopy = (size_t)nrecvd - offset;
+        }
+
+      memcpy(iov[i].iov_base, &buffer[offset], ncopy);
+      offset += ncopy;
+    }
+
+  kmm_free(buffer);
+  return nrecvd;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives one message from a socket, scattering the data
+ *   across the buffers in msg->msg_iov.  This is an internal OS interface.
+ *   It is functionally equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Buffers to receive the message.  If msg_name is non-NULL, the
+ *           source address is returned there and msg_namelen is updated.
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly
+ *   shutdown, zero is returned.  Otherwise, on any failure, a negated errno
+ *   value is returned (see comments with psock_recvfrom() for a list of
+ *   appropriate errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  socklen_t fromlen;
+  ssize_t ret;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (msg == NULL || msg->msg_iovlen > IOV_MAX ||
+      (msg->msg_iov == NULL && msg->msg_iovlen > 0))
+    {
+      return -EINVAL;
+    }
+
+  if (msg->msg_name != NULL && msg->msg_namelen <= 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Check if the address family supports a native scatter receive.  If
+   * not, or if it declines this particular request with -ENOSYS, then fall
+   * back to the generic emulation on top of psock_recvfrom().
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  msg->msg_flags = 0;
+  ret = -ENOSYS;
+  if (psock->s_sockif->si_recvmsg != NULL)
+    {
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+      ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+    }
+
+  if (ret == -ENOSYS)
+    {
+      fromlen = (socklen_t)msg->msg_namelen;
+      ret     = psock_scatter_recvfrom(psock, msg, flags, &fromlen);
+      if (ret >= 0)
+        {
+          if (msg->msg_name != NULL)
+            {
+              msg->msg_namelen = (int)fromlen;
+            }
+
+          /* Ancillary data is not supported by the emulation */
+
+          msg->msg_controllen = 0;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   The recvmsg() call is identical to recvfrom() except that the received
+ *   data is scattered into the buffers described by msg->msg_iov and the
+ *   source address is returned in msg->msg_name.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - Buffers to receive the message
+ *   flags  - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On any
+ *   failure, -1 (ERROR) is returned and errno is set appropriately (see
+ *   recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_recvmsg do all of the work */
+
+  ret = psock_recvmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   The sendmmsg() call sends up to vlen messages on a socket with a single
+ *   call.  The network is locked once for the entire batch so that the
+ *   per-message locking cost is paid only once.  The number of bytes sent
+ *   for each message is returned in the msg_len member of its entry.
+ *
+ *   Local (PF_LOCAL) sockets are serviced through FIFOs that may block
+ *   while writing, so no network lock is held across a batch on those
+ *   sockets.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msgvec - The array of messages to be sent
+ *   vlen   - The number of messages in msgvec
+ *   flags  - Send flags applied to every message
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent from msgvec.  If this
+ *   is less than vlen, then the caller may retry with the remaining
+ *   messages.  On a failure to send the first message, -1 (ERROR) is
+ *   returned and errno is set appropriately (see sendmsg()).
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  unsigned int count;
+  ssize_t ret = OK;
+  bool locked = false;
+
+  /* sendmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_NET_LOCAL
+  if (psock->s_domain != PF_LOCAL)
+#endif
+    {
+      net_lock();
+      locked = true;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[count].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[count].msg_len = (unsigned int)ret;
+    }
+
+  if (locked)
+    {
+      net_unlock();
+    }
+
+  /* An error is only reported if no message could be sent at all.  The
+   * error on a later message will be reported again on the next call.
+   */
+
+  if (count > 0 || ret >= 0)
+    {
+      leave_cancellation_point();
+      return (int)count;
+    }
+
+errout:
+  set_errno((int)-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,257 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_gather_sendto
+ *
+ * Description:
+ *   Fallback used when the address family does not provide si_sendmsg().
+ *   Stream data is sent one segment at a time; datagram data must be
+ *   gathered into one contiguous kernel buffer so that it is sent as a
+ *   single message.
+ *
+ ****************************************************************************/
+
+static ssize_t psock_gather_sendto(FAR struct socket *psock,
+                                   FAR struct msghdr *msg, int flags)
+{
+  FAR const struct iovec *iov = msg->msg_iov;
+  FAR uint8_t *buffer;
+  ssize_t nsent;
+  size_t len;
+  unsigned long i;
+
+  /* A single segment needs no gathering */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_sendto(psock, iov->iov_base, iov->iov_len, flags,
+                          msg->msg_name, msg->msg_namelen);
+    }
+
+  /* For a byte stream there are no message boundaries to preserve */
+
+  if (psock->s_type == SOCK_STREAM)
+    {
+      ssize_t total = 0;
+
+      for (i = 0; i < msg->msg_iovlen; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          nsent = psock_sendto(psock, iov[i].iov_base, iov[i].iov_len,
+                               flags, msg->msg_name, msg->msg_namelen);
+          if (nsent < 0)
+            {
+              return total > 0 ? total : nsent;
+            }
+
+          total += nsent;
+          if ((size_t)nsent < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return total;
+    }
+
+  /* Otherwise, gather the segments into one bounce buffer */
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(len > 0 ? len : 1);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      memcpy(&buffer[len], iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
+
+  nsent = psock_sendto(psock, buffer, len, flags, msg->msg_name,
+                       msg->msg_namelen);
+  kmm_free(buffer);
+  return nsent;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends the data gathered from all of the buffers in
+ *   msg->msg_iov as a single message.  This is an internal OS interface.
+ *   It is functionally equivalent to sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - The message to be sent
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On any failure, a
+ *   negated errno value is returned (see sendmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  ssize_t ret;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (msg == NULL || msg->msg_iovlen > IOV_MAX ||
+      (msg->msg_iov == NULL && msg->msg_iovlen > 0))
+    {
+      return -EINVAL;
+    }
+
+  /* Check if the address family supports a native scatter-gather send.
+   * If not, or if it declines this particular request with -ENOSYS, then
+   * fall back to the generic emulation on top of psock_sendto().
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  ret = -ENOSYS;
+  if (psock->s_sockif->si_sendmsg != NULL)
+    {
+      ret = psock->s_sockif->si_sendmsg(psock, msg, flags);
+    }
+
+  if (ret == -ENOSYS)
+    {
+      ret = psock_gather_sendto(psock, msg, flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   The sendmsg() call is identical to sendto() except that the data to be
+ *   sent is gathered from the buffers described by msg->msg_iov and the
+ *   destination address is taken from msg->msg_name.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of socket
+ *   msg    - The message to be sent
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On any failure, -1
+ *   (ERROR) is returned and errno is set appropriately (see sendto()).
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_sendmsg do all of the work */
+
+  ret = psock_sendmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
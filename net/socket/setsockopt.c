@@ -55,6 +55,7 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
+#include "can/can.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -62,6 +63,104 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: psock_bufsize_option
+ *
+ * Description:
+ *   Set the receive (SO_RCVBUF) or send (SO_SNDBUF) buffer limit of a TCP
+ *   or UDP socket.  The limit bounds the number of bytes that the socket
+ *   may hold in read-ahead or write buffer IOBs.  Zero removes the limit.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of socket to operate on
+ *   option    SO_RCVBUF or SO_SNDBUF
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.
+ *
+ ****************************************************************************/
+
+static int psock_bufsize_option(FAR struct socket *psock, int option,
+                                FAR const void *value, socklen_t value_len)
+{
+  int buffersize;
+  int ret = -ENOPROTOOPT;
+
+  /* Verify that option is the size of an 'int'.  Should also check
+   * that 'value' is properly aligned for an 'int'
+   */
+
+  if (value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  buffersize = *(FAR const int *)value;
+  if (buffersize < 0)
+    {
+      return -EINVAL;
+    }
+
+  if (psock->s_domain != PF_INET && psock->s_domain != PF_INET6)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  net_lock();
+
+#ifdef CONFIG_NET_TCP
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          conn->rcvbufs = buffersize;
+          ret = OK;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          conn->sndbufs = buffersize;
+          ret = OK;
+        }
+#endif
+      UNUSED(conn);
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          conn->rcvbufs = buffersize;
+          ret = OK;
+        }
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          conn->sndbufs = buffersize;
+          ret = OK;
+        }
+#endif
+      UNUSED(conn);
+    }
+#endif
+
+  net_unlock();
+  return ret;
+}
+
 /****************************************************************************
  * Name: psock_socketlevel_option
  *
@@ -283,11 +382,13 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 #endif
+      case SO_RCVBUF:     /* Sets receive buffer size */
+      case SO_SNDBUF:     /* Sets send buffer size */
+        return psock_bufsize_option(psock, option, value, value_len);
+
       /* The following are not yet implemented */
 
-      case SO_RCVBUF:     /* Sets receive buffer size */
       case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
-      case SO_SNDBUF:     /* Sets send buffer size */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
       /* There options are only valid when used with getopt */
@@ -400,6 +501,12 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_CAN
+      case SOL_CAN_RAW: /* CAN raw socket options (see include/netpacket/can.h) */
+        ret = can_setsockopt(psock, option, value, value_len);
+        break;
+#endif
+
       default:         /* The provided level is invalid */
         ret = -EINVAL;
         break;
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
@@ -165,9 +166,12 @@ struct tcp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the TCP/IP read-ahead data is retained.
+   *   rcvbufs   - The maximum number of bytes that may be retained in
+   *               the read-ahead queue (SO_RCVBUF).  Zero: No limit.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  uint32_t rcvbufs;               /* Read-ahead buffering limit */
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -177,10 +181,15 @@ struct tcp_conn_s
    *               list may be partially sent.  FIFO ordering.
    *   unacked_q - A queue of completely sent, but unacked I/O buffer
    *               chains.  Sequence number ordering.
+   *   sndbufs   - The maximum number of bytes that may be held in both
+   *               queues (SO_SNDBUF).  Zero: No limit.
+   *   sndsem    - Used to wait for space in the write buffer queues
    */
 
   sq_queue_t write_q;     /* Write buffering for segments */
   sq_queue_t unacked_q;   /* Write buffering for un-ACKed segments */
+  uint32_t   sndbufs;     /* Write buffering limit */
+  sem_t      sndsem;      /* Signals released write buffering */
   uint16_t   expired;     /* Number segments retransmitted but not yet ACKed,
                            * it can only be updated at TCP_ESTABLISHED state */
   uint32_t   sent;        /* The number of bytes sent (ACKed and un-ACKed) */
@@ -1295,6 +1304,33 @@ struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: psock_tcp_sendwrb
+ *
+ * Description:
+ *   Queue a write buffer that has already been filled by the caller on the
+ *   TCP connection's write queue.  Data is sent and retransmitted directly
+ *   from the write buffer's I/O buffer chain.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   wrb      The filled write buffer.  Must not be empty.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.  On failure, the
+ *   write buffer is still owned by the caller.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_WRITE_BUFFERS) && defined(CONFIG_NET_SENDFILE)
+struct tcp_wrbuffer_s;
+int psock_tcp_sendwrb(FAR struct socket *psock,
+                      FAR struct tcp_wrbuffer_s *wrb);
+#endif
+
 /****************************************************************************
  * Name: tcp_setsockopt
  *
@@ -1367,17 +1403,20 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
  * Name: tcp_get_recvwindow
  *
  * Description:
- *   Calculate the TCP receive window for the specified device.
+ *   Calculate the TCP receive window for the specified device and
+ *   connection.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection whose read-ahead limit applies.
  *
  * Returned Value:
  *   The value of the TCP receive window to use.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev);
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
 
 /****************************************************************************
  * Name: psock_tcp_cansend
@@ -1493,6 +1532,22 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb);
 int tcp_wrbuffer_test(void);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of a connection,
+ *   both those waiting to be sent and those waiting to be ACKed.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn);
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: tcp_wrbuffer_dump
  *
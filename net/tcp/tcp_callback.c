@@ -248,6 +248,18 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
   FAR struct iob_s *iob;
   int ret;
 
+  /* Enforce the read-ahead limit of the connection (SO_RCVBUF).  The first
+   * packet is always accepted into an empty queue so that a small limit
+   * can never stall the connection completely.
+   */
+
+  if (conn->rcvbufs > 0 && !IOB_QEMPTY(&conn->readahead) &&
+      iob_get_queue_size(&conn->readahead) + buflen > conn->rcvbufs)
+    {
+      ninfo("Read-ahead limit reached: %u\n", conn->rcvbufs);
+      return 0;
+    }
+
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
    * packet.
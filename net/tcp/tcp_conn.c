@@ -55,6 +55,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -722,6 +723,19 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
+#endif
+#ifdef CONFIG_NET_TCP_READAHEAD
+      conn->rcvbufs       = CONFIG_NET_RECV_BUFSIZE;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      conn->sndbufs       = CONFIG_NET_SEND_BUFSIZE;
+
+      /* The sndsem is used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      nxsem_init(&conn->sndsem, 0, 0);
+      nxsem_setprotocol(&conn->sndsem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -792,6 +806,8 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       tcp_wrbuffer_release(wrbuffer);
     }
+
+  nxsem_destroy(&conn->sndsem);
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -282,6 +282,15 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #endif
   if (listener != NULL)
     {
+      /* The new connection inherits the buffer limits of the listener */
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      conn->rcvbufs = listener->rcvbufs;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      conn->sndbufs = listener->sndbufs;
+#endif
+
       /* Yes, there is a listener.  Is it accepting connections now? */
 
       if (listener->accept)
@@ -60,17 +60,20 @@
  * Name: tcp_get_recvwindow
  *
  * Description:
- *   Calculate the TCP receive window for the specified device.
+ *   Calculate the TCP receive window for the specified device and
+ *   connection.
  *
  * Input Parameters:
- *   dev - The device whose TCP receive window will be updated.
+ *   dev  - The device whose TCP receive window will be updated.
+ *   conn - The TCP connection whose read-ahead limit applies.
  *
  * Returned Value:
  *   The value of the TCP receive window to use.
  *
  ****************************************************************************/
 
-uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
+uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
 {
   uint16_t iplen;
   uint16_t mss;
@@ -157,7 +160,26 @@ uint16_t tcp_get_recvwindow(FAR struct net_driver_s *dev)
        * buffering for this connection.
        */
 
-      rwnd = (niob_avail * CONFIG_IOB_BUFSIZE) + mss;
+      rwnd = niob_avail * CONFIG_IOB_BUFSIZE;
+
+      /* If the connection has a read-ahead limit (SO_RCVBUF), then it
+       * cannot buffer more than the space that remains under that limit,
+       * regardless of how many IOBs are free.  This keeps the peer from
+       * sending data that would only be dropped.
+       */
+
+      if (conn->rcvbufs > 0)
+        {
+          uint32_t used = iob_get_queue_size(&conn->readahead);
+          uint32_t room = used < conn->rcvbufs ? conn->rcvbufs - used : 0;
+
+          if (rwnd > room)
+            {
+              rwnd = room;
+            }
+        }
+
+      rwnd += mss;
       if (rwnd > UINT16_MAX)
         {
           rwnd = UINT16_MAX;
@@ -57,12 +57,14 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <debug.h>
 #include <debug.h>
 
 #include <arch/irq.h>
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -156,6 +158,35 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
     }
 }
 
+/****************************************************************************
+ * Name: psock_sndbuf_notify
+ *
+ * Description:
+ *   Wake up all senders that are waiting for the amount of buffered write
+ *   data to drop below the connection's write buffer limit (SO_SNDBUF).
+ *   Each re-checks the limit and waits again if there is still no room.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void psock_sndbuf_notify(FAR struct tcp_conn_s *conn)
+{
+  int val = 0;
+
+  while (nxsem_getvalue(&conn->sndsem, &val) >= 0 && val < 0)
+    {
+      nxsem_post(&conn->sndsem);
+    }
+}
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -207,6 +238,10 @@ static inline void psock_lost_connection(FAR struct socket *psock,
       sq_init(&conn->write_q);
       conn->sent       = 0;
       conn->sndseq_max = 0;
+
+      /* Wake up any sender waiting for write buffer space */
+
+      psock_sndbuf_notify(conn);
     }
 }
 
@@ -569,6 +604,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+      /* ACKed data has been released; a sender waiting for space under
+       * the write buffer limit may now proceed.
+       */
+
+      psock_sndbuf_notify(conn);
     }
 
   /* Check for a loss of connection */
@@ -1016,6 +1057,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
+  FAR struct timespec *ptimeo = NULL;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec abstime;
+#endif
   ssize_t    result = 0;
   int        ret = OK;
 
@@ -1081,11 +1126,76 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      /* The wait for room in the write buffers is bounded by SO_SNDTIMEO */
+
+      if (psock->s_sndtimeo != 0)
+        {
+          DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
+
+          abstime.tv_sec  += psock->s_sndtimeo / DSEC_PER_SEC;
+          abstime.tv_nsec += (psock->s_sndtimeo % DSEC_PER_SEC) *
+                             NSEC_PER_DSEC;
+          if (abstime.tv_nsec >= NSEC_PER_SEC)
+            {
+              abstime.tv_sec++;
+              abstime.tv_nsec -= NSEC_PER_SEC;
+            }
+
+          ptimeo = &abstime;
+        }
+#endif
+
+      net_lock();
+
+      /* Enforce the write buffer limit of the connection (SO_SNDBUF).
+       * Wait until the amount of buffered data drops below the limit.  A
+       * non-blocking send may only buffer up to the limit.
+       */
+
+      while (conn->sndbufs > 0)
+        {
+          uint32_t used = tcp_wrbuffer_inqueue_size(conn);
+
+          if (used < conn->sndbufs)
+            {
+              if (_SS_ISNONBLOCK(psock->s_flags) &&
+                  len > conn->sndbufs - used)
+                {
+                  len = conn->sndbufs - used;
+                }
+
+              break;
+            }
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_timedwait(&conn->sndsem, ptimeo);
+          if (ret < 0)
+            {
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = -EAGAIN;
+                }
+
+              goto errout_with_lock;
+            }
+
+          if (!_SS_ISCONNECTED(psock->s_flags))
+            {
+              ret = -ENOTCONN;
+              goto errout_with_lock;
+            }
+        }
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       if (_SS_ISNONBLOCK(psock->s_flags))
         {
           wrb = tcp_wrbuffer_tryalloc();
@@ -1225,6 +1335,86 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_tcp_sendwrb
+ *
+ * Description:
+ *   Queue a write buffer that has already been filled by the caller on the
+ *   TCP connection's write queue.  The I/O buffer chain is then owned by
+ *   the TCP stack and will be sent and, if necessary, retransmitted
+ *   directly from the IOBs.  This is used by tcp_sendfile() which reads
+ *   the file data into the write buffer without an intermediate copy.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   wrb      The filled write buffer.  Must not be empty.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.  On failure, the
+ *   write buffer is still owned by the caller.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+int psock_tcp_sendwrb(FAR struct socket *psock,
+                      FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_conn_s *conn;
+
+  DEBUGASSERT(psock != NULL && wrb != NULL && TCP_WBPKTLEN(wrb) > 0);
+
+  if (psock->s_type != SOCK_STREAM || !_SS_ISCONNECTED(psock->s_flags))
+    {
+      nerr("ERROR: Not connected\n");
+      return -ENOTCONN;
+    }
+
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
+  /* Allocate resources to receive a callback */
+
+  if (psock->s_sndcb == NULL)
+    {
+      psock->s_sndcb = tcp_callback_alloc(conn);
+      if (psock->s_sndcb == NULL)
+        {
+          nerr("ERROR: Failed to allocate callback\n");
+          return -ENOMEM;
+        }
+    }
+
+  /* Set up the callback in the connection */
+
+  psock->s_sndcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
+                           TCP_DISCONN_EVENTS);
+  psock->s_sndcb->priv  = (FAR void *)psock;
+  psock->s_sndcb->event = psock_send_eventhandler;
+
+  /* Initialize the write buffer */
+
+  TCP_WBSEQNO(wrb) = (unsigned)-1;
+  TCP_WBNRTX(wrb)  = 0;
+
+  /* psock_send_eventhandler() will send data in FIFO order from the
+   * conn->write_q
+   */
+
+  sq_addlast(&wrb->wb_node, &conn->write_q);
+  ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
+        wrb, TCP_WBPKTLEN(wrb),
+        conn->write_q.head, conn->write_q.tail);
+
+  /* Notify the device driver of the availability of TX data */
+
+  send_txnotify(psock, conn);
+  return OK;
+}
+#endif /* CONFIG_NET_SENDFILE */
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -1251,6 +1441,8 @@ errout:
 
 int psock_tcp_cansend(FAR struct socket *psock)
 {
+  FAR struct tcp_conn_s *conn;
+
   /* Verify that we received a valid socket */
 
   if (!psock || psock->s_crefs <= 0)
@@ -1267,6 +1459,9 @@ int psock_tcp_cansend(FAR struct socket *psock)
       return -ENOTCONN;
     }
 
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn != NULL);
+
   /* In order to setup the send, we need to have at least one free write
    * buffer head and at least one free IOB to initialize the write buffer head.
    *
@@ -1280,6 +1475,14 @@ int psock_tcp_cansend(FAR struct socket *psock)
       return -EWOULDBLOCK;
     }
 
+  /* The connection must also be below its write buffer limit */
+
+  if (conn->sndbufs > 0 &&
+      tcp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+    {
+      return -EWOULDBLOCK;
+    }
+
   return OK;
 }
 
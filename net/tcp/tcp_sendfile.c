@@ -58,6 +58,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -82,6 +83,14 @@
 #  define CONFIG_NET_TCP_SPLIT_SIZE 40
 #endif
 
+/* The maximum amount of file data that will be read into one write buffer
+ * when write buffering is enabled.
+ */
+
+#ifndef CONFIG_NET_SENDFILE_CHUNKSIZE
+#  define CONFIG_NET_SENDFILE_CHUNKSIZE 4096
+#endif
+
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
@@ -93,6 +102,7 @@
  * operated upon from the driver poll event.
  */
 
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
 struct sendfile_s
 {
   FAR struct socket *snd_sock;    /* Points to the parent socket structure */
@@ -109,11 +119,232 @@ struct sendfile_s
   clock_t            snd_time;    /* Last send time for determining timeout */
 #endif
 };
+#endif /* !CONFIG_NET_TCP_WRITE_BUFFERS */
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+/****************************************************************************
+ * Name: sendfile_wrbfill
+ *
+ * Description:
+ *   Read file data directly into the I/O buffer chain of a write buffer.
+ *   The data is read only once; the TCP stack will send and retransmit it
+ *   from the IOBs without going back to the file.
+ *
+ *   Additional IOBs are allocated without waiting so that we never block
+ *   while holding a partially filled write buffer.  The caller will just
+ *   queue whatever could be read and try again with a new write buffer.
+ *
+ * Input Parameters:
+ *   wrb    - The write buffer to fill.  It holds one empty IOB on entry.
+ *   infile - The file to read from (at its current file position)
+ *   len    - The maximum number of bytes to read
+ *
+ * Returned Value:
+ *   The number of bytes read into the write buffer, zero at the end of the
+ *   file, or a negated errno value if nothing could be read.
+ *
+ * Assumptions:
+ *   The network is NOT locked.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_wrbfill(FAR struct tcp_wrbuffer_s *wrb,
+                                FAR struct file *infile, size_t len)
+{
+  FAR struct iob_s *iob = TCP_WBIOB(wrb);
+  size_t nfilled = 0;
+
+  while (nfilled < len)
+    {
+      ssize_t nread;
+      size_t chunk;
+
+      /* Extend the chain if the current IOB is full */
+
+      if (iob->io_len >= CONFIG_IOB_BUFSIZE)
+        {
+          FAR struct iob_s *next = iob_tryalloc(false);
+          if (next == NULL)
+            {
+              break;
+            }
+
+          iob->io_flink = next;
+          iob           = next;
+        }
+
+      chunk = CONFIG_IOB_BUFSIZE - iob->io_len;
+      if (chunk > len - nfilled)
+        {
+          chunk = len - nfilled;
+        }
+
+      nread = file_read(infile, &iob->io_data[iob->io_len], chunk);
+      if (nread < 0)
+        {
+          if (nfilled == 0)
+            {
+              nerr("ERROR: Failed to read from input file: %d\n",
+                   (int)nread);
+              return nread;
+            }
+
+          break;
+        }
+      else if (nread == 0)
+        {
+          /* End of file */
+
+          break;
+        }
+
+      iob->io_len       += nread;
+      TCP_WBPKTLEN(wrb) += nread;
+      nfilled           += nread;
+    }
+
+  return nfilled;
+}
+
+/****************************************************************************
+ * Name: sendfile_buffered
+ *
+ * Description:
+ *   Perform sendfile() when TCP write buffering is enabled.  The file is
+ *   read in chunks directly into write buffers which are then queued on
+ *   the connection's write queue just as for send().  Data is never read
+ *   from the file more than once, even if it has to be retransmitted.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   infile   The file to read from
+ *   offset   The file offset to start from, or NULL to use (and update)
+ *            the current file position.
+ *   count    The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes queued for sending or a negated errno value if
+ *   nothing could be queued.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_buffered(FAR struct socket *psock,
+                                 FAR struct file *infile,
+                                 FAR off_t *offset, size_t count)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  off_t startpos = 0;
+  size_t nsent = 0;
+  ssize_t ret = OK;
+
+  /* If an offset was provided, remember the current file position so that
+   * it can be restored when we are finished.
+   */
+
+  if (offset != NULL)
+    {
+      startpos = file_seek(infile, 0, SEEK_CUR);
+      if (startpos < 0)
+        {
+          return (ssize_t)startpos;
+        }
+
+      ret = file_seek(infile, *offset, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Set the socket state to sending */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  while (nsent < count)
+    {
+      size_t chunk = count - nsent;
+      ssize_t nread;
+
+      if (chunk > CONFIG_NET_SENDFILE_CHUNKSIZE)
+        {
+          chunk = CONFIG_NET_SENDFILE_CHUNKSIZE;
+        }
+
+      /* Allocate a write buffer.  Careful, the network will be momentarily
+       * unlocked here.
+       */
+
+      net_lock();
+      if (_SS_ISNONBLOCK(psock->s_flags))
+        {
+          wrb = tcp_wrbuffer_tryalloc();
+        }
+      else
+        {
+          wrb = tcp_wrbuffer_alloc();
+        }
+
+      net_unlock();
+
+      if (wrb == NULL)
+        {
+          nerr("ERROR: Failed to allocate write buffer\n");
+          ret = _SS_ISNONBLOCK(psock->s_flags) ? -EAGAIN : -ENOMEM;
+          break;
+        }
+
+      /* Read the file data into the IOB chain with the network unlocked;
+       * the file system may block.
+       */
+
+      nread = sendfile_wrbfill(wrb, infile, chunk);
+
+      net_lock();
+      if (nread <= 0)
+        {
+          tcp_wrbuffer_release(wrb);
+          net_unlock();
+          ret = nread;
+          break;
+        }
+
+      TCP_WBDUMP("I/O buffer chain", wrb, TCP_WBPKTLEN(wrb), 0);
+
+      /* Hand the write buffer over to the TCP stack */
+
+      ret = psock_tcp_sendwrb(psock, wrb);
+      if (ret < 0)
+        {
+          tcp_wrbuffer_release(wrb);
+          net_unlock();
+          break;
+        }
+
+      net_unlock();
+      nsent += nread;
+    }
+
+  /* Set the socket state to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  /* Return the offset of the next byte and restore the file position */
+
+  if (offset != NULL)
+    {
+      *offset += nsent;
+      file_seek(infile, startpos, SEEK_SET);
+    }
+
+  return nsent > 0 ? (ssize_t)nsent : ret;
+}
+
+#else /* CONFIG_NET_TCP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: sendfile_timeout
  *
@@ -318,7 +549,7 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
 }
 
 #else /* CONFIG_NET_ETHERNET */
-#  sendfile_addrcheck(r) (true)
+#  define sendfile_addrcheck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
 /****************************************************************************
@@ -555,6 +786,7 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
     }
 #endif /* CONFIG_NET_IPv6 */
 }
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
 /****************************************************************************
  * Public Functions
@@ -584,8 +816,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
   struct sendfile_s state;
-  int ret;
+#endif
+  int ret = OK;
 
   /* If this is an un-connected socket, then return ENOTCONN */
 
@@ -631,6 +865,12 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  /* Read the file into write buffers and queue them for transmission */
+
+  UNUSED(ret);
+  return sendfile_buffered(psock, infile, offset, count);
+#else
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -734,6 +974,7 @@ errout_locked:
     {
       return state.snd_sent;
     }
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 }
 
 #endif /* CONFIG_NET_SENDFILE && CONFIG_NET_TCP && NET_TCP_HAVE_STACK */
@@ -269,6 +269,45 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
   nxsem_post(&g_wrbuffer.sem);
 }
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of a connection,
+ *   both those waiting to be sent and those waiting to be ACKed.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t total = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry != NULL; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (wrb->wb_iob != NULL)
+        {
+          total += wrb->wb_iob->io_pktlen;
+        }
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry != NULL; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (wrb->wb_iob != NULL)
+        {
+          total += wrb->wb_iob->io_pktlen;
+        }
+    }
+
+  return total;
+}
+
 /****************************************************************************
  * Name: tcp_wrbuffer_test
  *
@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
@@ -126,9 +127,12 @@ struct udp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the UDP/IP read-ahead data is retained.
+   *   rcvbufs   - The maximum number of bytes that may be retained in
+   *               the read-ahead queue (SO_RCVBUF).  Zero: No limit.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  uint32_t rcvbufs;               /* Read-ahead buffering limit */
 #endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
@@ -136,10 +140,15 @@ struct udp_conn_s
    *
    *   write_q   - The queue of unsent I/O buffers.  The head of this
    *               list may be partially sent.  FIFO ordering.
+   *   sndbufs   - The maximum number of bytes that may be held in the
+   *               write queue (SO_SNDBUF).  Zero: No limit.
+   *   sndsem    - Used to wait for space in the write queue
    */
 
   sq_queue_t write_q;             /* Write buffering for UDP packets */
   FAR struct net_driver_s *dev;   /* Last device */
+  uint32_t sndbufs;               /* Write buffering limit */
+  sem_t    sndsem;                /* Signals released write buffering */
 #endif
 
   /* Defines the list of UDP callbacks */
@@ -458,6 +467,22 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void);
 void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb);
 #endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of a connection
+ *   that are waiting to be sent.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: udp_wrbuffer_test
  *
@@ -631,6 +656,35 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmsg
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendmsg() socket operation.  The data in all of the buffers is
+ *   gathered into a single datagram.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iov      The buffers holding the data to send
+ *   iovcnt   The number of buffers
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+struct iovec;  /* Forward reference */
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen);
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
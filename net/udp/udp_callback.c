@@ -90,6 +90,18 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
+  /* Enforce the read-ahead limit of the connection (SO_RCVBUF).  A datagram
+   * is always accepted into an empty queue so that a datagram larger than
+   * a small limit can still be received.
+   */
+
+  if (conn->rcvbufs > 0 && !IOB_QEMPTY(&conn->readahead) &&
+      iob_get_queue_size(&conn->readahead) + buflen > conn->rcvbufs)
+    {
+      ninfo("Read-ahead limit reached: %u\n", conn->rcvbufs);
+      return 0;
+    }
+
   /* Allocate on I/O buffer to start the chain (throttling as necessary).
    * We will not wait for an I/O buffer to become available in this context.
    */
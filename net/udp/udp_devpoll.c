@@ -52,6 +52,7 @@
 #include <nuttx/net/udp.h>
 
 #include "devif/devif.h"
+#include "ipfrag/ipfrag.h"
 #include "udp/udp.h"
 
 /****************************************************************************
@@ -105,6 +106,12 @@ void udp_poll(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       if (dev->d_sndlen > 0)
         {
           udp_send(dev, conn);
+
+#ifdef CONFIG_NET_IPFRAG
+          /* Fragment the datagram if it is larger than the MTU */
+
+          ipfrag_txfinish(dev);
+#endif
           return;
         }
     }
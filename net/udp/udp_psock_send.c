@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -86,3 +87,24 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
 
   return psock_udp_sendto(psock, buf, len, 0, NULL, 0);
 }
+
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendmsg(psock, &iov, 1, flags, to, tolen);
+}
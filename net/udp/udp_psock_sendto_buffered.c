@@ -51,6 +51,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -62,6 +63,7 @@
 
 #include <arch/irq.h>
 #include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -73,6 +75,7 @@
 #include "inet/inet.h"
 #include "arp/arp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipfrag/ipfrag.h"
 #include "neighbor/neighbor.h"
 #include "udp/udp.h"
 #include "devif/devif.h"
@@ -129,6 +132,34 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendto_sndbuf_notify
+ *
+ * Description:
+ *   Wake up a sender that is waiting for the amount of buffered write data
+ *   to drop below the connection's write buffer limit (SO_SNDBUF).
+ *
+ * Input Parameters:
+ *   conn - The UDP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void sendto_sndbuf_notify(FAR struct udp_conn_s *conn)
+{
+  int val = 0;
+
+  if (nxsem_getvalue(&conn->sndsem, &val) >= 0 && val < 0)
+    {
+      nxsem_post(&conn->sndsem);
+    }
+}
+
 /****************************************************************************
  * Name: sendto_writebuffer_release
  *
@@ -178,6 +209,7 @@ static void sendto_writebuffer_release(FAR struct socket *psock,
           DEBUGASSERT(wrb != NULL);
 
           udp_wrbuffer_release(wrb);
+          sendto_sndbuf_notify(conn);
 
           /* Set up for the next packet transfer by setting the connection
            * address to the address of the next packet now at the header of
@@ -549,7 +581,21 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
            * corresponding to the size of the IP-dependent address structure.
            */
 
-          devif_iob_send(dev, wrb->wb_iob, sndlen, 0);
+#ifdef CONFIG_NET_IPFRAG
+          /* Switch to the large buffer if the datagram will not fit in
+           * the MTU.
+           */
+
+          if (ipfrag_txsetup(dev, sndlen) < 0)
+            {
+              nwarn("WARNING: Dropping %u byte datagram\n",
+                    (unsigned int)sndlen);
+            }
+          else
+#endif
+            {
+              devif_iob_send(dev, wrb->wb_iob, sndlen, 0);
+            }
 
           /* Free the write buffer at the head of the queue and attempt to
            * setup the next transfer.
@@ -588,16 +634,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendmsg
  *
  * Description:
  *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   sendmsg() socket operation.  The data in all of the buffers is
+ *   gathered into a single datagram.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      The buffers holding the data to send
+ *   iovcnt   The number of buffers
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
@@ -612,13 +659,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+  unsigned int offset;
+  size_t len;
   int ret = OK;
+  int i;
 
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
@@ -741,9 +792,51 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Dump the incoming buffers and get the size of the datagram */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_udp_send", iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
+
+#ifdef CONFIG_NET_IPFRAG
+  /* The datagram is queued and sendto() reports success before the driver
+   * polls for it, so a datagram that could never be fragmented must be
+   * refused here rather than silently dropped by sendto_eventhandler().
+   * This is the same limit that ipfrag_txsetup() applies to the IP
+   * datagram:  the payload plus the real IP and UDP header sizes.
+   */
+
+    {
+      unsigned int udpiplen;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (psock->s_domain == PF_INET)
+#endif
+        {
+          udpiplen = IPv4UDP_HDRLEN;
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          udpiplen = IPv6UDP_HDRLEN;
+        }
+#endif /* CONFIG_NET_IPv6 */
 
-  BUF_DUMP("psock_udp_send", buf, len);
+      if (len + udpiplen > CONFIG_NET_IPFRAG_MAXSIZE)
+        {
+          nerr("ERROR: %u byte datagram exceeds the fragmentation limit\n",
+               (unsigned int)len);
+          return -EMSGSIZE;
+        }
+    }
+#endif /* CONFIG_NET_IPFRAG */
 
   /* Set the socket state to sending */
 
@@ -751,11 +844,33 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+      /* Enforce the write buffer limit of the connection (SO_SNDBUF).
+       * Wait until the amount of buffered data drops below the limit.
+       */
+
+      while (conn->sndbufs > 0 &&
+             udp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+        {
+          if (_SS_ISNONBLOCK(psock->s_flags) ||
+              (flags & MSG_DONTWAIT) != 0)
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->sndsem);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = udp_wrbuffer_alloc();
       if (wrb == NULL)
         {
@@ -813,22 +928,30 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       wrb->wb_start = clock_systimer();
 #endif
 
-      /* Copy the user data into the write buffer.  We cannot wait for
+      /* Gather the user data into the write buffer.  We cannot wait for
        * buffer space if the socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-      else
+      for (i = 0, offset = 0; i < iovcnt; i++)
         {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = iob_trycopyin(wrb->wb_iob,
+                                  (FAR uint8_t *)iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+            }
+          else
+            {
+              ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+            }
 
-      if (ret < 0)
-        {
-          goto errout_with_wrb;
+          if (ret < 0)
+            {
+              goto errout_with_wrb;
+            }
+
+          offset += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
@@ -906,6 +1029,8 @@ errout_with_lock:
 
 int psock_udp_cansend(FAR struct socket *psock)
 {
+  FAR struct udp_conn_s *conn;
+
   /* Verify that we received a valid socket */
 
   if (!psock || psock->s_crefs <= 0)
@@ -927,6 +1052,15 @@ int psock_udp_cansend(FAR struct socket *psock)
       return -EWOULDBLOCK;
     }
 
+  /* The connection must also be below its write buffer limit */
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+  if (conn != NULL && conn->sndbufs > 0 &&
+      udp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+    {
+      return -EWOULDBLOCK;
+    }
+
   return OK;
 }
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -42,6 +42,7 @@
 #ifdef CONFIG_NET_UDP
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -57,6 +58,7 @@
 #include "devif/devif.h"
 #include "arp/arp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipfrag/ipfrag.h"
 #include "socket/socket.h"
 #include "udp/udp.h"
 
@@ -85,8 +87,9 @@ struct sendto_s
 #endif
   FAR struct devif_callback_s *st_cb; /* Reference to callback instance */
   sem_t st_sem;                       /* Semaphore signals sendto completion */
-  uint16_t st_buflen;                 /* Length of send buffer (error if <0) */
-  const char *st_buffer;              /* Pointer to send buffer */
+  uint16_t st_buflen;                 /* Total length of send buffers */
+  int st_iovcnt;                      /* Number of send buffers */
+  FAR const struct iovec *st_iov;     /* Send buffers */
   int st_sndlen;                      /* Result of the send (length sent or negated errno) */
 };
 
@@ -206,6 +209,9 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
                                     uint16_t flags)
 {
   FAR struct sendto_s *pstate = (FAR struct sendto_s *)pvpriv;
+#ifdef CONFIG_NET_IPFRAG
+  int ret;
+#endif
 
   ninfo("flags: %04x\n", flags);
   if (pstate)
@@ -266,10 +272,27 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
           sendto_ipselect(dev, pstate);
 #endif
 
-          /* Copy the user data into d_appdata and send it */
+#ifdef CONFIG_NET_IPFRAG
+          /* Switch to the large buffer if the datagram will not fit in
+           * the MTU.
+           */
 
-          devif_send(dev, pstate->st_buffer, pstate->st_buflen);
-          pstate->st_sndlen = pstate->st_buflen;
+          ret = ipfrag_txsetup(dev, pstate->st_buflen);
+          if (ret < 0)
+            {
+              nwarn("WARNING: Cannot send %u bytes: %d\n",
+                    (unsigned int)pstate->st_buflen, ret);
+              pstate->st_sndlen = ret;
+            }
+          else
+#endif
+            {
+              /* Copy the user data into d_appdata and send it */
+
+              devif_iovsend(dev, pstate->st_iov, pstate->st_iovcnt,
+                            pstate->st_buflen);
+              pstate->st_sndlen = pstate->st_buflen;
+            }
         }
 
       /* Don't allow any further call backs. */
@@ -291,16 +314,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendmsg
  *
  * Description:
  *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   sendmsg() socket operation.  The data in all of the buffers is
+ *   gathered into a single datagram.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      The buffers holding the data to send
+ *   iovcnt   The number of buffers
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
@@ -315,14 +339,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendmsg(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt,
+                          int flags, FAR const struct sockaddr *to,
+                          socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct net_driver_s *dev;
   struct sendto_s state;
+  size_t len;
   int ret;
+  int i;
 
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
@@ -464,8 +491,14 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   nxsem_init(&state.st_sem, 0, 0);
   nxsem_setprotocol(&state.st_sem, SEM_PRIO_NONE);
 
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   state.st_buflen = len;
-  state.st_buffer = buf;
+  state.st_iovcnt = iovcnt;
+  state.st_iov    = iov;
 
 #if defined(CONFIG_NET_SOCKOPTS) || defined(NEED_IPDOMAIN_SUPPORT)
   /* Save the reference to the socket structure if it will be needed for
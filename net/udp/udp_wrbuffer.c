@@ -197,6 +197,36 @@ void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb)
   nxsem_post(&g_wrbuffer.sem);
 }
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the number of bytes held in the write buffers of a connection
+ *   that are waiting to be sent.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  uint32_t total = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry != NULL; entry = sq_next(entry))
+    {
+      wrb = (FAR struct udp_wrbuffer_s *)entry;
+      if (wrb->wb_iob != NULL)
+        {
+          total += wrb->wb_iob->io_pktlen;
+        }
+    }
+
+  return total;
+}
+
 /****************************************************************************
  * Name: udp_wrbuffer_test
  *
@@ -1,7 +1,7 @@
 /****************************************************************************
- * libc/net/lib_recvmsg.c
+ * sched/clock/clock_timepage.c
  *
- *   Copyright (C) 2007, 2008, 2012, 2008 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -39,51 +39,53 @@
 
 #include <nuttx/config.h>
 
-#ifdef CONFIG_NET
+#include <time.h>
 
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <errno.h>
+#include <nuttx/clock.h>
+#include <nuttx/userspace.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: recvmsg
+ * Name: clock_timepage_update
  *
  * Description:
- *   The recvmsg() call is identical to recvfrom() with a NULL from parameter.
+ *   Copy the system timer and the time-of-day base into the user-space time
+ *   page so that the user-space clock_gettime() can derive the same time
+ *   that the kernel would report.  The sequence count is odd while the
+ *   update is in progress.
  *
- * Parameters:
- *   sockfd   Socket descriptor of socket
- *   buf      Buffer to receive data
- *   len      Length of buffer
- *   flags    Receive flags
+ * Input Parameters:
+ *   None
  *
  * Returned Value:
- *  (see recvfrom)
+ *   None
  *
  * Assumptions:
+ *   Called from the timer interrupt or with interrupts disabled.
  *
  ****************************************************************************/
 
-ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+void clock_timepage_update(void)
 {
-  FAR void *buf             = msg->msg_iov->iov_base;
-  FAR struct sockaddr *from = msg->msg_name;
-  FAR socklen_t *fromlen    = (FAR socklen_t *)&msg->msg_namelen;
-  size_t len                = msg->msg_iov->iov_len;
+  FAR struct clock_timepage_s *page = USERSPACE->us_timepage;
 
-  if (msg->msg_iovlen == 1)
-    {
-      return recvfrom(sockfd, buf, len, flags, from, fromlen);
-    }
-  else
+  if (page != NULL)
     {
-      set_errno(ENOTSUP);
-      return ERROR;
+      page->seq++;
+
+      page->systimer = g_system_timer;
+      page->basesec  = g_basetime.tv_sec;
+      page->basensec = g_basetime.tv_nsec;
+
+      page->seq++;
     }
 }
 
-#endif /* CONFIG_NET */
+#endif /* CONFIG_CLOCK_TIMEPAGE */
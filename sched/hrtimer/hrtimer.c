@@ -0,0 +1,646 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* An expiration time that will never be reached */
+
+#define HRTIMER_NEVER     UINT64_MAX
+
+/* The shortest delay that will be programmed into the platform timer.
+ * Times that have already passed are rounded up to this so that the
+ * interrupt is still taken (rather than the timer being rejected).
+ */
+
+#define HRTIMER_MIN_DELAY NSEC_PER_USEC
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Active timers are kept in a binary min-heap ordered by expiration time.
+ * The heap is 1-based (g_hrtimer_heap[1] holds the earliest timer) so that
+ * a zero index in struct hrtimer_s means "not queued".
+ */
+
+static FAR struct hrtimer_s *g_hrtimer_heap[CONFIG_HRTIMER_NTIMERS + 1];
+static unsigned int g_hrtimer_count;
+
+/* The scheduler's deadline (absolute nanoseconds) */
+
+static uint64_t g_hrtimer_sched = HRTIMER_NEVER;
+
+/* The time that the platform timer is currently programmed for */
+
+static uint64_t g_hrtimer_armed = HRTIMER_NEVER;
+
+/* True while expired timers are being processed.  The platform timer is
+ * re-programmed once when processing completes.
+ */
+
+static bool g_hrtimer_running;
+
+#ifdef CONFIG_HRTIMER_LATENCY
+static struct hrtimer_latency_s g_hrtimer_latency;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_ts2ns and hrtimer_ns2ts
+ *
+ * Description:
+ *   Convert between struct timespec and 64-bit nanoseconds.
+ *
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_ts2ns(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + (uint64_t)ts->tv_nsec;
+}
+
+static inline void hrtimer_ns2ts(uint64_t ns, FAR struct timespec *ts)
+{
+  ts->tv_sec  = (time_t)(ns / NSEC_PER_SEC);
+  ts->tv_nsec = (long)(ns % NSEC_PER_SEC);
+}
+
+/****************************************************************************
+ * Name: hrtimer_swap, hrtimer_siftup, and hrtimer_siftdown
+ *
+ * Description:
+ *   Min-heap maintenance.  The index in each timer follows the timer as it
+ *   moves through the heap.
+ *
+ ****************************************************************************/
+
+static inline void hrtimer_swap(unsigned int a, unsigned int b)
+{
+  FAR struct hrtimer_s *tmp = g_hrtimer_heap[a];
+
+  g_hrtimer_heap[a]        = g_hrtimer_heap[b];
+  g_hrtimer_heap[b]        = tmp;
+  g_hrtimer_heap[a]->index = a;
+  g_hrtimer_heap[b]->index = b;
+}
+
+static void hrtimer_siftup(unsigned int ndx)
+{
+  while (ndx > 1 &&
+         g_hrtimer_heap[ndx]->expired < g_hrtimer_heap[ndx >> 1]->expired)
+    {
+      hrtimer_swap(ndx, ndx >> 1);
+      ndx >>= 1;
+    }
+}
+
+static void hrtimer_siftdown(unsigned int ndx)
+{
+  unsigned int child;
+
+  while ((child = ndx << 1) <= g_hrtimer_count)
+    {
+      if (child < g_hrtimer_count &&
+          g_hrtimer_heap[child + 1]->expired < g_hrtimer_heap[child]->expired)
+        {
+          child++;
+        }
+
+      if (g_hrtimer_heap[ndx]->expired <= g_hrtimer_heap[child]->expired)
+        {
+          break;
+        }
+
+      hrtimer_swap(ndx, child);
+      ndx = child;
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_remove
+ *
+ * Description:
+ *   Remove the timer at heap position ndx.
+ *
+ ****************************************************************************/
+
+static void hrtimer_remove(unsigned int ndx)
+{
+  FAR struct hrtimer_s *timer = g_hrtimer_heap[ndx];
+  FAR struct hrtimer_s *moved;
+  unsigned int last = g_hrtimer_count--;
+
+  timer->index = 0;
+
+  if (ndx != last)
+    {
+      /* Move the last timer into the hole and restore the heap order */
+
+      moved               = g_hrtimer_heap[last];
+      g_hrtimer_heap[ndx] = moved;
+      moved->index        = ndx;
+
+      hrtimer_siftup(ndx);
+      hrtimer_siftdown(moved->index);
+    }
+
+  g_hrtimer_heap[last] = NULL;
+}
+
+/****************************************************************************
+ * Name: hrtimer_queued
+ *
+ * Description:
+ *   Return true if the timer is currently in the heap.  The back reference
+ *   is checked so that a stale index never removes someone else's timer.
+ *
+ ****************************************************************************/
+
+static inline bool hrtimer_queued(FAR struct hrtimer_s *timer)
+{
+  return timer->index > 0 && timer->index <= g_hrtimer_count &&
+         g_hrtimer_heap[timer->index] == timer;
+}
+
+/****************************************************************************
+ * Name: hrtimer_now
+ *
+ * Description:
+ *   Return the current platform time in nanoseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t hrtimer_now(void)
+{
+  struct timespec ts;
+
+  (void)up_timer_gettime(&ts);
+  return hrtimer_ts2ns(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the platform timer for the earlier of the scheduler deadline
+ *   and the first high resolution timer.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int hrtimer_reprogram(uint64_t now)
+{
+  struct timespec ts;
+  uint64_t next;
+  int ret = OK;
+
+  if (g_hrtimer_running)
+    {
+      return OK;
+    }
+
+  next = g_hrtimer_sched;
+  if (g_hrtimer_count > 0 && g_hrtimer_heap[1]->expired < next)
+    {
+      next = g_hrtimer_heap[1]->expired;
+    }
+
+  if (next == g_hrtimer_armed)
+    {
+      return OK;
+    }
+
+  /* Stop the platform timer if it is running */
+
+  if (g_hrtimer_armed != HRTIMER_NEVER)
+    {
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+      (void)up_alarm_cancel(&ts);
+#else
+      (void)up_timer_cancel(&ts);
+#endif
+      g_hrtimer_armed = HRTIMER_NEVER;
+    }
+
+  if (next != HRTIMER_NEVER)
+    {
+      if (next < now + HRTIMER_MIN_DELAY)
+        {
+          next = now + HRTIMER_MIN_DELAY;
+        }
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+      hrtimer_ns2ts(next, &ts);
+      ret = up_alarm_start(&ts);
+#else
+      hrtimer_ns2ts(next - now, &ts);
+      ret = up_timer_start(&ts);
+#endif
+      if (ret >= 0)
+        {
+          g_hrtimer_armed = next;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_account
+ *
+ * Description:
+ *   Add one expiration to the latency statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_LATENCY
+static void hrtimer_account(uint64_t latency)
+{
+  uint64_t usecs = latency / NSEC_PER_USEC;
+  unsigned int bucket = 0;
+
+  while (usecs > 0 && bucket < HRTIMER_NHISTOGRAM - 1)
+    {
+      usecs >>= 1;
+      bucket++;
+    }
+
+  g_hrtimer_latency.count++;
+  g_hrtimer_latency.total += latency;
+  g_hrtimer_latency.hist[bucket]++;
+
+  if (latency > g_hrtimer_latency.max)
+    {
+      g_hrtimer_latency.max = latency > UINT32_MAX ? UINT32_MAX :
+                              (uint32_t)latency;
+    }
+}
+#else
+#  define hrtimer_account(l)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_init
+ *
+ * Description:
+ *   Initialize a high resolution timer.
+ *
+ ****************************************************************************/
+
+void hrtimer_init(FAR struct hrtimer_s *timer, hrtimer_callback_t func,
+                  FAR void *arg)
+{
+  DEBUGASSERT(timer != NULL);
+
+  timer->expired = 0;
+  timer->func    = func;
+  timer->arg     = arg;
+  timer->index   = 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the current value of the high resolution time base.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+  return hrtimer_now();
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or re-start) a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t ns, int flags)
+{
+  irqstate_t intflags;
+  uint64_t now;
+  int ret;
+
+  if (timer == NULL || timer->func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  intflags = enter_critical_section();
+
+  /* Remove the timer if it is already queued */
+
+  if (hrtimer_queued(timer))
+    {
+      hrtimer_remove(timer->index);
+    }
+
+  if (g_hrtimer_count >= CONFIG_HRTIMER_NTIMERS)
+    {
+      leave_critical_section(intflags);
+      return -ENOMEM;
+    }
+
+  now = hrtimer_now();
+
+  if ((flags & HRTIMER_ABSTIME) != 0)
+    {
+      timer->expired = ns;
+    }
+  else
+    {
+      timer->expired = ns > HRTIMER_NEVER - now ? HRTIMER_NEVER - 1 :
+                       now + ns;
+    }
+
+  /* Add the timer at the bottom of the heap and let it rise */
+
+  g_hrtimer_count++;
+  g_hrtimer_heap[g_hrtimer_count] = timer;
+  timer->index = g_hrtimer_count;
+  hrtimer_siftup(g_hrtimer_count);
+
+  ret = hrtimer_reprogram(now);
+  if (ret < 0)
+    {
+      hrtimer_remove(timer->index);
+      serr("ERROR: Failed to program the timer: %d\n", ret);
+    }
+
+  leave_critical_section(intflags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+
+  if (timer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (hrtimer_queued(timer))
+    {
+      hrtimer_remove(timer->index);
+
+      /* There is no need to re-program the platform timer.  At worst, it
+       * will fire early and find nothing to do.
+       */
+    }
+
+  timer->index = 0;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_remaining
+ *
+ * Description:
+ *   Return the time remaining before a high resolution timer expires.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_remaining(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  uint64_t remaining = 0;
+  uint64_t now;
+
+  flags = enter_critical_section();
+  if (timer != NULL && hrtimer_queued(timer))
+    {
+      now = hrtimer_now();
+      if (timer->expired > now)
+        {
+          remaining = timer->expired - now;
+        }
+    }
+
+  leave_critical_section(flags);
+  return remaining;
+}
+
+/****************************************************************************
+ * Name: hrtimer_latency
+ *
+ * Description:
+ *   Return the expiration latency statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_LATENCY
+void hrtimer_latency(FAR struct hrtimer_latency_s *latency, bool reset)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(latency != NULL);
+
+  flags = enter_critical_section();
+  memcpy(latency, &g_hrtimer_latency, sizeof(struct hrtimer_latency_s));
+
+  if (reset)
+    {
+      memset(&g_hrtimer_latency, 0, sizeof(struct hrtimer_latency_s));
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_sched_start
+ *
+ * Description:
+ *   Set the scheduler deadline.
+ *
+ ****************************************************************************/
+
+int hrtimer_sched_start(FAR const struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+  int ret;
+
+  flags = enter_critical_section();
+  now   = hrtimer_now();
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  g_hrtimer_sched = hrtimer_ts2ns(ts);
+#else
+  g_hrtimer_sched = now + hrtimer_ts2ns(ts);
+#endif
+
+  ret = hrtimer_reprogram(now);
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_sched_cancel
+ *
+ * Description:
+ *   Remove the scheduler deadline.
+ *
+ ****************************************************************************/
+
+int hrtimer_sched_cancel(FAR struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t now;
+  int ret;
+
+  flags = enter_critical_section();
+  now   = hrtimer_now();
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  hrtimer_ns2ts(now, ts);
+#else
+  if (g_hrtimer_sched != HRTIMER_NEVER && g_hrtimer_sched > now)
+    {
+      hrtimer_ns2ts(g_hrtimer_sched - now, ts);
+    }
+  else
+    {
+      ts->tv_sec  = 0;
+      ts->tv_nsec = 0;
+    }
+#endif
+
+  g_hrtimer_sched = HRTIMER_NEVER;
+  ret = hrtimer_reprogram(now);
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_sched_expired
+ *
+ * Description:
+ *   Run the expired high resolution timers and report whether the
+ *   scheduler deadline has been reached.
+ *
+ ****************************************************************************/
+
+bool hrtimer_sched_expired(void)
+{
+  FAR struct hrtimer_s *timer;
+  irqstate_t flags;
+  uint64_t now;
+  bool due = false;
+
+  flags = enter_critical_section();
+
+  /* The platform timer has fired and is now idle */
+
+  g_hrtimer_armed   = HRTIMER_NEVER;
+  g_hrtimer_running = true;
+
+  now = hrtimer_now();
+  while (g_hrtimer_count > 0 && g_hrtimer_heap[1]->expired <= now)
+    {
+      /* Dequeue the timer before calling it so that the callback may
+       * re-start the same timer.
+       */
+
+      timer = g_hrtimer_heap[1];
+      hrtimer_remove(1);
+      hrtimer_account(now - timer->expired);
+
+      timer->func(timer);
+      now = hrtimer_now();
+    }
+
+  g_hrtimer_running = false;
+
+  if (g_hrtimer_sched <= now)
+    {
+      g_hrtimer_sched = HRTIMER_NEVER;
+      due = true;
+    }
+
+  (void)hrtimer_reprogram(now);
+  leave_critical_section(flags);
+  return due;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_HRTIMER_HRTIMER_H
+#define __SCHED_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* When CONFIG_HRTIMER is selected, the hrtimer logic owns the platform
+ * tickless timer.  The scheduler's own deadline becomes just one more
+ * expiration time, multiplexed with the pending high resolution timers.
+ * The interfaces below replace the direct calls to up_alarm_start(),
+ * up_alarm_cancel(), up_timer_start(), and up_timer_cancel() in
+ * sched/sched/sched_timerexpiration.c and have the same semantics.
+ */
+
+/****************************************************************************
+ * Name: hrtimer_sched_start
+ *
+ * Description:
+ *   Set the scheduler deadline.  If CONFIG_SCHED_TICKLESS_ALARM is selected,
+ *   ts is an absolute time (as for up_alarm_start()); otherwise it is an
+ *   interval from now (as for up_timer_start()).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value from the platform timer
+ *   interface on failure.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+int hrtimer_sched_start(FAR const struct timespec *ts);
+
+/****************************************************************************
+ * Name: hrtimer_sched_cancel
+ *
+ * Description:
+ *   Remove the scheduler deadline.  If CONFIG_SCHED_TICKLESS_ALARM is
+ *   selected, the current time is returned in ts (as for
+ *   up_alarm_cancel()); otherwise the time remaining until the deadline is
+ *   returned (as for up_timer_cancel()).
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+int hrtimer_sched_cancel(FAR struct timespec *ts);
+
+/****************************************************************************
+ * Name: hrtimer_sched_expired
+ *
+ * Description:
+ *   Called at the beginning of sched_alarm_expiration() and
+ *   sched_timer_expiration() when the platform timer fires.  All high
+ *   resolution timers that are due are run and the platform timer is
+ *   re-programmed for the next event.
+ *
+ * Returned Value:
+ *   True if the scheduler deadline has been reached and the normal
+ *   expiration processing should be performed; false if the interrupt was
+ *   only for the high resolution timers.
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+bool hrtimer_sched_expired(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __SCHED_HRTIMER_HRTIMER_H */
@@ -163,6 +163,29 @@ int os_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP_BALANCE
+      /* Pull any task that is waiting in the g_readytorun list and that is
+       * permitted to run on this CPU.  Normally such tasks are started
+       * when the lock that held them back is released; this catches the
+       * cases where that was not possible.
+       *
+       * The lists are first checked without a critical section so that an
+       * idle CPU does not contend for the IRQ lock on every pass.
+       */
+
+      if (sched_cpu_pullable(this_cpu()))
+        {
+          irqstate_t flags = enter_critical_section();
+
+          if (!sched_islocked_global() && sched_cpu_imbalanced())
+            {
+              up_release_pending();
+            }
+
+          leave_critical_section(flags);
+        }
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
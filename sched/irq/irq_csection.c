@@ -136,24 +136,32 @@ static inline bool irq_waitlock(int cpu)
 
   while (spin_trylock(&g_cpu_irqlock) == SP_LOCKED)
     {
-      /* Is a pause request pending? */
+      /* Spin with plain reads until the lock looks free, so that the
+       * waiting CPUs do not keep stealing the cache line from the holder.
+       */
 
-      if (up_cpu_pausereq(cpu))
+      do
         {
-          /* Yes.. some other CPU is requesting to pause this CPU!
-           * Abort the wait and return false.
-           */
+          /* Is a pause request pending? */
+
+          if (up_cpu_pausereq(cpu))
+            {
+              /* Yes.. some other CPU is requesting to pause this CPU!
+               * Abort the wait and return false.
+               */
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
-          /* Notify that we are waiting for a spinlock */
+              /* Notify that we are waiting for a spinlock */
 
-          sched_note_spinabort(tcb, &g_cpu_irqlock);
+              sched_note_spinabort(tcb, &g_cpu_irqlock);
 #endif
 
-          return false;
-        }
+              return false;
+            }
 
-      SP_DSB();
+          SP_DSB();
+        }
+      while (spin_islocked(&g_cpu_irqlock));
     }
 
   /* We have g_cpu_irqlock! */
@@ -552,7 +560,9 @@ void leave_critical_section(irqstate_t flags)
                    * because we were within a critical section then.
                    */
 
-                  if (g_pendingtasks.head != NULL && !sched_islocked_global())
+                  if ((g_pendingtasks.head != NULL ||
+                       sched_cpu_needbalance()) &&
+                      !sched_islocked_global())
                     {
                       /* Release any ready-to-run tasks that have collected
                        * in g_pendingtasks.  NOTE: This operation has a very
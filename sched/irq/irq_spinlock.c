@@ -52,9 +52,12 @@
  * Public Data
  ****************************************************************************/
 
-/* Used for access control */
+/* Used for access control.  With CONFIG_SPINLOCK_FAIR, this is a ticket
+ * lock so that a CPU that keeps re-taking the lock cannot starve the
+ * others.
+ */
 
-static volatile spinlock_t g_irq_spin SP_SECTION = SP_UNLOCKED;
+static struct spinlock_ticket_s g_irq_spin SP_SECTION = SP_TICKET_INITIALIZER;
 
 /* Handles nested calls to spin_lock_irqsave and spin_unlock_irqrestore */
 
@@ -97,7 +100,7 @@ irqstate_t spin_lock_irqsave(void)
   int me = this_cpu();
   if (0 == g_irq_spin_count[me])
     {
-      spin_lock(&g_irq_spin);
+      spin_lock_ticket(&g_irq_spin);
     }
 
   g_irq_spin_count[me]++;
@@ -136,7 +139,7 @@ void spin_unlock_irqrestore(irqstate_t flags)
 
   if (0 == g_irq_spin_count[me])
     {
-      spin_unlock(&g_irq_spin);
+      spin_unlock_ticket(&g_irq_spin);
     }
 
   up_irq_restore(flags);
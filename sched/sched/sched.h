@@ -321,6 +321,14 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
  */
 
 extern volatile uint32_t g_cpuload_total;
+
+#ifdef CONFIG_SMP
+/* This is the number of clock ticks that each CPU spent running a task
+ * other than its IDLE task, scaled back together with g_cpuload_total.
+ */
+
+extern volatile uint32_t g_cpuload_busy[CONFIG_SMP_NCPUS];
+#endif
 #endif
 
 /* Declared in sched_lock.c *************************************************/
@@ -400,6 +408,16 @@ extern volatile spinlock_t g_cpu_tasklistlock SP_SECTION;
 extern volatile int16_t g_global_lockcount;
 #endif
 
+#ifdef CONFIG_SMP_BALANCE
+/* Set when a task is added to the g_readytorun list, a CPU becomes idle or
+ * an affinity mask changes; cleared when sched_cpu_imbalanced() finds that
+ * there is nothing to migrate.  While it is clear, the lists need not be
+ * examined.
+ */
+
+extern volatile bool g_cpu_unbalanced;
+#endif
+
 #endif /* CONFIG_SMP */
 
 /****************************************************************************
@@ -458,6 +476,27 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_admit(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+void sched_deadline_start(FAR struct tcb_s *tcb);
+void sched_deadline_stop(FAR struct tcb_s *tcb);
+void sched_deadline_wakeup(FAR struct tcb_s *tcb);
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches);
+
+/* True if 'tcb1' must run before 'tcb2' of the same priority, i.e., both
+ * are SCHED_DEADLINE threads and 'tcb1' has the earlier absolute deadline.
+ */
+
+#  define sched_deadline_precedes(tcb1,tcb2) \
+     (((tcb1)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      ((tcb2)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE && \
+      (sclock_t)((tcb1)->deadline.abstime - (tcb2)->deadline.abstime) < 0)
+#else
+#  define sched_deadline_precedes(tcb1,tcb2) (false)
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void sched_suspend(FAR struct tcb_s *tcb);
 void sched_continue(FAR struct tcb_s *tcb);
@@ -471,6 +510,20 @@ FAR struct tcb_s *this_task(void);
 int  sched_cpu_select(cpu_set_t affinity);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_SMP_BALANCE
+bool sched_cpu_imbalanced(void);
+bool sched_cpu_pullable(int cpu);
+bool sched_cpu_balance(void);
+#  define sched_cpu_setunbalanced() do { g_cpu_unbalanced = true; } while (0)
+#  define sched_cpu_needbalance() (g_cpu_unbalanced && sched_cpu_imbalanced())
+#else
+#  define sched_cpu_imbalanced()  (false)
+#  define sched_cpu_pullable(c)   (false)
+#  define sched_cpu_balance()     (false)
+#  define sched_cpu_setunbalanced()
+#  define sched_cpu_needbalance() (false)
+#endif
+
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
 
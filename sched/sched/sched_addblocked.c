@@ -111,4 +111,15 @@ void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state)
   /* Make sure the TCB's state corresponds to the list */
 
   btcb->task_state = task_state;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The CBS wake-up rule is applied when the thread becomes ready-to-run
+   * again.
+   */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      btcb->deadline.blocked = true;
+    }
+#endif
 }
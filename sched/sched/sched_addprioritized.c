@@ -89,11 +89,20 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
+   * SCHED_DEADLINE threads of the same priority are further kept in
+   * order of increasing absolute deadline.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
        (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+       next = next->flink)
+    {
+      if (sched_priority == next->sched_priority &&
+          sched_deadline_precedes(tcb, next))
+        {
+          break;
+        }
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -85,13 +85,30 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A SCHED_DEADLINE thread that is waking up from a blocked state may
+   * need a new deadline.  Threads that are only re-queued (on a priority
+   * change or a yield, for example) keep their current deadline.
+   */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      btcb->deadline.blocked)
+    {
+      btcb->deadline.blocked = false;
+      sched_deadline_wakeup(btcb);
+    }
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 &&
+      (rtcb->sched_priority < btcb->sched_priority ||
+       (rtcb->sched_priority == btcb->sched_priority &&
+        sched_deadline_precedes(btcb, rtcb))))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -178,6 +195,20 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   irqstate_t lock = sched_tasklist_lock();
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A SCHED_DEADLINE thread that is waking up from a blocked state may
+   * need a new deadline.  Threads that are only re-queued (on a priority
+   * change or a yield, for example) keep their current deadline.
+   */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      btcb->deadline.blocked)
+    {
+      btcb->deadline.blocked = false;
+      sched_deadline_wakeup(btcb);
+    }
+#endif
+
   /* Check if the blocked TCB is locked to this CPU */
 
   if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
@@ -204,7 +235,9 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
    * the new task will be running and a context switch switch will be required.
    */
 
-  if (rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->sched_priority < btcb->sched_priority ||
+      (rtcb->sched_priority == btcb->sched_priority &&
+       sched_deadline_precedes(btcb, rtcb)))
     {
       task_state = TSTATE_TASK_RUNNING;
     }
@@ -263,6 +296,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        */
 
       (void)sched_addprioritized(btcb, (FAR dq_queue_t *)&g_readytorun);
+      sched_cpu_setunbalanced();
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
       doswitch         = false;
@@ -399,6 +433,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
                 {
                   next->task_state = TSTATE_TASK_READYTORUN;
                   tasklist         = (FAR dq_queue_t *)&g_readytorun;
+                  sched_cpu_setunbalanced();
                 }
 
               (void)sched_addprioritized(next, tasklist);
@@ -100,6 +100,16 @@
 
 volatile uint32_t g_cpuload_total;
 
+#ifdef CONFIG_SMP
+/* This is the number of clock ticks that each CPU spent running a task other
+ * than its IDLE task.  It is scaled back with g_cpuload_total and so gives
+ * the recent load of each CPU.  It is used by sched_cpu_select() to spread
+ * work across CPUs.
+ */
+
+volatile uint32_t g_cpuload_busy[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -139,6 +149,15 @@ static inline void sched_cpu_process_cpuload(int cpu)
   hash_index = PIDHASH(rtcb->pid);
   g_pidhash[hash_index].ticks++;
 
+#ifdef CONFIG_SMP
+  /* The IDLE task is always the last task in the assigned task list */
+
+  if (rtcb->flink != NULL)
+    {
+      g_cpuload_busy[cpu]++;
+    }
+#endif
+
   /* Increment tick count.  NOTE that the count is increment once for each
    * CPU on each sample interval.
    */
@@ -208,6 +227,13 @@ void weak_function sched_process_cpuload(void)
           total += g_pidhash[i].ticks;
         }
 
+#ifdef CONFIG_SMP
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          g_cpuload_busy[i] >>= 1;
+        }
+#endif
+
       /* Save the new total. */
 
       g_cpuload_total = total;
@@ -40,10 +40,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <queue.h>
 #include <assert.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/arch.h>
 
+#include "irq/irq.h"
 #include "sched/sched.h"
 
 #ifdef CONFIG_SMP
@@ -54,6 +58,161 @@
 
 #define IMPOSSIBLE_CPU 0xff
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+/* Set when the g_readytorun list must be examined by
+ * sched_cpu_imbalanced().
+ */
+
+volatile bool g_cpu_unbalanced;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  sched_cpu_nassigned
+ *
+ * Description:
+ *   Return the number of tasks queued in the assigned task list of a CPU,
+ *   not counting the running task and the IDLE task.  These are tasks that
+ *   are locked to the CPU and are waiting for it.
+ *
+ ****************************************************************************/
+
+static inline int sched_cpu_nassigned(int cpu)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)g_assignedtasks[cpu].head;
+  int nassigned = 0;
+
+  for (tcb = tcb->flink; tcb != NULL && tcb->flink != NULL; tcb = tcb->flink)
+    {
+      nassigned++;
+    }
+
+  return nassigned;
+}
+
+/****************************************************************************
+ * Name:  sched_cpu_better
+ *
+ * Description:
+ *   Decide between two CPUs whose running tasks have the same priority.
+ *   The CPU making the request is preferred:  The task being made ready-to-
+ *   run was most likely woken by the running task of this CPU and so shares
+ *   its cache, and no other CPU has to be paused to start it.  Otherwise
+ *   the CPU with fewer tasks locked to it and, if CPU load measurement is
+ *   enabled, the less loaded CPU is preferred.
+ *
+ * Input Parameters:
+ *   cpu - The candidate CPU
+ *   best - The best CPU found so far
+ *   nbest - The number of tasks assigned to 'best' or -1 if that has not
+ *     been counted yet.  Updated when 'cpu' becomes the best CPU so that
+ *     each assigned task list is walked at most once per selection.
+ *   me - The CPU making the request
+ *
+ * Returned Value:
+ *   true if 'cpu' is a better choice than 'best'
+ *
+ ****************************************************************************/
+
+static bool sched_cpu_better(int cpu, int best, FAR int *nbest, int me)
+{
+  int ncpu;
+
+  if (best == me)
+    {
+      return false;
+    }
+
+  if (cpu == me)
+    {
+      *nbest = -1;
+      return true;
+    }
+
+  if (*nbest < 0)
+    {
+      *nbest = sched_cpu_nassigned(best);
+    }
+
+  ncpu = sched_cpu_nassigned(cpu);
+  if (ncpu > *nbest)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (ncpu == *nbest && g_cpuload_busy[cpu] >= g_cpuload_busy[best])
+    {
+      return false;
+    }
+#else
+  if (ncpu == *nbest)
+    {
+      return false;
+    }
+#endif
+
+  *nbest = ncpu;
+  return true;
+}
+
+/****************************************************************************
+ * Name:  sched_cpu_idleset
+ *
+ * Description:
+ *   Return the set of CPUs that are currently running their IDLE task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+static cpu_set_t sched_cpu_idleset(void)
+{
+  cpu_set_t idleset = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      /* The IDLE task is always the last task in the assigned task list */
+
+      if (current_task(i)->flink == NULL)
+        {
+          idleset |= (1 << i);
+        }
+    }
+
+  return idleset;
+}
+#endif
+
+/****************************************************************************
+ * Name:  sched_cpu_idlework
+ *
+ * Description:
+ *   Return the highest priority task in the g_readytorun list that may run
+ *   on one of the CPUs in 'idleset', or NULL if there is no such task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+static FAR struct tcb_s *sched_cpu_idlework(cpu_set_t idleset)
+{
+  FAR struct tcb_s *tcb;
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL && (tcb->affinity & idleset) == 0;
+       tcb = tcb->flink);
+
+  return tcb;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -63,7 +222,7 @@
  *
  * Description:
  *   Return the index to the CPU with the lowest priority running task,
- *   possbily its IDLE task.
+ *   possbily its IDLE task.  Ties are broken by sched_cpu_better().
  *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
@@ -78,16 +237,20 @@
 
 int sched_cpu_select(cpu_set_t affinity)
 {
-  uint8_t minprio;
+  int minprio;
+  int nbest;
   int cpu;
+  int me;
   int i;
 
-  /* Otherwise, find the CPU that is executing the lowest priority task
-   * (possibly its IDLE task).
+  /* Find the CPU that is executing the lowest priority task (possibly its
+   * IDLE task).
    */
 
-  minprio = SCHED_PRIORITY_MAX;
+  minprio = SCHED_PRIORITY_MAX + 1;
+  nbest   = -1;
   cpu     = IMPOSSIBLE_CPU;
+  me      = this_cpu();
 
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
@@ -97,23 +260,22 @@ int sched_cpu_select(cpu_set_t affinity)
         {
           FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
 
-          /* If this thread is executing its IDLE task, the use it.  The
-           * IDLE task is always the last task in the assigned task list.
+          /* The IDLE task is always the last task in the assigned task list
+           * and should always have a priority of zero.
            */
 
-          if (rtcb->flink == NULL)
-            {
-              /* The IDLE task should always be assigned to this CPU and have
-               * a priority of zero.
-               */
+          DEBUGASSERT(rtcb->flink != NULL || rtcb->sched_priority == 0);
+          DEBUGASSERT(rtcb->flink == NULL || rtcb->sched_priority > 0);
 
-              DEBUGASSERT(rtcb->sched_priority == 0);
-              return i;
-            }
-          else if (rtcb->sched_priority < minprio)
+          if (rtcb->sched_priority < minprio)
             {
-              DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
+              nbest   = -1;
+              cpu     = i;
+            }
+          else if (rtcb->sched_priority == minprio &&
+                   sched_cpu_better(i, cpu, &nbest, me))
+            {
               cpu = i;
             }
         }
@@ -123,4 +285,146 @@ int sched_cpu_select(cpu_set_t affinity)
   return cpu;
 }
 
+/****************************************************************************
+ * Name:  sched_cpu_imbalanced
+ *
+ * Description:
+ *   Return true if some CPU is running its IDLE task while a task that is
+ *   permitted to run on that CPU waits in the g_readytorun list.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   true if sched_cpu_balance() would migrate a task.  If not,
+ *   g_cpu_unbalanced is cleared so that sched_cpu_needbalance() does not
+ *   call this function again until the lists change.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+bool sched_cpu_imbalanced(void)
+{
+  cpu_set_t idleset;
+
+  if (g_readytorun.head != NULL)
+    {
+      idleset = sched_cpu_idleset();
+      if (idleset != 0 && sched_cpu_idlework(idleset) != NULL)
+        {
+          return true;
+        }
+    }
+
+  g_cpu_unbalanced = false;
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name:  sched_cpu_pullable
+ *
+ * Description:
+ *   Return true if a task waiting in the g_readytorun list may be started
+ *   on 'cpu' and pre-emption is not disabled.  This is called by the IDLE
+ *   task of 'cpu' so that it enters a critical section only when a
+ *   migration is possible.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose IDLE task is calling
+ *
+ * Returned Value:
+ *   true if sched_cpu_imbalanced() might return true.
+ *
+ * Assumptions:
+ *   Called without a critical section.  The lists are read without a lock
+ *   so the result is only a hint; the caller must recheck with
+ *   sched_cpu_imbalanced() within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+bool sched_cpu_pullable(int cpu)
+{
+  if (!g_cpu_unbalanced || g_readytorun.head == NULL ||
+      sched_islocked_global())
+    {
+      return false;
+    }
+
+  return sched_cpu_idlework((cpu_set_t)(1 << cpu)) != NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name:  sched_cpu_balance
+ *
+ * Description:
+ *   Migrate tasks waiting in the g_readytorun list to CPUs that are running
+ *   their IDLE task.  The highest priority task that may run on an idle
+ *   CPU is moved first and each task is only started on a CPU in its
+ *   affinity mask.  Nothing is done while pre-emption is disabled or while
+ *   another CPU is in a critical section.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   true if the task running on this CPU has changed and a context switch
+ *   is needed.
+ *
+ * Assumptions:
+ *   Called from within a critical section.  Called from
+ *   sched_mergepending() so that the caller of up_release_pending()
+ *   performs any needed context switch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_BALANCE
+bool sched_cpu_balance(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t lock;
+  cpu_set_t idleset;
+  bool ret = false;
+  int me = this_cpu();
+
+  lock = sched_tasklist_lock();
+
+  while (!sched_islocked_global() && !irq_cpu_locked(me))
+    {
+      /* Find the highest priority task that may run on an idle CPU */
+
+      idleset = sched_cpu_idleset();
+      if (idleset == 0)
+        {
+          break;
+        }
+
+      tcb = sched_cpu_idlework(idleset);
+      if (tcb == NULL)
+        {
+          break;
+        }
+
+      /* Remove the task from the g_readytorun list and add it back.
+       * sched_cpu_select() will pick one of the idle CPUs since the task
+       * necessarily has a priority above that of the IDLE task.
+       */
+
+      dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+
+      sched_tasklist_unlock(lock);
+      ret |= sched_addreadytorun(tcb);
+      lock = sched_tasklist_lock();
+    }
+
+  sched_tasklist_unlock(lock);
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_SMP */
@@ -0,0 +1,341 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/* Bandwidth (runtime / period) is kept as a fixed point fraction of one
+ * CPU with DEADLINE_BW_SHIFT fractional bits.
+ */
+
+#define DEADLINE_BW_SHIFT  20
+#define DEADLINE_BW(r,p)   ((uint32_t)(((uint64_t)(r) << DEADLINE_BW_SHIFT) / (p)))
+#define DEADLINE_BW_LIMIT \
+  ((uint32_t)(((uint64_t)CONFIG_SCHED_DEADLINE_UTILIZATION << DEADLINE_BW_SHIFT) / 100))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidth reserved by all SCHED_DEADLINE threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_admit
+ *
+ * Description:
+ *   Validate the SCHED_DEADLINE parameters and perform admission control.
+ *   If the thread is already a SCHED_DEADLINE thread, its current
+ *   reservation is replaced by the new one.  On success the new parameters
+ *   are saved in the TCB but the server is not started; see
+ *   sched_deadline_start().
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The new scheduling parameters
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure:
+ *
+ *   EINVAL - The parameters do not satisfy runtime <= deadline <= period.
+ *   EBUSY  - The new reservation would exceed the admission limit.
+ *
+ ****************************************************************************/
+
+int sched_deadline_admit(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  irqstate_t flags;
+  sclock_t runtime;
+  sclock_t deadline;
+  sclock_t period;
+  uint32_t oldbw = 0;
+  uint32_t newbw;
+
+  /* Convert timespec values to system clock ticks */
+
+  (void)clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  (void)clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  (void)clock_time2ticks(&param->sched_dl_period, &period);
+
+  /* A zero period means that the period is equal to the deadline */
+
+  if (period <= 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime < 1 || deadline < runtime || period < deadline)
+    {
+      return -EINVAL;
+    }
+
+  newbw = DEADLINE_BW(runtime, period);
+
+  /* Replace any existing reservation with the new one */
+
+  flags = enter_critical_section();
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      oldbw = DEADLINE_BW(dl->runtime, dl->period);
+    }
+
+  if (g_deadline_bw - oldbw + newbw > DEADLINE_BW_LIMIT)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  g_deadline_bw = g_deadline_bw - oldbw + newbw;
+
+  dl->runtime   = (uint32_t)runtime;
+  dl->deadline  = (uint32_t)deadline;
+  dl->period    = (uint32_t)period;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_start
+ *
+ * Description:
+ *   Start a new server period for the thread: Refill its budget and set its
+ *   absolute deadline relative to the current time.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.  The caller must reprioritize the thread
+ *   afterward so that its position in the ready-to-run list reflects the
+ *   new deadline.
+ *
+ ****************************************************************************/
+
+void sched_deadline_start(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  dl->budget  = dl->runtime;
+  dl->abstime = clock_systimer() + dl->deadline;
+  dl->missed  = false;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_stop
+ *
+ * Description:
+ *   Release the bandwidth reserved by a thread that is leaving the
+ *   SCHED_DEADLINE policy or that is exiting.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_deadline_stop(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  irqstate_t flags;
+  uint32_t bw;
+
+  DEBUGASSERT(dl->period > 0);
+  bw = DEADLINE_BW(dl->runtime, dl->period);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_deadline_bw >= bw);
+  g_deadline_bw -= bw;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sched_deadline_wakeup
+ *
+ * Description:
+ *   Apply the CBS wake-up rule to a SCHED_DEADLINE thread that is becoming
+ *   ready-to-run:  The current deadline is kept only if the remaining
+ *   budget can be consumed before it without exceeding the reserved
+ *   bandwidth.  Otherwise (or if the deadline has already passed), a new
+ *   period is started.  This keeps a thread that slept from waking up with
+ *   a stale, early deadline and monopolizing the CPU.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled and the thread is not yet in the ready-to-run
+ *   list.
+ *
+ ****************************************************************************/
+
+void sched_deadline_wakeup(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  sclock_t remaining;
+
+  remaining = (sclock_t)(dl->abstime - clock_systimer());
+  if (remaining <= 0 ||
+      (uint64_t)dl->budget * dl->period > (uint64_t)remaining * dl->runtime)
+    {
+      sched_deadline_start(tcb);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_deadline_process
+ *
+ * Description:
+ *   Charge elapsed time against the budget of the currently executing
+ *   SCHED_DEADLINE thread.  When the budget is exhausted, the CBS rule
+ *   postpones the deadline by one period and refills the budget; the thread
+ *   is then moved behind any deadline thread that now has an earlier
+ *   deadline.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently executing task
+ *   ticks - The number of ticks that have elapsed on the interval timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number of ticks remaining in the current budget.  The value one is
+ *   returned if the budget is exhausted but the required context switch
+ *   cannot be performed now.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The task associated with TCB uses the deadline scheduling policy
+ *
+ ****************************************************************************/
+
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  DEBUGASSERT(tcb != NULL);
+
+  /* A deadline is missed if the thread is still running after it.  Count
+   * each deadline only once.
+   */
+
+  if (!dl->missed && (sclock_t)(clock_systimer() - dl->abstime) > 0)
+    {
+      dl->nmisses++;
+      dl->missed = true;
+    }
+
+  /* Charge the elapsed time against the budget */
+
+  dl->budget -= MIN(dl->budget, ticks);
+  if (dl->budget > 0)
+    {
+      return dl->budget;
+    }
+
+  /* The budget is exhausted.  Defer the replenishment until the thread can
+   * actually be moved in the ready-to-run list.
+   */
+
+  if (noswitches || sched_islocked_tcb(tcb))
+    {
+      return 1;
+    }
+
+  dl->noverruns++;
+  dl->abstime += dl->period;
+  dl->budget   = dl->runtime;
+  dl->missed   = false;
+
+  /* We know we are at the head of the ready to run list.  If the next task
+   * now has the earlier deadline, then we need to relinquish the CPU.
+   * Resetting the priority to its current value re-inserts this thread
+   * according to its new deadline.
+   */
+
+  if (tcb->flink != NULL &&
+      tcb->flink->sched_priority == tcb->sched_priority &&
+      sched_deadline_precedes(tcb->flink, tcb))
+    {
+      up_reprioritize_rtr(tcb, tcb->sched_priority);
+    }
+
+  return dl->budget;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
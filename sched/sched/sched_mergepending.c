@@ -116,7 +116,14 @@ bool sched_mergepending(void)
 
       for (;
            (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
-           rtcb = rtcb->flink);
+           rtcb = rtcb->flink)
+        {
+          if (ptcb->sched_priority == rtcb->sched_priority &&
+              sched_deadline_precedes(ptcb, rtcb))
+            {
+              break;
+            }
+        }
 
       /* Add the ptcb to the spot found in the list.  Check if the
        * ptcb goes at the ends of the ready-to-run list. This would be
@@ -289,6 +296,7 @@ bool sched_mergepending(void)
       sched_mergeprioritized((FAR dq_queue_t *)&g_pendingtasks,
                              (FAR dq_queue_t *)&g_readytorun,
                              TSTATE_TASK_READYTORUN);
+      sched_cpu_setunbalanced();
     }
 
 errout_with_lock:
@@ -296,6 +304,12 @@ errout_with_lock:
   /* Unlock the tasklist */
 
   sched_tasklist_unlock(lock);
+
+  /* Finally, start any tasks still waiting in the g_readytorun list on
+   * CPUs that are idle.
+   */
+
+  ret |= sched_cpu_balance();
   return ret;
 }
 #endif /* CONFIG_SMP */
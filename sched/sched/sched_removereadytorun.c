@@ -246,6 +246,15 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
           nxttcb = tmptcb;
         }
 
+      /* If this CPU is left idle while tasks are still waiting, one of them
+       * may have to be migrated here later.
+       */
+
+      if (nxttcb->flink == NULL && g_readytorun.head != NULL)
+        {
+          sched_cpu_setunbalanced();
+        }
+
       /* Will pre-emption be disabled after the switch?  If the lockcount is
        * greater than zero, then this task/this CPU holds the scheduler lock.
        */
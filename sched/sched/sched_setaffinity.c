@@ -125,6 +125,7 @@ int nxsched_setaffinity(pid_t pid, size_t cpusetsize,
   /* Set the new affinity mask. */
 
   tcb->affinity = *mask;
+  sched_cpu_setunbalanced();
 
   /* Is the task still executing a a CPU in its affinity mask? Will this
    * change cause the task to be removed from its current assigned task
@@ -87,6 +87,7 @@
  *          current scheduling policy.
  *   EPERM  The calling task does not have appropriate privileges.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  New SCHED_DEADLINE parameters failed admission control.
  *
  ****************************************************************************/
 
@@ -94,6 +95,7 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
 {
   FAR struct tcb_s *rtcb;
   FAR struct tcb_s *tcb;
+  int priority;
   int ret;
 
   /* Verify that the requested priority is in the valid range */
@@ -103,6 +105,8 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
       return -EINVAL;
     }
 
+  priority = param->sched_priority;
+
   /* Prohibit modifications to the head of the ready-to-run task
    * list while adjusting the priority
    */
@@ -218,9 +222,36 @@ int nxsched_setparam(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  The new parameters
+   * are subject to admission control and start a new server period.  All
+   * deadline threads keep the common deadline priority.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = sched_deadline_admit(tcb, param);
+      if (ret >= 0)
+        {
+          sched_deadline_start(tcb);
+        }
+
+      leave_critical_section(flags);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
+      priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+    }
+#endif
+
   /* Then perform the reprioritization */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
 
 errout_with_lock:
   sched_unlock();
@@ -80,7 +80,8 @@
  *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
- *      through SCHED_PRIORITY_MAX.
+ *      through SCHED_PRIORITY_MAX.  For SCHED_DEADLINE, sched_priority is
+ *      ignored and the sched_dl_* members provide the server parameters.
  *
  * Returned Value:
  *   On success, nxsched_setscheduler() returns OK (zero).  On error, a
@@ -88,6 +89,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE admission control failed.
  *
  ****************************************************************************/
 
@@ -96,6 +98,7 @@ int nxsched_setscheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+  int priority = param->sched_priority;
   int ret;
 
   /* Check for supported scheduling policy */
@@ -106,6 +109,9 @@ int nxsched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -136,6 +142,28 @@ int nxsched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Perform admission control while the current policy is still known.
+   * A thread leaving SCHED_DEADLINE releases its reserved bandwidth.
+   */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      ret = sched_deadline_admit(tcb, param);
+      if (ret < 0)
+        {
+          goto errout_with_irq;
+        }
+
+      priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+    }
+  else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      sched_deadline_stop(tcb);
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -271,6 +299,19 @@ int nxsched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Start the first server period.  The reprioritization below
+           * places the thread in deadline order.
+           */
+
+          tcb->flags       |= TCB_FLAG_SCHED_DEADLINE;
+          sched_deadline_start(tcb);
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -282,11 +323,11 @@ int nxsched_setscheduler(pid_t pid, int policy,
 
   /* Set the new priority */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -57,6 +57,10 @@
 #  include "clock/clock_timekeeping.h"
 #endif
 
+#ifdef CONFIG_HRTIMER
+#  include "hrtimer/hrtimer.h"
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 
 /****************************************************************************
@@ -91,6 +95,21 @@
 #  define MAX(a,b) (((a) > (b)) ? (a) : (b))
 #endif
 
+/* With CONFIG_HRTIMER, the platform timer is shared with the high
+ * resolution timers and all accesses go through the hrtimer logic.
+ */
+
+#if defined(CONFIG_HRTIMER)
+#  define SCHED_TIMER_START(ts)  hrtimer_sched_start(ts)
+#  define SCHED_TIMER_CANCEL(ts) hrtimer_sched_cancel(ts)
+#elif defined(CONFIG_SCHED_TICKLESS_ALARM)
+#  define SCHED_TIMER_START(ts)  up_alarm_start(ts)
+#  define SCHED_TIMER_CANCEL(ts) up_alarm_cancel(ts)
+#else
+#  define SCHED_TIMER_START(ts)  up_timer_start(ts)
+#  define SCHED_TIMER_CANCEL(ts) up_timer_cancel(ts)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -116,10 +135,12 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int sched_timer_process(unsigned int ticks, bool noswitches);
@@ -180,7 +201,8 @@ static struct timespec g_sched_time;
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -227,6 +249,19 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the elapsed time against its budget.  The remaining
+       * budget is the next interesting event.
+       */
+
+      ret = sched_deadline_process(rtcb, ticks, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -281,7 +316,8 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches)
 {
 #ifdef CONFIG_SMP
@@ -435,7 +471,7 @@ static void sched_timer_start(unsigned int ticks)
        */
 
       clock_timespec_add(&g_stop_time, &ts, &ts);
-      ret = up_alarm_start(&ts);
+      ret = SCHED_TIMER_START(&ts);
 
 #else
       /* Save new timer interval */
@@ -444,7 +480,7 @@ static void sched_timer_start(unsigned int ticks)
 
       /* [Re-]start the interval timer */
 
-      ret = up_timer_start(&ts);
+      ret = SCHED_TIMER_START(&ts);
 #endif
 
       if (ret < 0)
@@ -488,6 +524,17 @@ void sched_alarm_expiration(FAR const struct timespec *ts)
 
   DEBUGASSERT(ts);
 
+#ifdef CONFIG_HRTIMER
+  /* Run any expired high resolution timers.  Nothing more needs to be done
+   * unless the scheduler's own deadline has also been reached.
+   */
+
+  if (!hrtimer_sched_expired())
+    {
+      return;
+    }
+#endif
+
   /* Calculate elapsed */
 
   clock_timespec_subtract(ts, &g_stop_time, &delta);
@@ -545,6 +592,17 @@ void sched_timer_expiration(void)
   unsigned int elapsed;
   unsigned int nexttime;
 
+#ifdef CONFIG_HRTIMER
+  /* Run any expired high resolution timers.  Nothing more needs to be done
+   * unless the scheduler's own deadline has also been reached.
+   */
+
+  if (!hrtimer_sched_expired())
+    {
+      return;
+    }
+#endif
+
   /* Get the interval associated with last expiration */
 
   elapsed          = g_timer_interval;
@@ -601,7 +659,7 @@ unsigned int sched_timer_cancel(void)
   ts.tv_sec  = g_stop_time.tv_sec;
   ts.tv_nsec = g_stop_time.tv_nsec;
 
-  (void)up_alarm_cancel(&g_stop_time);
+  (void)SCHED_TIMER_CANCEL(&g_stop_time);
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
@@ -641,7 +699,7 @@ unsigned int sched_timer_cancel(void)
 
   /* Get the time remaining on the interval timer and cancel the timer. */
 
-  (void)up_timer_cancel(&ts);
+  (void)SCHED_TIMER_CANCEL(&ts);
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
@@ -152,7 +152,7 @@ int sched_unlock(void)
            */
 
           if (!sched_islocked_global() && !irq_cpu_locked(cpu) &&
-              g_pendingtasks.head != NULL)
+              (g_pendingtasks.head != NULL || sched_cpu_needbalance()))
             {
               up_release_pending();
             }
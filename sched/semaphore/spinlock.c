@@ -43,6 +43,7 @@
 #include <sched.h>
 #include <assert.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
@@ -128,7 +129,16 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
   while (up_testset(lock) == SP_LOCKED)
     {
-      SP_DSB();
+      /* Wait with plain reads until the lock looks free and only then try
+       * the test-and-set again.  Otherwise, every waiter would keep taking
+       * the cache line away from the holder (and from each other).
+       */
+
+      do
+        {
+          SP_DSB();
+        }
+      while (*lock == SP_LOCKED);
     }
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
@@ -165,7 +175,11 @@ void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
   while (up_testset(lock) == SP_LOCKED)
     {
-      SP_DSB();
+      do
+        {
+          SP_DSB();
+        }
+      while (*lock == SP_LOCKED);
     }
 
   SP_DMB();
@@ -561,4 +575,273 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
   up_irq_restore(flags);
 }
 
+#ifdef CONFIG_SPINLOCK_FAIR
+/****************************************************************************
+ * Name: spin_lock_ticket
+ *
+ * Description:
+ *   Take a ticket and loop until that ticket is served.  Like spin_lock(),
+ *   this is non-reentrant.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void spin_lock_ticket(FAR struct spinlock_ticket_s *lock)
+{
+  uint32_t ticket;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are waiting for a spinlock */
+
+  sched_note_spinlock(this_task(), lock);
+#endif
+
+  ticket = SP_FETCHADD(&lock->next, 1);
+  while (lock->owner != ticket)
+    {
+      SP_DSB();
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), lock);
+#endif
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: spin_trylock_ticket
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   SP_LOCKED   - Failure, the spinlock was already locked
+ *   SP_UNLOCKED - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+spinlock_t spin_trylock_ticket(FAR struct spinlock_ticket_s *lock)
+{
+  uint32_t owner = lock->owner;
+
+  /* The lock is free only if the next ticket is the one being served */
+
+  if (SP_CMPXCHG(&lock->next, owner, owner + 1))
+    {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+      sched_note_spinlocked(this_task(), lock);
+#endif
+      SP_DMB();
+      return SP_UNLOCKED;
+    }
+
+  return SP_LOCKED;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_ticket
+ *
+ * Description:
+ *   Release a ticket spinlock, handing it to the next waiter (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void spin_unlock_ticket(FAR struct spinlock_ticket_s *lock)
+{
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are unlocking the spinlock */
+
+  sched_note_spinunlock(this_task(), lock);
+#endif
+
+  /* Only the holder writes 'owner', so a plain increment is sufficient */
+
+  SP_DMB();
+  lock->owner++;
+  SP_DSB();
+}
+
+/****************************************************************************
+ * Name: spin_lock_mcs
+ *
+ * Description:
+ *   Queue the caller's node on an MCS spinlock and loop on that node until
+ *   the previous holder passes the lock on.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock object to lock.
+ *   node - The queue node to use for this acquisition.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void spin_lock_mcs(FAR struct spinlock_mcs_s *lock,
+                   FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are waiting for a spinlock */
+
+  sched_note_spinlock(this_task(), lock);
+#endif
+
+  node->next   = NULL;
+  node->locked = true;
+
+  /* Append our node to the queue.  If there was no previous node, the lock
+   * was free and is now ours.
+   */
+
+  prev = SP_XCHG(&lock->tail, node);
+  if (prev != NULL)
+    {
+      /* Link behind the previous waiter and spin on our own node until it
+       * hands the lock to us.
+       */
+
+      prev->next = node;
+      while (node->locked)
+        {
+          SP_DSB();
+        }
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), lock);
+#endif
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: spin_unlock_mcs
+ *
+ * Description:
+ *   Release an MCS spinlock, handing it to the next queued waiter (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS spinlock object to unlock.
+ *   node - The queue node that was passed to spin_lock_mcs().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void spin_unlock_mcs(FAR struct spinlock_mcs_s *lock,
+                     FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *next;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are unlocking the spinlock */
+
+  sched_note_spinunlock(this_task(), lock);
+#endif
+
+  SP_DMB();
+
+  next = node->next;
+  if (next == NULL)
+    {
+      /* No known successor.  If we are still the tail, the queue is now
+       * empty.
+       */
+
+      if (SP_CMPXCHG(&lock->tail, node, NULL))
+        {
+          return;
+        }
+
+      /* Otherwise, a new waiter has swapped itself in as the tail but has
+       * not yet linked itself to our node.  Wait for it.
+       */
+
+      while ((next = node->next) == NULL)
+        {
+          SP_DSB();
+        }
+    }
+
+  next->locked = false;
+  SP_DSB();
+}
+#endif /* CONFIG_SPINLOCK_FAIR */
+
+/****************************************************************************
+ * Name: spin_lock_irqsave_local
+ *
+ * Description:
+ *   Disable local interrupts and take a spinlock that protects data private
+ *   to one driver or subsystem.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+irqstate_t spin_lock_irqsave_local(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags;
+
+  /* Disable interrupts first so that an interrupt handler on this CPU can
+   * never spin on a lock held by the code that it interrupted.
+   */
+
+  flags = up_irq_save();
+  spin_lock(lock);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore_local
+ *
+ * Description:
+ *   Release a spinlock taken with spin_lock_irqsave_local() and restore the
+ *   local interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_irqsave_local().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void spin_unlock_irqrestore_local(FAR volatile spinlock_t *lock,
+                                  irqstate_t flags)
+{
+  spin_unlock(lock);
+  up_irq_restore(flags);
+}
+#endif /* CONFIG_SMP */
+
 #endif /* CONFIG_SPINLOCK */
@@ -52,6 +52,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 
@@ -143,6 +144,75 @@ static void nxsig_timeout(int argc, wdparm_t itcb)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer used for the timeout has expired.
+ *
+ * Assumptions:
+ *   This function executes in the context of the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void nxsig_hrtimeout(FAR struct hrtimer_s *timer)
+{
+  union wdparm_u wdparm;
+
+  wdparm.pvarg = timer->arg;
+  nxsig_timeout(1, (wdparm_t)wdparm.uiarg);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsig_hrwait
+ *
+ * Description:
+ *   Wait for a signal with a timeout implemented by a high resolution timer
+ *   so that the delay is not rounded up to a multiple of the system tick.
+ *
+ * Returned Value:
+ *   Zero (OK) if the wait was performed.  A negated errno value if no high
+ *   resolution timer could be started; the caller should then fall back to
+ *   a watchdog timer.
+ *
+ * Assumptions:
+ *   Called from nxsig_timedwait() within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int nxsig_hrwait(FAR struct tcb_s *rtcb,
+                        FAR const struct timespec *timeout)
+{
+  uint64_t nsec;
+  int ret;
+
+  nsec = (uint64_t)timeout->tv_sec * NSEC_PER_SEC +
+         (uint64_t)timeout->tv_nsec;
+
+  hrtimer_init(&rtcb->waithrtimer, nxsig_hrtimeout, rtcb);
+  ret = hrtimer_start(&rtcb->waithrtimer, nsec, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Now wait for either the signal or the timer, but first, make sure
+   * this is not the idle task, descheduling that isn't going to end well.
+   */
+
+  DEBUGASSERT(NULL != rtcb->flink);
+  up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+  /* We no longer need the timer */
+
+  (void)hrtimer_cancel(&rtcb->waithrtimer);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -315,6 +385,13 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Check if we should wait for the timeout */
 
+#ifdef CONFIG_HRTIMER
+      if (timeout != NULL && nxsig_hrwait(rtcb, timeout) >= 0)
+        {
+          /* The timed wait was performed with a high resolution timer */
+        }
+      else
+#endif
       if (timeout != NULL)
         {
           /* Convert the timespec to system clock ticks, making sure that
@@ -43,6 +43,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/sched.h>
 
 #include "semaphore/semaphore.h"
@@ -80,6 +81,10 @@ void task_recover(FAR struct tcb_s *tcb)
 
   wd_recover(tcb);
 
+#ifdef CONFIG_HRTIMER
+  (void)hrtimer_cancel(&tcb->waithrtimer);
+#endif
+
   /* If the thread holds semaphore counts or is waiting for a semaphore count,
    * then release the counts.
    */
@@ -100,4 +105,16 @@ void task_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(sched_sporadic_stop(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Release the reserved bandwidth.  Revert to SCHED_FIFO so that the
+       * bandwidth is not released again if the task is restarted.
+       */
+
+      sched_deadline_stop(tcb);
+      tcb->flags = (tcb->flags & ~TCB_FLAG_POLICY_MASK) | TCB_FLAG_SCHED_FIFO;
+    }
+#endif
 }
@@ -206,6 +206,11 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_init(&ret->pt_hrtimer, NULL, ret);
+  ret->pt_interval = 0;
+#endif
+
   /* Was a struct sigevent provided? */
 
   if (evp)
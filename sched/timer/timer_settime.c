@@ -61,6 +61,11 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer);
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(int argc, wdparm_t itimer);
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer);
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags,
+                         FAR const struct itimerspec *value);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -197,6 +202,117 @@ static void timer_timeout(int argc, wdparm_t itimer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   This function is called when the high resolution timer that provides
+ *   the timing for the POSIX timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - The high resolution timer embedded in the POSIX timer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function executes in the context of the timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer)
+{
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)hrtimer->arg;
+  uint64_t next;
+  uint64_t now;
+
+  /* Send the specified signal to the specified task.   Increment the
+   * reference count on the timer first so that will not be deleted until
+   * after the signal handler returns.
+   */
+
+  timer->pt_crefs++;
+  timer_signotify(timer);
+
+  /* Release the reference.  timer_release will return nonzero if the timer
+   * was not deleted.
+   */
+
+  if (timer_release(timer) && timer->pt_interval > 0)
+    {
+      /* This is a repetitive timer.  The next expiration is relative to the
+       * previous expiration time so that the period does not drift with the
+       * interrupt latency.  Overruns are skipped rather than delivered
+       * back-to-back.
+       */
+
+      next = hrtimer->expired + timer->pt_interval;
+      now  = hrtimer_gettime();
+      if (next <= now)
+        {
+          next = now + timer->pt_interval;
+        }
+
+      (void)hrtimer_start(hrtimer, next, HRTIMER_ABSTIME);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: timer_hrstart
+ *
+ * Description:
+ *   Start the POSIX timer using a high resolution timer.
+ *
+ * Input Parameters:
+ *   timer - The POSIX timer to be started
+ *   flags - Specifies characteristics of the timer (see timer_settime())
+ *   value - Specifies the timer value to set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure, in which case
+ *   the caller should fall back to the watchdog timer.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static int timer_hrstart(FAR struct posix_timer_s *timer, int flags,
+                         FAR const struct itimerspec *value)
+{
+  struct timespec delay;
+  uint64_t nsec;
+
+  timer->pt_interval = (uint64_t)value->it_interval.tv_sec * NSEC_PER_SEC +
+                       (uint64_t)value->it_interval.tv_nsec;
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Convert the absolute CLOCK_REALTIME value to a delay.  A time in
+       * the past results in a zero delay and an immediate notification.
+       */
+
+      struct timespec now;
+
+      (void)clock_gettime(CLOCK_REALTIME, &now);
+      clock_timespec_subtract(&value->it_value, &now, &delay);
+    }
+  else
+    {
+      delay.tv_sec  = value->it_value.tv_sec;
+      delay.tv_nsec = value->it_value.tv_nsec;
+    }
+
+  nsec = (uint64_t)delay.tv_sec * NSEC_PER_SEC + (uint64_t)delay.tv_nsec;
+
+  hrtimer_init(&timer->pt_hrtimer, timer_hrtimeout, timer);
+  return hrtimer_start(&timer->pt_hrtimer, nsec, 0);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -287,6 +403,9 @@ int timer_settime(timer_t timerid, int flags,
    */
 
   (void)wd_cancel(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  (void)hrtimer_cancel(&timer->pt_hrtimer);
+#endif
 
   /* If the it_value member of value is zero, the timer will not be re-armed */
 
@@ -316,6 +435,18 @@ int timer_settime(timer_t timerid, int flags,
 
   intflags = enter_critical_section();
 
+#ifdef CONFIG_HRTIMER
+  /* Use a high resolution timer if one is available.  Otherwise, fall back
+   * to the tick-based watchdog timer.
+   */
+
+  if (timer_hrstart(timer, flags, value) >= 0)
+    {
+      leave_critical_section(intflags);
+      return OK;
+    }
+#endif
+
   /* Check if abstime is selected */
 
   if ((flags & TIMER_ABSTIME) != 0)
@@ -206,6 +206,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(aio_write,                1, STUB_aio_write)
   SYSCALL_LOOKUP(aio_fsync,                2, STUB_aio_fsync)
   SYSCALL_LOOKUP(aio_cancel,               2, STUB_aio_cancel)
+#    ifdef CONFIG_FS_AIO_RING
+  SYSCALL_LOOKUP(io_setup,                 2, STUB_io_setup)
+  SYSCALL_LOOKUP(io_destroy,               1, STUB_io_destroy)
+  SYSCALL_LOOKUP(io_submit,                3, STUB_io_submit)
+  SYSCALL_LOOKUP(io_getevents,             5, STUB_io_getevents)
+#    endif
 #  endif
 #  ifndef CONFIG_DISABLE_POLL
   SYSCALL_LOOKUP(poll,                     3, STUB_poll)
@@ -266,9 +272,7 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sched_getstreams,         0, STUB_sched_getstreams)
 #  endif
 
-#  if defined(CONFIG_NET_SENDFILE)
-  SYSCALL_LOOKUP(sendfile,                 4, STUB_fs_sendifile)
-#  endif
+  SYSCALL_LOOKUP(sendfile,                 4, STUB_sendfile)
 
 #  if !defined(CONFIG_DISABLE_MOUNTPOINT)
 #    if defined(CONFIG_FS_READABLE)
@@ -377,7 +381,11 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(listen,                   2, STUB_listen)
   SYSCALL_LOOKUP(recv,                     4, STUB_recv)
   SYSCALL_LOOKUP(recvfrom,                 6, STUB_recvfrom)
+  SYSCALL_LOOKUP(recvmmsg,                 5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(recvmsg,                  3, STUB_recvmsg)
   SYSCALL_LOOKUP(send,                     4, STUB_send)
+  SYSCALL_LOOKUP(sendmmsg,                 4, STUB_sendmmsg)
+  SYSCALL_LOOKUP(sendmsg,                  3, STUB_sendmsg)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)